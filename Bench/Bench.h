@@ -0,0 +1,15 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Benchmarks of line-casters-bench. Each one prints its own table and returns
+// a checksum of what it computed, so the compiler cannot drop the work.
+// Rounds scale how long a bench runs, 0 picks its default.
+namespace Bench {
+    // Wire encode/decode against the memcpy of the structs
+    uint64_t runWire(size_t rounds);
+    // Datagram checksums in every integrity mode, by payload size
+    uint64_t runIntegrity(size_t rounds);
+    // Snapshot bytes per tick and per client in rooms of many players
+    uint64_t runSnapshots(size_t rounds);
+}
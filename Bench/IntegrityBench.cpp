@@ -0,0 +1,108 @@
+#include "Bench.h"
+#include "../Network/Integrity.h"
+#include "../Network/NetUtils.h"
+#include "../Network/PacketView.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// Checksum of a whole datagram in each integrity mode, per payload size up to
+// MAX_PACKET_DATA_BYTES, next to the word by word loop NetUtils had before.
+namespace {
+    constexpr size_t PAYLOAD_SIZES[] = {16, 64, 256, 512, Packet::MAX_PACKET_DATA_BYTES};
+    constexpr size_t BATCH = 256;
+
+    // NetUtils::getNetChecksum as it was, one 16 bit word per step
+    uint32_t sumWordByWord(const uint8_t *bytes, const size_t size, uint32_t sum) {
+        for (size_t i = 0; i + 1 < size; i += 2) {
+            uint16_t word;
+            memcpy(&word, bytes + i, sizeof(uint16_t));
+            sum += word;
+        }
+
+        if (size % 2 != 0) {
+            sum += static_cast<uint16_t>(bytes[size - 1] << 8);
+        }
+        return sum;
+    }
+
+    uint16_t wordByWordChecksum(const uint8_t *bytes, const size_t packetSize) {
+        constexpr size_t afterChecksum = PacketView::CHECKSUM_OFFSET + sizeof(uint16_t);
+        uint32_t sum = sumWordByWord(bytes, PacketView::CHECKSUM_OFFSET, 0);
+        sum = sumWordByWord(bytes + afterChecksum, packetSize - afterChecksum, sum);
+        return NetUtils::foldNetChecksum(sum);
+    }
+
+    uint16_t portableCrcChecksum(const uint8_t *bytes, const size_t packetSize) {
+        constexpr size_t afterChecksum = PacketView::CHECKSUM_OFFSET + sizeof(uint16_t);
+        uint32_t crc = Integrity::crc32cPortable(bytes, PacketView::CHECKSUM_OFFSET, 0xFFFFFFFF);
+        crc = ~Integrity::crc32cPortable(bytes + afterChecksum, packetSize - afterChecksum, crc);
+        return static_cast<uint16_t>(crc ^ (crc >> 16));
+    }
+
+    template <typename Function>
+    double timePerPacket(const size_t rounds, Function &&function) {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t round = 0; round < rounds; round++) {
+            function();
+        }
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / static_cast<double>(rounds * BATCH);
+    }
+}
+
+uint64_t Bench::runIntegrity(size_t rounds) {
+    if (rounds == 0) {
+        rounds = 2000;
+    }
+    srand(1);
+
+    std::vector<PacketBuffer> packets(BATCH);
+    uint64_t sink = 0;
+
+    printf("%zu rounds of %zu datagrams, ns per datagram, hardware CRC32C %s\n",
+        rounds, BATCH, Integrity::hasHardwareCrc32c() ? "yes" : "no");
+    printf("%-8s %12s %12s %12s %12s\n", "payload", "word loop", "ones' comp", "crc32c", "crc32c table");
+
+    for (const size_t payloadSize : PAYLOAD_SIZES) {
+        const size_t packetSize = Packet::PACKET_HEADER_BYTES + payloadSize;
+
+        for (size_t i = 0; i < BATCH; i++) {
+            const PacketWriter writer(packets[i].bytes);
+            writer.Begin(static_cast<uint16_t>(i), Packet::DATA_FLAG, static_cast<uint32_t>(rand()));
+            for (size_t j = 0; j < payloadSize; j++) {
+                writer.GetPayload()[j] = static_cast<uint8_t>(rand());
+            }
+            writer.Finish(payloadSize);
+        }
+
+        const auto checksumAll = [&](auto &&checksum) {
+            return timePerPacket(rounds, [&] {
+                for (auto &packet : packets) {
+                    sink += checksum(packet.bytes);
+                }
+            });
+        };
+
+        const double wordLoop = checksumAll([&](const uint8_t *bytes) {
+            return wordByWordChecksum(bytes, packetSize);
+        });
+        const double onesComplement = checksumAll([&](const uint8_t *bytes) {
+            return Integrity::computePacketChecksum(IntegrityMode::ONES_COMPLEMENT, bytes, packetSize,
+                PacketView::CHECKSUM_OFFSET);
+        });
+        const double crc = checksumAll([&](const uint8_t *bytes) {
+            return Integrity::computePacketChecksum(IntegrityMode::CRC32C, bytes, packetSize,
+                PacketView::CHECKSUM_OFFSET);
+        });
+        const double crcTable = checksumAll([&](const uint8_t *bytes) {
+            return portableCrcChecksum(bytes, packetSize);
+        });
+
+        printf("%-8zu %12.1f %12.1f %12.1f %12.1f\n", payloadSize, wordLoop, onesComplement, crc, crcTable);
+    }
+
+    return sink;
+}
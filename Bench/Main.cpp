@@ -0,0 +1,38 @@
+#include "Bench.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+int main(const int argc, char **argv) {
+    const char *name = argc > 1 ? argv[1] : "all";
+    const size_t rounds = argc > 2 ? strtoul(argv[2], nullptr, 10) : 0;
+    const bool all = strcmp(name, "all") == 0;
+
+    uint64_t sink = 0;
+    bool ran = false;
+    if (all || strcmp(name, "wire") == 0) {
+        sink += Bench::runWire(rounds);
+        ran = true;
+    }
+    if (all || strcmp(name, "integrity") == 0) {
+        if (ran) {
+            printf("\n");
+        }
+        sink += Bench::runIntegrity(rounds);
+        ran = true;
+    }
+    if (all || strcmp(name, "snapshot") == 0) {
+        if (ran) {
+            printf("\n");
+        }
+        sink += Bench::runSnapshots(rounds);
+        ran = true;
+    }
+
+    if (!ran) {
+        printf("Usage: %s [all|wire|integrity|snapshot] [ROUNDS]\n", argv[0]);
+        return 1;
+    }
+
+    return sink == 42 ? 1 : 0;
+}
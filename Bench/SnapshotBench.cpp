@@ -0,0 +1,195 @@
+#include "Bench.h"
+#include "../Client/SnapshotCodec.h"
+#include "../Network/PacketView.h"
+#include "../Server/Match.h"
+#include "../Server/Server.h"
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Bytes each client gets per server tick in a room of bots flying around, as
+// the server sends them: interest management picks the other players that fit
+// one datagram, and the snapshot is a delta against the last one the client
+// acked. Acks come back ACK_DELAY_TICKS later and some snapshots are lost on
+// the way, so baselines are as old as on a real link. The same states are also
+// sized as full snapshots and as the packed FullState the codec replaced.
+namespace {
+    constexpr int ROOM_SIZES[] = {8, 32, Match::MAX_PLAYERS};
+    // ~100 ms round trip at 30 ticks per second
+    constexpr size_t ACK_DELAY_TICKS = 3;
+    constexpr int LOSS_PERCENT = 5;
+    // a bot holds its keys this many ticks on average, and shoots now and then
+    constexpr int KEY_CHANGE_ODDS = 20;
+    constexpr int SHOT_ODDS = 60;
+
+    // The packed layout of FullState sent with memcpy before SnapshotCodec:
+    // the RawState, every OtherState, a size_t count and the two counters
+    constexpr size_t RAW_STATE_BYTES = 1 + 3 * sizeof(float) + sizeof(int) + sizeof(float);
+    constexpr size_t RAW_OTHER_STATE_BYTES = sizeof(int) + 3 * sizeof(float) + sizeof(int) + sizeof(float);
+    constexpr size_t RAW_FULL_STATE_FIXED_BYTES = RAW_STATE_BYTES + sizeof(uint64_t) + 2 * sizeof(uint32_t);
+
+    // Room left for the snapshot in a DATA payload after the header
+    constexpr size_t SNAPSHOT_CAPACITY = PacketWriter::PAYLOAD_CAPACITY - Wire::size<ServerDataHeader>();
+
+    struct BenchClient {
+        int playerId;
+        int slot;
+        uint8_t keys;
+        uint16_t nextSnapshotId;
+        bool hasAck;
+        uint16_t ackedId;
+        SnapshotHistory sent;
+        // ids in flight, acked when they land
+        std::vector<std::pair<size_t, uint16_t>> pendingAcks;
+    };
+
+    struct Totals {
+        size_t snapshots;
+        size_t otherStates;
+        size_t rawBytes;
+        size_t fullBytes;
+        size_t deltaBytes;
+        size_t deltas;
+    };
+
+    uint8_t randomKeys() {
+        uint8_t keys = 0;
+        if (rand() % 4 != 0) {
+            keys |= static_cast<uint8_t>(KeyValue::MOVE_FORWARD);
+        }
+        if (const int turn = rand() % 3; turn == 1) {
+            keys |= static_cast<uint8_t>(KeyValue::MOVE_LEFT);
+        } else if (turn == 2) {
+            keys |= static_cast<uint8_t>(KeyValue::MOVE_RIGHT);
+        }
+        return keys;
+    }
+
+    void join(Match &match, BenchClient &client, const int playerId) {
+        client = BenchClient();
+        client.playerId = playerId;
+        client.slot = match.AddPlayer(playerId);
+        client.keys = randomKeys();
+    }
+
+    Totals runRoom(const int players, const size_t ticks) {
+        Match match;
+        std::vector<BenchClient> clients(players);
+        int nextPlayerId = 0;
+        for (auto &client : clients) {
+            join(match, client, nextPlayerId++);
+        }
+
+        Totals totals{};
+        uint8_t buffer[PacketWriter::PAYLOAD_CAPACITY];
+        uint32_t commandSequence = 0;
+
+        for (size_t tick = 0; tick < ticks; tick++) {
+            // two client frames per tick, like the uplink
+            for (auto &client : clients) {
+                if (rand() % KEY_CHANGE_ODDS == 0) {
+                    client.keys = randomKeys();
+                }
+
+                Command commands[2];
+                for (auto &command : commands) {
+                    uint8_t keys = client.keys;
+                    if (rand() % SHOT_ODDS == 0) {
+                        keys |= static_cast<uint8_t>(KeyValue::SHOOT);
+                    }
+                    command = Command(++commandSequence, InputData(keys));
+                }
+                match.ApplyCommands(client.slot, commands, 2, 0.0f);
+            }
+            match.Update(Server::TICK_DELTA_TIME);
+
+            for (auto &client : clients) {
+                // acks of the snapshots that made it back by now
+                for (auto it = client.pendingAcks.begin(); it != client.pendingAcks.end();) {
+                    if (it->first > tick) {
+                        ++it;
+                        continue;
+                    }
+                    if (!client.hasAck || SnapshotCodec::isNewer(it->second, client.ackedId)) {
+                        client.hasAck = true;
+                        client.ackedId = it->second;
+                    }
+                    it = client.pendingAcks.erase(it);
+                }
+
+                FullState state = match.BuildState(client.slot);
+                state.serverTick = static_cast<uint32_t>(tick);
+                const uint16_t snapshotId = client.nextSnapshotId++;
+
+                const FullState *baseline = client.hasAck ? client.sent.FindBaseline(snapshotId, client.ackedId) : nullptr;
+                size_t written = 0;
+                const size_t size = SnapshotCodec::encode(state, snapshotId, baseline, client.ackedId, buffer,
+                    SNAPSHOT_CAPACITY, &written);
+
+                size_t fullWritten = 0;
+                const size_t fullSize = SnapshotCodec::encode(state, snapshotId, nullptr, 0, buffer,
+                    SNAPSHOT_CAPACITY, &fullWritten);
+
+                state.otherStateSize = written;
+                client.sent.Store(snapshotId, state);
+                match.MarkStateSent(client.slot, state);
+
+                if (rand() % 100 >= LOSS_PERCENT) {
+                    client.pendingAcks.emplace_back(tick + ACK_DELAY_TICKS, snapshotId);
+                }
+
+                totals.snapshots++;
+                totals.otherStates += written;
+                totals.rawBytes += RAW_FULL_STATE_FIXED_BYTES + written * RAW_OTHER_STATE_BYTES;
+                totals.fullBytes += fullSize;
+                totals.deltaBytes += size;
+                totals.deltas += baseline != nullptr ? 1 : 0;
+            }
+
+            // the dead come back as new players, with no history on either side
+            for (auto &client : clients) {
+                if (match.BuildState(client.slot).rawState.life <= 0) {
+                    match.RemovePlayer(client.slot);
+                    join(match, client, nextPlayerId++);
+                }
+            }
+        }
+
+        return totals;
+    }
+}
+
+uint64_t Bench::runSnapshots(size_t rounds) {
+    if (rounds == 0) {
+        rounds = 3000;
+    }
+    srand(1);
+
+    printf("%zu ticks per room, acks %zu ticks late, %d%% of the snapshots lost\n",
+        rounds, ACK_DELAY_TICKS, LOSS_PERCENT);
+    printf("bytes per tick and per client, snapshot capacity %zu B\n", SNAPSHOT_CAPACITY);
+    printf("%-8s %7s %9s %9s %9s %7s %7s %12s\n",
+        "players", "others", "packed", "full", "delta", "deltas", "ratio", "room kB/s");
+
+    uint64_t sink = 0;
+    for (const int players : ROOM_SIZES) {
+        const Totals totals = runRoom(players, rounds);
+        const auto snapshots = static_cast<double>(totals.snapshots);
+        const double delta = static_cast<double>(totals.deltaBytes) / snapshots;
+        const double packed = static_cast<double>(totals.rawBytes) / snapshots;
+
+        printf("%-8d %7.1f %9.1f %9.1f %9.1f %6.0f%% %6.1fx %12.1f\n",
+            players,
+            static_cast<double>(totals.otherStates) / snapshots,
+            packed,
+            static_cast<double>(totals.fullBytes) / snapshots,
+            delta,
+            100.0 * static_cast<double>(totals.deltas) / snapshots,
+            packed / delta,
+            delta * players * Server::TICK_RATE / 1000.0);
+
+        sink += totals.deltaBytes;
+    }
+
+    return sink;
+}
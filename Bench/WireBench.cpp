@@ -0,0 +1,212 @@
+#include "Bench.h"
+#include "../Client/DataObjects.h"
+#include "../Network/Packet.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// Times the Wire encode/decode of the messages still sent as fixed structs
+// against a memcpy of the structs, the bar for the wire path. Every round goes
+// over a batch of different messages so nothing is folded at compile time,
+// and the decoded values feed a checksum the compiler has to keep. The packet
+// case is a whole uplink DATA payload, header and commands, built and checked
+// like the client and server do.
+namespace {
+    constexpr size_t BATCH = 4096;
+    // raw and wire take turns and keep their best time, so neither pays for
+    // running first or for the odd preemption
+    constexpr int REPEATS = 9;
+
+    uint64_t sSink = 0;
+
+    template <typename T>
+    void consume(const T &value) {
+        uint64_t word = 0;
+        memcpy(&word, &value, std::min(sizeof(word), sizeof(value)));
+        sSink += word;
+    }
+
+    struct Result {
+        double rawNs;
+        double wireNs;
+    };
+
+    template <typename Function>
+    double timePerMessage(const size_t rounds, Function &&function) {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t round = 0; round < rounds; round++) {
+            function();
+        }
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / static_cast<double>(rounds * BATCH);
+    }
+
+    template <typename Raw, typename Wire>
+    Result bestOf(const size_t rounds, Raw &&raw, Wire &&wire) {
+        Result best{};
+        for (int i = 0; i < REPEATS; i++) {
+            const double rawNs = timePerMessage(rounds, raw);
+            const double wireNs = timePerMessage(rounds, wire);
+            best.rawNs = i == 0 ? rawNs : std::min(best.rawNs, rawNs);
+            best.wireNs = i == 0 ? wireNs : std::min(best.wireNs, wireNs);
+        }
+        return best;
+    }
+
+    // Encode then decode every message of the batch, raw and through Wire
+    template <typename T>
+    Result benchMessage(const std::vector<T> &messages, const size_t rounds) {
+        std::vector<uint8_t> bytes(BATCH * std::max(sizeof(T), Wire::size<T>()));
+        std::vector<T> decoded(messages);
+
+        return bestOf(rounds, [&] {
+            for (size_t i = 0; i < BATCH; i++) {
+                memcpy(bytes.data() + i * sizeof(T), &messages[i], sizeof(T));
+            }
+            for (size_t i = 0; i < BATCH; i++) {
+                memcpy(&decoded[i], bytes.data() + i * sizeof(T), sizeof(T));
+            }
+            consume(decoded[sSink % BATCH]);
+        }, [&] {
+            for (size_t i = 0; i < BATCH; i++) {
+                Wire::encode(messages[i], bytes.data() + i * Wire::size<T>(), Wire::size<T>());
+            }
+            for (size_t i = 0; i < BATCH; i++) {
+                Wire::decode(bytes.data() + i * Wire::size<T>(), Wire::size<T>(), &decoded[i]);
+            }
+            consume(decoded[sSink % BATCH]);
+        });
+    }
+
+    constexpr size_t PACKET_COMMANDS = 16;
+    constexpr size_t PACKET_BATCH = BATCH / PACKET_COMMANDS;
+
+    // The commands of one uplink payload as an array, per command
+    Result benchCommandArray(const std::vector<Command> &commands, const size_t rounds) {
+        uint8_t bytes[PACKET_COMMANDS * sizeof(Command)];
+        Command decoded[PACKET_COMMANDS];
+
+        return bestOf(rounds, [&] {
+            for (size_t i = 0; i < PACKET_BATCH; i++) {
+                memcpy(bytes, &commands[i * PACKET_COMMANDS], sizeof(bytes));
+                memcpy(decoded, bytes, sizeof(bytes));
+                consume(decoded[i % PACKET_COMMANDS]);
+            }
+        }, [&] {
+            for (size_t i = 0; i < PACKET_BATCH; i++) {
+                const size_t size = Wire::encodeArray(&commands[i * PACKET_COMMANDS], PACKET_COMMANDS, bytes, sizeof(bytes));
+                Wire::decodeArray(bytes, size, decoded, PACKET_COMMANDS);
+                consume(decoded[i % PACKET_COMMANDS]);
+            }
+        });
+    }
+
+    // Header and commands into a DATA packet and back out, per packet
+    Result benchPacket(const std::vector<ClientDataHeader> &headers, const std::vector<Command> &commands, const size_t rounds) {
+        Packet packet(0, Packet::DATA_FLAG, 1);
+        uint8_t payload[Packet::MAX_PACKET_DATA_BYTES];
+        Command decoded[PACKET_COMMANDS];
+        ClientDataHeader header(false, 0);
+
+        const auto roundTrip = [&](auto &&encode, auto &&decode) {
+            for (size_t i = 0; i < PACKET_BATCH; i++) {
+                const size_t bytes = encode(headers[i], &commands[i * PACKET_COMMANDS]);
+                packet.Reset(static_cast<uint16_t>(i), Packet::DATA_FLAG, 1);
+                packet.SetData(payload, bytes);
+                packet.BuildPacket();
+                if (packet.IsValid(Packet::PACKET_HEADER_BYTES + bytes)) {
+                    decode(static_cast<const uint8_t*>(packet.GetData()), packet.GetLength());
+                }
+            }
+            consume(header);
+            consume(decoded[sSink % PACKET_COMMANDS]);
+        };
+
+        const auto rawPacket = [&] {
+            roundTrip([&](const ClientDataHeader &h, const Command *c) {
+                memcpy(payload, &h, sizeof(h));
+                memcpy(payload + sizeof(h), c, PACKET_COMMANDS * sizeof(Command));
+                return sizeof(h) + PACKET_COMMANDS * sizeof(Command);
+            }, [&](const uint8_t *data, const size_t) {
+                memcpy(&header, data, sizeof(header));
+                memcpy(decoded, data + sizeof(header), PACKET_COMMANDS * sizeof(Command));
+            });
+        };
+
+        const auto wirePacket = [&] {
+            roundTrip([&](const ClientDataHeader &h, const Command *c) {
+                const size_t headerSize = Wire::encode(h, payload, sizeof(payload));
+                return headerSize + Wire::encodeArray(c, PACKET_COMMANDS, payload + headerSize, sizeof(payload) - headerSize);
+            }, [&](const uint8_t *data, const size_t size) {
+                const size_t headerSize = Wire::decode(data, size, &header);
+                Wire::decodeArray(data + headerSize, size - headerSize, decoded, PACKET_COMMANDS);
+            });
+        };
+
+        Result result = bestOf(rounds, rawPacket, wirePacket);
+        result.rawNs *= PACKET_COMMANDS;
+        result.wireNs *= PACKET_COMMANDS;
+        return result;
+    }
+
+    void print(const char *name, const size_t rawBytes, const size_t wireBytes, const Result &result) {
+        printf("%-18s raw %3zu B %6.2f ns   wire %3zu B %6.2f ns   %5.2fx\n",
+            name, rawBytes, result.rawNs, wireBytes, result.wireNs, result.wireNs / result.rawNs);
+    }
+}
+
+uint64_t Bench::runWire(size_t rounds) {
+    if (rounds == 0) {
+        rounds = 2000;
+    }
+    srand(1);
+
+    std::vector<ClientDataHeader> clientHeaders;
+    std::vector<Command> commands;
+    std::vector<ServerDataHeader> serverHeaders;
+    std::vector<ShotEvent> shots;
+    std::vector<CommandRun> runs;
+    for (size_t i = 0; i < BATCH; i++) {
+        ClientDataHeader header(rand() & 1, static_cast<uint16_t>(rand()));
+        header.hasDownlinkAck = 1;
+        header.downlinkAckedSequence = static_cast<uint16_t>(rand());
+        header.downlinkAckBits = static_cast<uint32_t>(rand());
+        header.hasViewTick = 1;
+        header.viewTick = static_cast<uint32_t>(rand());
+        header.viewTickFraction = static_cast<uint8_t>(rand());
+        clientHeaders.push_back(header);
+
+        commands.emplace_back(static_cast<uint32_t>(rand()), InputData(static_cast<uint8_t>(rand())));
+
+        ServerDataHeader serverHeader;
+        serverHeader.hasAck = 1;
+        serverHeader.ackedSequence = static_cast<uint16_t>(rand());
+        serverHeader.ackBits = static_cast<uint32_t>(rand());
+        serverHeader.ackDelayMs = static_cast<uint8_t>(rand());
+        serverHeaders.push_back(serverHeader);
+
+        shots.emplace_back(rand() % 64, static_cast<uint32_t>(rand()),
+            static_cast<float>(rand() % 1000), static_cast<float>(rand() % 1000), static_cast<float>(rand() % 628) / 100.0f);
+
+        runs.emplace_back(static_cast<uint32_t>(rand()), static_cast<uint8_t>(rand()), static_cast<uint8_t>(rand()));
+    }
+
+    printf("%zu rounds of %zu messages, encode + decode per message\n", rounds, BATCH);
+    print("ClientDataHeader", sizeof(ClientDataHeader), Wire::size<ClientDataHeader>(), benchMessage(clientHeaders, rounds));
+    print("Command", sizeof(Command), Wire::size<Command>(), benchMessage(commands, rounds));
+    print("ServerDataHeader", sizeof(ServerDataHeader), Wire::size<ServerDataHeader>(), benchMessage(serverHeaders, rounds));
+    print("ShotEvent", sizeof(ShotEvent), Wire::size<ShotEvent>(), benchMessage(shots, rounds));
+    print("CommandRun", sizeof(CommandRun), Wire::size<CommandRun>(), benchMessage(runs, rounds));
+
+    print("Command[16]", PACKET_COMMANDS * sizeof(Command), PACKET_COMMANDS * Wire::size<Command>(),
+        benchCommandArray(commands, rounds));
+
+    printf("\nDATA packet of a header and %zu commands, build and check included\n", PACKET_COMMANDS);
+    constexpr size_t packetBytes = Wire::size<ClientDataHeader>() + PACKET_COMMANDS * Wire::size<Command>();
+    print("packet", sizeof(ClientDataHeader) + PACKET_COMMANDS * sizeof(Command), packetBytes, benchPacket(clientHeaders, commands, rounds));
+
+    return sSink;
+}
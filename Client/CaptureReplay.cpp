@@ -0,0 +1,210 @@
+#include "CaptureReplay.h"
+#include "Client.h"
+#include "ClientOperations.h"
+#include "CommandRuns.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+CaptureReplay::CaptureReplay()
+    : mSpeed(1.0)
+      , mServerAddr{}
+      , mFirstTime(0)
+      , mStarted(false)
+      , mHasPending(false)
+      , mPending{}
+      , mBatch(Client::RECEIVE_BATCH_CAPACITY)
+      , mHasCommand(false)
+      , mLastCommandSequence(0)
+{
+}
+
+bool CaptureReplay::Open(const char *path, const double speed) {
+    Close();
+    if (!mLog.Open(path)) {
+        return false;
+    }
+
+    mSpeed = speed;
+
+    // the client keeps the first SYN_ACK that answers one of its SYNs. A
+    // capture of another wire version fails validation and has none.
+    Capture::Record record{};
+    while (mLog.Next(&record)) {
+        const PacketView view(record.data, record.size);
+        if (!view.IsValid(IntegrityMode::ONES_COMPLEMENT)) {
+            continue;
+        }
+
+        if (record.direction == Capture::Direction::OUTGOING || view.GetFlag() != Packet::SYN_ACK_FLAG) {
+            continue;
+        }
+
+        memcpy(&mSynAck, record.data, std::min(record.size, sizeof(Packet)));
+        mServerAddr = record.addr;
+        mFirstTime = record.time;
+        return true;
+    }
+
+    Close();
+    return false;
+}
+
+void CaptureReplay::Close() {
+    mLog.Close();
+    mStarted = false;
+    mHasPending = false;
+    mBatch.Clear();
+    mOutgoingReader.Clear();
+    mHasCommand = false;
+    mLastCommandSequence = 0;
+    mStats = ReplayStats();
+}
+
+bool CaptureReplay::NextRecord(Capture::Record *record) {
+    if (mHasPending) {
+        *record = mPending;
+        mHasPending = false;
+        return true;
+    }
+
+    if (!mLog.Next(record)) {
+        return false;
+    }
+    mStats.records++;
+    return true;
+}
+
+void CaptureReplay::PushBack(const Capture::Record &record) {
+    mPending = record;
+    mHasPending = true;
+}
+
+// Records are due at their capture time scaled by the speed, counted from the first step
+std::chrono::steady_clock::time_point CaptureReplay::WaitUntilDue(const std::chrono::nanoseconds time) {
+    const auto now = std::chrono::steady_clock::now();
+    if (!mStarted) {
+        mStarted = true;
+        mStartedAt = now;
+    }
+
+    const auto offset = std::max(std::chrono::nanoseconds(0), time - mFirstTime);
+    mStats.replayed = offset;
+    mStats.elapsed = now - mStartedAt;
+
+    if (mSpeed <= 0.0) {
+        return now;
+    }
+
+    const auto due = mStartedAt + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double, std::nano>(static_cast<double>(offset.count()) / mSpeed));
+    if (due > now) {
+        std::this_thread::sleep_until(due);
+    }
+    return due;
+}
+
+bool CaptureReplay::Advance(Client *client, ReceivedSnapshot *snapshot, bool *received, std::vector<Command> *commands) {
+    *received = false;
+
+    Capture::Record record{};
+    if (!NextRecord(&record)) {
+        return false;
+    }
+
+    const auto at = WaitUntilDue(record.time);
+
+    if (record.direction == Capture::Direction::OUTGOING) {
+        ReadOutgoing(client, record, at, commands);
+        return true;
+    }
+
+    // one receive call stamped all of its datagrams with the same time
+    mBatch.Clear();
+    size_t size = 0;
+    do {
+        const size_t bytes = std::min(record.size, PacketBatch::SLOT_BYTES);
+        memcpy(mBatch.GetBuffer(size), record.data, bytes);
+        mBatch.GetAddress(size) = record.addr;
+        mBatch.SetBytes(size, bytes);
+        size++;
+
+        Capture::Record next{};
+        if (!NextRecord(&next)) {
+            break;
+        }
+        if (next.direction != Capture::Direction::INCOMING || next.time != record.time || size == mBatch.GetCapacity()) {
+            PushBack(next);
+            break;
+        }
+        record = next;
+    } while (true);
+    mBatch.SetSize(size);
+    mStats.batches++;
+
+    const auto decodeStart = std::chrono::steady_clock::now();
+    *received = ClientOperations::receiveDataFromBatch(client, &mBatch, at, snapshot);
+    mStats.decoding += std::chrono::steady_clock::now() - decodeStart;
+
+    if (*received) {
+        mStats.snapshots++;
+    }
+    return true;
+}
+
+// The sends are timed like the originals so the acks in the snapshots give
+// back the recorded RTT, and the commands not seen yet go to the prediction
+void CaptureReplay::ReadOutgoing(
+    Client *client,
+    const Capture::Record &record,
+    const std::chrono::steady_clock::time_point at,
+    std::vector<Command> *commands
+) {
+    if (record.addr.sin_addr.s_addr != mServerAddr.sin_addr.s_addr || record.addr.sin_port != mServerAddr.sin_port) {
+        return;
+    }
+
+    const PacketView packet(record.data, record.size);
+    if (!packet.IsValid(client->GetIntegrityMode())) {
+        return;
+    }
+
+    Transport::Message message{};
+    mOutgoingReader.Begin(packet, at);
+    while (mOutgoingReader.Next(&message)) {
+        if (message.flag != Packet::DATA_FLAG && message.flag != Packet::PING_FLAG) {
+            continue;
+        }
+
+        client->GetConnectionStats().OnPacketSent(message.sequence, Packet::PACKET_HEADER_BYTES + message.size, at);
+
+        ClientDataHeader header(false, 0);
+        const size_t headerSize = Wire::decode(message.data, message.size, &header);
+        if (message.flag != Packet::DATA_FLAG || headerSize == 0) {
+            continue;
+        }
+
+        const uint8_t *body = message.data + headerSize;
+        const size_t bodySize = message.size - headerSize;
+
+        Command decoded[PacketWriter::PAYLOAD_CAPACITY / Wire::size<Command>()];
+        size_t decodedSize;
+        if (header.commandFormat == CommandFormat::RUNS) {
+            decodedSize = CommandRuns::decode(body, bodySize, decoded, CommandRuns::REDUNDANCY_WINDOW);
+        } else {
+            decodedSize = Wire::decodeArray(body, bodySize, decoded, sizeof(decoded) / sizeof(Command));
+        }
+
+        // every datagram repeats the unconfirmed commands
+        for (size_t i = 0; i < decodedSize; i++) {
+            if (mHasCommand && decoded[i].sequence <= mLastCommandSequence) {
+                continue;
+            }
+
+            commands->push_back(decoded[i]);
+            mHasCommand = true;
+            mLastCommandSequence = decoded[i].sequence;
+            mStats.commands++;
+        }
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+#include "../Network/Capture.h"
+#include "../Network/Packet.h"
+#include "../Network/PacketBatch.h"
+#include "../Network/Transport.h"
+#include "DataObjects.h"
+
+class Client;
+struct ReceivedSnapshot;
+
+struct ReplayStats {
+    size_t records = 0;
+    size_t batches = 0;
+    size_t snapshots = 0;
+    size_t commands = 0;
+    // capture time covered so far and the wall time it took
+    std::chrono::nanoseconds replayed{0};
+    std::chrono::nanoseconds elapsed{0};
+    // spent inside ClientOperations decoding the server batches
+    std::chrono::nanoseconds decoding{0};
+};
+
+// Feeds a capture taken by the client back through ClientOperations in place
+// of the socket. The server datagrams seen by one batched receive share their
+// timestamp and are fed as one batch again. The client's own DATA give back
+// the commands it predicted, in the order it sent them.
+class CaptureReplay {
+public:
+    CaptureReplay();
+
+    // Opens the log and skips to the SYN_ACK the client accepted. A speed of 1
+    // keeps the original pace, 0 or less replays as fast as possible.
+    bool Open(const char *path, double speed);
+    void Close();
+
+    // The recorded connection, the replay starts right after it
+    [[nodiscard]] const sockaddr_in &GetServerAddress() const { return mServerAddr; }
+    [[nodiscard]] const Packet &GetSynAck() const { return mSynAck; }
+
+    // Waits until the next step is due and feeds it: a batch of server
+    // datagrams or one client datagram. Commands newer than any seen before are
+    // appended. False once the log is over.
+    bool Advance(Client *client, ReceivedSnapshot *snapshot, bool *received, std::vector<Command> *commands);
+
+    [[nodiscard]] const ReplayStats &GetStats() const { return mStats; }
+
+private:
+    bool NextRecord(Capture::Record *record);
+    void PushBack(const Capture::Record &record);
+    [[nodiscard]] std::chrono::steady_clock::time_point WaitUntilDue(std::chrono::nanoseconds time);
+    void ReadOutgoing(Client *client, const Capture::Record &record, std::chrono::steady_clock::time_point at,
+        std::vector<Command> *commands);
+
+    CaptureLog mLog;
+    double mSpeed;
+    Packet mSynAck;
+    sockaddr_in mServerAddr;
+    std::chrono::nanoseconds mFirstTime;
+    bool mStarted;
+    std::chrono::steady_clock::time_point mStartedAt;
+
+    // a record read ahead while gathering a batch
+    bool mHasPending;
+    Capture::Record mPending;
+
+    PacketBatch mBatch;
+    // the client datagrams are split apart like the server does it
+    TransportReader mOutgoingReader;
+    bool mHasCommand;
+    uint32_t mLastCommandSequence;
+
+    ReplayStats mStats;
+};
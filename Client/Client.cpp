@@ -4,6 +4,7 @@
 #include "Client.h"
 #include <algorithm>
 #include "ClientOperations.h"
+#include "CommandRuns.h"
 #include "../Network/Socket.h"
 #include "../Network/Addresses.h"
 #include "../Network/Defs.h"
@@ -19,16 +20,32 @@ Client::Client(Game *game)
     : mState(ClientState::CLIENT_DOWN)
       , mSocket(-1)
       , mServerAddrV4{}
+      , mReceiveBatch(RECEIVE_BATCH_CAPACITY)
+      , mSendBatch(Transport::MAX_FRAGMENTS)
+      , mTransportWriter(&mSendBatch)
+      , mNetworkRunning(false)
+      , mViewTick(0.0)
       , mCurrentPacketSequence(0)
       , mClientNonce(0)
-      , mConnecting(false)
+      , mIntegrityMode(IntegrityMode::ONES_COMPLEMENT)
+      , mUplinkMode(UplinkMode::TICK_ALIGNED)
       , mDisconnecting(false)
+      , mProbes{}
+      , mProbesSize(0)
+      , mFirstSynSequence(0)
+      , mReplaying(false)
       , mLastReceivedInputSequence(0)
       , mLasRemovedInputSequence(0)
+      , mHasSnapshot(false)
+      , mLastSnapshotId(0)
       , mGame(game)
 {
 }
 
+Client::~Client() {
+    StopNetworkThread();
+}
+
 void Client::Initialize() {
     if (mState != ClientState::CLIENT_DOWN) {
         return;
@@ -42,56 +59,228 @@ void Client::Initialize() {
 }
 
 bool Client::AddServerAddr(const char *serverIp) {
-    if (mState != ClientState::CLIENT_SET) {
+    if (mState != ClientState::CLIENT_SET && mState != ClientState::CLIENT_READY) {
+        return false;
+    }
+
+    if (mProbesSize == MAX_SERVER_CANDIDATES) {
         return false;
     }
 
-    if (!Addresses::parseAddrV4(&mServerAddrV4, serverIp, APP_PORT)) {
+    // a port can be given to go through the network condition simulator
+    ServerProbe &probe = mProbes[mProbesSize];
+    if (!Addresses::parseEndpointV4(&probe.addr, serverIp, APP_PORT)) {
         return false;
     }
 
+    mProbesSize++;
     mState = ClientState::CLIENT_READY;
 
     SDL_Log("Server address added");
     return true;
 }
 
+void Client::ClearServerAddrs() {
+    if (mState != ClientState::CLIENT_READY) {
+        return;
+    }
 
-bool Client::Connect() {
+    mProbesSize = 0;
+    mState = ClientState::CLIENT_SET;
+}
+
+bool Client::StartConnection() {
     if (mState != ClientState::CLIENT_READY) {
         return false;
     }
 
-    mConnecting = true;
+    mIntegrityMode = IntegrityMode::ONES_COMPLEMENT;
+    mSnapshotHistory.Clear();
+    mHasSnapshot = false;
+    mViewTick = 0.0;
+    mFirstSynSequence = mCurrentPacketSequence;
+
+    // every candidate gets its first SYN right away, the fastest answer wins
+    const auto now = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < mProbesSize; i++) {
+        ServerProbe &probe = mProbes[i];
+        probe.attempts = 0;
+        probe.failed = false;
+        probe.timeout = INITIAL_SYN_TIMEOUT;
+        SendSyn(probe, now);
+    }
 
-    for (int i = 0; i < MAX_CONNECTION_ATTEMPTS; i++) {
-        ClientOperations::sendSinglePacketToServer(this, Packet::SYN_FLAG);
+    mState = ClientState::CLIENT_CONNECTING;
+    return true;
+}
 
-        if (!ClientOperations::receiveSinglePacketFromServer(this, Packet::SYN_ACK_FLAG)) {
-            SDL_Log("Response not received, trying again...");
+ConnectionStatus Client::CheckConnection() {
+    if (mState == ClientState::CLIENT_CONNECTED) {
+        return ConnectionStatus::SUCCESS;
+    }
+
+    if (mState != ClientState::CLIENT_CONNECTING) {
+        return ConnectionStatus::FAILURE;
+    }
+
+    if (ReceiveSynAck()) {
+        return ConnectionStatus::SUCCESS;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    bool probing = false;
+    for (size_t i = 0; i < mProbesSize; i++) {
+        ServerProbe &probe = mProbes[i];
+        if (probe.failed) {
             continue;
         }
 
-        ClientOperations::sendSinglePacketToServer(this, Packet::ACK_FLAG);
+        if (now >= probe.nextSendAt) {
+            if (probe.attempts == MAX_CONNECTION_ATTEMPTS) {
+                probe.failed = true;
+                continue;
+            }
 
-        SDL_Log("Client connected");
-        mState = ClientState::CLIENT_CONNECTED;
-        mConnecting = false;
-        return true;
+            probe.timeout = std::min(probe.timeout * 2, MAX_SYN_TIMEOUT);
+            SendSyn(probe, now);
+        }
+        probing = true;
     }
 
+    if (probing) {
+        return ConnectionStatus::IN_PROGRESS;
+    }
+
+    // the candidates have to be given again for the next try
     SDL_Log("Max connection attempts reached");
-    mConnecting = false;
+    mProbesSize = 0;
+    mState = ClientState::CLIENT_SET;
+    return ConnectionStatus::FAILURE;
+}
+
+void Client::SendSyn(ServerProbe &probe, const std::chrono::steady_clock::time_point now) {
+    const auto sequence = static_cast<uint16_t>(mFirstSynSequence + probe.attempts);
+    ClientOperations::sendSynToServer(this, probe.addr, sequence);
+
+    probe.sentAt[probe.attempts] = now;
+    probe.attempts++;
+    probe.nextSendAt = now + probe.timeout;
+}
+
+// Drains the socket without waiting, true once a candidate answered
+bool Client::ReceiveSynAck() {
+    while (SocketUtils::socketReadyToReceive(mSocket, 0)) {
+        Packet packet;
+        sockaddr_in addr{};
+        const size_t size = SocketUtils::receivePacketFromV4(mSocket, &packet, &addr);
+        if (size == 0) {
+            return false;
+        }
+
+        if (!packet.IsValid(size, IntegrityMode::ONES_COMPLEMENT) ||
+            (packet.GetFlag() != Packet::SYN_ACK_FLAG && packet.GetFlag() != Packet::RST_FLAG)) {
+            continue;
+        }
+
+        for (size_t i = 0; i < mProbesSize; i++) {
+            ServerProbe &probe = mProbes[i];
+            if (probe.addr.sin_addr.s_addr != addr.sin_addr.s_addr || probe.addr.sin_port != addr.sin_port) {
+                continue;
+            }
+
+            // refused, usually a server of another wire version
+            if (packet.GetFlag() == Packet::RST_FLAG) {
+                SDL_Log("Connection refused by a server candidate");
+                probe.failed = true;
+                break;
+            }
+
+            // the reply to attempt n carries its sequence plus one
+            const auto attempt = static_cast<uint16_t>(packet.GetSequence() - 1 - mFirstSynSequence);
+            if (attempt >= probe.attempts) {
+                break;
+            }
+
+            CompleteHandshake(probe, packet, probe.sentAt[attempt]);
+            return true;
+        }
+    }
+
     return false;
 }
 
+void Client::CompleteHandshake(const ServerProbe &probe, const Packet &synAck, const std::chrono::steady_clock::time_point sentAt) {
+    ApplySynAck(probe.addr, synAck);
+
+    // a lost ACK is covered by the server, the first DATA or PING implies it
+    ClientOperations::sendSinglePacketToServer(this, Packet::ACK_FLAG);
+
+    const auto rtt = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - sentAt);
+    char ip[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &mServerAddrV4.sin_addr, ip, sizeof(ip));
+    SDL_Log("Client connected to %s:%d, rtt %lld ms", ip, ntohs(mServerAddrV4.sin_port), static_cast<long long>(rtt.count()));
+
+    mState = ClientState::CLIENT_CONNECTED;
+    StartNetworkThread();
+}
+
+void Client::ApplySynAck(const sockaddr_in &serverAddr, const Packet &synAck) {
+    mServerAddrV4 = serverAddr;
+    mClientNonce = synAck.GetNonce();
+    mCurrentPacketSequence = synAck.GetSequence();
+
+    // servers without negotiation send an empty SYN_ACK
+    IntegrityMode negotiated = IntegrityMode::ONES_COMPLEMENT;
+    if (synAck.GetLength() >= sizeof(uint8_t)) {
+        negotiated = Integrity::parseMode(*static_cast<const uint8_t*>(synAck.GetData()));
+    }
+    mIntegrityMode = negotiated;
+}
+
+bool Client::StartReplay(const char *path, const double speed) {
+    if (mState != ClientState::CLIENT_SET && mState != ClientState::CLIENT_READY) {
+        return false;
+    }
+
+    if (!mReplay.Open(path, speed)) {
+        SDL_Log("Capture %s could not be opened or has no handshake", path);
+        return false;
+    }
+
+    mSnapshotHistory.Clear();
+    mHasSnapshot = false;
+    mViewTick = 0.0;
+    ApplySynAck(mReplay.GetServerAddress(), mReplay.GetSynAck());
+
+    char ip[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &mServerAddrV4.sin_addr, ip, sizeof(ip));
+    SDL_Log("Replaying %s, recorded with %s:%d at %.1fx", path, ip, ntohs(mServerAddrV4.sin_port), speed);
+
+    mReplaying = true;
+    mState = ClientState::CLIENT_CONNECTED;
+    StartNetworkThread();
+    return true;
+}
+
 bool Client::Disconnect() {
     if (mState != ClientState::CLIENT_CONNECTED) {
         return false;
     }
 
+    // nothing was connected, the capture just stops
+    if (mReplaying) {
+        StopNetworkThread();
+        mReplay.Close();
+        mReplaying = false;
+        mState = ClientState::CLIENT_DISCONNECTED;
+        return true;
+    }
+
     mDisconnecting = true;
 
+    // the handshake below reads the socket directly
+    StopNetworkThread();
+
     for (int i = 0; i < MAX_CONNECTION_ATTEMPTS; i++) {
         ClientOperations::sendSinglePacketToServer(this, Packet::END_FLAG);
 
@@ -114,36 +303,59 @@ bool Client::Disconnect() {
 }
 
 
-void Client::Shutdown() const {
+void Client::Shutdown() {
     if (mState == ClientState::CLIENT_DOWN) {
         return;
     }
+    StopNetworkThread();
     close_socket(mSocket);
 
     SDL_Log("Client shutdown");
 }
 
 void Client::AddInput(const Uint8 *keyState) {
-    InputData input = SDLInputParser::parse(keyState);
-    if (input.NoKeysActive()) {
+    if (mReplaying) {
+        AddReplayedInputs();
         return;
     }
 
-    uint32_t sequence = mCurrentCommandSequence++;
-    mCommands.emplace_back(sequence, input);
-}
+    InputData input = SDLInputParser::parse(keyState);
 
-void Client::SendCommandsToServer() const {
-    if (mState != ClientState::CLIENT_CONNECTED || mConnecting || mDisconnecting) {
-        return;
+    // a command the network thread never sees must not be predicted either
+    bool queued = false;
+    if (!input.NoKeysActive()) {
+        queued = mCommandRing.TryPush(Command(mCurrentCommandSequence, input));
+        if (!queued) {
+            input.ResetKeys();
+        }
     }
 
-    if (mCommands.empty()) {
-        ClientOperations::sendPingToServer(this);
-        return;
+    // idle frames only cool the laser down, the same step the server runs
+    const bool fired = ShipSimulation::step(mPredictedState, input, Game::SIM_DELTA_TIME);
+
+    if (queued) {
+        mCommands.push_back({Command(mCurrentCommandSequence, input), mPredictedState});
+        mCurrentCommandSequence++;
+    }
+
+    if (mGame->IsPlayerSet()) {
+        mGame->SetPlayerPose(mPredictedState, fired);
+    }
+}
+
+// Predicts the recorded commands the replay reached since the last frame,
+// the idle frames in between were never sent and are not stepped
+void Client::AddReplayedInputs() {
+    bool fired = false;
+    Command command;
+    while (mReplayCommandRing.TryPop(command)) {
+        fired = ShipSimulation::step(mPredictedState, command.inputData, Game::SIM_DELTA_TIME) || fired;
+        mCommands.push_back({command, mPredictedState});
     }
 
-    ClientOperations::sendDataToServer(this);
+    if (mGame->IsPlayerSet()) {
+        mGame->SetPlayerPose(mPredictedState, fired);
+    }
 }
 
 void Client::ReceiveStateFromServer()  {
@@ -151,11 +363,40 @@ void Client::ReceiveStateFromServer()  {
         return;
     }
 
-    // receive server response
-    if (!ClientOperations::receiveDataPacketFromServer(this)) {
+    // snapshots reach this thread sooner than the reports, keep the newer arrival
+    ConnectionReport report;
+    while (mReportRing.TryPop(report)) {
+        if (mConnectionReport.hasSnapshot && report.lastSnapshotAt < mConnectionReport.lastSnapshotAt) {
+            report.lastSnapshotAt = mConnectionReport.lastSnapshotAt;
+        }
+        mConnectionReport = report;
+    }
+
+    // every event counts, they are played when the enemies reach their tick
+    ShotEvent event;
+    while (mEventRing.TryPop(event)) {
+        mGame->QueueEnemyShot(event);
+    }
+
+    // only the newest snapshot queued by the network thread matters
+    ReceivedSnapshot snapshot;
+    bool received = false;
+    while (mSnapshotRing.TryPop(snapshot)) {
+        received = true;
+    }
+
+    if (!received) {
         return;
     }
 
+    mConnectionReport.hasSnapshot = true;
+    mConnectionReport.lastSnapshotAt = snapshot.receivedAt;
+
+    // extract state
+    SetLastReceivedInputSequence(snapshot.state.lastConfirmedInputSequence);
+    SetOtherState(snapshot.state.otherStates, snapshot.state.otherStateSize);
+    SetRawState(snapshot.state.rawState);
+
     if (!mRawState.active) {
        mGame->Quit();
     }
@@ -163,6 +404,7 @@ void Client::ReceiveStateFromServer()  {
     // set the player if not set yet
     if (!mGame->IsPlayerSet()) {
         mGame->SetPlayer(Vector2(mRawState.posX, mRawState.posY), mRawState.rotation);
+        ResetPrediction(mRawState);
         return;
     }
 
@@ -171,64 +413,238 @@ void Client::ReceiveStateFromServer()  {
         CleanConfirmedCommands(mLastReceivedInputSequence);
     }
 
-    // set the state sent by the server
+    // lives and invulnerability always come from the server
     mGame->SetPlayerState(mRawState);
 
-    // apply again the rest of the commands
+    // apply again the rest of the commands when the prediction was off
     ReprocessLocalState();
 
-    // control enemies state
-    for (const auto other: mOtherStates) {
+    // control enemies state, players left out of this snapshot keep their last one
+    for (const auto &other: mOtherStates) {
         if (!mGame->IsEnemySet(other.id)) {
             mGame->SetEnemy(other.id, Vector2(other.posX, other.posY), other.rotation);
-        }else {
-            mGame->SetEnemiesState(mOtherStates);
         }
     }
+    mGame->SetEnemiesState(mOtherStates, snapshot.state.serverTick, snapshot.receivedAt);
+}
+
+void Client::StartNetworkThread() {
+    if (mNetworkRunning) {
+        return;
+    }
+
+    mCommandRing.Clear();
+    mReplayCommandRing.Clear();
+    mReportRing.Clear();
+    mEventRing.Clear();
+    mDownlinkAcks.Clear();
+    mEventReceiver.Clear();
+    mTransportReader.Clear();
+    mOutgoingCommands.clear();
+    mConnectionStats.Clear();
+    mConnectionReport = ConnectionReport();
+    mNetworkRunning = true;
+    mNetworkThread = std::thread(mReplaying ? &Client::ReplayLoop : &Client::NetworkLoop, this);
+}
+
+void Client::StopNetworkThread() {
+    mNetworkRunning = false;
+    if (mNetworkThread.joinable()) {
+        mNetworkThread.join();
+    }
+}
+
+// Waits on the socket until the next send is due, so snapshots are decoded
+// and timestamped as they arrive regardless of the frame rate. The tick aligned
+// uplink sends as soon as the game loop produces a command and repeats the
+// unconfirmed ones every tick, idle connections only ping.
+void Client::NetworkLoop() {
+    const bool tickAligned = mUplinkMode == UplinkMode::TICK_ALIGNED;
+    const auto idleInterval = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::milliseconds(COMMAND_SEND_INTERVAL_MS));
+    const auto pendingInterval = tickAligned ? TICK_SEND_INTERVAL : idleInterval;
+    const int pollTimeoutMs = tickAligned ? TICK_POLL_TIMEOUT_MS : NETWORK_POLL_TIMEOUT_MS;
+    auto nextSend = std::chrono::steady_clock::now();
+    auto nextReport = nextSend + CONNECTION_REPORT_INTERVAL;
+
+    while (mNetworkRunning) {
+        const auto untilSend = std::chrono::duration_cast<std::chrono::milliseconds>(
+            nextSend - std::chrono::steady_clock::now()).count();
+        const int waitMs = static_cast<int>(std::max<long long>(0, std::min<long long>(untilSend, pollTimeoutMs)));
+
+        if (SocketUtils::socketReadyToReceive(mSocket, waitMs)) {
+            ReceivedSnapshot snapshot;
+            if (ClientOperations::receiveDataPacketFromServer(this, &snapshot)) {
+                const uint32_t confirmed = snapshot.state.lastConfirmedInputSequence;
+                mOutgoingCommands.erase(
+                    std::remove_if(mOutgoingCommands.begin(), mOutgoingCommands.end(), [confirmed](const Command &cmd) {
+                        return cmd.sequence <= confirmed;
+                    }),
+                    mOutgoingCommands.end()
+                );
+
+                // the game loop drains the ring every frame, a full ring means it stalled
+                if (!mSnapshotRing.TryPush(snapshot)) {
+                    SDL_Log("Snapshot ring full, dropping snapshot %d", snapshot.snapshotId);
+                }
+            }
+
+            // events may come from packets whose snapshot was too old to use
+            ForwardEvents();
+        }
+
+        const bool newCommands = DrainCommandRing();
+
+        if (const auto now = std::chrono::steady_clock::now(); now >= nextSend || (tickAligned && newCommands)) {
+            SendCommandsToServer();
+            nextSend = now + (mOutgoingCommands.empty() ? idleInterval : pendingInterval);
+        }
+
+        // a full ring only means the game loop has not caught up, the next report replaces it
+        if (const auto now = std::chrono::steady_clock::now(); now >= nextReport) {
+            mReportRing.TryPush(mConnectionStats.BuildReport(now));
+            nextReport = now + CONNECTION_REPORT_INTERVAL;
+        }
+    }
+}
+
+// NetworkLoop for a replay, the capture stands in for the socket and paces
+// itself. Nothing is sent, the recorded uplink is read back instead.
+void Client::ReplayLoop() {
+    auto nextReport = std::chrono::steady_clock::now() + CONNECTION_REPORT_INTERVAL;
+    size_t droppedSnapshots = 0;
+    size_t droppedCommands = 0;
+    std::vector<Command> commands;
+
+    while (mNetworkRunning) {
+        ReceivedSnapshot snapshot;
+        bool received;
+        if (!mReplay.Advance(this, &snapshot, &received, &commands)) {
+            break;
+        }
+
+        for (const Command &command : commands) {
+            if (!mReplayCommandRing.TryPush(command)) {
+                droppedCommands++;
+            }
+        }
+        commands.clear();
+
+        // faster than real time the game loop only sees the newest snapshots
+        if (received && !mSnapshotRing.TryPush(snapshot)) {
+            droppedSnapshots++;
+        }
+
+        ForwardEvents();
+
+        if (const auto now = std::chrono::steady_clock::now(); now >= nextReport) {
+            mReportRing.TryPush(mConnectionStats.BuildReport(now));
+            nextReport = now + CONNECTION_REPORT_INTERVAL;
+        }
+    }
+
+    const ReplayStats &stats = mReplay.GetStats();
+    const auto toMs = [](const std::chrono::nanoseconds time) { return static_cast<double>(time.count()) / 1e6; };
+    SDL_Log("Replay %s: %zu records, %zu batches, %zu snapshots (%zu dropped), %zu commands (%zu dropped)",
+        mNetworkRunning ? "finished" : "stopped", stats.records, stats.batches, stats.snapshots, droppedSnapshots,
+        stats.commands, droppedCommands);
+    SDL_Log("Replay %.1f ms of capture in %.1f ms, %.3f ms decoding", toMs(stats.replayed), toMs(stats.elapsed),
+        toMs(stats.decoding));
+}
+
+// Hands the events to the game loop in order, an event stays in the receiver
+// until the ring has room for it
+void Client::ForwardEvents() {
+    while (const ReliableChannel::Message *message = mEventReceiver.Peek()) {
+        ShotEvent event;
+        if (Wire::decode(message->data, message->size, &event) == message->size && event.type == EventType::SHOT) {
+            if (!mEventRing.TryPush(event)) {
+                return;
+            }
+        }
+        mEventReceiver.Pop();
+    }
+}
+
+void Client::SendCommandsToServer() {
+    if (mOutgoingCommands.empty()) {
+        ClientOperations::sendPingToServer(this);
+    } else {
+        ClientOperations::sendDataToServer(this);
+    }
+
+    ClientOperations::flushToServer(this);
+}
+
+bool Client::DrainCommandRing() {
+    bool drained = false;
+    Command command;
+    while (mCommandRing.TryPop(command)) {
+        mOutgoingCommands.push_back(command);
+        drained = true;
+    }
+
+    // commands older than the redundancy window are never sent again
+    if (mUplinkMode == UplinkMode::TICK_ALIGNED && mOutgoingCommands.size() > CommandRuns::REDUNDANCY_WINDOW) {
+        mOutgoingCommands.erase(
+            mOutgoingCommands.begin(),
+            mOutgoingCommands.end() - CommandRuns::REDUNDANCY_WINDOW
+        );
+    }
+
+    return drained;
 }
 
 void Client::CleanConfirmedCommands(uint32_t confirmedSequence) {
     const auto it = std::find_if(
         mCommands.begin(),
         mCommands.end(),
-        [&confirmedSequence](const Command& cmd) {
-            return cmd.sequence > confirmedSequence;
+        [&confirmedSequence](const PredictedCommand& cmd) {
+            return cmd.command.sequence > confirmedSequence;
         }
     );
 
     if (it != mCommands.begin()) {
+        mConfirmedPrediction = (it - 1)->predicted;
         mCommands.erase(mCommands.begin(), it);
         mLasRemovedInputSequence = confirmedSequence;
     }
 }
 
-void Client::ReprocessLocalState() const {
-    if (mCommands.empty()) {
-        return;
-    }
-
-    for (const auto &cmd : mCommands) {
-        const auto state = SDLInputParser::revert(cmd.inputData);
-
-        mGame->GetPlayer()->ProcessInput(state);
-        mGame->GetPlayer()->Update(Game::SIM_DELTA_TIME);
-    }
+void Client::ResetPrediction(const RawState &state) {
+    mPredictedState = ShipSimState();
+    mPredictedState.posX = state.posX;
+    mPredictedState.posY = state.posY;
+    mPredictedState.rotation = state.rotation;
+    mPredictedState.life = state.life;
+    mConfirmedPrediction = mPredictedState;
 }
 
-ConnectionStatus Client::CheckConnection() {
-    if (!mConnectionFuture.valid()) {
-        return ConnectionStatus::FAILURE;
+// Replays the unconfirmed commands on top of the server state through the
+// shared simulation step, nothing to do when the prediction already matched
+void Client::ReprocessLocalState() {
+    ShipSimState state = mConfirmedPrediction;
+    state.posX = mRawState.posX;
+    state.posY = mRawState.posY;
+    state.rotation = mRawState.rotation;
+
+    if (ShipSimulation::nearlyEqual(
+        state,
+        mConfirmedPrediction,
+        RECONCILE_POSITION_EPSILON,
+        RECONCILE_ROTATION_EPSILON
+    )) {
+        return;
     }
 
-    if (mConnectionFuture.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready) {
-        const bool result = mConnectionFuture.get();
-
-        mConnectionFuture = {};
-
-        if (!result) {
-            return ConnectionStatus::FAILURE;
-        };
-        return ConnectionStatus::SUCCESS;
+    mConfirmedPrediction = state;
+    for (auto &[command, predicted] : mCommands) {
+        ShipSimulation::step(state, command.inputData, Game::SIM_DELTA_TIME);
+        predicted = state;
     }
-    return ConnectionStatus::IN_PROGRESS;
+
+    // the cooldown is never sent, the local one also counted the idle frames
+    state.laserCooldown = mPredictedState.laserCooldown;
+    mPredictedState = state;
+    mGame->SetPlayerPose(mPredictedState, false);
 }
@@ -3,16 +3,28 @@
 //
 #pragma once
 #include "../Network/Platforms.h"
+#include "../Network/PacketBatch.h"
+#include "../Network/SpscRing.h"
+#include "../Network/AckWindow.h"
+#include "../Network/ReliableChannel.h"
+#include "../Network/Transport.h"
 #include "DataObjects.h"
+#include "SnapshotCodec.h"
+#include "ShipSimulation.h"
+#include "ConnectionStats.h"
+#include "CaptureReplay.h"
 #include "../Source/Game.h"
 #include <vector>
 #include <SDL.h>
-#include <future>
+#include <atomic>
+#include <chrono>
+#include <thread>
 
 enum class ClientState {
     CLIENT_DOWN,
     CLIENT_SET,
     CLIENT_READY,
+    CLIENT_CONNECTING,
     CLIENT_CONNECTED,
     CLIENT_DISCONNECTED,
 };
@@ -23,63 +35,196 @@ enum class ConnectionStatus {
     FAILURE
 };
 
+enum class UplinkMode {
+    // every pending command, batched every COMMAND_SEND_INTERVAL_MS
+    BATCHED,
+    // sent on every simulation tick, only the newest commands as runs
+    TICK_ALIGNED,
+};
+
+constexpr int MAX_SYN_ATTEMPTS = 10;
+
+// Candidate server during the handshake. Attempt n sends its SYN with
+// firstSequence + n and the SYN_ACK echoes it, so every reply is timed
+// against the SYN it answers.
+struct ServerProbe {
+    sockaddr_in addr;
+    int attempts;
+    bool failed;
+    std::chrono::milliseconds timeout;
+    std::chrono::steady_clock::time_point nextSendAt;
+    std::chrono::steady_clock::time_point sentAt[MAX_SYN_ATTEMPTS];
+};
+
+// Command kept for replay together with the state predicted right after it
+struct PredictedCommand {
+    Command command;
+    ShipSimState predicted;
+};
+
+// Decoded snapshot handed from the network thread to the game loop
+struct ReceivedSnapshot {
+    FullState state;
+    uint16_t snapshotId;
+    std::chrono::steady_clock::time_point receivedAt;
+};
+
 class Client {
 public:
     explicit Client(Game *game);
-    ~Client() = default;
+    ~Client();
 
     void Initialize();
+    // Candidate servers, all of them are probed and the first to answer is used
     bool AddServerAddr(const char *serverIp);
-
+    void ClearServerAddrs();
 
     bool Disconnect();
-    void Shutdown() const;
+    void Shutdown();
 
     void SetNonce(const uint32_t nonce) { mClientNonce = nonce; }
+    void SetIntegrityMode(const IntegrityMode mode) { mIntegrityMode = mode; }
+    // Read by the network thread, set it before connecting
+    void SetUplinkMode(const UplinkMode mode) { mUplinkMode = mode; }
     void IncreasePacketSequence() { mCurrentPacketSequence++; }
 
     [[nodiscard]] SocketType GetSocket() const { return mSocket;}
     [[nodiscard]] sockaddr_in GetServerAddress() const { return mServerAddrV4; }
     [[nodiscard]] uint32_t GetClientNonce() const { return mClientNonce; }
     [[nodiscard]] uint16_t GetCurrentPacketSequence() const { return mCurrentPacketSequence; }
-
-    static constexpr int MAX_CONNECTION_ATTEMPTS = 10;
+    [[nodiscard]] IntegrityMode GetIntegrityMode() const { return mIntegrityMode; }
+    [[nodiscard]] UplinkMode GetUplinkMode() const { return mUplinkMode; }
+    [[nodiscard]] PacketBatch *GetReceiveBatch() { return &mReceiveBatch; }
+    // Uplink messages are queued in the send batch and leave together on the
+    // next flush, the reader splits the server datagrams back into messages
+    [[nodiscard]] PacketBatch *GetSendBatch() { return &mSendBatch; }
+    [[nodiscard]] TransportWriter *GetTransportWriter() { return &mTransportWriter; }
+    [[nodiscard]] TransportReader &GetTransportReader() { return mTransportReader; }
+
+    static constexpr int MAX_CONNECTION_ATTEMPTS = MAX_SYN_ATTEMPTS;
     static constexpr int CONNECTION_RECEIVING_TIMEOUT_IN_MS = 2000;
-
-    // Inputs Control
+    static constexpr size_t MAX_SERVER_CANDIDATES = 4;
+    // SYN retransmission, doubled after every unanswered attempt
+    static constexpr auto INITIAL_SYN_TIMEOUT = std::chrono::milliseconds(200);
+    static constexpr auto MAX_SYN_TIMEOUT = std::chrono::milliseconds(2000);
+    static constexpr size_t RECEIVE_BATCH_CAPACITY = 32;
+    static constexpr int COMMAND_SEND_INTERVAL_MS = 100;
+    // tick aligned uplink: one send per simulation tick while commands are unconfirmed
+    static constexpr auto TICK_SEND_INTERVAL = std::chrono::microseconds(1000000 / 60);
+    static constexpr int TICK_POLL_TIMEOUT_MS = 1;
+    // upper bound of a network thread wait, also how fast it notices a stop request
+    static constexpr int NETWORK_POLL_TIMEOUT_MS = 10;
+    static constexpr size_t COMMAND_RING_CAPACITY = 1024;
+    static constexpr size_t SNAPSHOT_RING_CAPACITY = 8;
+    static constexpr size_t REPORT_RING_CAPACITY = 4;
+    static constexpr size_t EVENT_RING_CAPACITY = 256;
+    static constexpr auto CONNECTION_REPORT_INTERVAL = std::chrono::milliseconds(500);
+    // snapshots quantize positions to 1/8 px and rotations to 2pi/1024
+    static constexpr float RECONCILE_POSITION_EPSILON = 0.5f;
+    static constexpr float RECONCILE_ROTATION_EPSILON = 0.01f;
+
+    // Inputs Control, game thread
     void AddInput(const Uint8 *keyState);
-    [[nodiscard]] const std::vector<Command>& GetCommands() const { return mCommands; }
-    void SendCommandsToServer() const;
 
-    // State control
+    // Render tick of the interpolated enemies, written by the game thread every
+    // frame and sent with the uplink so the server judges our shots against it
+    void SetViewTick(const double tick) { mViewTick.store(tick, std::memory_order_relaxed); }
+    [[nodiscard]] double GetViewTick() const { return mViewTick.load(std::memory_order_relaxed); }
+
+    // Commands not yet confirmed by the server, owned by the network thread
+    [[nodiscard]] const std::vector<Command>& GetOutgoingCommands() const { return mOutgoingCommands; }
+
+    // Server DATA packets received and the events riding on them, owned by the network thread
+    [[nodiscard]] AckWindow &GetDownlinkAcks() { return mDownlinkAcks; }
+    [[nodiscard]] ReliableReceiver &GetEventReceiver() { return mEventReceiver; }
+
+    // Link quality, the stats are owned by the network thread and published
+    // to the game thread as a report every CONNECTION_REPORT_INTERVAL
+    [[nodiscard]] ConnectionStats &GetConnectionStats() { return mConnectionStats; }
+    [[nodiscard]] const ConnectionReport &GetConnectionReport() const { return mConnectionReport; }
+
+    // State control, game thread
     void ReceiveStateFromServer();
     void SetLastReceivedInputSequence(const uint32_t inputSequence) { mLastReceivedInputSequence = inputSequence; }
 
+    // Decoded snapshots, the newest id is acked back so the server can delta
+    // against it. Owned by the network thread once the connection is up.
+    [[nodiscard]] const SnapshotHistory &GetSnapshotHistory() const { return mSnapshotHistory; }
+    [[nodiscard]] bool HasSnapshot() const { return mHasSnapshot; }
+    [[nodiscard]] uint16_t GetLastSnapshotId() const { return mLastSnapshotId; }
+    void AddSnapshot(uint16_t snapshotId, const FullState &state);
+
     void SetRawState(const RawState& state) { mRawState = state; }
     void SetOtherState(const OtherState states[MAX_OTHER_STATES], const size_t statesSize) {
         const size_t sizeToUse = std::min(statesSize, static_cast<size_t>(MAX_OTHER_STATES));
         mOtherStates.assign(states, states + sizeToUse);
     }
 
-    void StartConnection() {
-        mConnectionFuture = std::async(std::launch::async, &Client::Connect, this);
-    }
-
+    // Non-blocking handshake, CheckConnection drives it and must be called
+    // every frame until it stops returning IN_PROGRESS
+    bool StartConnection();
     ConnectionStatus CheckConnection();
+
+    // Plays a capture taken by this client instead of connecting, see
+    // CaptureReplay. The recorded commands replace the keyboard.
+    bool StartReplay(const char *path, double speed);
+    [[nodiscard]] bool IsReplaying() const { return mReplaying; }
 private:
     ClientState mState;
     SocketType mSocket;
     sockaddr_in mServerAddrV4;
+    PacketBatch mReceiveBatch;
+    PacketBatch mSendBatch;
+    TransportWriter mTransportWriter;
+    TransportReader mTransportReader;
+
+    // Network thread, all socket I/O after the handshake happens here
+    std::thread mNetworkThread;
+    std::atomic<bool> mNetworkRunning;
+    std::atomic<double> mViewTick;
+    SpscRing<Command, COMMAND_RING_CAPACITY> mCommandRing;
+    SpscRing<ReceivedSnapshot, SNAPSHOT_RING_CAPACITY> mSnapshotRing;
+    SpscRing<ConnectionReport, REPORT_RING_CAPACITY> mReportRing;
+    SpscRing<ShotEvent, EVENT_RING_CAPACITY> mEventRing;
+    AckWindow mDownlinkAcks;
+    ReliableReceiver mEventReceiver;
+    ConnectionStats mConnectionStats;
+    ConnectionReport mConnectionReport;
+    std::vector<Command> mOutgoingCommands;
+    void StartNetworkThread();
+    void StopNetworkThread();
+    void NetworkLoop();
+    void SendCommandsToServer();
+    bool DrainCommandRing();
+    void ForwardEvents();
 
     // Connection control
     uint16_t mCurrentPacketSequence;
     uint32_t mClientNonce;
-    bool mConnecting;
+    IntegrityMode mIntegrityMode;
+    UplinkMode mUplinkMode;
     bool mDisconnecting;
-
-    // Inputs Control
-    std::vector<Command> mCommands;
+    ServerProbe mProbes[MAX_SERVER_CANDIDATES];
+    size_t mProbesSize;
+    uint16_t mFirstSynSequence;
+    void SendSyn(ServerProbe &probe, std::chrono::steady_clock::time_point now);
+    bool ReceiveSynAck();
+    void CompleteHandshake(const ServerProbe &probe, const Packet &synAck, std::chrono::steady_clock::time_point sentAt);
+    void ApplySynAck(const sockaddr_in &serverAddr, const Packet &synAck);
+
+    // Replay, the network thread reads the capture instead of the socket
+    CaptureReplay mReplay;
+    bool mReplaying;
+    SpscRing<Command, COMMAND_RING_CAPACITY> mReplayCommandRing;
+    void ReplayLoop();
+    void AddReplayedInputs();
+
+    // Inputs Control, commands kept for local replay until the server confirms them
+    std::vector<PredictedCommand> mCommands;
     static uint32_t mCurrentCommandSequence;
+    ShipSimState mPredictedState;
+    // prediction for the last command the server confirmed
+    ShipSimState mConfirmedPrediction;
     void CleanConfirmedCommands(uint32_t confirmedSequence);
 
     // State control
@@ -87,10 +232,12 @@ private:
     std::vector<OtherState> mOtherStates;
     uint32_t mLastReceivedInputSequence;
     uint32_t mLasRemovedInputSequence;
-    void ReprocessLocalState() const;
+    SnapshotHistory mSnapshotHistory;
+    bool mHasSnapshot;
+    uint16_t mLastSnapshotId;
+    void ResetPrediction(const RawState &state);
+    void ReprocessLocalState();
 
     // Game owner
     Game *mGame;
-    std::future<bool> mConnectionFuture;
-    bool Connect();
 };
\ No newline at end of file
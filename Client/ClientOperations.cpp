@@ -5,9 +5,158 @@
 #include "ClientOperations.h"
 #include "../Network/Packet.h"
 #include "../Network/Socket.h"
+#include "../Network/Transport.h"
+#include "CommandRuns.h"
+#include <algorithm>
+
+namespace {
+    // DATA and PING carry their own sequence so the server can ack each of them
+    void recordSentPacket(Client *client, const size_t packetSize) {
+        client->GetConnectionStats().OnPacketSent(
+            client->GetCurrentPacketSequence(),
+            packetSize,
+            std::chrono::steady_clock::now()
+        );
+        client->IncreasePacketSequence();
+    }
+
+    // snapshot ack plus the ack of the server packets, the events they carried are done
+    ClientDataHeader buildDataHeader(Client *client, const CommandFormat format) {
+        ClientDataHeader header(client->HasSnapshot(), client->GetLastSnapshotId(), format);
+
+        const AckWindow &acks = client->GetDownlinkAcks();
+        if (acks.HasReceived()) {
+            header.hasDownlinkAck = 1;
+            header.downlinkAckedSequence = acks.GetNewest();
+            header.downlinkAckBits = acks.GetBits();
+        }
+
+        // stays zero until the jitter buffer has a clock, the server then does not rewind
+        if (const double viewTick = client->GetViewTick(); viewTick > 0.0) {
+            header.hasViewTick = 1;
+            header.viewTick = static_cast<uint32_t>(viewTick);
+            header.viewTickFraction = static_cast<uint8_t>((viewTick - header.viewTick) * 256.0);
+        }
+        return header;
+    }
+
+    struct NewestSnapshot {
+        bool received = false;
+        uint16_t id = 0;
+        FullState state;
+        std::chrono::steady_clock::time_point receivedAt;
+    };
+
+    // acks, events and arrivals count even for snapshots that are dropped
+    void readServerData(
+        Client *client,
+        const Transport::Message &message,
+        const std::chrono::steady_clock::time_point arrivalTime,
+        NewestSnapshot *newest
+    ) {
+        ServerDataHeader header;
+        const size_t headerSize = Wire::decode(message.data, message.size, &header);
+        if (headerSize == 0) {
+            return;
+        }
+
+        const uint8_t *body = message.data + headerSize;
+        const size_t bodySize = message.size - headerSize;
+
+        bool eventsAccepted;
+        const size_t eventsSize = client->GetEventReceiver().Read(body, bodySize, &eventsAccepted);
+        if (eventsSize == 0) {
+            return;
+        }
+
+        // a packet whose events could not be kept is left unacked so they come again
+        if (eventsAccepted) {
+            client->GetDownlinkAcks().Receive(message.sequence);
+        }
+
+        const uint8_t *encoded = body + eventsSize;
+        const size_t encodedSize = bodySize - eventsSize;
+
+        ConnectionStats &stats = client->GetConnectionStats();
+        stats.OnAck(header, arrivalTime);
+
+        uint16_t snapshotId;
+        if (!SnapshotCodec::peekId(encoded, encodedSize, &snapshotId)) {
+            return;
+        }
+        stats.OnSnapshot(snapshotId, arrivalTime);
+
+        // datagrams may be reordered, drop anything older than what was already applied
+        if (client->HasSnapshot() && !SnapshotCodec::isNewer(snapshotId, client->GetLastSnapshotId())) {
+            return;
+        }
+
+        if (newest->received && !SnapshotCodec::isNewer(snapshotId, newest->id)) {
+            return;
+        }
+
+        FullState decoded;
+        if (!SnapshotCodec::decode(encoded, encodedSize, client->GetSnapshotHistory(), &decoded, &snapshotId)) {
+            return;
+        }
+
+        newest->state = decoded;
+        newest->id = snapshotId;
+        newest->receivedAt = arrivalTime;
+        newest->received = true;
+    }
+
+    // newest first, so older snapshots in the same batch are skipped before decoding
+    void readServerBatch(
+        Client *client,
+        PacketBatch *batch,
+        const std::chrono::steady_clock::time_point arrivalTime,
+        NewestSnapshot *newest
+    ) {
+        TransportReader &reader = client->GetTransportReader();
+        const sockaddr_in serverAddr = client->GetServerAddress();
+
+        for (size_t i = batch->GetSize(); i > 0; i--) {
+            const size_t index = i - 1;
+            if (!batch->IsValid(index, client->GetIntegrityMode())) {
+                continue;
+            }
+
+            const sockaddr_in &addr = batch->GetAddress(index);
+            if (addr.sin_addr.s_addr != serverAddr.sin_addr.s_addr || addr.sin_port != serverAddr.sin_port) {
+                continue;
+            }
+
+            const PacketView packet = batch->GetView(index);
+            client->GetConnectionStats().OnPacketReceived(Packet::PACKET_HEADER_BYTES + packet.GetLength());
+
+            // fragments only yield the DATA once the last one is in
+            Transport::Message message{};
+            reader.Begin(packet, arrivalTime);
+            while (reader.Next(&message)) {
+                if (message.flag == Packet::DATA_FLAG) {
+                    readServerData(client, message, arrivalTime, newest);
+                }
+            }
+        }
+    }
+
+    bool takeNewestSnapshot(Client *client, const NewestSnapshot &newest, ReceivedSnapshot *snapshot) {
+        if (!newest.received) {
+            return false;
+        }
+
+        client->AddSnapshot(newest.id, newest.state);
+
+        snapshot->state = newest.state;
+        snapshot->snapshotId = newest.id;
+        snapshot->receivedAt = newest.receivedAt;
+        return true;
+    }
+}
 
 void ClientOperations::sendSinglePacketToServer(const Client *client, const uint8_t flag) {
-    if (flag != Packet::SYN_FLAG && flag != Packet::ACK_FLAG && flag != Packet::END_FLAG) {
+    if (flag != Packet::ACK_FLAG && flag != Packet::END_FLAG) {
         return;
     }
 
@@ -16,9 +165,9 @@ void ClientOperations::sendSinglePacketToServer(const Client *client, const uint
         flag,
         client->GetClientNonce()
     );
-    packet.BuildPacket();
+    packet.BuildPacket(client->GetIntegrityMode());
 
-    constexpr size_t packetSize = Packet::PACKET_HEADER_BYTES;
+    const size_t packetSize = Packet::PACKET_HEADER_BYTES + packet.GetLength();
     sockaddr_in addr = client->GetServerAddress();
 
     SocketUtils::sendPacketToV4(
@@ -29,8 +178,28 @@ void ClientOperations::sendSinglePacketToServer(const Client *client, const uint
     );
 }
 
+void ClientOperations::sendSynToServer(const Client *client, const sockaddr_in &serverAddr, const uint16_t sequence) {
+    Packet packet(sequence, Packet::SYN_FLAG, client->GetClientNonce());
+
+    // the SYN advertises the checksum modes, the server picks one in the SYN_ACK
+    uint8_t payload[Wire::size<SynPayload>()];
+    Wire::encode(SynPayload(Integrity::getSupportedModes()), payload, sizeof(payload));
+    packet.SetData(payload, sizeof(payload));
+    packet.BuildPacket(IntegrityMode::ONES_COMPLEMENT);
+
+    const size_t packetSize = Packet::PACKET_HEADER_BYTES + packet.GetLength();
+    sockaddr_in addr = serverAddr;
+
+    SocketUtils::sendPacketToV4(
+        client->GetSocket(),
+        &packet,
+        packetSize,
+        &addr
+    );
+}
+
 bool ClientOperations::receiveSinglePacketFromServer(Client *client, const uint8_t flag) {
-    if (flag != Packet::SYN_ACK_FLAG && flag != Packet::END_ACK_FLAG) {
+    if (flag != Packet::END_ACK_FLAG) {
         return false;
     }
 
@@ -42,15 +211,18 @@ bool ClientOperations::receiveSinglePacketFromServer(Client *client, const uint8
     Packet packet;
     sockaddr_in addr = client->GetServerAddress();
 
-    if (!SocketUtils::receivePacketFromV4(
+    const size_t size = SocketUtils::receivePacketFromV4(
         client->GetSocket(),
         &packet,
         &addr
-    )) {
+    );
+    if (size == 0) {
         return false;
     }
 
-    if (!packet.IsValid()) {
+    const IntegrityMode mode = client->GetIntegrityMode();
+
+    if (!packet.IsValid(size, mode)) {
         return false;
     }
 
@@ -66,15 +238,16 @@ bool ClientOperations::receiveSinglePacketFromServer(Client *client, const uint8
 
             Packet temp;
 
-            if (!SocketUtils::receivePacketFromV4(
+            const size_t tempSize = SocketUtils::receivePacketFromV4(
                 client->GetSocket(),
                 &temp,
                 &addr
-            )) {
+            );
+            if (tempSize == 0) {
                 return false;
             }
 
-            if (!temp.IsValid()) {
+            if (!temp.IsValid(tempSize, mode)) {
                 return false;
             }
 
@@ -94,81 +267,84 @@ bool ClientOperations::receiveSinglePacketFromServer(Client *client, const uint8
     return true;
 }
 
-void ClientOperations::sendDataToServer(const Client *client) {
-    Packet packet(
-        client->GetCurrentPacketSequence(),
+void ClientOperations::sendDataToServer(Client *client) {
+    uint8_t payload[PacketWriter::PAYLOAD_CAPACITY];
+    const std::vector<Command>& commands = client->GetOutgoingCommands();
+    constexpr size_t headerSize = Wire::size<ClientDataHeader>();
+    size_t commandsSize;
+
+    if (client->GetUplinkMode() == UplinkMode::TICK_ALIGNED) {
+        // snapshot ack followed by the newest pending commands as runs
+        Wire::encode(buildDataHeader(client, CommandFormat::RUNS), payload, sizeof(payload));
+
+        commandsSize = CommandRuns::encode(
+            commands.data(),
+            commands.size(),
+            payload + headerSize,
+            CommandRuns::UPLINK_MTU_BYTES - Packet::PACKET_HEADER_BYTES - headerSize
+        );
+    } else {
+        // snapshot ack followed by the oldest pending commands that fit
+        Wire::encode(buildDataHeader(client, CommandFormat::COMMANDS), payload, sizeof(payload));
+        commandsSize = Wire::encodeArray(commands.data(), commands.size(), payload + headerSize, sizeof(payload) - headerSize);
+    }
+
+    const size_t bytes = client->GetTransportWriter()->Write(
+        client->GetServerAddress(),
+        client->GetClientNonce(),
+        client->GetIntegrityMode(),
         Packet::DATA_FLAG,
-        client->GetClientNonce()
+        client->GetCurrentPacketSequence(),
+        payload,
+        headerSize + commandsSize
     );
 
-    const std::vector<Command>& commands = client->GetCommands();
-    const size_t commandsSize = commands.size() * sizeof(Command);
-    packet.SetData(commands.data(), commandsSize);
-    packet.BuildPacket();
-
-    const size_t packetSize = Packet::PACKET_HEADER_BYTES + packet.GetLength();
-    sockaddr_in addr = client->GetServerAddress();
-
-    SocketUtils::sendPacketToV4(
-        client->GetSocket(),
-        &packet,
-        packetSize,
-        &addr
-    );
+    recordSentPacket(client, bytes);
 }
 
-bool ClientOperations::receiveDataPacketFromServer(Client *client) {
-    if (!SocketUtils::socketReadyToReceive(
-        client->GetSocket(), 0)) {
-        return false;
-    }
+bool ClientOperations::receiveDataPacketFromServer(Client *client, ReceivedSnapshot *snapshot) {
+    PacketBatch *batch = client->GetReceiveBatch();
+    NewestSnapshot newest;
 
-    Packet packet;
-    sockaddr_in addr = client->GetServerAddress();
+    // drain everything queued on the socket, only the newest snapshot matters
+    size_t batchSize;
+    do {
+        batchSize = SocketUtils::receivePacketBatchFromV4(client->GetSocket(), batch);
+        readServerBatch(client, batch, std::chrono::steady_clock::now(), &newest);
+    } while (batchSize == batch->GetCapacity());
 
-    if (!SocketUtils::receivePacketFromV4(
-        client->GetSocket(),
-        &packet,
-        &addr
-    )) {
-        return false;
-    }
-
-    if (!packet.IsValid()) {
-        return false;
-    }
-
-    if (packet.GetFlag() != Packet::DATA_FLAG) {
-        return false;
-    }
-
-    // extract state
-    const auto state = static_cast<const FullState*>(packet.GetData());
-
-    const uint32_t received = state->lastConfirmedInputSequence;
-    client->SetLastReceivedInputSequence(received);
-
-    client->SetOtherState(state->otherStates, state->otherStateSize);
+    return takeNewestSnapshot(client, newest, snapshot);
+}
 
-    client->SetRawState(state->rawState);
-    return true;
+bool ClientOperations::receiveDataFromBatch(
+    Client *client,
+    PacketBatch *batch,
+    const std::chrono::steady_clock::time_point arrivalTime,
+    ReceivedSnapshot *snapshot
+) {
+    NewestSnapshot newest;
+    readServerBatch(client, batch, arrivalTime, &newest);
+    return takeNewestSnapshot(client, newest, snapshot);
 }
 
-void ClientOperations::sendPingToServer(const Client *client) {
-    Packet packet(
-        client->GetCurrentPacketSequence(),
+void ClientOperations::sendPingToServer(Client *client) {
+    uint8_t payload[Wire::size<ClientDataHeader>()];
+    Wire::encode(buildDataHeader(client, CommandFormat::COMMANDS), payload, sizeof(payload));
+
+    const size_t bytes = client->GetTransportWriter()->Write(
+        client->GetServerAddress(),
+        client->GetClientNonce(),
+        client->GetIntegrityMode(),
         Packet::PING_FLAG,
-        client->GetClientNonce()
+        client->GetCurrentPacketSequence(),
+        payload,
+        sizeof(payload)
     );
-    packet.BuildPacket();
 
-    constexpr size_t packetSize = Packet::PACKET_HEADER_BYTES;
-    sockaddr_in addr = client->GetServerAddress();
+    recordSentPacket(client, bytes);
+}
 
-    SocketUtils::sendPacketToV4(
-        client->GetSocket(),
-        &packet,
-        packetSize,
-        &addr
-    );
-}
\ No newline at end of file
+void ClientOperations::flushToServer(Client *client) {
+    client->GetTransportWriter()->Seal();
+    SocketUtils::sendPacketBatchToV4(client->GetSocket(), client->GetSendBatch());
+}
@@ -8,8 +8,20 @@
 
 namespace ClientOperations {
     void sendSinglePacketToServer(const Client *client, uint8_t flag);
+    // Handshake probe of one candidate, the SYN_ACK echoes the sequence plus one
+    void sendSynToServer(const Client *client, const sockaddr_in &serverAddr, uint16_t sequence);
     bool receiveSinglePacketFromServer(Client *client, uint8_t flag);
-    void sendDataToServer(const Client *client);
-    bool receiveDataPacketFromServer(Client *client);
-    void sendPingToServer(const Client *client);
+    void sendDataToServer(Client *client);
+    // Network thread: decodes the newest snapshot queued on the socket
+    bool receiveDataPacketFromServer(Client *client, ReceivedSnapshot *snapshot);
+    // Same decoding over datagrams already in the batch, replays feed captures through it
+    bool receiveDataFromBatch(
+        Client *client,
+        PacketBatch *batch,
+        std::chrono::steady_clock::time_point arrivalTime,
+        ReceivedSnapshot *snapshot
+    );
+    void sendPingToServer(Client *client);
+    // DATA and PING are only queued, this sends them in one call
+    void flushToServer(Client *client);
 };
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "CommandRuns.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+    size_t countRuns(const Command *commands, const size_t commandsSize) {
+        size_t runs = 0;
+        for (size_t i = 0; i < commandsSize; i++) {
+            if (i == 0 ||
+                commands[i].inputData.GetKeys() != commands[i - 1].inputData.GetKeys() ||
+                commands[i].sequence != commands[i - 1].sequence + 1) {
+                runs++;
+            }
+        }
+        return runs;
+    }
+}
+
+size_t CommandRuns::encode(const Command *commands, size_t commandsSize, void *buffer, const size_t capacity) {
+    if (commandsSize > REDUNDANCY_WINDOW) {
+        commands += commandsSize - REDUNDANCY_WINDOW;
+        commandsSize = REDUNDANCY_WINDOW;
+    }
+
+    // drop the oldest commands until the runs fit, the newest ones matter most
+    const size_t maxRuns = std::min(MAX_RUNS, capacity / Wire::size<CommandRun>());
+    while (commandsSize > 0 && countRuns(commands, commandsSize) > maxRuns) {
+        commands++;
+        commandsSize--;
+    }
+
+    auto *out = static_cast<uint8_t*>(buffer);
+    size_t written = 0;
+    size_t i = 0;
+    while (i < commandsSize) {
+        const uint32_t startSequence = commands[i].sequence;
+        const uint8_t keys = commands[i].inputData.GetKeys();
+
+        size_t count = 1;
+        while (i + count < commandsSize &&
+               count < std::numeric_limits<uint8_t>::max() &&
+               commands[i + count].inputData.GetKeys() == keys &&
+               commands[i + count].sequence == startSequence + count) {
+            count++;
+        }
+
+        written += Wire::encode(CommandRun(startSequence, static_cast<uint8_t>(count), keys), out + written, capacity - written);
+        i += count;
+    }
+
+    return written;
+}
+
+size_t CommandRuns::decode(const void *data, const size_t size, Command *commands, const size_t capacity) {
+    CommandRun runs[MAX_RUNS];
+    const size_t runsSize = Wire::decodeArray(data, size, runs, MAX_RUNS);
+
+    size_t written = 0;
+    for (size_t r = 0; r < runsSize; r++) {
+        const CommandRun &run = runs[r];
+
+        for (uint32_t c = 0; c < run.count && written < capacity; c++) {
+            commands[written++] = Command(run.startSequence + c, InputData(run.keys));
+        }
+    }
+
+    return written;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "DataObjects.h"
+#include "../Network/Packet.h"
+
+// Run length encoding of the commands sent by the tick aligned uplink. Each
+// datagram repeats the newest unconfirmed commands, so a held key costs one
+// run no matter how many ticks it lasted.
+namespace CommandRuns {
+    // Newest commands repeated in every datagram, half a second at 60 ticks
+    constexpr size_t REDUNDANCY_WINDOW = 32;
+    // Worst case is every command in the window holding different keys
+    constexpr size_t MAX_RUNS = REDUNDANCY_WINDOW;
+    // Largest IPv4 datagram payload every host must accept without fragmenting
+    constexpr size_t UPLINK_MTU_BYTES = 508;
+
+    static_assert(
+        Packet::PACKET_HEADER_BYTES + Wire::size<ClientDataHeader>() + MAX_RUNS * Wire::size<CommandRun>() <= UPLINK_MTU_BYTES,
+        "a full uplink batch must fit a single unfragmented datagram"
+    );
+
+    // Encodes up to the last REDUNDANCY_WINDOW commands, which must be in sequence
+    // order. Returns the bytes written, a smaller window is used when the runs
+    // would not fit the capacity.
+    size_t encode(const Command *commands, size_t commandsSize, void *buffer, size_t capacity);
+
+    // Expands the runs back into commands, oldest first. Returns how many commands
+    // were written, trailing bytes that do not form a whole run are ignored.
+    size_t decode(const void *data, size_t size, Command *commands, size_t capacity);
+};
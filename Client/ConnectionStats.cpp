@@ -0,0 +1,238 @@
+#include "ConnectionStats.h"
+#include "../Network/AckWindow.h"
+#include <cmath>
+
+namespace {
+    template<size_t N>
+    void addToHistogram(uint32_t (&histogram)[N], const float (&bounds)[N - 1], const float value) {
+        size_t bucket = 0;
+        while (bucket < N - 1 && value > bounds[bucket]) {
+            bucket++;
+        }
+        histogram[bucket]++;
+    }
+
+    float toMilliseconds(const std::chrono::steady_clock::duration duration) {
+        return std::chrono::duration<float, std::milli>(duration).count();
+    }
+
+    float toPercent(const uint64_t part, const uint64_t total) {
+        return total > 0 ? 100.0f * static_cast<float>(part) / static_cast<float>(total) : 0.0f;
+    }
+}
+
+float ConnectionReport::GetSnapshotAgeMs(const std::chrono::steady_clock::time_point now) const {
+    return hasSnapshot ? toMilliseconds(now - lastSnapshotAt) : 0.0f;
+}
+
+float ConnectionReport::GetRttPercentileMs(const float fraction) const {
+    uint64_t total = 0;
+    for (const uint32_t count : rttHistogram) {
+        total += count;
+    }
+    if (total == 0) {
+        return 0.0f;
+    }
+
+    const auto target = static_cast<uint64_t>(std::ceil(fraction * static_cast<float>(total)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < RTT_BUCKETS - 1; i++) {
+        seen += rttHistogram[i];
+        if (seen >= target) {
+            return RTT_BUCKET_BOUNDS_MS[i];
+        }
+    }
+
+    // past the last bound, the best known value is that bound
+    return RTT_BUCKET_BOUNDS_MS[RTT_BUCKETS - 2];
+}
+
+void ConnectionStats::Clear() {
+    for (auto &packet : mSent) {
+        packet.pending = false;
+        packet.sequence = 0;
+    }
+
+    mHasRtt = false;
+    mLastRttSampleMs = 0.0f;
+    mRttMs = 0.0f;
+    mJitterMs = 0.0f;
+    for (auto &count : mRttHistogram) {
+        count = 0;
+    }
+    for (auto &count : mJitterHistogram) {
+        count = 0;
+    }
+
+    mUplinkSent = 0;
+    mUplinkAcked = 0;
+    mUplinkLost = 0;
+    mDownlinkReceived = 0;
+    mDownlinkLost = 0;
+    mHasSnapshot = false;
+    mNewestSnapshotId = 0;
+
+    mBytesIn = 0;
+    mBytesOut = 0;
+
+    mHasReport = false;
+    mReportedUplinkAcked = 0;
+    mReportedUplinkLost = 0;
+    mReportedDownlinkReceived = 0;
+    mReportedDownlinkLost = 0;
+    mReportedBytesIn = 0;
+    mReportedBytesOut = 0;
+}
+
+void ConnectionStats::OnPacketSent(const uint16_t sequence, const size_t bytes, const std::chrono::steady_clock::time_point now) {
+    SentPacket &packet = mSent[sequence % SENT_HISTORY_SIZE];
+
+    // a slot still waiting after a full history lap never got an ack
+    if (packet.pending) {
+        mUplinkLost++;
+    }
+
+    packet.pending = true;
+    packet.sequence = sequence;
+    packet.sentAt = now;
+
+    mUplinkSent++;
+    mBytesOut += bytes;
+}
+
+void ConnectionStats::OnPacketReceived(const size_t bytes) {
+    mBytesIn += bytes;
+}
+
+bool ConnectionStats::OnAck(const ServerDataHeader &header, const std::chrono::steady_clock::time_point now) {
+    if (header.hasAck == 0) {
+        return false;
+    }
+
+    bool sampled = false;
+    for (uint16_t offset = 0; offset <= AckWindow::WINDOW_SIZE; offset++) {
+        const auto sequence = static_cast<uint16_t>(header.ackedSequence - offset);
+        if (!AckWindow::isAcked(sequence, header.ackedSequence, header.ackBits)) {
+            continue;
+        }
+
+        SentPacket &packet = mSent[sequence % SENT_HISTORY_SIZE];
+        if (!packet.pending || packet.sequence != sequence) {
+            continue;
+        }
+
+        packet.pending = false;
+        mUplinkAcked++;
+
+        // only the newest packet has a known wait on the server
+        if (offset == 0) {
+            AddRttSample(toMilliseconds(now - packet.sentAt) - header.ackDelayMs);
+            sampled = true;
+        }
+    }
+
+    ResolveLosses(header.ackedSequence);
+    return sampled;
+}
+
+void ConnectionStats::OnSnapshot(const uint16_t snapshotId, const std::chrono::steady_clock::time_point now) {
+    mDownlinkReceived++;
+
+    if (!mHasSnapshot) {
+        mHasSnapshot = true;
+        mNewestSnapshotId = snapshotId;
+        mLastSnapshotAt = now;
+        return;
+    }
+
+    const auto gap = static_cast<int16_t>(snapshotId - mNewestSnapshotId);
+    if (gap > 0) {
+        mDownlinkLost += gap - 1;
+        mNewestSnapshotId = snapshotId;
+        mLastSnapshotAt = now;
+    } else if (gap < 0 && mDownlinkLost > 0) {
+        // reordered, it was counted as lost when the newer one came in
+        mDownlinkLost--;
+    }
+}
+
+ConnectionReport ConnectionStats::BuildReport(const std::chrono::steady_clock::time_point now) {
+    ConnectionReport report;
+    report.valid = true;
+    report.hasRtt = mHasRtt;
+    report.rttMs = mRttMs;
+    report.jitterMs = mJitterMs;
+    for (size_t i = 0; i < ConnectionReport::RTT_BUCKETS; i++) {
+        report.rttHistogram[i] = mRttHistogram[i];
+    }
+    for (size_t i = 0; i < ConnectionReport::JITTER_BUCKETS; i++) {
+        report.jitterHistogram[i] = mJitterHistogram[i];
+    }
+
+    report.uplinkSent = mUplinkSent;
+    report.uplinkLost = mUplinkLost;
+    report.downlinkReceived = mDownlinkReceived;
+    report.downlinkLost = mDownlinkLost;
+    report.hasSnapshot = mHasSnapshot;
+    report.lastSnapshotAt = mLastSnapshotAt;
+
+    // loss and rates over the interval, the totals are there for the long run
+    const uint64_t uplinkAcked = mUplinkAcked - mReportedUplinkAcked;
+    const uint64_t uplinkLost = mUplinkLost - mReportedUplinkLost;
+    const uint64_t downlinkReceived = mDownlinkReceived - mReportedDownlinkReceived;
+    const uint64_t downlinkLost = mDownlinkLost - mReportedDownlinkLost;
+    report.uplinkLossPercent = toPercent(uplinkLost, uplinkAcked + uplinkLost);
+    report.downlinkLossPercent = toPercent(downlinkLost, downlinkReceived + downlinkLost);
+
+    if (mHasReport) {
+        const float seconds = toMilliseconds(now - mLastReportAt) / 1000.0f;
+        if (seconds > 0.0f) {
+            report.bytesInPerSecond = static_cast<float>(mBytesIn - mReportedBytesIn) / seconds;
+            report.bytesOutPerSecond = static_cast<float>(mBytesOut - mReportedBytesOut) / seconds;
+        }
+    }
+
+    mHasReport = true;
+    mLastReportAt = now;
+    mReportedUplinkAcked = mUplinkAcked;
+    mReportedUplinkLost = mUplinkLost;
+    mReportedDownlinkReceived = mDownlinkReceived;
+    mReportedDownlinkLost = mDownlinkLost;
+    mReportedBytesIn = mBytesIn;
+    mReportedBytesOut = mBytesOut;
+
+    return report;
+}
+
+void ConnectionStats::AddRttSample(float rttMs) {
+    // the delay is rounded to whole milliseconds by the server
+    if (rttMs < 0.0f) {
+        rttMs = 0.0f;
+    }
+    mLastRttSampleMs = rttMs;
+
+    if (!mHasRtt) {
+        mHasRtt = true;
+        mRttMs = rttMs;
+        mJitterMs = rttMs / 2.0f;
+    } else {
+        const float deviation = std::fabs(rttMs - mRttMs);
+        addToHistogram(mJitterHistogram, ConnectionReport::JITTER_BUCKET_BOUNDS_MS, deviation);
+        mJitterMs += (deviation - mJitterMs) * JITTER_GAIN;
+        mRttMs += (rttMs - mRttMs) * RTT_GAIN;
+    }
+
+    addToHistogram(mRttHistogram, ConnectionReport::RTT_BUCKET_BOUNDS_MS, rttMs);
+}
+
+void ConnectionStats::ResolveLosses(const uint16_t newestAcked) {
+    // anything the window has moved past can no longer be acked
+    const auto windowStart = static_cast<uint16_t>(newestAcked - AckWindow::WINDOW_SIZE);
+
+    for (auto &packet : mSent) {
+        if (packet.pending && AckWindow::isNewer(windowStart, packet.sequence)) {
+            packet.pending = false;
+            mUplinkLost++;
+        }
+    }
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include "DataObjects.h"
+
+// Link quality numbers published by the network thread, rates cover the
+// interval since the previous report
+struct ConnectionReport {
+    static constexpr size_t RTT_BUCKETS = 11;
+    static constexpr size_t JITTER_BUCKETS = 8;
+    // upper bounds in milliseconds, the last bucket holds everything above
+    static constexpr float RTT_BUCKET_BOUNDS_MS[RTT_BUCKETS - 1] = {10, 20, 30, 50, 75, 100, 150, 200, 300, 500};
+    static constexpr float JITTER_BUCKET_BOUNDS_MS[JITTER_BUCKETS - 1] = {1, 2, 5, 10, 20, 50, 100};
+
+    bool valid = false;
+    bool hasRtt = false;
+    float rttMs = 0.0f;
+    float jitterMs = 0.0f;
+    uint32_t rttHistogram[RTT_BUCKETS] = {};
+    uint32_t jitterHistogram[JITTER_BUCKETS] = {};
+
+    // client packets unacked once they left the server ack window
+    float uplinkLossPercent = 0.0f;
+    // snapshot ids skipped, late arrivals are given back
+    float downlinkLossPercent = 0.0f;
+    uint64_t uplinkSent = 0;
+    uint64_t uplinkLost = 0;
+    uint64_t downlinkReceived = 0;
+    uint64_t downlinkLost = 0;
+
+    float bytesInPerSecond = 0.0f;
+    float bytesOutPerSecond = 0.0f;
+
+    bool hasSnapshot = false;
+    std::chrono::steady_clock::time_point lastSnapshotAt;
+
+    // milliseconds since the newest snapshot arrived
+    [[nodiscard]] float GetSnapshotAgeMs(std::chrono::steady_clock::time_point now) const;
+    // upper bound of the bucket holding the given fraction of the RTT samples
+    [[nodiscard]] float GetRttPercentileMs(float fraction) const;
+};
+
+// Per connection link quality, owned by the network thread. RTT comes from the
+// server acks of the client packet sequences, with the time the newest packet
+// waited on the server taken out. Smoothing follows RFC 6298 (1/8 and 1/4).
+class ConnectionStats {
+public:
+    ConnectionStats() { Clear(); }
+
+    void Clear();
+
+    void OnPacketSent(uint16_t sequence, size_t bytes, std::chrono::steady_clock::time_point now);
+    void OnPacketReceived(size_t bytes);
+    // True when the ack timed the newest packet, GetLastRttSampleMs has the unsmoothed value
+    bool OnAck(const ServerDataHeader &header, std::chrono::steady_clock::time_point now);
+    void OnSnapshot(uint16_t snapshotId, std::chrono::steady_clock::time_point now);
+
+    [[nodiscard]] float GetLastRttSampleMs() const { return mLastRttSampleMs; }
+
+    // Rates are measured since the previous call
+    ConnectionReport BuildReport(std::chrono::steady_clock::time_point now);
+
+    static constexpr size_t SENT_HISTORY_SIZE = 256;
+    static constexpr float RTT_GAIN = 1.0f / 8.0f;
+    static constexpr float JITTER_GAIN = 1.0f / 4.0f;
+
+private:
+    struct SentPacket {
+        bool pending;
+        uint16_t sequence;
+        std::chrono::steady_clock::time_point sentAt;
+    };
+
+    void AddRttSample(float rttMs);
+    void ResolveLosses(uint16_t newestAcked);
+
+    SentPacket mSent[SENT_HISTORY_SIZE];
+
+    bool mHasRtt;
+    float mLastRttSampleMs;
+    float mRttMs;
+    float mJitterMs;
+    uint32_t mRttHistogram[ConnectionReport::RTT_BUCKETS];
+    uint32_t mJitterHistogram[ConnectionReport::JITTER_BUCKETS];
+
+    uint64_t mUplinkSent;
+    uint64_t mUplinkAcked;
+    uint64_t mUplinkLost;
+    uint64_t mDownlinkReceived;
+    uint64_t mDownlinkLost;
+    bool mHasSnapshot;
+    uint16_t mNewestSnapshotId;
+    std::chrono::steady_clock::time_point mLastSnapshotAt;
+
+    uint64_t mBytesIn;
+    uint64_t mBytesOut;
+
+    // counters at the previous report
+    bool mHasReport;
+    std::chrono::steady_clock::time_point mLastReportAt;
+    uint64_t mReportedUplinkAcked;
+    uint64_t mReportedUplinkLost;
+    uint64_t mReportedDownlinkReceived;
+    uint64_t mReportedDownlinkLost;
+    uint64_t mReportedBytesIn;
+    uint64_t mReportedBytesOut;
+};
@@ -6,19 +6,22 @@
 #include <cstdint>
 
 #include "InputData.h"
+#include "../Network/WireFormat.h"
 
-struct InterpolationState {
-    float targetPosX, targetPosY, targetRotation;
-};
+// Messages that go out through Wire:: keep their widest fields first, so the
+// compiler leaves no padding between them and on little endian hosts
+// Wire::encode and decode copy their bytes whole (see Wire::isPlain). The ones
+// sent in arrays or many per tick hold Wire::LittleEndian fields instead, they
+// are as long as on the wire and a batch of them is a single memcpy.
 
-#pragma pack(1)
 // Commands to be sent to the server
 struct Command {
-    uint32_t sequence;
+    Wire::LittleEndian<uint32_t> sequence;
     InputData inputData;
 
     Command(const uint32_t sequence, const InputData &inputData)
     :sequence(sequence), inputData(inputData) {}
+    Command() :sequence(0) {}
 };
 
 struct RawState {
@@ -33,7 +36,6 @@ struct RawState {
 struct OtherState {
     int id;
     float posX, posY, rotation;
-    bool hasShot;
     int life;
     float invulnerableTimer;
 
@@ -42,23 +44,181 @@ struct OtherState {
         const float x,
         const float y,
         const float rot,
-        const bool hasShot,
         const int life,
         const float invulnerableTimer
     )
-    :id(id), posX(x), posY(y), rotation(rot), hasShot(hasShot), life(life), invulnerableTimer(invulnerableTimer) {}
-    OtherState() :id(-1), posX(0), posY(0), rotation(0), hasShot(false), life(0), invulnerableTimer(0) {}
+    :id(id), posX(x), posY(y), rotation(rot), life(life), invulnerableTimer(invulnerableTimer) {}
+    OtherState() :id(-1), posX(0), posY(0), rotation(0), life(0), invulnerableTimer(0) {}
 };
 
-#define MAX_OTHER_STATES 3
+// Upper bound of a room, snapshots only carry the ones that fit the byte budget
+#define MAX_OTHER_STATES 63
 
 struct FullState {
     RawState rawState;
     OtherState otherStates[MAX_OTHER_STATES];
     size_t otherStateSize;
     uint32_t lastConfirmedInputSequence;
+    // Server simulation tick the state was taken at
+    uint32_t serverTick;
 
     FullState(const RawState &raw,const uint32_t sequence)
-    :rawState(raw), otherStateSize(0), lastConfirmedInputSequence(sequence) {}
+    :rawState(raw), otherStateSize(0), lastConfirmedInputSequence(sequence), serverTick(0) {}
+    FullState() :otherStateSize(0), lastConfirmedInputSequence(0), serverTick(0) {}
+};
+
+// Layout of the commands that follow a ClientDataHeader
+enum class CommandFormat : uint8_t {
+    COMMANDS = 0, // Command structs, oldest first
+    RUNS = 1, // CommandRun structs, see CommandRuns.h
+};
+
+// Prefix of every DATA and PING payload sent by the client. The server DATA
+// packets are acked by their header sequence, see AckWindow.
+struct ClientDataHeader {
+    uint32_t downlinkAckBits;
+    // Server tick the other players were drawn at when the packet left, in
+    // 1/256 ticks. The server judges this client's shots against that past.
+    uint32_t viewTick;
+    uint16_t ackedSnapshotId;
+    uint16_t downlinkAckedSequence;
+    uint8_t hasAckedSnapshot;
+    CommandFormat commandFormat;
+    uint8_t hasDownlinkAck;
+    uint8_t hasViewTick;
+    uint8_t viewTickFraction;
+
+    ClientDataHeader(const bool hasAck, const uint16_t snapshotId, const CommandFormat format = CommandFormat::COMMANDS)
+    :downlinkAckBits(0), viewTick(0), ackedSnapshotId(snapshotId), downlinkAckedSequence(0),
+    hasAckedSnapshot(hasAck ? 1 : 0), commandFormat(format), hasDownlinkAck(0),
+    hasViewTick(0), viewTickFraction(0) {}
+};
+
+// Prefix of every DATA payload sent by the server, acks the client packets
+// (DATA and PING) by their header sequence, see AckWindow. A reliable event
+// block (see ReliableChannel) and the snapshot follow it.
+struct ServerDataHeader {
+    uint32_t ackBits;
+    uint16_t ackedSequence;
+    uint8_t hasAck;
+    // milliseconds the newest client packet waited on the server, capped at 255
+    uint8_t ackDelayMs;
+
+    ServerDataHeader() :ackBits(0), ackedSequence(0), hasAck(0), ackDelayMs(0) {}
 };
-#pragma pack(0)
\ No newline at end of file
+
+enum class EventType : uint8_t {
+    SHOT = 0,
+};
+
+// Another player fired, with the pose the laser left from. The type goes
+// last, after the word sized fields.
+struct ShotEvent {
+    Wire::LittleEndian<int32_t> playerId;
+    Wire::LittleEndian<uint32_t> serverTick;
+    Wire::LittleEndian<float> posX, posY, rotation;
+    EventType type;
+
+    ShotEvent(const int32_t playerId, const uint32_t serverTick, const float x, const float y, const float rot)
+    :playerId(playerId), serverTick(serverTick), posX(x), posY(y), rotation(rot), type(EventType::SHOT) {}
+    ShotEvent() :playerId(-1), serverTick(0), posX(0), posY(0), rotation(0), type(EventType::SHOT) {}
+};
+
+// First bytes of a SYN. The wire version travels in the packet header, see
+// Packet::WIRE_VERSION.
+struct SynPayload {
+    uint8_t integrityModes;
+
+    SynPayload() :integrityModes(0) {}
+    explicit SynPayload(const uint8_t modes) :integrityModes(modes) {}
+};
+
+// Consecutive commands holding the same keys, starting at startSequence
+struct CommandRun {
+    Wire::LittleEndian<uint32_t> startSequence;
+    uint8_t count;
+    uint8_t keys;
+
+    CommandRun(const uint32_t startSequence, const uint8_t count, const uint8_t keys)
+    :startSequence(startSequence), count(count), keys(keys) {}
+    CommandRun() :startSequence(0), count(0), keys(0) {}
+};
+
+// Wire layout of every message above that goes out as is. Snapshots are not
+// here, SnapshotCodec quantizes them into a bit stream.
+template <>
+struct Wire::Codec<InputData> {
+    static constexpr size_t BYTES = 1;
+    static constexpr bool PLAIN = sizeof(InputData) == BYTES;
+    static void write(const InputData value, uint8_t *out) { out[0] = value.GetKeys(); }
+    static InputData read(const uint8_t *in) { return InputData(in[0]); }
+};
+
+template <>
+struct Wire::Schema<Command> {
+    using Fields = std::tuple<
+        Wire::Field<&Command::sequence>,
+        Wire::Field<&Command::inputData>
+    >;
+};
+
+template <>
+struct Wire::Schema<ClientDataHeader> {
+    using Fields = std::tuple<
+        Wire::Field<&ClientDataHeader::downlinkAckBits>,
+        Wire::Field<&ClientDataHeader::viewTick>,
+        Wire::Field<&ClientDataHeader::ackedSnapshotId>,
+        Wire::Field<&ClientDataHeader::downlinkAckedSequence>,
+        Wire::Field<&ClientDataHeader::hasAckedSnapshot>,
+        Wire::Field<&ClientDataHeader::commandFormat>,
+        Wire::Field<&ClientDataHeader::hasDownlinkAck>,
+        Wire::Field<&ClientDataHeader::hasViewTick>,
+        Wire::Field<&ClientDataHeader::viewTickFraction>
+    >;
+};
+
+template <>
+struct Wire::Schema<ServerDataHeader> {
+    using Fields = std::tuple<
+        Wire::Field<&ServerDataHeader::ackBits>,
+        Wire::Field<&ServerDataHeader::ackedSequence>,
+        Wire::Field<&ServerDataHeader::hasAck>,
+        Wire::Field<&ServerDataHeader::ackDelayMs>
+    >;
+};
+
+template <>
+struct Wire::Schema<ShotEvent> {
+    using Fields = std::tuple<
+        Wire::Field<&ShotEvent::playerId>,
+        Wire::Field<&ShotEvent::serverTick>,
+        Wire::Field<&ShotEvent::posX>,
+        Wire::Field<&ShotEvent::posY>,
+        Wire::Field<&ShotEvent::rotation>,
+        Wire::Field<&ShotEvent::type>
+    >;
+};
+
+template <>
+struct Wire::Schema<SynPayload> {
+    using Fields = std::tuple<
+        Wire::Field<&SynPayload::integrityModes>
+    >;
+};
+
+template <>
+struct Wire::Schema<CommandRun> {
+    using Fields = std::tuple<
+        Wire::Field<&CommandRun::startSequence>,
+        Wire::Field<&CommandRun::count>,
+        Wire::Field<&CommandRun::keys>
+    >;
+};
+
+// The messages sent every tick must stay copyable as they are
+static_assert(!Wire::LITTLE_ENDIAN_HOST || (Wire::isPlain<ClientDataHeader>() && Wire::isPlain<ServerDataHeader>()),
+              "message fields out of order or missing from the schema");
+static_assert(Wire::isPlain<Command>() && sizeof(Command) == Wire::size<Command>() &&
+              Wire::isPlain<CommandRun>() && sizeof(CommandRun) == Wire::size<CommandRun>() &&
+              Wire::isPlain<ShotEvent>() && sizeof(ShotEvent) == Wire::size<ShotEvent>(),
+              "arrays of these are copied whole, they must be as long as on the wire");
@@ -16,6 +16,7 @@ enum class KeyValue : uint8_t{
 class InputData {
 public:
     InputData() :mActiveKeys(0){}
+    explicit InputData(const uint8_t keys) :mActiveKeys(keys){}
     ~InputData() = default;
 
     void SetKeyActive(KeyValue key) {
@@ -33,6 +34,7 @@ public:
     void ResetKeys() { mActiveKeys = 0; }
 
     [[nodiscard]] bool NoKeysActive() const { return mActiveKeys == 0; }
+    [[nodiscard]] uint8_t GetKeys() const { return mActiveKeys; }
 private:
     uint8_t mActiveKeys;
 };
\ No newline at end of file
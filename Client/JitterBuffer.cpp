@@ -0,0 +1,228 @@
+#include "JitterBuffer.h"
+#include "ShipSimulation.h"
+#include <algorithm>
+
+namespace {
+    float wrapPosition(float value, const float size) {
+        if (value < 0.0f) {
+            value += size;
+        } else if (value > size) {
+            value -= size;
+        }
+        return value;
+    }
+}
+
+void JitterBuffer::Clear() {
+    for (auto &entity : mEntities) {
+        entity.used = false;
+        entity.id = -1;
+        entity.head = 0;
+        entity.size = 0;
+    }
+
+    mHasClock = false;
+    mClockOffset = 0.0;
+    mJitter = 0.0;
+    mDelayTicks = MIN_DELAY_TICKS;
+    mHasRenderTime = false;
+    mLastRenderTime = 0.0;
+    mRenderTick = 0.0;
+    mNewestTick = 0;
+
+    mInterpolatedFrames = 0;
+    mExtrapolatedFrames = 0;
+    mHeldFrames = 0;
+    mLateSamples = 0;
+}
+
+int JitterBuffer::FindSlot(const int id) const {
+    for (size_t i = 0; i < CAPACITY; i++) {
+        if (mEntities[i].used && mEntities[i].id == id) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+int JitterBuffer::AddEntity(const int id) {
+    for (size_t i = 0; i < CAPACITY; i++) {
+        Entity &entity = mEntities[i];
+        if (entity.used) {
+            continue;
+        }
+
+        entity.used = true;
+        entity.id = id;
+        entity.head = 0;
+        entity.size = 0;
+        return static_cast<int>(i);
+    }
+    return -1;
+}
+
+void JitterBuffer::RemoveEntity(const int slot) {
+    mEntities[slot].used = false;
+    mEntities[slot].id = -1;
+    mEntities[slot].size = 0;
+}
+
+void JitterBuffer::OnSnapshot(const uint32_t serverTick, const std::chrono::steady_clock::time_point receivedAt) {
+    if (!mHasClock) {
+        mEpoch = receivedAt;
+    }
+
+    // local time of server tick zero as seen through this arrival
+    const double offset = ToSeconds(receivedAt) - serverTick * SERVER_TICK_SECONDS;
+
+    if (!mHasClock) {
+        mClockOffset = offset;
+        mHasClock = true;
+    } else if (offset < mClockOffset) {
+        mClockOffset = offset;
+    } else {
+        mClockOffset += (offset - mClockOffset) * CLOCK_RISE_GAIN;
+    }
+
+    // how late this snapshot was compared to the fastest one seen
+    const double lateness = offset - mClockOffset;
+    mJitter += (lateness - mJitter) * JITTER_GAIN;
+
+    if (static_cast<int32_t>(serverTick - mNewestTick) > 0) {
+        mNewestTick = serverTick;
+    }
+}
+
+void JitterBuffer::Push(const int slot, const uint32_t serverTick, const float posX, const float posY, const float rotation) {
+    Entity &entity = mEntities[slot];
+
+    // samples are kept in tick order, snapshots older than the newest one are useless
+    if (entity.size > 0) {
+        const TickSample &newest = GetSample(entity, entity.size - 1);
+        if (static_cast<int32_t>(serverTick - newest.tick) <= 0) {
+            mLateSamples++;
+            return;
+        }
+    }
+
+    const size_t index = (entity.head + entity.size) % SAMPLES_PER_ENTITY;
+    entity.samples[index] = {serverTick, posX, posY, rotation};
+
+    if (entity.size < SAMPLES_PER_ENTITY) {
+        entity.size++;
+    } else {
+        entity.head = (entity.head + 1) % SAMPLES_PER_ENTITY;
+    }
+}
+
+double JitterBuffer::AdvanceRenderTick(const std::chrono::steady_clock::time_point now) {
+    if (!mHasClock) {
+        return mRenderTick;
+    }
+
+    const double nowSeconds = ToSeconds(now);
+    const double elapsed = mHasRenderTime ? std::max(0.0, nowSeconds - mLastRenderTime) : 0.0;
+    mLastRenderTime = nowSeconds;
+    mHasRenderTime = true;
+
+    // move the delay toward its target a little every frame so the render clock never jumps
+    const double target = std::clamp(
+        MIN_DELAY_TICKS + JITTER_DELAY_FACTOR * mJitter / SERVER_TICK_SECONDS,
+        MIN_DELAY_TICKS,
+        MAX_DELAY_TICKS
+    );
+    const double step = DELAY_ADAPT_RATE * elapsed;
+    mDelayTicks += std::clamp(target - mDelayTicks, -step, step);
+
+    mRenderTick = (nowSeconds - mClockOffset) / SERVER_TICK_SECONDS - mDelayTicks;
+    return mRenderTick;
+}
+
+SampleResult JitterBuffer::Sample(const int slot, const double renderTick, EntityPose *pose) {
+    const Entity &entity = mEntities[slot];
+    if (entity.size == 0) {
+        return SampleResult::EMPTY;
+    }
+
+    const TickSample &oldest = GetSample(entity, 0);
+    if (entity.size == 1 || renderTick <= oldest.tick) {
+        const TickSample &held = renderTick <= oldest.tick ? oldest : GetSample(entity, entity.size - 1);
+        *pose = {held.posX, held.posY, held.rotation};
+        mHeldFrames++;
+        return SampleResult::HELD;
+    }
+
+    // latest pair whose first sample is not past the render tick, the newest
+    // pair when the render tick ran past the buffer
+    size_t index = entity.size - 2;
+    while (index > 0 && GetSample(entity, index).tick > renderTick) {
+        index--;
+    }
+
+    const TickSample &from = GetSample(entity, index);
+    const TickSample &to = GetSample(entity, index + 1);
+    const double span = static_cast<double>(to.tick - from.tick);
+    double t = (renderTick - from.tick) / span;
+
+    SampleResult result = SampleResult::INTERPOLATED;
+    if (t > 1.0) {
+        // keep moving for a moment on loss, then freeze where the motion stopped
+        const double limit = 1.0 + MAX_EXTRAPOLATION_TICKS / span;
+        result = t > limit ? SampleResult::HELD : SampleResult::EXTRAPOLATED;
+        t = std::min(t, limit);
+    }
+
+    // the world wraps around, a ship crossing an edge moves the short way
+    const auto alpha = static_cast<float>(t);
+    pose->posX = wrapPosition(
+        from.posX + ShipSimulation::wrapDelta(from.posX, to.posX, ShipSimulation::WORLD_WIDTH) * alpha,
+        ShipSimulation::WORLD_WIDTH
+    );
+    pose->posY = wrapPosition(
+        from.posY + ShipSimulation::wrapDelta(from.posY, to.posY, ShipSimulation::WORLD_HEIGHT) * alpha,
+        ShipSimulation::WORLD_HEIGHT
+    );
+    pose->rotation = from.rotation + ShipSimulation::angleDelta(from.rotation, to.rotation) * alpha;
+
+    switch (result) {
+        case SampleResult::INTERPOLATED:
+            mInterpolatedFrames++;
+            break;
+        case SampleResult::EXTRAPOLATED:
+            mExtrapolatedFrames++;
+            break;
+        default:
+            mHeldFrames++;
+            break;
+    }
+
+    return result;
+}
+
+JitterBufferStats JitterBuffer::GetStats() const {
+    JitterBufferStats stats{};
+
+    for (const auto &entity : mEntities) {
+        if (entity.used) {
+            stats.entities++;
+            stats.bufferedSamples += entity.size;
+        }
+    }
+
+    stats.delayMs = static_cast<float>(mDelayTicks * SERVER_TICK_SECONDS * 1000.0);
+    stats.jitterMs = static_cast<float>(mJitter * 1000.0);
+    stats.leadTicks = mHasClock ? static_cast<float>(mNewestTick - mRenderTick) : 0.0f;
+    stats.interpolatedFrames = mInterpolatedFrames;
+    stats.extrapolatedFrames = mExtrapolatedFrames;
+    stats.heldFrames = mHeldFrames;
+    stats.lateSamples = mLateSamples;
+    return stats;
+}
+
+const JitterBuffer::TickSample &JitterBuffer::GetSample(const Entity &entity, const size_t index) const {
+    return entity.samples[(entity.head + index) % SAMPLES_PER_ENTITY];
+}
+
+double JitterBuffer::ToSeconds(const std::chrono::steady_clock::time_point time) const {
+    return std::chrono::duration<double>(time - mEpoch).count();
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include "DataObjects.h"
+
+struct EntityPose {
+    float posX, posY, rotation;
+};
+
+enum class SampleResult {
+    EMPTY,
+    INTERPOLATED,
+    EXTRAPOLATED,
+    // older than the buffer or past the extrapolation limit, the pose is frozen
+    HELD,
+};
+
+// Health counters since the last Clear, per entity per rendered frame
+struct JitterBufferStats {
+    size_t entities;
+    size_t bufferedSamples;
+    float delayMs;
+    float jitterMs;
+    // newest buffered tick minus the render tick, negative when starving
+    float leadTicks;
+    uint64_t interpolatedFrames;
+    uint64_t extrapolatedFrames;
+    uint64_t heldFrames;
+    uint64_t lateSamples;
+};
+
+// Tick stamped poses of the remote players. The server clock is estimated from
+// snapshot arrivals and entities are rendered a little behind it, between the
+// two samples bracketing the render tick. The delay grows with the measured
+// arrival jitter and shrinks back when the link calms down.
+class JitterBuffer {
+public:
+    JitterBuffer() { Clear(); }
+
+    void Clear();
+
+    // Flat entity table, slots stay valid until removed
+    int FindSlot(int id) const;
+    int AddEntity(int id);
+    void RemoveEntity(int slot);
+    [[nodiscard]] bool IsUsed(const int slot) const { return mEntities[slot].used; }
+
+    // Called once per snapshot, before its samples are pushed
+    void OnSnapshot(uint32_t serverTick, std::chrono::steady_clock::time_point receivedAt);
+    void Push(int slot, uint32_t serverTick, float posX, float posY, float rotation);
+
+    // Moves the render clock to now, once per frame before sampling
+    double AdvanceRenderTick(std::chrono::steady_clock::time_point now);
+    SampleResult Sample(int slot, double renderTick, EntityPose *pose);
+
+    [[nodiscard]] JitterBufferStats GetStats() const;
+
+    static constexpr size_t CAPACITY = MAX_OTHER_STATES;
+    // one second of server ticks per entity
+    static constexpr size_t SAMPLES_PER_ENTITY = 32;
+    // Must match Server::TICK_RATE
+    static constexpr double SERVER_TICK_RATE = 30.0;
+    static constexpr double SERVER_TICK_SECONDS = 1.0 / SERVER_TICK_RATE;
+    // one tick behind the newest sample is the least that still brackets it
+    static constexpr double MIN_DELAY_TICKS = 1.0;
+    static constexpr double MAX_DELAY_TICKS = 10.0;
+    static constexpr double JITTER_DELAY_FACTOR = 2.0;
+    // how fast the render delay follows its target, in ticks per second
+    static constexpr double DELAY_ADAPT_RATE = 2.0;
+    static constexpr double JITTER_GAIN = 1.0 / 16.0;
+    // the clock estimate follows the fastest arrival, later ones pull it slowly
+    static constexpr double CLOCK_RISE_GAIN = 1.0 / 256.0;
+    static constexpr double MAX_EXTRAPOLATION_TICKS = 3.0;
+
+private:
+    struct TickSample {
+        uint32_t tick;
+        float posX, posY, rotation;
+    };
+
+    struct Entity {
+        bool used;
+        int id;
+        size_t head;
+        size_t size;
+        TickSample samples[SAMPLES_PER_ENTITY];
+    };
+
+    [[nodiscard]] const TickSample &GetSample(const Entity &entity, size_t index) const;
+    [[nodiscard]] double ToSeconds(std::chrono::steady_clock::time_point time) const;
+
+    Entity mEntities[CAPACITY];
+
+    bool mHasClock;
+    std::chrono::steady_clock::time_point mEpoch;
+    double mClockOffset;
+    double mJitter;
+    double mDelayTicks;
+    bool mHasRenderTime;
+    double mLastRenderTime;
+    double mRenderTick;
+    uint32_t mNewestTick;
+
+    uint64_t mInterpolatedFrames;
+    uint64_t mExtrapolatedFrames;
+    uint64_t mHeldFrames;
+    uint64_t mLateSamples;
+};
@@ -8,5 +8,4 @@
 
 namespace SDLInputParser {
     InputData parse(const Uint8 *keyState);
-    const Uint8 *revert(const InputData &input);
 };
\ No newline at end of file
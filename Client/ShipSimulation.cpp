@@ -0,0 +1,197 @@
+#include "ShipSimulation.h"
+
+bool ShipSimulation::step(ShipSimState &state, const InputData &input, const float deltaTime) {
+    const bool up = input.IsKeyActive(KeyValue::MOVE_FORWARD);
+    const bool down = input.IsKeyActive(KeyValue::MOVE_BACKWARD);
+    const bool left = input.IsKeyActive(KeyValue::MOVE_LEFT);
+    const bool right = input.IsKeyActive(KeyValue::MOVE_RIGHT);
+
+    Vector2 velocity = Vector2::Zero;
+
+    if (up && !down) {
+        velocity.y = -SHIP_SPEED;
+    } else if (down && !up) {
+        velocity.y = SHIP_SPEED;
+    }
+
+    if (left && !right) {
+        velocity.x = -SHIP_SPEED;
+    } else if (right && !left) {
+        velocity.x = SHIP_SPEED;
+    }
+
+    if (velocity.x != 0.0f || velocity.y != 0.0f) {
+        state.rotation = Math::Atan2(velocity.y, velocity.x);
+        if (velocity.x != 0.0f && velocity.y != 0.0f) {
+            const float length = Math::Sqrt(velocity.x * velocity.x + velocity.y * velocity.y);
+
+            velocity.x = (velocity.x / length) * SHIP_SPEED;
+            velocity.y = (velocity.y / length) * SHIP_SPEED;
+        }
+    }
+
+    bool fired = false;
+    if (input.IsKeyActive(KeyValue::SHOOT) && state.laserCooldown <= 0.f) {
+        state.laserCooldown = LASER_COOLDOWN;
+        fired = true;
+    }
+
+    updateCooldown(state, deltaTime);
+
+    state.posX += velocity.x * deltaTime;
+    state.posY += velocity.y * deltaTime;
+    screenWrap(state.posX, state.posY);
+
+    return fired;
+}
+
+void ShipSimulation::updateCooldown(ShipSimState &state, const float deltaTime) {
+    state.laserCooldown -= deltaTime;
+    if (state.laserCooldown <= 0) {
+        state.laserCooldown = 0.f;
+    }
+}
+
+void ShipSimulation::updateInvulnerability(ShipSimState &state, const float deltaTime) {
+    if (state.invulnerableTimer > 0.0f) {
+        state.invulnerableTimer -= deltaTime;
+        if (state.invulnerableTimer <= 0.0f) {
+            state.invulnerableTimer = 0.0f;
+        }
+    }
+}
+
+bool ShipSimulation::takeDamage(ShipSimState &state) {
+    if (state.life <= 0 || state.invulnerableTimer > 0.0f) {
+        return false;
+    }
+
+    state.life--;
+    state.invulnerableTimer = INVULNERABILITY_TIME;
+    return true;
+}
+
+void ShipSimulation::screenWrap(float &x, float &y) {
+    if (x > WORLD_WIDTH) {
+        x = 0;
+    } else if (x < 0) {
+        x = WORLD_WIDTH;
+    }
+
+    if (y > WORLD_HEIGHT) {
+        y = 0;
+    } else if (y < 0) {
+        y = WORLD_HEIGHT;
+    }
+}
+
+float ShipSimulation::wrapDelta(const float from, const float to, const float size) {
+    float delta = to - from;
+    if (delta > size / 2.0f) {
+        delta -= size;
+    } else if (delta < -size / 2.0f) {
+        delta += size;
+    }
+    return delta;
+}
+
+float ShipSimulation::angleDelta(const float from, const float to) {
+    float delta = to - from;
+    while (delta > Math::Pi) {
+        delta -= Math::TwoPi;
+    }
+    while (delta < -Math::Pi) {
+        delta += Math::TwoPi;
+    }
+    return delta;
+}
+
+bool ShipSimulation::nearlyEqual(
+    const ShipSimState &a,
+    const ShipSimState &b,
+    const float positionEpsilon,
+    const float rotationEpsilon
+) {
+    return Math::Abs(wrapDelta(a.posX, b.posX, WORLD_WIDTH)) <= positionEpsilon &&
+           Math::Abs(wrapDelta(a.posY, b.posY, WORLD_HEIGHT)) <= positionEpsilon &&
+           Math::Abs(angleDelta(a.rotation, b.rotation)) <= rotationEpsilon;
+}
+
+Vector2 ShipSimulation::getLaserStart(const ShipSimState &state) {
+    const Vector2 forward(Math::Cos(state.rotation), Math::Sin(state.rotation));
+    return Vector2(state.posX, state.posY) + forward * (SHIP_HEIGHT / 2.0f);
+}
+
+Vector2 ShipSimulation::getLaserEdgeEnd(const Vector2 &start, const float rotation) {
+    const float cosR = Math::Cos(rotation);
+    const float sinR = Math::Sin(rotation);
+
+    constexpr float verticalEdges[] = {WORLD_WIDTH, 0.0f};
+    constexpr float horizontalEdges[] = {0.0f, WORLD_HEIGHT};
+    float minDist = WORLD_WIDTH + WORLD_HEIGHT;
+
+    if (Math::Abs(cosR) > 0.0001f) {
+        for (const float edge : verticalEdges) {
+            if (const float t = (edge - start.x) / cosR; t > 0.0f) {
+                if (const float y = start.y + sinR * t; y >= 0.0f && y <= WORLD_HEIGHT) {
+                    minDist = Math::Min(minDist, t);
+                }
+            }
+        }
+    }
+
+    if (Math::Abs(sinR) > 0.0001f) {
+        for (const float edge : horizontalEdges) {
+            if (const float t = (edge - start.y) / sinR; t > 0.0f) {
+                if (const float x = start.x + cosR * t; x >= 0.0f && x <= WORLD_WIDTH) {
+                    minDist = Math::Min(minDist, t);
+                }
+            }
+        }
+    }
+
+    if (minDist >= WORLD_WIDTH + WORLD_HEIGHT) {
+        minDist = Math::Sqrt(WORLD_WIDTH * WORLD_WIDTH + WORLD_HEIGHT * WORLD_HEIGHT);
+    }
+
+    return Vector2(start.x + cosR * minDist, start.y + sinR * minDist);
+}
+
+float ShipSimulation::rayCastToCircle(const Vector2 &start, const float rotation, const Vector2 &center, const float radius) {
+    const Vector2 rayDir(Math::Cos(rotation), Math::Sin(rotation));
+    const Vector2 toCircle = center - start;
+
+    const float projection = toCircle.x * rayDir.x + toCircle.y * rayDir.y;
+    if (projection < 0.0f) {
+        return -1.0f;
+    }
+
+    const Vector2 toClosest = center - (start + rayDir * projection);
+    const float distSq = toClosest.LengthSq();
+    const float radiusSq = radius * radius;
+
+    if (distSq > radiusSq) {
+        return -1.0f;
+    }
+
+    return projection - Math::Sqrt(radiusSq - distSq);
+}
+
+bool ShipSimulation::segmentIntersectsCircle(const Vector2 &start, const Vector2 &end, const Vector2 &center, const float radius) {
+    Vector2 lineDir = end - start;
+    const float lineLength = lineDir.Length();
+
+    if (lineLength < 0.0001f) {
+        return false;
+    }
+
+    lineDir.x /= lineLength;
+    lineDir.y /= lineLength;
+
+    const Vector2 toCircle = center - start;
+    float projection = toCircle.x * lineDir.x + toCircle.y * lineDir.y;
+    projection = Math::Max(0.0f, Math::Min(lineLength, projection));
+
+    const Vector2 toClosest = center - (start + lineDir * projection);
+    return toClosest.LengthSq() <= (radius * radius);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "InputData.h"
+#include "../Source/Math.h"
+
+// Plain ship state, free of SDL and actors, used by the authoritative server
+struct ShipSimState {
+    float posX, posY, rotation;
+    float laserCooldown;
+    float invulnerableTimer;
+    int life;
+
+    ShipSimState() : posX(0), posY(0), rotation(0), laserCooldown(0), invulnerableTimer(0), life(0) {}
+};
+
+// Movement, cooldown and laser rules of the multiplayer Ship/RigidBodyComponent
+namespace ShipSimulation {
+    constexpr float SHIP_SPEED = 300.0f;
+    constexpr float SHIP_HEIGHT = 40.0f;
+    constexpr float SHIP_COLLIDER_RADIUS = SHIP_HEIGHT;
+    constexpr float LASER_COOLDOWN = 0.2f;
+    constexpr float LASER_LIFETIME = 0.5f;
+    constexpr float INVULNERABILITY_TIME = 2.0f;
+    constexpr int MAX_LIVES = 4;
+
+    constexpr float WORLD_WIDTH = 1920.0f;
+    constexpr float WORLD_HEIGHT = 1080.0f;
+
+    // Applies one input frame, returns true if the ship fired a laser
+    bool step(ShipSimState &state, const InputData &input, float deltaTime);
+    void updateCooldown(ShipSimState &state, float deltaTime);
+    void updateInvulnerability(ShipSimState &state, float deltaTime);
+    bool takeDamage(ShipSimState &state);
+    void screenWrap(float &x, float &y);
+
+    // Shortest signed differences on the wrapping world and around the circle
+    float wrapDelta(float from, float to, float size);
+    float angleDelta(float from, float to);
+    // Pose comparison used to skip reconciliation when the prediction was right
+    bool nearlyEqual(const ShipSimState &a, const ShipSimState &b, float positionEpsilon, float rotationEpsilon);
+
+    Vector2 getLaserStart(const ShipSimState &state);
+    Vector2 getLaserEdgeEnd(const Vector2 &start, float rotation);
+    float rayCastToCircle(const Vector2 &start, float rotation, const Vector2 &center, float radius);
+    bool segmentIntersectsCircle(const Vector2 &start, const Vector2 &end, const Vector2 &center, float radius);
+};
@@ -0,0 +1,422 @@
+#include "SnapshotCodec.h"
+#include "ShipSimulation.h"
+#include "../Network/BitStream.h"
+#include "../Source/Math.h"
+#include <algorithm>
+
+void SnapshotHistory::Clear() {
+    for (auto &entry : mEntries) {
+        entry.valid = false;
+        entry.snapshotId = 0;
+    }
+}
+
+void SnapshotHistory::Store(const uint16_t snapshotId, const FullState &state) {
+    Entry &entry = mEntries[snapshotId % HISTORY_SIZE];
+    entry.valid = true;
+    entry.snapshotId = snapshotId;
+    entry.state = state;
+}
+
+const FullState *SnapshotHistory::Find(const uint16_t snapshotId) const {
+    const Entry &entry = mEntries[snapshotId % HISTORY_SIZE];
+    if (!entry.valid || entry.snapshotId != snapshotId) {
+        return nullptr;
+    }
+
+    return &entry.state;
+}
+
+const FullState *SnapshotHistory::FindBaseline(const uint16_t snapshotId, const uint16_t ackedId) const {
+    if (static_cast<uint16_t>(snapshotId - ackedId) >= HISTORY_SIZE) {
+        return nullptr;
+    }
+
+    return Find(ackedId);
+}
+
+namespace {
+    // Quantized view of the fields shared by RawState and OtherState
+    struct QuantizedShip {
+        uint32_t posX, posY, rotation, life, timer;
+    };
+
+    uint32_t quantizePosition(const float value, const float max) {
+        const float clamped = Math::Clamp(value, 0.0f, max);
+        return static_cast<uint32_t>(clamped * SnapshotCodec::POSITION_SCALE + 0.5f);
+    }
+
+    float dequantizePosition(const uint32_t value) {
+        return static_cast<float>(value) / SnapshotCodec::POSITION_SCALE;
+    }
+
+    uint32_t quantizeRotation(float rotation) {
+        constexpr auto steps = static_cast<float>(1 << SnapshotCodec::ROTATION_BITS);
+
+        rotation = Math::Fmod(rotation, Math::TwoPi);
+        if (rotation < 0.0f) {
+            rotation += Math::TwoPi;
+        }
+
+        const auto value = static_cast<uint32_t>(rotation / Math::TwoPi * steps + 0.5f);
+        return value & ((1u << SnapshotCodec::ROTATION_BITS) - 1);
+    }
+
+    float dequantizeRotation(const uint32_t value) {
+        constexpr auto steps = static_cast<float>(1 << SnapshotCodec::ROTATION_BITS);
+        return static_cast<float>(value) * Math::TwoPi / steps;
+    }
+
+    uint32_t quantizeLife(const int life) {
+        constexpr int maxLife = (1 << SnapshotCodec::LIFE_BITS) - 1;
+        return static_cast<uint32_t>(Math::Clamp(life, 0, maxLife));
+    }
+
+    uint32_t quantizeTimer(const float timer) {
+        constexpr float maxTimer = static_cast<float>((1 << SnapshotCodec::TIMER_BITS) - 1) / SnapshotCodec::TIMER_SCALE;
+        return static_cast<uint32_t>(Math::Clamp(timer, 0.0f, maxTimer) * SnapshotCodec::TIMER_SCALE + 0.5f);
+    }
+
+    float dequantizeTimer(const uint32_t value) {
+        return static_cast<float>(value) / SnapshotCodec::TIMER_SCALE;
+    }
+
+    QuantizedShip quantize(const float x, const float y, const float rotation, const int life, const float timer) {
+        return {
+            quantizePosition(x, ShipSimulation::WORLD_WIDTH),
+            quantizePosition(y, ShipSimulation::WORLD_HEIGHT),
+            quantizeRotation(rotation),
+            quantizeLife(life),
+            quantizeTimer(timer)
+        };
+    }
+
+    QuantizedShip quantize(const RawState &state) {
+        return quantize(state.posX, state.posY, state.rotation, state.life, state.invulnerableTimer);
+    }
+
+    QuantizedShip quantize(const OtherState &state) {
+        return quantize(state.posX, state.posY, state.rotation, state.life, state.invulnerableTimer);
+    }
+
+    bool fitsPositionDelta(const uint32_t value, const uint32_t base) {
+        constexpr int limit = 1 << (SnapshotCodec::POSITION_DELTA_BITS - 1);
+        const int delta = static_cast<int>(value) - static_cast<int>(base);
+        return delta >= -limit && delta < limit;
+    }
+
+    void writePositionDelta(BitWriter &writer, const uint32_t value, const uint32_t base) {
+        constexpr int offset = 1 << (SnapshotCodec::POSITION_DELTA_BITS - 1);
+        const int delta = static_cast<int>(value) - static_cast<int>(base);
+        writer.WriteBits(static_cast<uint32_t>(delta + offset), SnapshotCodec::POSITION_DELTA_BITS);
+    }
+
+    uint32_t readPositionDelta(BitReader &reader, const uint32_t base) {
+        constexpr int offset = 1 << (SnapshotCodec::POSITION_DELTA_BITS - 1);
+        const int delta = static_cast<int>(reader.ReadBits(SnapshotCodec::POSITION_DELTA_BITS)) - offset;
+        return static_cast<uint32_t>(static_cast<int>(base) + delta);
+    }
+
+    // Each field group is preceded by a changed bit when there is a baseline,
+    // positions that moved a little are sent as a short signed delta
+    void writeShip(BitWriter &writer, const QuantizedShip &ship, const QuantizedShip *base) {
+        if (base == nullptr) {
+            writer.WriteBits(ship.posX, SnapshotCodec::POSITION_BITS);
+            writer.WriteBits(ship.posY, SnapshotCodec::POSITION_BITS);
+            writer.WriteBits(ship.rotation, SnapshotCodec::ROTATION_BITS);
+            writer.WriteBits(ship.life, SnapshotCodec::LIFE_BITS);
+            writer.WriteBits(ship.timer, SnapshotCodec::TIMER_BITS);
+            return;
+        }
+
+        const bool positionChanged = ship.posX != base->posX || ship.posY != base->posY;
+        writer.WriteBool(positionChanged);
+        if (positionChanged) {
+            const bool small = fitsPositionDelta(ship.posX, base->posX) && fitsPositionDelta(ship.posY, base->posY);
+            writer.WriteBool(small);
+            if (small) {
+                writePositionDelta(writer, ship.posX, base->posX);
+                writePositionDelta(writer, ship.posY, base->posY);
+            } else {
+                writer.WriteBits(ship.posX, SnapshotCodec::POSITION_BITS);
+                writer.WriteBits(ship.posY, SnapshotCodec::POSITION_BITS);
+            }
+        }
+
+        const bool rotationChanged = ship.rotation != base->rotation;
+        writer.WriteBool(rotationChanged);
+        if (rotationChanged) {
+            writer.WriteBits(ship.rotation, SnapshotCodec::ROTATION_BITS);
+        }
+
+        const bool vitalsChanged = ship.life != base->life || ship.timer != base->timer;
+        writer.WriteBool(vitalsChanged);
+        if (vitalsChanged) {
+            writer.WriteBits(ship.life, SnapshotCodec::LIFE_BITS);
+            writer.WriteBits(ship.timer, SnapshotCodec::TIMER_BITS);
+        }
+    }
+
+    QuantizedShip readShip(BitReader &reader, const QuantizedShip *base) {
+        QuantizedShip ship{};
+
+        if (base == nullptr) {
+            ship.posX = reader.ReadBits(SnapshotCodec::POSITION_BITS);
+            ship.posY = reader.ReadBits(SnapshotCodec::POSITION_BITS);
+            ship.rotation = reader.ReadBits(SnapshotCodec::ROTATION_BITS);
+            ship.life = reader.ReadBits(SnapshotCodec::LIFE_BITS);
+            ship.timer = reader.ReadBits(SnapshotCodec::TIMER_BITS);
+            return ship;
+        }
+
+        ship = *base;
+
+        if (reader.ReadBool()) {
+            if (reader.ReadBool()) {
+                ship.posX = readPositionDelta(reader, base->posX);
+                ship.posY = readPositionDelta(reader, base->posY);
+            } else {
+                ship.posX = reader.ReadBits(SnapshotCodec::POSITION_BITS);
+                ship.posY = reader.ReadBits(SnapshotCodec::POSITION_BITS);
+            }
+        }
+
+        if (reader.ReadBool()) {
+            ship.rotation = reader.ReadBits(SnapshotCodec::ROTATION_BITS);
+        }
+
+        if (reader.ReadBool()) {
+            ship.life = reader.ReadBits(SnapshotCodec::LIFE_BITS);
+            ship.timer = reader.ReadBits(SnapshotCodec::TIMER_BITS);
+        }
+
+        return ship;
+    }
+
+    // counters that only move forward, written as a short delta from the baseline
+    void writeCounter(BitWriter &writer, const uint32_t value, const uint32_t *baseValue) {
+        if (baseValue == nullptr) {
+            writer.WriteBits(value, 32);
+            return;
+        }
+
+        const uint32_t delta = value - *baseValue;
+        writer.WriteBool(delta != 0);
+        if (delta == 0) {
+            return;
+        }
+
+        const bool small = delta < (1u << SnapshotCodec::COUNTER_DELTA_BITS);
+        writer.WriteBool(small);
+        if (small) {
+            writer.WriteBits(delta, SnapshotCodec::COUNTER_DELTA_BITS);
+        } else {
+            writer.WriteBits(value, 32);
+        }
+    }
+
+    int findOtherState(const FullState *baseline, const int id) {
+        if (baseline == nullptr) {
+            return -1;
+        }
+
+        for (size_t i = 0; i < baseline->otherStateSize; i++) {
+            if (baseline->otherStates[i].id == id) {
+                return static_cast<int>(i);
+            }
+        }
+
+        return -1;
+    }
+
+    uint32_t readCounter(BitReader &reader, const uint32_t *baseValue) {
+        if (baseValue == nullptr) {
+            return reader.ReadBits(32);
+        }
+
+        if (!reader.ReadBool()) {
+            return *baseValue;
+        }
+
+        if (reader.ReadBool()) {
+            return *baseValue + reader.ReadBits(SnapshotCodec::COUNTER_DELTA_BITS);
+        }
+
+        return reader.ReadBits(32);
+    }
+}
+
+size_t SnapshotCodec::encode(
+    const FullState &state,
+    const uint16_t snapshotId,
+    const FullState *baseline,
+    const uint16_t baselineId,
+    void *buffer,
+    const size_t capacity,
+    size_t *otherStatesWritten
+) {
+    BitWriter writer(buffer, capacity);
+
+    writer.WriteBits(snapshotId, 16);
+    writer.WriteBool(baseline != nullptr);
+    if (baseline != nullptr) {
+        writer.WriteBits(baselineId, 16);
+    }
+
+    writeCounter(writer, state.serverTick, baseline != nullptr ? &baseline->serverTick : nullptr);
+    writeCounter(
+        writer,
+        state.lastConfirmedInputSequence,
+        baseline != nullptr ? &baseline->lastConfirmedInputSequence : nullptr
+    );
+
+    // player
+    const QuantizedShip raw = quantize(state.rawState);
+    QuantizedShip rawBase{};
+    if (baseline != nullptr) {
+        rawBase = quantize(baseline->rawState);
+    }
+
+    writer.WriteBool(state.rawState.active);
+    writeShip(writer, raw, baseline != nullptr ? &rawBase : nullptr);
+
+    // other players, each one preceded by a continuation bit and delta
+    // encoded against the entry with the same id in the baseline
+    const size_t othersSize = std::min(state.otherStateSize, static_cast<size_t>(MAX_OTHER_STATES));
+    const size_t capacityBits = capacity * 8;
+    size_t written = 0;
+
+    for (; written < othersSize; written++) {
+        if (writer.GetBitsWritten() + MAX_OTHER_STATE_BITS + 1 > capacityBits) {
+            break;
+        }
+
+        const OtherState &other = state.otherStates[written];
+        const int baselineIndex = findOtherState(baseline, other.id);
+
+        writer.WriteBool(true);
+        writer.WriteBool(baselineIndex >= 0);
+        if (baselineIndex >= 0) {
+            writer.WriteBits(static_cast<uint32_t>(baselineIndex), BASELINE_INDEX_BITS);
+        } else {
+            writer.WriteBits(static_cast<uint32_t>(other.id), 32);
+        }
+
+        QuantizedShip otherBase{};
+        if (baselineIndex >= 0) {
+            otherBase = quantize(baseline->otherStates[baselineIndex]);
+        }
+        writeShip(writer, quantize(other), baselineIndex >= 0 ? &otherBase : nullptr);
+    }
+    writer.WriteBool(false);
+
+    const size_t size = writer.Flush();
+    if (writer.HasOverflowed()) {
+        return 0;
+    }
+
+    *otherStatesWritten = written;
+    return size;
+}
+
+bool SnapshotCodec::decode(
+    const void *data,
+    const size_t size,
+    const SnapshotHistory &history,
+    FullState *state,
+    uint16_t *snapshotId
+) {
+    BitReader reader(data, size);
+
+    const auto id = static_cast<uint16_t>(reader.ReadBits(16));
+
+    const FullState *baseline = nullptr;
+    if (reader.ReadBool()) {
+        const auto baselineId = static_cast<uint16_t>(reader.ReadBits(16));
+        baseline = history.Find(baselineId);
+        if (baseline == nullptr) {
+            return false;
+        }
+    }
+
+    FullState decoded;
+    decoded.serverTick = readCounter(reader, baseline != nullptr ? &baseline->serverTick : nullptr);
+    decoded.lastConfirmedInputSequence = readCounter(
+        reader,
+        baseline != nullptr ? &baseline->lastConfirmedInputSequence : nullptr
+    );
+
+    // player
+    QuantizedShip rawBase{};
+    if (baseline != nullptr) {
+        rawBase = quantize(baseline->rawState);
+    }
+
+    decoded.rawState.active = reader.ReadBool();
+    const QuantizedShip raw = readShip(reader, baseline != nullptr ? &rawBase : nullptr);
+    decoded.rawState.posX = dequantizePosition(raw.posX);
+    decoded.rawState.posY = dequantizePosition(raw.posY);
+    decoded.rawState.rotation = dequantizeRotation(raw.rotation);
+    decoded.rawState.life = static_cast<int>(raw.life);
+    decoded.rawState.invulnerableTimer = dequantizeTimer(raw.timer);
+
+    // other players
+    size_t othersSize = 0;
+    while (reader.ReadBool()) {
+        if (othersSize >= MAX_OTHER_STATES) {
+            return false;
+        }
+
+        const OtherState *base = nullptr;
+        int id;
+        if (reader.ReadBool()) {
+            const size_t baselineIndex = reader.ReadBits(BASELINE_INDEX_BITS);
+            if (baseline == nullptr || baselineIndex >= baseline->otherStateSize) {
+                return false;
+            }
+            base = &baseline->otherStates[baselineIndex];
+            id = base->id;
+        } else {
+            id = static_cast<int>(reader.ReadBits(32));
+        }
+
+        OtherState &other = decoded.otherStates[othersSize++];
+        other.id = id;
+
+        QuantizedShip otherBase{};
+        if (base != nullptr) {
+            otherBase = quantize(*base);
+        }
+
+        const QuantizedShip ship = readShip(reader, base != nullptr ? &otherBase : nullptr);
+        other.posX = dequantizePosition(ship.posX);
+        other.posY = dequantizePosition(ship.posY);
+        other.rotation = dequantizeRotation(ship.rotation);
+        other.life = static_cast<int>(ship.life);
+        other.invulnerableTimer = dequantizeTimer(ship.timer);
+    }
+    decoded.otherStateSize = othersSize;
+
+    if (reader.HasOverflowed()) {
+        return false;
+    }
+
+    *state = decoded;
+    *snapshotId = id;
+    return true;
+}
+
+bool SnapshotCodec::peekId(const void *data, const size_t size, uint16_t *snapshotId) {
+    BitReader reader(data, size);
+    const auto id = static_cast<uint16_t>(reader.ReadBits(16));
+    if (reader.HasOverflowed()) {
+        return false;
+    }
+
+    *snapshotId = id;
+    return true;
+}
+
+bool SnapshotCodec::isNewer(const uint16_t snapshotId, const uint16_t otherId) {
+    return static_cast<int16_t>(snapshotId - otherId) > 0;
+}
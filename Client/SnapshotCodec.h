@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "DataObjects.h"
+
+// Recent snapshots indexed by id, the server keeps the ones it sent and the
+// client the ones it decoded so both sides can resolve the same baseline
+class SnapshotHistory {
+public:
+    SnapshotHistory() { Clear(); }
+
+    void Clear();
+    void Store(uint16_t snapshotId, const FullState &state);
+
+    // nullptr when the snapshot was never stored or was already overwritten
+    [[nodiscard]] const FullState *Find(uint16_t snapshotId) const;
+
+    // Baseline to delta encode snapshotId against, nullptr when the acked one
+    // is so old its entry may hold a newer snapshot. A full snapshot goes then.
+    [[nodiscard]] const FullState *FindBaseline(uint16_t snapshotId, uint16_t ackedId) const;
+
+    static constexpr size_t HISTORY_SIZE = 32;
+
+private:
+    struct Entry {
+        bool valid;
+        uint16_t snapshotId;
+        FullState state;
+    };
+
+    Entry mEntries[HISTORY_SIZE];
+};
+
+// Bit packed snapshots. Positions, rotations and timers are quantized and,
+// when a baseline is given, only the fields that differ from it are sent.
+namespace SnapshotCodec {
+    // 1/8 px over the world, 1920 * 8 and 1080 * 8 fit in 14 bits
+    constexpr float POSITION_SCALE = 8.0f;
+    constexpr int POSITION_BITS = 14;
+    constexpr int POSITION_DELTA_BITS = 10;
+    constexpr int ROTATION_BITS = 10;
+    constexpr int LIFE_BITS = 3;
+    // centiseconds, covers the 2s invulnerability window
+    constexpr float TIMER_SCALE = 100.0f;
+    constexpr int TIMER_BITS = 8;
+    constexpr int COUNTER_DELTA_BITS = 8;
+    constexpr int BASELINE_INDEX_BITS = 6;
+    constexpr int SHIP_BITS = POSITION_BITS * 2 + ROTATION_BITS + LIFE_BITS + TIMER_BITS;
+    // continuation bit, baseline bit, id and a full ship
+    constexpr int MAX_OTHER_STATE_BITS = 1 + 1 + 32 + SHIP_BITS;
+
+    static_assert(MAX_OTHER_STATES <= (1 << BASELINE_INDEX_BITS), "baseline index does not fit");
+
+    // Other states are written in order until the next one could overflow the
+    // capacity, callers sort them by priority. Returns the encoded size (0 when
+    // not even the player fits) and how many other states were written. A null
+    // baseline produces a full snapshot that decodes without any history.
+    size_t encode(
+        const FullState &state,
+        uint16_t snapshotId,
+        const FullState *baseline,
+        uint16_t baselineId,
+        void *buffer,
+        size_t capacity,
+        size_t *otherStatesWritten
+    );
+
+    // Fails on truncated data or when the referenced baseline is not in the history
+    bool decode(
+        const void *data,
+        size_t size,
+        const SnapshotHistory &history,
+        FullState *state,
+        uint16_t *snapshotId
+    );
+
+    // Id of an encoded snapshot without decoding it, false when truncated
+    bool peekId(const void *data, size_t size, uint16_t *snapshotId);
+
+    // Wrap around aware comparison of snapshot ids
+    bool isNewer(uint16_t snapshotId, uint16_t otherId);
+};
@@ -0,0 +1,515 @@
+#include "Bot.h"
+#include "../Network/Socket.h"
+#include "../Client/CommandRuns.h"
+#include "../Client/JitterBuffer.h"
+#include <algorithm>
+
+namespace {
+    float toMilliseconds(const std::chrono::steady_clock::duration duration) {
+        return std::chrono::duration<float, std::milli>(duration).count();
+    }
+
+    bool isSameAddress(const sockaddr_in &a, const sockaddr_in &b) {
+        return a.sin_addr.s_addr == b.sin_addr.s_addr && a.sin_port == b.sin_port;
+    }
+
+    bool isInWorld(const float x, const float y) {
+        // positions are quantized to 1/8 px, the wrap may round up to the edge
+        constexpr float slack = 1.0f / SnapshotCodec::POSITION_SCALE;
+        return x >= 0.0f && x <= ShipSimulation::WORLD_WIDTH + slack &&
+               y >= 0.0f && y <= ShipSimulation::WORLD_HEIGHT + slack;
+    }
+}
+
+Bot::Bot(const uint32_t id, const sockaddr_in &serverAddr, const InputScript &script)
+    : mId(id)
+      , mState(BotState::IDLE)
+      , mSocket(INVALID_SOCKET)
+      , mServerAddr(serverAddr)
+      , mFirstSynSequence(0)
+      , mAttempts(0)
+      , mTimeout(INITIAL_SYN_TIMEOUT)
+      , mSequence(0)
+      , mNonce(0)
+      , mIntegrityMode(IntegrityMode::ONES_COMPLEMENT)
+      , mSendBatch(Transport::MAX_FRAGMENTS)
+      , mTransportWriter(&mSendBatch)
+      , mHasSnapshot(false)
+      , mLastSnapshotId(0)
+      , mLastServerTick(0)
+      , mLastConfirmed(0)
+      , mAlive(false)
+      , mScript(script)
+      , mCommandSequence(0)
+{
+    mScript.Start(id);
+}
+
+bool Bot::Open() {
+    mSocket = create_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (mSocket == INVALID_SOCKET) {
+        return false;
+    }
+
+    if (socket_set_nonblocking(mSocket) < 0) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void Bot::Close() {
+    if (mSocket != INVALID_SOCKET) {
+        close_socket(mSocket);
+        mSocket = INVALID_SOCKET;
+    }
+}
+
+void Bot::StartConnection(const std::chrono::steady_clock::time_point now, LoadStats &stats) {
+    if (mState != BotState::IDLE) {
+        return;
+    }
+
+    // usually out of file descriptors, see RLIMIT_NOFILE
+    if (mSocket == INVALID_SOCKET && !Open()) {
+        mState = BotState::FAILED;
+        return;
+    }
+
+    // the nonce only has to differ between bots, the server replaces it anyway
+    mNonce = mId * 2654435761u;
+    mFirstSynSequence = static_cast<uint16_t>(mId);
+    mAttempts = 0;
+    mTimeout = INITIAL_SYN_TIMEOUT;
+    mState = BotState::CONNECTING;
+    SendSyn(now, stats);
+}
+
+void Bot::StartDisconnect(const std::chrono::steady_clock::time_point now, LoadStats &stats) {
+    if (mState == BotState::CONNECTING || mState == BotState::IDLE) {
+        mState = BotState::CLOSED;
+        return;
+    }
+
+    if (mState != BotState::CONNECTED) {
+        return;
+    }
+
+    mState = BotState::CLOSING;
+    mAttempts = 1;
+    mNextAttemptAt = now + END_TIMEOUT;
+    SendControl(Packet::END_FLAG, stats);
+}
+
+void Bot::SendSyn(const std::chrono::steady_clock::time_point now, LoadStats &stats) {
+    Packet packet(static_cast<uint16_t>(mFirstSynSequence + mAttempts), Packet::SYN_FLAG, mNonce);
+    uint8_t payload[Wire::size<SynPayload>()];
+    Wire::encode(SynPayload(Integrity::getSupportedModes()), payload, sizeof(payload));
+    packet.SetData(payload, sizeof(payload));
+    packet.BuildPacket(IntegrityMode::ONES_COMPLEMENT);
+
+    const size_t packetSize = Packet::PACKET_HEADER_BYTES + packet.GetLength();
+    if (SocketUtils::sendPacketToV4(mSocket, &packet, packetSize, &mServerAddr)) {
+        stats.datagramsOut++;
+        stats.bytesOut += packetSize;
+    }
+
+    mAttempts++;
+    mNextAttemptAt = now + mTimeout;
+}
+
+void Bot::SendControl(const uint8_t flag, LoadStats &stats) {
+    Packet packet(mSequence, flag, mNonce);
+    packet.BuildPacket(mIntegrityMode);
+
+    const size_t packetSize = Packet::PACKET_HEADER_BYTES + packet.GetLength();
+    if (SocketUtils::sendPacketToV4(mSocket, &packet, packetSize, &mServerAddr)) {
+        stats.datagramsOut++;
+        stats.bytesOut += packetSize;
+    }
+}
+
+void Bot::Receive(PacketBatch *batch, LoadStats &stats) {
+    size_t batchSize;
+    do {
+        batchSize = SocketUtils::receivePacketBatchFromV4(mSocket, batch);
+        const auto now = std::chrono::steady_clock::now();
+
+        for (size_t i = 0; i < batchSize; i++) {
+            if (!isSameAddress(batch->GetAddress(i), mServerAddr)) {
+                continue;
+            }
+
+            stats.datagramsIn++;
+            stats.bytesIn += batch->GetBytes(i);
+            HandleDatagram(batch->GetView(i), now, stats);
+        }
+    } while (batchSize == batch->GetCapacity());
+}
+
+void Bot::HandleDatagram(const PacketView &packet, const std::chrono::steady_clock::time_point now, LoadStats &stats) {
+    if (mState == BotState::CONNECTING) {
+        if (!packet.IsValid(IntegrityMode::ONES_COMPLEMENT)) {
+            return;
+        }
+
+        if (packet.GetFlag() == Packet::SYN_ACK_FLAG) {
+            HandleSynAck(packet, stats);
+        } else if (packet.GetFlag() == Packet::RST_FLAG) {
+            // another wire version
+            mState = BotState::REJECTED;
+        }
+        return;
+    }
+
+    if ((mState != BotState::CONNECTED && mState != BotState::CLOSING) || !packet.IsValid(mIntegrityMode)) {
+        return;
+    }
+
+    mConnectionStats.OnPacketReceived(Packet::PACKET_HEADER_BYTES + packet.GetLength());
+
+    Transport::Message message{};
+    mTransportReader.Begin(packet, now);
+    while (mTransportReader.Next(&message)) {
+        switch (message.flag) {
+            case Packet::DATA_FLAG:
+                if (mState == BotState::CONNECTED) {
+                    HandleData(message, now, stats);
+                }
+                break;
+            case Packet::RST_FLAG:
+                mState = BotState::REJECTED;
+                return;
+            case Packet::END_ACK_FLAG:
+                if (mState == BotState::CLOSING) {
+                    SendControl(Packet::ACK_FLAG, stats);
+                    mState = BotState::CLOSED;
+                }
+                return;
+            default:
+                break;
+        }
+    }
+}
+
+// Same checks and setup as Client::ReceiveSynAck and Client::ApplySynAck
+void Bot::HandleSynAck(const PacketView &packet, LoadStats &stats) {
+    const auto attempt = static_cast<uint16_t>(packet.GetSequence() - 1 - mFirstSynSequence);
+    if (attempt >= mAttempts) {
+        return;
+    }
+
+    mNonce = packet.GetNonce();
+    mSequence = packet.GetSequence();
+    mIntegrityMode = IntegrityMode::ONES_COMPLEMENT;
+    if (packet.GetLength() >= sizeof(uint8_t)) {
+        mIntegrityMode = Integrity::parseMode(*static_cast<const uint8_t *>(packet.GetData()));
+    }
+
+    SendControl(Packet::ACK_FLAG, stats);
+    mState = BotState::CONNECTED;
+    mNextSendAt = std::chrono::steady_clock::now();
+}
+
+// readServerData of ClientOperations, every newer snapshot is decoded
+void Bot::HandleData(const Transport::Message &message, const std::chrono::steady_clock::time_point now, LoadStats &stats) {
+    ServerDataHeader header;
+    const size_t headerSize = Wire::decode(message.data, message.size, &header);
+    if (headerSize == 0) {
+        return;
+    }
+
+    const uint8_t *body = message.data + headerSize;
+    const size_t bodySize = message.size - headerSize;
+
+    bool eventsAccepted;
+    const size_t eventsSize = mEventReceiver.Read(body, bodySize, &eventsAccepted);
+    if (eventsSize == 0) {
+        stats.decodeFailures++;
+        return;
+    }
+
+    if (eventsAccepted) {
+        mDownlinkAcks.Receive(message.sequence);
+    }
+
+    while (mEventReceiver.Peek()) {
+        mEventReceiver.Pop();
+        stats.events++;
+    }
+
+    if (mConnectionStats.OnAck(header, now)) {
+        stats.rtt.Add(mConnectionStats.GetLastRttSampleMs());
+    }
+
+    const uint8_t *encoded = body + eventsSize;
+    const size_t encodedSize = bodySize - eventsSize;
+
+    uint16_t snapshotId;
+    if (!SnapshotCodec::peekId(encoded, encodedSize, &snapshotId)) {
+        stats.decodeFailures++;
+        return;
+    }
+    mConnectionStats.OnSnapshot(snapshotId, now);
+
+    if (mHasSnapshot && !SnapshotCodec::isNewer(snapshotId, mLastSnapshotId)) {
+        return;
+    }
+
+    FullState state;
+    if (!SnapshotCodec::decode(encoded, encodedSize, mSnapshotHistory, &state, &snapshotId)) {
+        stats.decodeFailures++;
+        return;
+    }
+
+    ApplySnapshot(snapshotId, state, now, stats);
+}
+
+void Bot::ApplySnapshot(const uint16_t snapshotId, const FullState &state, const std::chrono::steady_clock::time_point now,
+    LoadStats &stats) {
+    stats.snapshots++;
+    if (mHasSnapshot) {
+        stats.snapshotInterval.Add(toMilliseconds(now - mLastSnapshotAt));
+    }
+
+    if (!IsPlausible(state)) {
+        stats.invalidSnapshots++;
+    }
+
+    mSnapshotHistory.Store(snapshotId, state);
+    mHasSnapshot = true;
+    mLastSnapshotId = snapshotId;
+    mLastSnapshotAt = now;
+    mLastServerTick = state.serverTick;
+    mLastConfirmed = std::max(mLastConfirmed, state.lastConfirmedInputSequence);
+
+    const RawState &raw = state.rawState;
+
+    // the server ignores the commands of a dead ship, nothing left to confirm
+    const bool wasAlive = mAlive;
+    mAlive = raw.active && raw.life > 0;
+    if (!mAlive) {
+        mCommands.clear();
+        mOutgoingCommands.clear();
+        return;
+    }
+
+    if (!wasAlive) {
+        // commands start once the bot knows where its ship is, again after a respawn
+        mPredictedState = ShipSimState();
+        mPredictedState.posX = raw.posX;
+        mPredictedState.posY = raw.posY;
+        mPredictedState.rotation = raw.rotation;
+        mPredictedState.life = raw.life;
+        return;
+    }
+
+    const auto confirmed = std::find_if(mCommands.begin(), mCommands.end(), [this](const PendingCommand &pending) {
+        return pending.command.sequence > mLastConfirmed;
+    });
+    if (confirmed == mCommands.begin()) {
+        return;
+    }
+
+    for (auto it = mCommands.begin(); it != confirmed; ++it) {
+        stats.inputLatency.Add(toMilliseconds(now - it->sentAt));
+    }
+
+    // the pose right after the last confirmed command must match the prediction
+    ShipSimState server = (confirmed - 1)->predicted;
+    server.posX = raw.posX;
+    server.posY = raw.posY;
+    server.rotation = raw.rotation;
+    const bool matched = ShipSimulation::nearlyEqual(
+        server,
+        (confirmed - 1)->predicted,
+        RECONCILE_POSITION_EPSILON,
+        RECONCILE_ROTATION_EPSILON
+    );
+    mCommands.erase(mCommands.begin(), confirmed);
+
+    mOutgoingCommands.erase(
+        std::remove_if(mOutgoingCommands.begin(), mOutgoingCommands.end(), [this](const Command &command) {
+            return command.sequence <= mLastConfirmed;
+        }),
+        mOutgoingCommands.end()
+    );
+
+    if (matched) {
+        return;
+    }
+
+    // replay the rest on top of the server pose like the client does
+    stats.mispredictions++;
+    for (auto &pending : mCommands) {
+        ShipSimulation::step(server, pending.command.inputData, SIM_DELTA_TIME);
+        pending.predicted = server;
+    }
+    server.laserCooldown = mPredictedState.laserCooldown;
+    mPredictedState = server;
+}
+
+// Decoding succeeded, these are values the server should never produce
+bool Bot::IsPlausible(const FullState &state) const {
+    const RawState &raw = state.rawState;
+    if (raw.life < 0 || raw.life > ShipSimulation::MAX_LIVES || !isInWorld(raw.posX, raw.posY)) {
+        return false;
+    }
+
+    if (state.otherStateSize > MAX_OTHER_STATES) {
+        return false;
+    }
+
+    for (size_t i = 0; i < state.otherStateSize; i++) {
+        const OtherState &other = state.otherStates[i];
+        if (other.life < 0 || other.life > ShipSimulation::MAX_LIVES || !isInWorld(other.posX, other.posY)) {
+            return false;
+        }
+    }
+
+    // a newer snapshot never goes back in time or confirms commands never sent
+    if (mHasSnapshot && static_cast<int32_t>(state.serverTick - mLastServerTick) < 0) {
+        return false;
+    }
+    return state.lastConfirmedInputSequence <= mCommandSequence;
+}
+
+void Bot::Tick(const std::chrono::steady_clock::time_point now, LoadStats &stats) {
+    switch (mState) {
+        case BotState::CONNECTING:
+            if (now < mNextAttemptAt) {
+                return;
+            }
+            if (mAttempts == MAX_SYN_ATTEMPTS) {
+                mState = BotState::FAILED;
+                return;
+            }
+            mTimeout = std::min(mTimeout * 2, MAX_SYN_TIMEOUT);
+            SendSyn(now, stats);
+            return;
+        case BotState::CLOSING:
+            if (now < mNextAttemptAt) {
+                return;
+            }
+            // the server drops the connection on its own timeout
+            if (mAttempts == MAX_END_ATTEMPTS) {
+                mState = BotState::CLOSED;
+                return;
+            }
+            mAttempts++;
+            mNextAttemptAt = now + END_TIMEOUT;
+            SendControl(Packet::END_FLAG, stats);
+            return;
+        case BotState::CONNECTED:
+            break;
+        default:
+            return;
+    }
+
+    bool newCommand = false;
+    if (mHasSnapshot && mAlive) {
+        // Client::AddInput, idle ticks are stepped but never sent
+        const InputData input = mScript.Next();
+        const bool idle = input.NoKeysActive();
+        if (!idle) {
+            mCommandSequence++;
+        }
+
+        ShipSimulation::step(mPredictedState, input, SIM_DELTA_TIME);
+
+        if (!idle) {
+            const Command command(mCommandSequence, input);
+            mCommands.push_back({command, mPredictedState, now});
+            mOutgoingCommands.push_back(command);
+            if (mOutgoingCommands.size() > CommandRuns::REDUNDANCY_WINDOW) {
+                mOutgoingCommands.erase(mOutgoingCommands.begin());
+            }
+            stats.commandsSent++;
+            newCommand = true;
+        }
+    }
+
+    if (newCommand || now >= mNextSendAt) {
+        SendUplink(now, stats);
+    }
+}
+
+// ClientOperations::sendDataToServer with the tick aligned uplink, or a ping
+void Bot::SendUplink(const std::chrono::steady_clock::time_point now, LoadStats &stats) {
+    uint8_t payload[PacketWriter::PAYLOAD_CAPACITY];
+    const bool hasCommands = !mOutgoingCommands.empty();
+
+    ClientDataHeader header(mHasSnapshot, mLastSnapshotId, hasCommands ? CommandFormat::RUNS : CommandFormat::COMMANDS);
+    if (mDownlinkAcks.HasReceived()) {
+        header.hasDownlinkAck = 1;
+        header.downlinkAckedSequence = mDownlinkAcks.GetNewest();
+        header.downlinkAckBits = mDownlinkAcks.GetBits();
+    }
+
+    // bots draw nothing, they claim the least delay a jitter buffer keeps
+    if (mHasSnapshot) {
+        header.hasViewTick = 1;
+        header.viewTick = mLastServerTick - static_cast<uint32_t>(JitterBuffer::MIN_DELAY_TICKS);
+    }
+    const size_t headerSize = Wire::encode(header, payload, sizeof(payload));
+
+    size_t commandsSize = 0;
+    if (hasCommands) {
+        commandsSize = CommandRuns::encode(
+            mOutgoingCommands.data(),
+            mOutgoingCommands.size(),
+            payload + headerSize,
+            CommandRuns::UPLINK_MTU_BYTES - Packet::PACKET_HEADER_BYTES - headerSize
+        );
+    }
+
+    const size_t bytes = mTransportWriter.Write(
+        mServerAddr,
+        mNonce,
+        mIntegrityMode,
+        hasCommands ? Packet::DATA_FLAG : Packet::PING_FLAG,
+        mSequence,
+        payload,
+        headerSize + commandsSize
+    );
+
+    mConnectionStats.OnPacketSent(mSequence, bytes, now);
+    mSequence++;
+    stats.bytesOut += bytes;
+    Flush(stats);
+
+    // with commands pending every tick sends, idle bots only ping
+    mNextSendAt = now + (hasCommands ? std::chrono::steady_clock::duration::zero() : IDLE_SEND_INTERVAL);
+}
+
+void Bot::Flush(LoadStats &stats) {
+    mTransportWriter.Seal();
+    stats.datagramsOut += SocketUtils::sendPacketBatchToV4(mSocket, &mSendBatch);
+}
+
+void Bot::Report(const std::chrono::steady_clock::time_point now, LoadStats &stats) {
+    switch (mState) {
+        case BotState::CONNECTING:
+            stats.connecting++;
+            break;
+        case BotState::CONNECTED:
+            stats.connected++;
+            break;
+        case BotState::FAILED:
+            stats.failed++;
+            break;
+        case BotState::REJECTED:
+            stats.rejected++;
+            break;
+        default:
+            break;
+    }
+
+    // the report keeps totals, only what moved since the last one is added
+    const ConnectionReport report = mConnectionStats.BuildReport(now);
+    stats.uplinkSent += report.uplinkSent - mReported.uplinkSent;
+    stats.uplinkLost += report.uplinkLost - mReported.uplinkLost;
+    stats.downlinkReceived += report.downlinkReceived - mReported.downlinkReceived;
+    stats.downlinkLost += report.downlinkLost - mReported.downlinkLost;
+    mReported = report;
+}
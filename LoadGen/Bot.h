@@ -0,0 +1,129 @@
+#pragma once
+
+#include "../Network/Platforms.h"
+#include "../Network/Packet.h"
+#include "../Network/PacketBatch.h"
+#include "../Network/AckWindow.h"
+#include "../Network/ReliableChannel.h"
+#include "../Network/Transport.h"
+#include "../Client/DataObjects.h"
+#include "../Client/SnapshotCodec.h"
+#include "../Client/ShipSimulation.h"
+#include "../Client/ConnectionStats.h"
+#include "InputScript.h"
+#include "LoadStats.h"
+#include <chrono>
+#include <vector>
+
+enum class BotState {
+    IDLE,
+    CONNECTING,
+    CONNECTED,
+    // no SYN_ACK after every attempt
+    FAILED,
+    // the server answered with RST, usually every match is full
+    REJECTED,
+    CLOSING,
+    CLOSED,
+};
+
+// One simulated player. Speaks the protocol of the game client's network
+// thread: the SYN/SYN_ACK/ACK handshake, the tick aligned uplink with run
+// length encoded commands, snapshot and event acks. It predicts its own ship
+// with ShipSimulation to check the server against it. Bots are driven by a
+// LoadWorker thread and record straight into its LoadStats.
+class Bot {
+public:
+    Bot(uint32_t id, const sockaddr_in &serverAddr, const InputScript &script);
+
+    // Each bot needs its own socket, the server tells clients apart by address
+    bool Open();
+    void Close();
+
+    // Opens the socket when needed, FAILED when it cannot
+    void StartConnection(std::chrono::steady_clock::time_point now, LoadStats &stats);
+    void StartDisconnect(std::chrono::steady_clock::time_point now, LoadStats &stats);
+
+    // Drains the socket through the worker's batch
+    void Receive(PacketBatch *batch, LoadStats &stats);
+    // One simulation tick: handshake retries, the next command and the uplink
+    void Tick(std::chrono::steady_clock::time_point now, LoadStats &stats);
+
+    // Adds the bot's state and the loss counters moved since the last call
+    void Report(std::chrono::steady_clock::time_point now, LoadStats &stats);
+
+    [[nodiscard]] SocketType GetSocket() const { return mSocket; }
+    [[nodiscard]] BotState GetState() const { return mState; }
+    [[nodiscard]] bool IsDone() const {
+        return mState == BotState::CLOSED || mState == BotState::FAILED || mState == BotState::REJECTED;
+    }
+
+    // Must match Game::SIM_DELTA_TIME, the worker ticks the bots at this rate
+    static constexpr float SIM_DELTA_TIME = 1.0f / 60.0f;
+    // Same handshake and uplink timings as the game client
+    static constexpr int MAX_SYN_ATTEMPTS = 10;
+    static constexpr auto INITIAL_SYN_TIMEOUT = std::chrono::milliseconds(200);
+    static constexpr auto MAX_SYN_TIMEOUT = std::chrono::milliseconds(2000);
+    static constexpr auto IDLE_SEND_INTERVAL = std::chrono::milliseconds(100);
+    static constexpr auto END_TIMEOUT = std::chrono::milliseconds(200);
+    static constexpr int MAX_END_ATTEMPTS = 5;
+    static constexpr float RECONCILE_POSITION_EPSILON = 0.5f;
+    static constexpr float RECONCILE_ROTATION_EPSILON = 0.01f;
+
+private:
+    struct PendingCommand {
+        Command command;
+        ShipSimState predicted;
+        std::chrono::steady_clock::time_point sentAt;
+    };
+
+    void SendSyn(std::chrono::steady_clock::time_point now, LoadStats &stats);
+    void SendControl(uint8_t flag, LoadStats &stats);
+    void HandleDatagram(const PacketView &packet, std::chrono::steady_clock::time_point now, LoadStats &stats);
+    void HandleSynAck(const PacketView &packet, LoadStats &stats);
+    void HandleData(const Transport::Message &message, std::chrono::steady_clock::time_point now, LoadStats &stats);
+    void ApplySnapshot(uint16_t snapshotId, const FullState &state, std::chrono::steady_clock::time_point now,
+        LoadStats &stats);
+    [[nodiscard]] bool IsPlausible(const FullState &state) const;
+    void SendUplink(std::chrono::steady_clock::time_point now, LoadStats &stats);
+    void Flush(LoadStats &stats);
+
+    uint32_t mId;
+    BotState mState;
+    SocketType mSocket;
+    sockaddr_in mServerAddr;
+
+    // handshake and teardown
+    uint16_t mFirstSynSequence;
+    int mAttempts;
+    std::chrono::milliseconds mTimeout;
+    std::chrono::steady_clock::time_point mNextAttemptAt;
+
+    uint16_t mSequence;
+    uint32_t mNonce;
+    IntegrityMode mIntegrityMode;
+    PacketBatch mSendBatch;
+    TransportWriter mTransportWriter;
+    TransportReader mTransportReader;
+
+    // downlink
+    SnapshotHistory mSnapshotHistory;
+    bool mHasSnapshot;
+    uint16_t mLastSnapshotId;
+    uint32_t mLastServerTick;
+    uint32_t mLastConfirmed;
+    bool mAlive;
+    std::chrono::steady_clock::time_point mLastSnapshotAt;
+    AckWindow mDownlinkAcks;
+    ReliableReceiver mEventReceiver;
+    ConnectionStats mConnectionStats;
+    ConnectionReport mReported;
+
+    // uplink, commands kept for prediction until the server confirms them
+    InputScript mScript;
+    uint32_t mCommandSequence;
+    ShipSimState mPredictedState;
+    std::vector<PendingCommand> mCommands;
+    std::vector<Command> mOutgoingCommands;
+    std::chrono::steady_clock::time_point mNextSendAt;
+};
@@ -0,0 +1,100 @@
+#include "InputScript.h"
+#include <cstdio>
+#include <cstring>
+
+bool InputScript::Load(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        return false;
+    }
+
+    mSteps.clear();
+    char line[256];
+    bool valid = true;
+    while (valid && fgets(line, sizeof(line), file)) {
+        if (char *comment = strchr(line, '#')) {
+            *comment = '\0';
+        }
+
+        char *token = strtok(line, " \t\r\n");
+        if (!token) {
+            continue;
+        }
+
+        Step step{};
+        step.ticks = static_cast<uint32_t>(strtoul(token, nullptr, 10));
+        valid = step.ticks > 0;
+
+        while (valid && (token = strtok(nullptr, " \t\r\n"))) {
+            if (strcmp(token, "W") == 0) {
+                step.input.SetKeyActive(KeyValue::MOVE_FORWARD);
+            } else if (strcmp(token, "A") == 0) {
+                step.input.SetKeyActive(KeyValue::MOVE_LEFT);
+            } else if (strcmp(token, "S") == 0) {
+                step.input.SetKeyActive(KeyValue::MOVE_BACKWARD);
+            } else if (strcmp(token, "D") == 0) {
+                step.input.SetKeyActive(KeyValue::MOVE_RIGHT);
+            } else if (strcmp(token, "SPACE") == 0) {
+                step.input.SetKeyActive(KeyValue::SHOOT);
+            } else {
+                valid = false;
+            }
+        }
+
+        mSteps.push_back(step);
+    }
+    fclose(file);
+
+    if (!valid) {
+        mSteps.clear();
+    }
+    return valid && !mSteps.empty();
+}
+
+void InputScript::Start(const uint32_t seed) {
+    mGenerator.seed(seed);
+    mTicksLeft = 0;
+    mStep = mSteps.empty() ? 0 : seed % mSteps.size();
+}
+
+InputData InputScript::Next() {
+    if (mTicksLeft == 0) {
+        Step step;
+        if (mSteps.empty()) {
+            step = RandomStep();
+        } else {
+            step = mSteps[mStep];
+            mStep = (mStep + 1) % mSteps.size();
+        }
+
+        mCurrent = step.input;
+        mTicksLeft = step.ticks;
+    }
+
+    mTicksLeft--;
+    return mCurrent;
+}
+
+// One movement direction at most, like a player holding a single arrow, and
+// idle now and then
+InputScript::Step InputScript::RandomStep() {
+    static constexpr KeyValue MOVES[] = {
+        KeyValue::NONE,
+        KeyValue::MOVE_FORWARD,
+        KeyValue::MOVE_BACKWARD,
+        KeyValue::MOVE_LEFT,
+        KeyValue::MOVE_RIGHT,
+    };
+
+    std::uniform_int_distribution<uint32_t> ticks(MIN_RANDOM_TICKS, MAX_RANDOM_TICKS);
+    std::uniform_int_distribution<size_t> move(0, sizeof(MOVES) / sizeof(MOVES[0]) - 1);
+    std::uniform_int_distribution<uint32_t> percent(0, 99);
+
+    Step step{};
+    step.ticks = ticks(mGenerator);
+    step.input.SetKeyActive(MOVES[move(mGenerator)]);
+    if (percent(mGenerator) < RANDOM_SHOOT_PERCENT) {
+        step.input.SetKeyActive(KeyValue::SHOOT);
+    }
+    return step;
+}
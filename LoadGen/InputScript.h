@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "../Client/InputData.h"
+
+// Keys held by a bot on every simulation tick, what SDLInputParser would read
+// from a player. A script is a list of steps played in a loop, each step holds
+// its keys for a number of ticks. Without a script the steps are random.
+class InputScript {
+public:
+    struct Step {
+        uint32_t ticks;
+        InputData input;
+    };
+
+    // Script file, one step per line: "<ticks> [W] [A] [S] [D] [SPACE]",
+    // a step without keys is idle and '#' starts a comment
+    bool Load(const char *path);
+    [[nodiscard]] bool IsScripted() const { return !mSteps.empty(); }
+
+    // Start a bot on its own position of the script so bots do not move in lockstep
+    void Start(uint32_t seed);
+    InputData Next();
+
+    // random steps last between these many ticks
+    static constexpr uint32_t MIN_RANDOM_TICKS = 10;
+    static constexpr uint32_t MAX_RANDOM_TICKS = 90;
+    // chance of a random step holding SHOOT, in percent
+    static constexpr uint32_t RANDOM_SHOOT_PERCENT = 30;
+
+private:
+    Step RandomStep();
+
+    std::vector<Step> mSteps;
+    size_t mStep = 0;
+    uint32_t mTicksLeft = 0;
+    InputData mCurrent;
+    std::mt19937 mGenerator;
+};
@@ -0,0 +1,114 @@
+#include "LoadStats.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+    float toPercent(const uint64_t part, const uint64_t total) {
+        return total > 0 ? 100.0f * static_cast<float>(part) / static_cast<float>(total) : 0.0f;
+    }
+
+    float perSecond(const uint64_t value, const float seconds) {
+        return seconds > 0.0f ? static_cast<float>(value) / seconds : 0.0f;
+    }
+}
+
+void LatencyHistogram::Clear() {
+    memset(mBuckets, 0, sizeof(mBuckets));
+    mCount = 0;
+    mMaxMs = 0.0f;
+}
+
+void LatencyHistogram::Add(const float ms) {
+    const float clamped = std::max(ms, 0.0f);
+    const auto bucket = std::min(static_cast<size_t>(clamped), BUCKETS - 1);
+    mBuckets[bucket]++;
+    mCount++;
+    mMaxMs = std::max(mMaxMs, clamped);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram &other) {
+    for (size_t i = 0; i < BUCKETS; i++) {
+        mBuckets[i] += other.mBuckets[i];
+    }
+    mCount += other.mCount;
+    mMaxMs = std::max(mMaxMs, other.mMaxMs);
+}
+
+float LatencyHistogram::GetPercentileMs(const float fraction) const {
+    if (mCount == 0) {
+        return 0.0f;
+    }
+
+    const auto target = static_cast<uint64_t>(fraction * static_cast<float>(mCount - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS - 1; i++) {
+        seen += mBuckets[i];
+        if (seen >= target) {
+            return static_cast<float>(i + 1);
+        }
+    }
+    return mMaxMs;
+}
+
+void LoadStats::Merge(const LoadStats &other) {
+    connecting += other.connecting;
+    connected += other.connected;
+    failed += other.failed;
+    rejected += other.rejected;
+
+    datagramsOut += other.datagramsOut;
+    datagramsIn += other.datagramsIn;
+    bytesOut += other.bytesOut;
+    bytesIn += other.bytesIn;
+    commandsSent += other.commandsSent;
+
+    snapshots += other.snapshots;
+    decodeFailures += other.decodeFailures;
+    invalidSnapshots += other.invalidSnapshots;
+    mispredictions += other.mispredictions;
+    events += other.events;
+
+    uplinkSent += other.uplinkSent;
+    uplinkLost += other.uplinkLost;
+    downlinkReceived += other.downlinkReceived;
+    downlinkLost += other.downlinkLost;
+
+    rtt.Merge(other.rtt);
+    inputLatency.Merge(other.inputLatency);
+    snapshotInterval.Merge(other.snapshotInterval);
+}
+
+void LoadStats::Print(const char *label, const float seconds, const size_t totalBots) const {
+    const auto printLatency = [](const char *name, const LatencyHistogram &histogram) {
+        printf("  %-17s p50 %4.0f  p90 %4.0f  p99 %4.0f  max %6.1f ms (%llu samples)\n",
+            name,
+            histogram.GetPercentileMs(0.5f),
+            histogram.GetPercentileMs(0.9f),
+            histogram.GetPercentileMs(0.99f),
+            histogram.GetMaxMs(),
+            static_cast<unsigned long long>(histogram.GetCount()));
+    };
+
+    printf("%s over %.1f s: %u/%zu connected, %u connecting, %u failed, %u rejected\n",
+        label, seconds, connected, totalBots, connecting, failed, rejected);
+    printf("  out %.0f pkt/s %.1f KB/s, in %.0f pkt/s %.1f KB/s, %.0f commands/s\n",
+        perSecond(datagramsOut, seconds),
+        perSecond(bytesOut, seconds) / 1024.0f,
+        perSecond(datagramsIn, seconds),
+        perSecond(bytesIn, seconds) / 1024.0f,
+        perSecond(commandsSent, seconds));
+    printf("  snapshots %.0f/s (%.1f per bot), decode failures %llu, invalid %llu, mispredicted %llu, events %llu\n",
+        perSecond(snapshots, seconds),
+        connected > 0 ? perSecond(snapshots, seconds) / static_cast<float>(connected) : 0.0f,
+        static_cast<unsigned long long>(decodeFailures),
+        static_cast<unsigned long long>(invalidSnapshots),
+        static_cast<unsigned long long>(mispredictions),
+        static_cast<unsigned long long>(events));
+    printf("  loss up %.2f%% down %.2f%%\n",
+        toPercent(uplinkLost, uplinkSent),
+        toPercent(downlinkLost, downlinkReceived + downlinkLost));
+    printLatency("rtt", rtt);
+    printLatency("input latency", inputLatency);
+    printLatency("snapshot interval", snapshotInterval);
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Millisecond resolution histogram, merged across workers to get percentiles
+// over every bot instead of averages of per bot numbers
+class LatencyHistogram {
+public:
+    LatencyHistogram() { Clear(); }
+
+    void Clear();
+    void Add(float ms);
+    void Merge(const LatencyHistogram &other);
+
+    // Upper bound of the bucket holding the given fraction of the samples, 0 without samples
+    [[nodiscard]] float GetPercentileMs(float fraction) const;
+    [[nodiscard]] float GetMaxMs() const { return mMaxMs; }
+    [[nodiscard]] uint64_t GetCount() const { return mCount; }
+
+    // the last bucket holds everything above
+    static constexpr size_t BUCKETS = 2001;
+
+private:
+    uint32_t mBuckets[BUCKETS];
+    uint64_t mCount;
+    float mMaxMs;
+};
+
+// Counters of a group of bots over one interval, workers publish theirs and
+// the main thread sums them up
+struct LoadStats {
+    // bots by handshake outcome, these are current counts and not rates
+    uint32_t connecting = 0;
+    uint32_t connected = 0;
+    uint32_t failed = 0;
+    uint32_t rejected = 0;
+
+    uint64_t datagramsOut = 0;
+    uint64_t datagramsIn = 0;
+    uint64_t bytesOut = 0;
+    uint64_t bytesIn = 0;
+    uint64_t commandsSent = 0;
+
+    uint64_t snapshots = 0;
+    uint64_t decodeFailures = 0;
+    // decoded fine but carried impossible values
+    uint64_t invalidSnapshots = 0;
+    // server pose differed from the local prediction of the same command
+    uint64_t mispredictions = 0;
+    uint64_t events = 0;
+
+    // from ConnectionStats, see ConnectionReport
+    uint64_t uplinkSent = 0;
+    uint64_t uplinkLost = 0;
+    uint64_t downlinkReceived = 0;
+    uint64_t downlinkLost = 0;
+
+    // server acks of the bot packets, hold time on the server taken out
+    LatencyHistogram rtt;
+    // from sending a command to the first snapshot confirming it
+    LatencyHistogram inputLatency;
+    // between snapshots of the same bot, stretches when the server misses ticks
+    LatencyHistogram snapshotInterval;
+
+    void Merge(const LoadStats &other);
+    // Rates use the interval length, the bot counts are taken as they are
+    void Print(const char *label, float seconds, size_t totalBots) const;
+};
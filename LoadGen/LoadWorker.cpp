@@ -0,0 +1,202 @@
+#include "LoadWorker.h"
+#include "../Network/Logger.h"
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <algorithm>
+
+LoadWorker::LoadWorker(const LoadConfig &config, const InputScript &script, const size_t index)
+:mConfig(config)
+,mIndex(index)
+,mStarted(0)
+,mEpollFd(-1)
+,mTimerFd(-1)
+,mIsRunning(false)
+,mReceiveBatch(RECEIVE_BATCH_CAPACITY)
+{
+    for (size_t id = index; id < config.bots; id += config.threads) {
+        mBots.push_back(std::make_unique<Bot>(static_cast<uint32_t>(id + config.seed), config.serverAddr, script));
+    }
+}
+
+LoadWorker::~LoadWorker() {
+    Stop();
+}
+
+bool LoadWorker::Start(const std::chrono::steady_clock::time_point startAt) {
+    mTimerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+    if (mTimerFd < 0) {
+        Logger::sysLogExit("create tick timer");
+    }
+
+    const auto tickIntervalNs = static_cast<long>(Bot::SIM_DELTA_TIME * 1e9f);
+    itimerspec interval{};
+    interval.it_interval.tv_nsec = tickIntervalNs;
+    interval.it_value.tv_nsec = tickIntervalNs;
+    if (timerfd_settime(mTimerFd, 0, &interval, nullptr) < 0) {
+        Logger::sysLogExit("start tick timer");
+    }
+
+    mEpollFd = epoll_create1(0);
+    if (mEpollFd < 0) {
+        Logger::sysLogExit("create epoll");
+    }
+
+    epoll_event timerEvent{};
+    timerEvent.events = EPOLLIN;
+    timerEvent.data.u64 = 0;
+    if (epoll_ctl(mEpollFd, EPOLL_CTL_ADD, mTimerFd, &timerEvent) < 0) {
+        Logger::sysLogExit("register epoll events");
+    }
+
+    mStartAt = startAt;
+    mNextPublish = startAt + PUBLISH_INTERVAL;
+    mIsRunning = true;
+    mThread = std::thread(&LoadWorker::Run, this);
+    return true;
+}
+
+void LoadWorker::Stop() {
+    mIsRunning = false;
+    if (mThread.joinable()) {
+        mThread.join();
+    }
+
+    for (const auto &bot : mBots) {
+        bot->Close();
+    }
+
+    if (mEpollFd >= 0) {
+        close(mEpollFd);
+        mEpollFd = -1;
+    }
+
+    if (mTimerFd >= 0) {
+        close(mTimerFd);
+        mTimerFd = -1;
+    }
+}
+
+LoadStats LoadWorker::TakeStats() {
+    std::lock_guard lock(mPublishedMutex);
+    LoadStats stats = mPublished;
+
+    // the bot counts are a state and stay until the next publish
+    mPublished = LoadStats();
+    mPublished.connecting = stats.connecting;
+    mPublished.connected = stats.connected;
+    mPublished.failed = stats.failed;
+    mPublished.rejected = stats.rejected;
+    return stats;
+}
+
+void LoadWorker::Run() {
+    epoll_event events[MAX_EPOLL_EVENTS];
+    bool stopping = false;
+    std::chrono::steady_clock::time_point stopDeadline;
+
+    while (true) {
+        auto now = std::chrono::steady_clock::now();
+        if (!stopping && !mIsRunning) {
+            stopping = true;
+            stopDeadline = now + STOP_TIMEOUT;
+            for (const auto &bot : mBots) {
+                bot->StartDisconnect(now, mStats);
+            }
+        }
+
+        if (stopping) {
+            const bool done = std::all_of(mBots.begin(), mBots.end(), [](const std::unique_ptr<Bot> &bot) {
+                return bot->IsDone();
+            });
+            if (done || now >= stopDeadline) {
+                break;
+            }
+        }
+
+        const int eventsSize = epoll_wait(mEpollFd, events, MAX_EPOLL_EVENTS, static_cast<int>(PUBLISH_INTERVAL.count()));
+        if (eventsSize < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            Logger::sysLogExit("epoll wait");
+        }
+
+        for (int i = 0; i < eventsSize; i++) {
+            if (events[i].data.u64 != 0) {
+                mBots[events[i].data.u64 - 1]->Receive(&mReceiveBatch, mStats);
+                continue;
+            }
+
+            uint64_t expirations = 0;
+            if (read(mTimerFd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+                continue;
+            }
+
+            // same catch up rule as the server, a stalled worker skips ticks
+            const uint64_t ticks = std::min<uint64_t>(expirations, MAX_TICKS_PER_WAKEUP);
+            now = std::chrono::steady_clock::now();
+            for (uint64_t t = 0; t < ticks; t++) {
+                Tick(now);
+            }
+        }
+
+        now = std::chrono::steady_clock::now();
+        if (now >= mNextPublish) {
+            Publish(now);
+            mNextPublish = now + PUBLISH_INTERVAL;
+        }
+    }
+
+    Publish(std::chrono::steady_clock::now());
+}
+
+void LoadWorker::Tick(const std::chrono::steady_clock::time_point now) {
+    // bot id n connects n / ramp seconds after the start, whichever worker owns it
+    while (mStarted < mBots.size() && mIsRunning) {
+        const size_t id = mIndex + mStarted * mConfig.threads;
+        if (mConfig.rampPerSecond > 0.0f) {
+            const auto delay = std::chrono::duration<float>(static_cast<float>(id) / mConfig.rampPerSecond);
+            if (now < mStartAt + std::chrono::duration_cast<std::chrono::steady_clock::duration>(delay)) {
+                break;
+            }
+        }
+
+        Bot &bot = *mBots[mStarted];
+        mStarted++;
+        bot.StartConnection(now, mStats);
+        if (bot.GetSocket() == INVALID_SOCKET) {
+            continue;
+        }
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = mStarted;
+        if (epoll_ctl(mEpollFd, EPOLL_CTL_ADD, bot.GetSocket(), &event) < 0) {
+            Logger::sysLogExit("register epoll events");
+        }
+    }
+
+    for (const auto &bot : mBots) {
+        bot->Tick(now, mStats);
+    }
+}
+
+void LoadWorker::Publish(const std::chrono::steady_clock::time_point now) {
+    mStats.connecting = 0;
+    mStats.connected = 0;
+    mStats.failed = 0;
+    mStats.rejected = 0;
+    for (const auto &bot : mBots) {
+        bot->Report(now, mStats);
+    }
+
+    {
+        std::lock_guard lock(mPublishedMutex);
+        mPublished.Merge(mStats);
+        mPublished.connecting = mStats.connecting;
+        mPublished.connected = mStats.connected;
+        mPublished.failed = mStats.failed;
+        mPublished.rejected = mStats.rejected;
+    }
+    mStats = LoadStats();
+}
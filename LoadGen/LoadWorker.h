@@ -0,0 +1,71 @@
+#pragma once
+
+#include "../Network/PacketBatch.h"
+#include "Bot.h"
+#include "LoadStats.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct LoadConfig {
+    sockaddr_in serverAddr;
+    size_t bots;
+    size_t threads;
+    // new connections per second, spread across every worker
+    float rampPerSecond;
+    int durationSeconds;
+    int statsIntervalSeconds;
+    uint32_t seed;
+};
+
+// Thread driving a slice of the bots. One epoll waits on every bot socket and
+// on a timerfd ticking at the simulation rate, so hundreds of bots share a few
+// threads instead of one each.
+class LoadWorker {
+public:
+    // Worker i of n drives the bots i, i + n, i + 2n... so the ramp stays even
+    LoadWorker(const LoadConfig &config, const InputScript &script, size_t index);
+    ~LoadWorker();
+
+    bool Start(std::chrono::steady_clock::time_point startAt);
+    // Disconnects every bot and waits for the thread
+    void Stop();
+
+    // Counters published since the last call
+    LoadStats TakeStats();
+
+    static constexpr size_t RECEIVE_BATCH_CAPACITY = 16;
+    static constexpr int MAX_EPOLL_EVENTS = 64;
+    static constexpr int MAX_TICKS_PER_WAKEUP = 4;
+    static constexpr auto PUBLISH_INTERVAL = std::chrono::milliseconds(100);
+    // bots still closing after this are left to the server's timeout
+    static constexpr auto STOP_TIMEOUT = std::chrono::seconds(1);
+
+private:
+    void Run();
+    void Tick(std::chrono::steady_clock::time_point now);
+    void Publish(std::chrono::steady_clock::time_point now);
+
+    LoadConfig mConfig;
+    size_t mIndex;
+    std::vector<std::unique_ptr<Bot>> mBots;
+    size_t mStarted;
+    std::chrono::steady_clock::time_point mStartAt;
+
+    int mEpollFd;
+    int mTimerFd;
+    std::thread mThread;
+    std::atomic<bool> mIsRunning;
+    PacketBatch mReceiveBatch;
+
+    // written by the worker only
+    LoadStats mStats;
+    std::chrono::steady_clock::time_point mNextPublish;
+
+    // handed to the main thread
+    std::mutex mPublishedMutex;
+    LoadStats mPublished;
+};
@@ -0,0 +1,175 @@
+#include "LoadWorker.h"
+#include "../Network/Addresses.h"
+#include "../Network/Defs.h"
+#include <sys/resource.h>
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static std::atomic<bool> sIsRunning(true);
+
+static void HandleSignal(int) {
+    sIsRunning = false;
+}
+
+static void PrintUsage(const char *program) {
+    printf("Usage: %s [options]\n", program);
+    printf("  --server IP[:PORT]     server under load (default 127.0.0.1:%d)\n", APP_PORT);
+    printf("  --bots N               simulated players (default 100)\n");
+    printf("  --threads N            worker threads sharing the bots (default 2)\n");
+    printf("  --ramp PER_SECOND      new connections per second, 0 all at once (default 50)\n");
+    printf("  --duration SECONDS     run time, 0 until interrupted (default 0)\n");
+    printf("  --stats SECONDS        statistics interval, 0 only at exit (default 5)\n");
+    printf("  --seed N               seed of the random inputs (default 1)\n");
+    printf("  --script FILE          play this input script instead of random inputs\n");
+}
+
+// Every bot holds a socket, the default soft limit of 1024 is not enough
+static void RaiseFileLimit(const size_t bots) {
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) < 0 || limit.rlim_cur >= limit.rlim_max) {
+        return;
+    }
+
+    limit.rlim_cur = limit.rlim_max;
+    if (setrlimit(RLIMIT_NOFILE, &limit) < 0 || limit.rlim_cur < bots + 16) {
+        printf("Warning: file limit %llu may be too low for %zu bots\n",
+            static_cast<unsigned long long>(limit.rlim_cur), bots);
+    }
+}
+
+int main(const int argc, char **argv) {
+    networkingInit();
+
+    LoadConfig config{};
+    config.bots = 100;
+    config.threads = 2;
+    config.rampPerSecond = 50.0f;
+    config.durationSeconds = 0;
+    config.statsIntervalSeconds = 5;
+    config.seed = 1;
+    Addresses::parseAddrV4(&config.serverAddr, "127.0.0.1", APP_PORT);
+    const char *scriptPath = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--", 2) != 0 || i + 1 >= argc) {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+
+        const char *name = argv[i] + 2;
+        const char *value = argv[++i];
+
+        bool valid = true;
+        if (strcmp(name, "server") == 0) {
+            valid = Addresses::parseEndpointV4(&config.serverAddr, value, APP_PORT);
+        } else if (strcmp(name, "bots") == 0) {
+            config.bots = strtoul(value, nullptr, 10);
+        } else if (strcmp(name, "threads") == 0) {
+            config.threads = strtoul(value, nullptr, 10);
+            valid = config.threads > 0;
+        } else if (strcmp(name, "ramp") == 0) {
+            config.rampPerSecond = static_cast<float>(atof(value));
+        } else if (strcmp(name, "duration") == 0) {
+            config.durationSeconds = atoi(value);
+        } else if (strcmp(name, "stats") == 0) {
+            config.statsIntervalSeconds = atoi(value);
+        } else if (strcmp(name, "seed") == 0) {
+            config.seed = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+        } else if (strcmp(name, "script") == 0) {
+            scriptPath = value;
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    InputScript script;
+    if (scriptPath && !script.Load(scriptPath)) {
+        printf("Could not read input script %s\n", scriptPath);
+        return 1;
+    }
+
+    config.threads = std::max<size_t>(1, std::min(config.threads, config.bots));
+    RaiseFileLimit(config.bots);
+
+    std::signal(SIGINT, HandleSignal);
+    std::signal(SIGTERM, HandleSignal);
+
+    char server[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &config.serverAddr.sin_addr, server, sizeof(server));
+    printf("Load on %s:%d: %zu bots on %zu threads, %.0f connections/s, %s inputs\n",
+        server, ntohs(config.serverAddr.sin_port), config.bots, config.threads, config.rampPerSecond,
+        script.IsScripted() ? "scripted" : "random");
+
+    std::vector<std::unique_ptr<LoadWorker>> workers;
+    for (size_t i = 0; i < config.threads; i++) {
+        workers.push_back(std::make_unique<LoadWorker>(config, script, i));
+    }
+
+    const auto startAt = std::chrono::steady_clock::now();
+    for (const auto &worker : workers) {
+        worker->Start(startAt);
+    }
+
+    const auto takeStats = [&workers](LoadStats &stats) {
+        for (const auto &worker : workers) {
+            stats.Merge(worker->TakeStats());
+        }
+    };
+
+    const auto secondsSince = [](const std::chrono::steady_clock::time_point since) {
+        return std::chrono::duration<float>(std::chrono::steady_clock::now() - since).count();
+    };
+
+    LoadStats total;
+    auto intervalStart = startAt;
+    auto nextStats = startAt + std::chrono::seconds(config.statsIntervalSeconds);
+    const auto endAt = startAt + std::chrono::seconds(config.durationSeconds);
+
+    while (sIsRunning) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        const auto now = std::chrono::steady_clock::now();
+
+        if (config.statsIntervalSeconds > 0 && now >= nextStats) {
+            LoadStats interval;
+            takeStats(interval);
+            interval.Print("interval", secondsSince(intervalStart), config.bots);
+            total.Merge(interval);
+            intervalStart = now;
+            nextStats = now + std::chrono::seconds(config.statsIntervalSeconds);
+        }
+
+        if (config.durationSeconds > 0 && now >= endAt) {
+            break;
+        }
+    }
+
+    // bot counts as they were under load, not after the disconnects
+    LoadStats underLoad;
+    takeStats(underLoad);
+    const float seconds = secondsSince(startAt);
+    for (const auto &worker : workers) {
+        worker->Stop();
+    }
+
+    LoadStats closing;
+    takeStats(closing);
+    total.Merge(underLoad);
+    total.Merge(closing);
+    total.connecting = underLoad.connecting;
+    total.connected = underLoad.connected;
+    total.failed = underLoad.failed;
+    total.rejected = underLoad.rejected;
+    total.Print("total", seconds, config.bots);
+
+    networkingCleanup();
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include "LinkSimulator.h"
+#include <algorithm>
+
+namespace {
+    LinkSimulator::Clock::duration fromMs(const double ms) {
+        return std::chrono::duration_cast<LinkSimulator::Clock::duration>(std::chrono::duration<double, std::milli>(ms));
+    }
+}
+
+LinkSimulator::LinkSimulator(const LinkConditions &conditions, const uint32_t seed)
+:mConditions(conditions)
+,mGenerator(seed)
+,mUnit(0.0f, 1.0f)
+{
+}
+
+size_t LinkSimulator::Schedule(const size_t bytes, const Clock::time_point now, Clock::time_point deliveries[2]) {
+    mStats.received++;
+    mStats.receivedBytes += bytes;
+
+    if (Roll(mConditions.lossPercent)) {
+        mStats.lost++;
+        return 0;
+    }
+
+    // serialization on a rate limited link, the packet waits for the ones ahead of it
+    Clock::time_point departure = now;
+    if (mConditions.bandwidthKbps > 0) {
+        departure = std::max(now, mLinkFreeAt);
+        if (departure - now > fromMs(mConditions.maxQueueMs)) {
+            mStats.queueDrops++;
+            return 0;
+        }
+
+        const double transmitMs = static_cast<double>(bytes) * 8.0 / mConditions.bandwidthKbps;
+        mLinkFreeAt = departure + fromMs(transmitMs);
+        departure = mLinkFreeAt;
+    }
+
+    const float jitter = (mUnit(mGenerator) * 2.0f - 1.0f) * mConditions.jitterMs;
+    Clock::time_point delivery = departure + fromMs(std::max(0.0f, mConditions.latencyMs + jitter));
+
+    if (Roll(mConditions.reorderPercent)) {
+        mStats.reordered++;
+        delivery += fromMs(mConditions.reorderDelayMs);
+    } else {
+        // jitter alone never swaps packets, like a real queue
+        delivery = std::max(delivery, mLastDelivery);
+        mLastDelivery = delivery;
+    }
+
+    deliveries[0] = delivery;
+    if (Roll(mConditions.duplicatePercent)) {
+        mStats.duplicated++;
+        deliveries[1] = delivery;
+        return 2;
+    }
+
+    return 1;
+}
+
+void LinkSimulator::OnDelivered(const size_t bytes, const Clock::duration delay) {
+    const double delayMs = std::chrono::duration<double, std::milli>(delay).count();
+
+    mStats.delivered++;
+    mStats.deliveredBytes += bytes;
+    mStats.delaySumMs += delayMs;
+    mStats.maxDelayMs = std::max(mStats.maxDelayMs, delayMs);
+}
+
+bool LinkSimulator::Roll(const float percent) {
+    const float value = mUnit(mGenerator) * 100.0f;
+    return value < percent;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+// Impairments applied to one direction of a flow
+struct LinkConditions {
+    float latencyMs = 0.0f;
+    // uniform in [-jitter, +jitter], order is kept unless a packet is picked for reordering
+    float jitterMs = 0.0f;
+    float lossPercent = 0.0f;
+    float duplicatePercent = 0.0f;
+    float reorderPercent = 0.0f;
+    // extra hold applied to reordered packets so later ones overtake them
+    float reorderDelayMs = 20.0f;
+    // 0 disables the cap
+    uint32_t bandwidthKbps = 0;
+    // packets that would wait longer than this for the link are tail dropped
+    float maxQueueMs = 500.0f;
+};
+
+struct LinkStats {
+    uint64_t received = 0;
+    uint64_t receivedBytes = 0;
+    uint64_t delivered = 0;
+    uint64_t deliveredBytes = 0;
+    uint64_t lost = 0;
+    uint64_t duplicated = 0;
+    uint64_t reordered = 0;
+    uint64_t queueDrops = 0;
+    double delaySumMs = 0.0;
+    double maxDelayMs = 0.0;
+};
+
+// Seeded model of a lossy, jittery, rate limited link. Every decision comes
+// from the link's own generator, so a run with the same seed and the same
+// traffic makes the same decisions.
+class LinkSimulator {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    LinkSimulator(const LinkConditions &conditions, uint32_t seed);
+
+    // Decides the fate of one datagram, fills the delivery times and returns
+    // how many copies leave the link (0 when dropped, 2 when duplicated)
+    size_t Schedule(size_t bytes, Clock::time_point now, Clock::time_point deliveries[2]);
+    void OnDelivered(size_t bytes, Clock::duration delay);
+    // A scheduled copy that never left, the proxy ran out of in flight slots
+    void OnDropped() { mStats.queueDrops++; }
+
+    [[nodiscard]] const LinkStats &GetStats() const { return mStats; }
+
+    static constexpr size_t MAX_COPIES = 2;
+
+private:
+    [[nodiscard]] bool Roll(float percent);
+
+    LinkConditions mConditions;
+    std::mt19937 mGenerator;
+    std::uniform_real_distribution<float> mUnit;
+    Clock::time_point mLinkFreeAt;
+    Clock::time_point mLastDelivery;
+    LinkStats mStats;
+};
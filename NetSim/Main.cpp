@@ -0,0 +1,120 @@
+#include "Proxy.h"
+#include "../Network/Addresses.h"
+#include "../Network/Defs.h"
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static Proxy *sProxy = nullptr;
+
+static void HandleSignal(int) {
+    if (sProxy) {
+        sProxy->Quit();
+    }
+}
+
+static void PrintUsage(const char *program) {
+    printf("Usage: %s [options]\n", program);
+    printf("  --listen PORT          port the clients connect to (default %d)\n", NETSIM_PORT);
+    printf("  --server IP[:PORT]     server behind the proxy (default 127.0.0.1:%d)\n", APP_PORT);
+    printf("  --seed N               seed of every random decision (default 1)\n");
+    printf("  --stats SECONDS        per flow statistics interval, 0 only at exit (default 5)\n");
+    printf("Link options apply to both directions, prefix them with up- or down- for one:\n");
+    printf("  --latency MS  --jitter MS  --loss PCT  --duplicate PCT\n");
+    printf("  --reorder PCT  --reorder-delay MS  --bandwidth KBPS  --queue MS\n");
+}
+
+// Applies a link option to the uplink, the downlink or both
+static bool ParseLinkOption(const char *name, const char *value, ProxyConfig &config) {
+    LinkConditions *links[2] = {&config.uplink, &config.downlink};
+    size_t first = 0;
+    size_t last = 2;
+
+    if (strncmp(name, "up-", 3) == 0) {
+        name += 3;
+        last = 1;
+    } else if (strncmp(name, "down-", 5) == 0) {
+        name += 5;
+        first = 1;
+    }
+
+    const auto number = static_cast<float>(atof(value));
+    for (size_t i = first; i < last; i++) {
+        LinkConditions &link = *links[i];
+
+        if (strcmp(name, "latency") == 0) {
+            link.latencyMs = number;
+        } else if (strcmp(name, "jitter") == 0) {
+            link.jitterMs = number;
+        } else if (strcmp(name, "loss") == 0) {
+            link.lossPercent = number;
+        } else if (strcmp(name, "duplicate") == 0) {
+            link.duplicatePercent = number;
+        } else if (strcmp(name, "reorder") == 0) {
+            link.reorderPercent = number;
+        } else if (strcmp(name, "reorder-delay") == 0) {
+            link.reorderDelayMs = number;
+        } else if (strcmp(name, "bandwidth") == 0) {
+            link.bandwidthKbps = static_cast<uint32_t>(atoi(value));
+        } else if (strcmp(name, "queue") == 0) {
+            link.maxQueueMs = number;
+        } else {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(const int argc, char **argv) {
+    networkingInit();
+
+    ProxyConfig config{};
+    config.listenPort = NETSIM_PORT;
+    config.seed = 1;
+    config.statsIntervalSeconds = 5;
+    Addresses::parseAddrV4(&config.serverAddr, "127.0.0.1", APP_PORT);
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--", 2) != 0 || i + 1 >= argc) {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+
+        const char *name = argv[i] + 2;
+        const char *value = argv[++i];
+
+        bool valid = true;
+        if (strcmp(name, "listen") == 0) {
+            config.listenPort = static_cast<uint16_t>(atoi(value));
+        } else if (strcmp(name, "server") == 0) {
+            valid = Addresses::parseEndpointV4(&config.serverAddr, value, APP_PORT);
+        } else if (strcmp(name, "seed") == 0) {
+            config.seed = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+        } else if (strcmp(name, "stats") == 0) {
+            config.statsIntervalSeconds = atoi(value);
+        } else {
+            valid = ParseLinkOption(name, value, config);
+        }
+
+        if (!valid) {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    Proxy proxy(config);
+    sProxy = &proxy;
+
+    std::signal(SIGINT, HandleSignal);
+    std::signal(SIGTERM, HandleSignal);
+
+    if (proxy.Initialize()) {
+        proxy.RunLoop();
+    }
+    proxy.Shutdown();
+
+    networkingCleanup();
+    return 0;
+}
@@ -0,0 +1,271 @@
+#include "Proxy.h"
+#include "../Network/Socket.h"
+#include "../Network/Logger.h"
+#include <sys/epoll.h>
+#include <algorithm>
+#include <cstdio>
+
+Proxy::Proxy(const ProxyConfig &config)
+:mConfig(config)
+,mSocket(INVALID_SOCKET)
+,mEpollFd(-1)
+,mIsRunning(false)
+,mReceiveBatch(RECEIVE_BATCH_CAPACITY)
+,mSlots(MAX_IN_FLIGHT)
+,mNextOrder(0)
+{
+    mFreeSlots.reserve(MAX_IN_FLIGHT);
+    for (size_t i = MAX_IN_FLIGHT; i > 0; i--) {
+        mFreeSlots.push_back(i - 1);
+    }
+}
+
+bool Proxy::Initialize() {
+    mSocket = SocketUtils::createSocketV4();
+    SocketUtils::bindSocketToPortV4(mSocket, mConfig.listenPort);
+    SocketUtils::setSocketNonBlocking(mSocket);
+
+    mEpollFd = epoll_create1(0);
+    if (mEpollFd < 0) {
+        Logger::sysLogExit("create epoll");
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = 0;
+    if (epoll_ctl(mEpollFd, EPOLL_CTL_ADD, mSocket, &event) < 0) {
+        Logger::sysLogExit("register epoll events");
+    }
+
+    char server[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &mConfig.serverAddr.sin_addr, server, sizeof(server));
+    printf("Proxy listening on %d, forwarding to %s:%d (seed %u)\n",
+        mConfig.listenPort, server, ntohs(mConfig.serverAddr.sin_port), mConfig.seed);
+
+    mIsRunning = true;
+    return true;
+}
+
+void Proxy::RunLoop() {
+    epoll_event events[MAX_EPOLL_EVENTS];
+    auto nextStats = std::chrono::steady_clock::now() + std::chrono::seconds(mConfig.statsIntervalSeconds);
+
+    while (mIsRunning) {
+        const int ready = epoll_wait(mEpollFd, events, MAX_EPOLL_EVENTS, GetWaitMs());
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            Logger::sysLogExit("epoll wait");
+        }
+
+        for (int i = 0; i < ready; i++) {
+            if (events[i].data.u64 == 0) {
+                ReceiveFromClients();
+            } else {
+                ReceiveFromServer(static_cast<size_t>(events[i].data.u64 - 1));
+            }
+        }
+
+        DeliverDue();
+
+        if (const auto now = std::chrono::steady_clock::now(); mConfig.statsIntervalSeconds > 0 && now >= nextStats) {
+            PrintStats();
+            RemoveIdleFlows();
+            nextStats = now + std::chrono::seconds(mConfig.statsIntervalSeconds);
+        }
+    }
+}
+
+void Proxy::Shutdown() {
+    PrintStats();
+
+    for (auto &flow : mFlows) {
+        if (flow.active) {
+            close_socket(flow.upstream);
+            flow.active = false;
+        }
+    }
+
+    if (mEpollFd >= 0) {
+        close(mEpollFd);
+        mEpollFd = -1;
+    }
+
+    if (mSocket != INVALID_SOCKET) {
+        close_socket(mSocket);
+        mSocket = INVALID_SOCKET;
+    }
+
+    printf("Proxy shutdown\n");
+}
+
+void Proxy::PrintStats() const {
+    const auto printLink = [](const char *name, const LinkStats &stats) {
+        const double averageDelay = stats.delivered > 0 ? stats.delaySumMs / static_cast<double>(stats.delivered) : 0.0;
+        printf("  %s rx %llu (%llu B) tx %llu (%llu B) lost %llu dup %llu reorder %llu queue %llu delay avg %.1f max %.1f ms\n",
+            name,
+            static_cast<unsigned long long>(stats.received),
+            static_cast<unsigned long long>(stats.receivedBytes),
+            static_cast<unsigned long long>(stats.delivered),
+            static_cast<unsigned long long>(stats.deliveredBytes),
+            static_cast<unsigned long long>(stats.lost),
+            static_cast<unsigned long long>(stats.duplicated),
+            static_cast<unsigned long long>(stats.reordered),
+            static_cast<unsigned long long>(stats.queueDrops),
+            averageDelay,
+            stats.maxDelayMs);
+    };
+
+    for (size_t i = 0; i < mFlows.size(); i++) {
+        const ProxyFlow &flow = mFlows[i];
+        char client[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &flow.clientAddr.sin_addr, client, sizeof(client));
+
+        printf("flow %zu %s:%d%s\n", i, client, ntohs(flow.clientAddr.sin_port), flow.active ? "" : " (closed)");
+        printLink("up  ", flow.uplink.GetStats());
+        printLink("down", flow.downlink.GetStats());
+    }
+}
+
+void Proxy::ReceiveFromClients() {
+    size_t batchSize;
+    do {
+        batchSize = SocketUtils::receivePacketBatchFromV4(mSocket, &mReceiveBatch);
+        for (size_t i = 0; i < batchSize; i++) {
+            const size_t flowIndex = FindOrCreateFlow(mReceiveBatch.GetAddress(i));
+            Enqueue(flowIndex, Direction::UPLINK, mReceiveBatch.GetBuffer(i), mReceiveBatch.GetBytes(i));
+        }
+    } while (batchSize == mReceiveBatch.GetCapacity());
+}
+
+void Proxy::ReceiveFromServer(const size_t flowIndex) {
+    ProxyFlow &flow = mFlows[flowIndex];
+    if (!flow.active) {
+        return;
+    }
+
+    size_t batchSize;
+    do {
+        batchSize = SocketUtils::receivePacketBatchFromV4(flow.upstream, &mReceiveBatch);
+        for (size_t i = 0; i < batchSize; i++) {
+            Enqueue(flowIndex, Direction::DOWNLINK, mReceiveBatch.GetBuffer(i), mReceiveBatch.GetBytes(i));
+        }
+    } while (batchSize == mReceiveBatch.GetCapacity());
+}
+
+void Proxy::Enqueue(const size_t flowIndex, const Direction direction, const uint8_t *bytes, const size_t size) {
+    ProxyFlow &flow = mFlows[flowIndex];
+    LinkSimulator &link = direction == Direction::UPLINK ? flow.uplink : flow.downlink;
+
+    const auto now = std::chrono::steady_clock::now();
+    flow.lastPacketTime = now;
+
+    std::chrono::steady_clock::time_point deliveries[LinkSimulator::MAX_COPIES];
+    const size_t copies = link.Schedule(size, now, deliveries);
+
+    for (size_t c = 0; c < copies; c++) {
+        if (mFreeSlots.empty()) {
+            link.OnDropped();
+            continue;
+        }
+
+        const size_t slot = mFreeSlots.back();
+        mFreeSlots.pop_back();
+        std::copy_n(bytes, size, mSlots[slot].bytes);
+
+        mDeliveries.push({deliveries[c], now, mNextOrder++, slot, size, flowIndex, direction});
+    }
+}
+
+void Proxy::DeliverDue() {
+    const auto now = std::chrono::steady_clock::now();
+
+    while (!mDeliveries.empty() && mDeliveries.top().deliverAt <= now) {
+        const Delivery delivery = mDeliveries.top();
+        mDeliveries.pop();
+
+        ProxyFlow &flow = mFlows[delivery.flow];
+        if (flow.active) {
+            const uint8_t *bytes = mSlots[delivery.slot].bytes;
+
+            if (delivery.direction == Direction::UPLINK) {
+                SocketUtils::sendBytesToV4(flow.upstream, bytes, delivery.bytes, &mConfig.serverAddr);
+                flow.uplink.OnDelivered(delivery.bytes, now - delivery.receivedAt);
+            } else {
+                SocketUtils::sendBytesToV4(mSocket, bytes, delivery.bytes, &flow.clientAddr);
+                flow.downlink.OnDelivered(delivery.bytes, now - delivery.receivedAt);
+            }
+        }
+
+        mFreeSlots.push_back(delivery.slot);
+    }
+}
+
+void Proxy::RemoveIdleFlows() {
+    const auto now = std::chrono::steady_clock::now();
+    const auto timeout = std::chrono::milliseconds(FLOW_TIMEOUT_MS);
+
+    for (auto &flow : mFlows) {
+        if (!flow.active || now - flow.lastPacketTime <= timeout) {
+            continue;
+        }
+
+        epoll_ctl(mEpollFd, EPOLL_CTL_DEL, flow.upstream, nullptr);
+        close_socket(flow.upstream);
+        flow.active = false;
+        mFlowIndex.erase(GetAddressKey(flow.clientAddr));
+    }
+}
+
+int Proxy::GetWaitMs() const {
+    if (mDeliveries.empty()) {
+        return MAX_WAIT_MS;
+    }
+
+    // rounded up, waking early would only spin until the delivery is due
+    const auto untilDue = mDeliveries.top().deliverAt - std::chrono::steady_clock::now();
+    const auto waitMs = std::chrono::ceil<std::chrono::milliseconds>(untilDue).count();
+    return static_cast<int>(std::clamp<long long>(waitMs, 0, MAX_WAIT_MS));
+}
+
+size_t Proxy::FindOrCreateFlow(const sockaddr_in &addr) {
+    const uint64_t key = GetAddressKey(addr);
+    if (const auto it = mFlowIndex.find(key); it != mFlowIndex.end()) {
+        return it->second;
+    }
+
+    // each flow and direction draws from its own generator, derived from the run seed
+    const size_t index = mFlows.size();
+    const auto flowSeed = mConfig.seed + static_cast<uint32_t>(index) * 2;
+
+    ProxyFlow flow{
+        true,
+        addr,
+        SocketUtils::createSocketV4(),
+        LinkSimulator(mConfig.uplink, flowSeed),
+        LinkSimulator(mConfig.downlink, flowSeed + 1),
+        std::chrono::steady_clock::now()
+    };
+    SocketUtils::setSocketNonBlocking(flow.upstream);
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = index + 1;
+    if (epoll_ctl(mEpollFd, EPOLL_CTL_ADD, flow.upstream, &event) < 0) {
+        Logger::sysLogExit("register epoll events");
+    }
+
+    mFlows.push_back(flow);
+    mFlowIndex.emplace(key, index);
+
+    char client[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &addr.sin_addr, client, sizeof(client));
+    printf("New flow %zu from %s:%d\n", index, client, ntohs(addr.sin_port));
+
+    return index;
+}
+
+uint64_t Proxy::GetAddressKey(const sockaddr_in &addr) {
+    return (static_cast<uint64_t>(addr.sin_addr.s_addr) << 16) | addr.sin_port;
+}
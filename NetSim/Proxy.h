@@ -0,0 +1,96 @@
+#pragma once
+
+#include "../Network/Platforms.h"
+#include "../Network/PacketBatch.h"
+#include "LinkSimulator.h"
+#include <atomic>
+#include <chrono>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+struct ProxyConfig {
+    uint16_t listenPort;
+    sockaddr_in serverAddr;
+    uint32_t seed;
+    LinkConditions uplink;
+    LinkConditions downlink;
+    int statsIntervalSeconds;
+};
+
+// One client address and the upstream socket that stands for it on the server
+struct ProxyFlow {
+    bool active;
+    sockaddr_in clientAddr;
+    SocketType upstream;
+    LinkSimulator uplink;
+    LinkSimulator downlink;
+    std::chrono::steady_clock::time_point lastPacketTime;
+};
+
+// Loopback UDP proxy between clients and a server. Every datagram goes
+// through the link model of its direction and waits in a delivery queue.
+class Proxy {
+public:
+    explicit Proxy(const ProxyConfig &config);
+    ~Proxy() = default;
+
+    bool Initialize();
+    void RunLoop();
+    void Shutdown();
+    void Quit() { mIsRunning = false; }
+
+    void PrintStats() const;
+
+    static constexpr size_t RECEIVE_BATCH_CAPACITY = 64;
+    static constexpr size_t MAX_IN_FLIGHT = 8192;
+    static constexpr int MAX_EPOLL_EVENTS = 16;
+    static constexpr int MAX_WAIT_MS = 100;
+    static constexpr int FLOW_TIMEOUT_MS = 30000;
+
+private:
+    enum class Direction : uint8_t {
+        UPLINK,
+        DOWNLINK,
+    };
+
+    struct Delivery {
+        std::chrono::steady_clock::time_point deliverAt;
+        std::chrono::steady_clock::time_point receivedAt;
+        uint64_t order;
+        size_t slot;
+        size_t bytes;
+        size_t flow;
+        Direction direction;
+
+        // earliest first, arrival order breaks ties
+        bool operator>(const Delivery &other) const {
+            return deliverAt != other.deliverAt ? deliverAt > other.deliverAt : order > other.order;
+        }
+    };
+
+    void ReceiveFromClients();
+    void ReceiveFromServer(size_t flowIndex);
+    void Enqueue(size_t flowIndex, Direction direction, const uint8_t *bytes, size_t size);
+    void DeliverDue();
+    void RemoveIdleFlows();
+    int GetWaitMs() const;
+    size_t FindOrCreateFlow(const sockaddr_in &addr);
+
+    static uint64_t GetAddressKey(const sockaddr_in &addr);
+
+    ProxyConfig mConfig;
+    SocketType mSocket;
+    int mEpollFd;
+    std::atomic<bool> mIsRunning;
+    PacketBatch mReceiveBatch;
+
+    std::vector<ProxyFlow> mFlows;
+    std::unordered_map<uint64_t, size_t> mFlowIndex;
+
+    // packets waiting on the simulated links, stored in preallocated slots
+    std::vector<PacketBuffer> mSlots;
+    std::vector<size_t> mFreeSlots;
+    std::priority_queue<Delivery, std::vector<Delivery>, std::greater<>> mDeliveries;
+    uint64_t mNextOrder;
+};
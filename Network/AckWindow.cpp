@@ -0,0 +1,55 @@
+#include "AckWindow.h"
+
+void AckWindow::Clear() {
+    mHasReceived = false;
+    mNewest = 0;
+    mBits = 0;
+}
+
+bool AckWindow::Receive(const uint16_t sequence) {
+    if (!mHasReceived) {
+        mHasReceived = true;
+        mNewest = sequence;
+        mBits = 0;
+        return true;
+    }
+
+    if (isNewer(sequence, mNewest)) {
+        // the old newest becomes one of the bits, everything shifts by the gap
+        const uint16_t shift = static_cast<uint16_t>(sequence - mNewest);
+        if (shift > WINDOW_SIZE) {
+            mBits = 0;
+        } else {
+            mBits = shift == WINDOW_SIZE ? 0 : mBits << shift;
+            mBits |= 1u << (shift - 1);
+        }
+        mNewest = sequence;
+        return true;
+    }
+
+    const uint16_t age = static_cast<uint16_t>(mNewest - sequence);
+    if (age == 0 || age > WINDOW_SIZE) {
+        return false;
+    }
+
+    const uint32_t bit = 1u << (age - 1);
+    if (mBits & bit) {
+        return false;
+    }
+
+    mBits |= bit;
+    return true;
+}
+
+bool AckWindow::isAcked(const uint16_t sequence, const uint16_t newest, const uint32_t bits) {
+    if (sequence == newest) {
+        return true;
+    }
+
+    const uint16_t age = static_cast<uint16_t>(newest - sequence);
+    return age <= WINDOW_SIZE && (bits & (1u << (age - 1))) != 0;
+}
+
+bool AckWindow::isNewer(const uint16_t sequence, const uint16_t than) {
+    return static_cast<int16_t>(sequence - than) > 0;
+}
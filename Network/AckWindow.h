@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+// Newest sequence received plus a bitfield of the 32 before it, bit n is set
+// when sequence newest - 1 - n also arrived. Sequences wrap around at 16 bits.
+class AckWindow {
+public:
+    AckWindow() { Clear(); }
+
+    void Clear();
+
+    // False for duplicates and sequences older than the window
+    bool Receive(uint16_t sequence);
+
+    [[nodiscard]] bool HasReceived() const { return mHasReceived; }
+    [[nodiscard]] uint16_t GetNewest() const { return mNewest; }
+    [[nodiscard]] uint32_t GetBits() const { return mBits; }
+
+    // True when an ack with this newest sequence and bitfield covers the sequence
+    static bool isAcked(uint16_t sequence, uint16_t newest, uint32_t bits);
+    static bool isNewer(uint16_t sequence, uint16_t than);
+
+    static constexpr uint16_t WINDOW_SIZE = 32;
+
+private:
+    bool mHasReceived;
+    uint16_t mNewest;
+    uint32_t mBits;
+};
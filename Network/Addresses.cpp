@@ -2,6 +2,8 @@
 // Created by pedro-souza on 24/11/2025.
 //
 #include "Addresses.h"
+#include <cstdlib>
+#include <cstring>
 
 void Addresses::initAddrAnyV4(sockaddr_in *addr4, const unsigned int port) {
     addr4->sin_family = AF_INET;
@@ -20,4 +22,28 @@ bool Addresses::parseAddrV4(sockaddr_in *addr, const char *addrStr, const uint16
     addr->sin_port = htons(port);
 
     return true;
-}
\ No newline at end of file
+}
+
+bool Addresses::parseEndpointV4(sockaddr_in *addr, const char *endpointStr, const uint16_t defaultPort) {
+    const char *colon = strchr(endpointStr, ':');
+    if (colon == nullptr) {
+        return parseAddrV4(addr, endpointStr, defaultPort);
+    }
+
+    char ip[INET_ADDRSTRLEN];
+    const auto ipSize = static_cast<size_t>(colon - endpointStr);
+    if (ipSize >= sizeof(ip)) {
+        return false;
+    }
+
+    memcpy(ip, endpointStr, ipSize);
+    ip[ipSize] = '\0';
+
+    char *end = nullptr;
+    const long port = strtol(colon + 1, &end, 10);
+    if (end == colon + 1 || *end != '\0' || port <= 0 || port > 65535) {
+        return false;
+    }
+
+    return parseAddrV4(addr, ip, static_cast<uint16_t>(port));
+}
@@ -8,4 +8,6 @@
 namespace Addresses {
     void initAddrAnyV4(sockaddr_in *addr4, unsigned int port);
     bool parseAddrV4(sockaddr_in *addr, const char *addrStr, uint16_t port);
+    // "ip" or "ip:port", the default port is used when none is given
+    bool parseEndpointV4(sockaddr_in *addr, const char *endpointStr, uint16_t defaultPort);
 };
\ No newline at end of file
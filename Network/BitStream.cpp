@@ -0,0 +1,79 @@
+#include "BitStream.h"
+
+BitWriter::BitWriter(void *buffer, const size_t capacity)
+:mBuffer(static_cast<uint8_t *>(buffer))
+,mCapacity(capacity)
+,mBytesWritten(0)
+,mScratch(0)
+,mScratchBits(0)
+,mOverflowed(false)
+{}
+
+void BitWriter::WriteBits(const uint32_t value, const int bits) {
+    if (bits <= 0 || bits > 32) {
+        return;
+    }
+
+    const uint64_t mask = (static_cast<uint64_t>(1) << bits) - 1;
+    mScratch |= (static_cast<uint64_t>(value) & mask) << mScratchBits;
+    mScratchBits += bits;
+
+    while (mScratchBits >= 8) {
+        if (mBytesWritten >= mCapacity) {
+            mOverflowed = true;
+            mScratch = 0;
+            mScratchBits = 0;
+            return;
+        }
+
+        mBuffer[mBytesWritten++] = static_cast<uint8_t>(mScratch & 0xFF);
+        mScratch >>= 8;
+        mScratchBits -= 8;
+    }
+}
+
+size_t BitWriter::Flush() {
+    if (mScratchBits > 0) {
+        if (mBytesWritten >= mCapacity) {
+            mOverflowed = true;
+        } else {
+            mBuffer[mBytesWritten++] = static_cast<uint8_t>(mScratch & 0xFF);
+        }
+        mScratch = 0;
+        mScratchBits = 0;
+    }
+
+    return mBytesWritten;
+}
+
+BitReader::BitReader(const void *data, const size_t size)
+:mData(static_cast<const uint8_t *>(data))
+,mSize(size)
+,mBytesRead(0)
+,mScratch(0)
+,mScratchBits(0)
+,mOverflowed(false)
+{}
+
+uint32_t BitReader::ReadBits(const int bits) {
+    if (bits <= 0 || bits > 32 || mOverflowed) {
+        return 0;
+    }
+
+    while (mScratchBits < bits) {
+        if (mBytesRead >= mSize) {
+            mOverflowed = true;
+            return 0;
+        }
+
+        mScratch |= static_cast<uint64_t>(mData[mBytesRead++]) << mScratchBits;
+        mScratchBits += 8;
+    }
+
+    const uint64_t mask = (static_cast<uint64_t>(1) << bits) - 1;
+    const auto value = static_cast<uint32_t>(mScratch & mask);
+    mScratch >>= bits;
+    mScratchBits -= bits;
+
+    return value;
+}
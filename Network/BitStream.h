@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Packs values with arbitrary bit widths, bytes are filled LSB first so the
+// output does not depend on the host byte order
+class BitWriter {
+public:
+    BitWriter(void *buffer, size_t capacity);
+
+    void WriteBits(uint32_t value, int bits);
+    void WriteBool(const bool value) { WriteBits(value ? 1 : 0, 1); }
+
+    // Writes the pending partial byte and returns the number of bytes used
+    size_t Flush();
+
+    [[nodiscard]] bool HasOverflowed() const { return mOverflowed; }
+    [[nodiscard]] size_t GetBitsWritten() const { return mBytesWritten * 8 + mScratchBits; }
+
+private:
+    uint8_t *mBuffer;
+    size_t mCapacity;
+    size_t mBytesWritten;
+    uint64_t mScratch;
+    int mScratchBits;
+    bool mOverflowed;
+};
+
+class BitReader {
+public:
+    BitReader(const void *data, size_t size);
+
+    // Reading past the end returns zeros and marks the reader as overflowed
+    uint32_t ReadBits(int bits);
+    bool ReadBool() { return ReadBits(1) != 0; }
+
+    [[nodiscard]] bool HasOverflowed() const { return mOverflowed; }
+
+private:
+    const uint8_t *mData;
+    size_t mSize;
+    size_t mBytesRead;
+    uint64_t mScratch;
+    int mScratchBits;
+    bool mOverflowed;
+};
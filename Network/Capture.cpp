@@ -0,0 +1,202 @@
+#include "Capture.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+#define CAPTURE_HAS_MMAP 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace {
+    constexpr uint8_t PADDING[Capture::RECORD_ALIGNMENT] = {};
+
+    size_t paddingFor(const size_t size) {
+        return (Capture::RECORD_ALIGNMENT - size % Capture::RECORD_ALIGNMENT) % Capture::RECORD_ALIGNMENT;
+    }
+}
+
+bool CaptureWriter::Open(const char *path) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mFile) {
+        return false;
+    }
+
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+    setvbuf(file, nullptr, _IOFBF, FILE_BUFFER_BYTES);
+
+    Capture::FileHeader header{};
+    header.magic = Capture::MAGIC;
+    header.version = Capture::VERSION;
+    header.headerBytes = sizeof(Capture::FileHeader);
+    header.startUnixNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    if (fwrite(&header, sizeof(header), 1, file) != 1) {
+        fclose(file);
+        return false;
+    }
+
+    mStartedAt = std::chrono::steady_clock::now();
+    mFile = file;
+    return true;
+}
+
+void CaptureWriter::Close() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mFile) {
+        return;
+    }
+
+    fclose(mFile);
+    mFile = nullptr;
+}
+
+void CaptureWriter::Write(
+    const Capture::Direction direction,
+    const sockaddr_in &addr,
+    const void *data,
+    size_t size,
+    const std::chrono::steady_clock::time_point at
+) {
+    size = std::min(size, static_cast<size_t>(Capture::SIZE_MASK));
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mFile) {
+        return;
+    }
+
+    Capture::RecordHeader header{};
+    header.timeNs = at > mStartedAt
+        ? static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(at - mStartedAt).count())
+        : 0;
+    header.addr = addr.sin_addr.s_addr;
+    header.port = addr.sin_port;
+    header.sizeAndDirection = static_cast<uint16_t>(size);
+    if (direction == Capture::Direction::INCOMING) {
+        header.sizeAndDirection |= Capture::INCOMING_BIT;
+    }
+
+    // a failed write only loses the capture, never the datagram
+    fwrite(&header, sizeof(header), 1, mFile);
+    fwrite(data, 1, size, mFile);
+    fwrite(PADDING, 1, paddingFor(size), mFile);
+}
+
+bool CaptureLog::Open(const char *path) {
+    Close();
+
+#ifdef CAPTURE_HAS_MMAP
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info{};
+    if (fstat(fd, &info) < 0 || static_cast<size_t>(info.st_size) < sizeof(Capture::FileHeader)) {
+        close(fd);
+        return false;
+    }
+
+    void *mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+
+    // records are walked front to back
+    madvise(mapping, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+
+    mBytes = static_cast<const uint8_t *>(mapping);
+    mSize = static_cast<size_t>(info.st_size);
+    mMapped = true;
+#else
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+
+    uint8_t chunk[4096];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        mBuffer.insert(mBuffer.end(), chunk, chunk + read);
+    }
+    fclose(file);
+
+    mBytes = mBuffer.data();
+    mSize = mBuffer.size();
+#endif
+
+    Capture::FileHeader header{};
+    if (mSize >= sizeof(header)) {
+        memcpy(&header, mBytes, sizeof(header));
+    }
+
+    if (mSize < sizeof(header) || header.magic != Capture::MAGIC || header.version != Capture::VERSION ||
+        header.headerBytes < sizeof(header) || header.headerBytes > mSize) {
+        Close();
+        return false;
+    }
+
+    mStartUnixNs = header.startUnixNs;
+    mOffset = header.headerBytes;
+    return true;
+}
+
+void CaptureLog::Close() {
+#ifdef CAPTURE_HAS_MMAP
+    if (mMapped) {
+        munmap(const_cast<uint8_t *>(mBytes), mSize);
+    }
+#endif
+
+    mBuffer.clear();
+    mBytes = nullptr;
+    mSize = 0;
+    mMapped = false;
+    mOffset = 0;
+    mStartUnixNs = 0;
+}
+
+bool CaptureLog::Next(Capture::Record *record) {
+    if (!mBytes || mSize - mOffset < sizeof(Capture::RecordHeader)) {
+        return false;
+    }
+
+    Capture::RecordHeader header;
+    memcpy(&header, mBytes + mOffset, sizeof(header));
+
+    const size_t size = header.sizeAndDirection & Capture::SIZE_MASK;
+    const size_t recordBytes = sizeof(header) + size;
+    if (mSize - mOffset < recordBytes) {
+        return false;
+    }
+
+    record->time = std::chrono::nanoseconds(header.timeNs);
+    record->direction = (header.sizeAndDirection & Capture::INCOMING_BIT) != 0
+        ? Capture::Direction::INCOMING
+        : Capture::Direction::OUTGOING;
+    record->addr = sockaddr_in{};
+    record->addr.sin_family = AF_INET;
+    record->addr.sin_addr.s_addr = header.addr;
+    record->addr.sin_port = header.port;
+    record->data = mBytes + mOffset + sizeof(header);
+    record->size = size;
+
+    // the padding of the last record may be missing when the capture was cut short
+    mOffset = std::min(mSize, mOffset + recordBytes + paddingFor(size));
+    return true;
+}
+
+void CaptureLog::Rewind() {
+    if (!mBytes) {
+        return;
+    }
+
+    Capture::FileHeader header;
+    memcpy(&header, mBytes, sizeof(header));
+    mOffset = header.headerBytes;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+#include "Platforms.h"
+
+// Datagram log written by SocketUtils while a capture is running. The file is
+// a CaptureFileHeader followed by records appended in the order the socket
+// saw them, each a CaptureRecordHeader, the raw datagram and padding up to
+// RECORD_ALIGNMENT, so a mapped file can be walked in place. Fields are in
+// host byte order, the magic tells a file from another machine apart.
+namespace Capture {
+    static constexpr uint32_t MAGIC = 0x5041434C; // "LCAP"
+    static constexpr uint16_t VERSION = 1;
+    static constexpr size_t RECORD_ALIGNMENT = 8;
+    // direction is kept in the top bit of the size
+    static constexpr uint16_t INCOMING_BIT = 0x8000;
+    static constexpr uint16_t SIZE_MASK = 0x7FFF;
+
+#pragma pack(1)
+    struct FileHeader {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t headerBytes;
+        // wall clock at the start, record times count from it
+        int64_t startUnixNs;
+    };
+
+    struct RecordHeader {
+        // steady clock nanoseconds since the capture started
+        uint64_t timeNs;
+        // peer address in network byte order, as in sockaddr_in
+        uint32_t addr;
+        uint16_t port;
+        uint16_t sizeAndDirection;
+    };
+#pragma pack(0)
+
+    static_assert(sizeof(FileHeader) % RECORD_ALIGNMENT == 0, "records must start aligned");
+    static_assert(sizeof(RecordHeader) % RECORD_ALIGNMENT == 0, "datagrams must start aligned");
+
+    enum class Direction : uint8_t {
+        OUTGOING,
+        INCOMING,
+    };
+
+    // One datagram of a mapped log, data points into the mapping
+    struct Record {
+        std::chrono::nanoseconds time;
+        Direction direction;
+        sockaddr_in addr;
+        const uint8_t *data;
+        size_t size;
+    };
+}
+
+// Appends records to a capture file, shared by every thread using SocketUtils
+class CaptureWriter {
+public:
+    CaptureWriter() :mFile(nullptr) {}
+    ~CaptureWriter() { Close(); }
+
+    CaptureWriter(const CaptureWriter &) = delete;
+    CaptureWriter &operator=(const CaptureWriter &) = delete;
+
+    bool Open(const char *path);
+    void Close();
+
+    [[nodiscard]] bool IsOpen() const { return mFile != nullptr; }
+
+    // Datagrams handled by one batched call share the time they were seen at
+    void Write(
+        Capture::Direction direction,
+        const sockaddr_in &addr,
+        const void *data,
+        size_t size,
+        std::chrono::steady_clock::time_point at
+    );
+
+    // Writes are buffered, a large buffer keeps them off the send path
+    static constexpr size_t FILE_BUFFER_BYTES = 1 << 20;
+
+private:
+    std::mutex mMutex;
+    FILE *mFile;
+    std::chrono::steady_clock::time_point mStartedAt;
+};
+
+// Read only view of a capture file, mapped on Linux and macOS and read into
+// memory elsewhere. Records stay valid until Close.
+class CaptureLog {
+public:
+    CaptureLog() :mBytes(nullptr), mSize(0), mMapped(false), mOffset(0), mStartUnixNs(0) {}
+    ~CaptureLog() { Close(); }
+
+    CaptureLog(const CaptureLog &) = delete;
+    CaptureLog &operator=(const CaptureLog &) = delete;
+
+    // False when the file is missing or not a capture of this version
+    bool Open(const char *path);
+    void Close();
+
+    // Next complete record, false at the end. A record cut short by a crash
+    // while capturing ends the log.
+    bool Next(Capture::Record *record);
+    void Rewind();
+
+    [[nodiscard]] int64_t GetStartUnixNs() const { return mStartUnixNs; }
+
+private:
+    const uint8_t *mBytes;
+    size_t mSize;
+    bool mMapped;
+    std::vector<uint8_t> mBuffer;
+    size_t mOffset;
+    int64_t mStartUnixNs;
+};
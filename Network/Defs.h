@@ -3,4 +3,6 @@
 //
 #pragma once
 
-#define APP_PORT 51001
\ No newline at end of file
+#define APP_PORT 51001
+// Default port of the network condition simulator, forwards to APP_PORT
+#define NETSIM_PORT 51002
\ No newline at end of file
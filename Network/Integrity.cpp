@@ -0,0 +1,137 @@
+#include "Integrity.h"
+#include "NetUtils.h"
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define INTEGRITY_HAS_SSE42_PATH 1
+#include <nmmintrin.h>
+#endif
+
+namespace {
+    constexpr uint32_t CRC32C_POLYNOMIAL = 0x82F63B78;
+
+    struct Crc32cTable {
+        uint32_t values[256];
+
+        constexpr Crc32cTable() :values{} {
+            for (uint32_t i = 0; i < 256; i++) {
+                uint32_t crc = i;
+                for (int bit = 0; bit < 8; bit++) {
+                    crc = (crc & 1) != 0 ? (crc >> 1) ^ CRC32C_POLYNOMIAL : crc >> 1;
+                }
+                values[i] = crc;
+            }
+        }
+    };
+
+    constexpr Crc32cTable CRC32C_TABLE;
+
+    uint32_t crc32cSoftware(const uint8_t *bytes, const size_t size, uint32_t crc) {
+        for (size_t i = 0; i < size; i++) {
+            crc = CRC32C_TABLE.values[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return crc;
+    }
+
+#ifdef INTEGRITY_HAS_SSE42_PATH
+    __attribute__((target("sse4.2")))
+    uint32_t crc32cHardware(const uint8_t *bytes, const size_t size, uint32_t crc) {
+        size_t i = 0;
+
+#if defined(__x86_64__)
+        uint64_t crc64 = crc;
+        for (; i + 8 <= size; i += 8) {
+            uint64_t word;
+            memcpy(&word, bytes + i, sizeof(uint64_t));
+            crc64 = _mm_crc32_u64(crc64, word);
+        }
+        crc = static_cast<uint32_t>(crc64);
+#endif
+
+        for (; i + 4 <= size; i += 4) {
+            uint32_t word;
+            memcpy(&word, bytes + i, sizeof(uint32_t));
+            crc = _mm_crc32_u32(crc, word);
+        }
+
+        for (; i < size; i++) {
+            crc = _mm_crc32_u8(crc, bytes[i]);
+        }
+
+        return crc;
+    }
+
+    // evaluated during static initialization, so the cpu model has to be loaded first
+    const bool HARDWARE_CRC32C = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse4.2") != 0;
+    }();
+#endif
+}
+
+uint8_t Integrity::getSupportedModes() {
+    return ONES_COMPLEMENT_BIT | CRC32C_BIT;
+}
+
+IntegrityMode Integrity::chooseMode(const uint8_t peerModes) {
+    if ((peerModes & getSupportedModes() & CRC32C_BIT) != 0) {
+        return IntegrityMode::CRC32C;
+    }
+
+    return IntegrityMode::ONES_COMPLEMENT;
+}
+
+IntegrityMode Integrity::parseMode(const uint8_t value) {
+    if (value == static_cast<uint8_t>(IntegrityMode::CRC32C)) {
+        return IntegrityMode::CRC32C;
+    }
+
+    return IntegrityMode::ONES_COMPLEMENT;
+}
+
+uint16_t Integrity::computePacketChecksum(
+    const IntegrityMode mode,
+    const uint8_t *bytes,
+    const size_t packetSize,
+    const size_t checksumOffset
+) {
+    const size_t afterChecksum = checksumOffset + sizeof(uint16_t);
+
+    if (mode == IntegrityMode::CRC32C) {
+        uint32_t crc = crc32c(bytes, checksumOffset, 0xFFFFFFFF);
+        crc = ~crc32c(bytes + afterChecksum, packetSize - afterChecksum, crc);
+
+        // the header field has 16 bits, fold the CRC instead of truncating it
+        return static_cast<uint16_t>(crc ^ (crc >> 16));
+    }
+
+    // one pass over the whole datagram, adding the complement of the checksum
+    // field takes it back out (the sync words keep the sum from being zero)
+    uint16_t field;
+    memcpy(&field, bytes + checksumOffset, sizeof(field));
+    return NetUtils::foldNetChecksum(NetUtils::sumNetWords(bytes, packetSize, static_cast<uint16_t>(~field)));
+}
+
+uint32_t Integrity::crc32c(const void *data, const size_t dataSize, const uint32_t crc) {
+    const auto *bytes = static_cast<const uint8_t *>(data);
+
+#ifdef INTEGRITY_HAS_SSE42_PATH
+    if (HARDWARE_CRC32C) {
+        return crc32cHardware(bytes, dataSize, crc);
+    }
+#endif
+
+    return crc32cSoftware(bytes, dataSize, crc);
+}
+
+uint32_t Integrity::crc32cPortable(const void *data, const size_t dataSize, const uint32_t crc) {
+    return crc32cSoftware(static_cast<const uint8_t *>(data), dataSize, crc);
+}
+
+bool Integrity::hasHardwareCrc32c() {
+#ifdef INTEGRITY_HAS_SSE42_PATH
+    return HARDWARE_CRC32C;
+#else
+    return false;
+#endif
+}
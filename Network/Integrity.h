@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Checksum carried in the 16 bit header field. Handshake packets always use
+// ones' complement, the rest of the connection uses the negotiated mode.
+enum class IntegrityMode : uint8_t {
+    ONES_COMPLEMENT = 0,
+    CRC32C = 1,
+};
+
+namespace Integrity {
+    // Capability bits exchanged in the SYN and SYN_ACK payloads
+    constexpr uint8_t ONES_COMPLEMENT_BIT = 1 << 0;
+    constexpr uint8_t CRC32C_BIT = 1 << 1;
+
+    uint8_t getSupportedModes();
+    // Strongest mode both sides support
+    IntegrityMode chooseMode(uint8_t peerModes);
+    // Parses the mode picked by the server, unknown values fall back to ones' complement
+    IntegrityMode parseMode(uint8_t value);
+
+    // Checksum of a datagram with the header checksum field skipped
+    uint16_t computePacketChecksum(IntegrityMode mode, const uint8_t *bytes, size_t packetSize, size_t checksumOffset);
+
+    // Castagnoli CRC, SSE4.2 when the CPU has it and a table otherwise
+    uint32_t crc32c(const void *data, size_t dataSize, uint32_t crc);
+    // The table driven fallback alone, whatever the CPU has
+    uint32_t crc32cPortable(const void *data, size_t dataSize, uint32_t crc);
+    bool hasHardwareCrc32c();
+};
@@ -8,6 +8,9 @@
 
 namespace  NetUtils {
     uint16_t getNetChecksum(const void *data, size_t dataSize);
+    // Partial ones' complement sums, segments must start at even offsets
+    uint32_t sumNetWords(const void *data, size_t dataSize, uint32_t sum);
+    uint16_t foldNetChecksum(uint32_t sum);
     uint32_t getNonce();
     uint32_t getRandomNonce(uint32_t baseNonce);
 };
\ No newline at end of file
@@ -4,34 +4,48 @@
 
 #include "Packet.h"
 #include "Platforms.h"
-#include "NetUtils.h"
+#include "PacketView.h"
+#include <algorithm>
 #include <cstring>
 #include <cstdio>
 
 Packet::Packet()
 :sync1(PACKET_SYNC_BYTES)
-,sync2(PACKET_SYNC_BYTES)
+,sync2(PACKET_SYNC2_BYTES)
+,version(WIRE_VERSION)
 ,state(PACKET_HOLD)
 ,sequence(0)
 ,flag(0)
 ,nonce(0)
 ,length(0)
 ,checksum(0)
-,data{}
 {}
 
 Packet::Packet(const uint16_t _sequence, const uint8_t _flag, const uint32_t _nonce)
 :sync1(PACKET_SYNC_BYTES)
-,sync2(PACKET_SYNC_BYTES)
+,sync2(PACKET_SYNC2_BYTES)
+,version(WIRE_VERSION)
 ,state(PACKET_HOLD)
 ,sequence(_sequence)
 ,flag(_flag)
 ,nonce(_nonce)
 ,length(0)
 ,checksum(0)
-,data{}
 {}
 
+// Reuses a packet slot, only the header is reset since length bounds the payload
+void Packet::Reset(const uint16_t _sequence, const uint8_t _flag, const uint32_t _nonce) {
+    sync1 = PACKET_SYNC_BYTES;
+    sync2 = PACKET_SYNC2_BYTES;
+    version = WIRE_VERSION;
+    state = PACKET_HOLD;
+    sequence = _sequence;
+    flag = _flag;
+    nonce = _nonce;
+    length = 0;
+    checksum = 0;
+}
+
 void Packet::SetData(const void *sourceData, const size_t dataSize) {
     if (state != PACKET_HOLD) {
         return;
@@ -52,13 +66,14 @@ void Packet::SetData(const void *sourceData, const size_t dataSize) {
     length = dataSize;
 }
 
-void Packet::BuildPacket() {
+void Packet::BuildPacket(const IntegrityMode mode) {
     if (state != PACKET_HOLD) {
         return;
     }
 
     sync1 = htonl(sync1);
-    sync2 = htonl(sync2);
+    sync2 = htons(sync2);
+    version = htons(version);
     sequence = htons(sequence);
     nonce = htonl(nonce);
 
@@ -68,34 +83,23 @@ void Packet::BuildPacket() {
     length = htons(length);
 
     const size_t packetSize = PACKET_HEADER_BYTES + _length;
-    checksum = NetUtils::getNetChecksum(this, packetSize);
+    checksum = 0;
+    checksum = Integrity::computePacketChecksum(
+        mode,
+        reinterpret_cast<const uint8_t *>(this),
+        packetSize,
+        PacketView::CHECKSUM_OFFSET
+    );
     checksum = htons(checksum);
 }
 
-bool Packet::IsValid() const {
+// Validated in place, only over the bytes received
+bool Packet::IsValid(const size_t size, const IntegrityMode mode) const {
     if (state != PACKET_READY) {
         return false;
     }
 
-    if(sync1 != htonl(PACKET_SYNC_BYTES) ||
-       sync2 != htonl(PACKET_SYNC_BYTES)) {
-        return false;
-       }
-
-    const uint16_t dataSize = ntohs(length);
-    if(dataSize > MAX_PACKET_DATA_BYTES){
-        return false;
-    }
-
-    const uint16_t savedChecksum = checksum;
-    const auto temp = const_cast<Packet*>(this);
-    temp->checksum = 0;
-
-    const size_t packetSize = PACKET_HEADER_BYTES + dataSize;
-    const uint16_t calculatedChecksum = NetUtils::getNetChecksum(temp, packetSize);
-    temp->checksum = savedChecksum;
-
-    return calculatedChecksum == ntohs(savedChecksum);
+    return PacketView(this, std::min(size, sizeof(Packet))).IsValid(mode);
 }
 
 void Packet::PrintPacket() const {
@@ -112,6 +116,7 @@ void Packet::PrintPacket() const {
     printf("LENGTH: %hu\n", _length);
     printf("==== CONTROL FIELDS ====\n");
     printf("SYNC1:    %#x\n", ntohl(sync1));
-    printf("SYNC2:    %#x\n", ntohl(sync2));
+    printf("SYNC2:    %#x\n", ntohs(sync2));
+    printf("VERSION:  %hu\n", ntohs(version));
     printf("CHECKSUM: %#x\n", ntohl(checksum));
 }
\ No newline at end of file
@@ -6,20 +6,31 @@
 #include <cstdint>
 #include <cstdlib>
 #include "Platforms.h"
+#include "Integrity.h"
 
 #pragma pack(1)
 class Packet {
 public:
     Packet();
     Packet(uint16_t _sequence, uint8_t _flag, uint32_t _nonce);
+    void Reset(uint16_t _sequence, uint8_t _flag, uint32_t _nonce);
     void SetData(const void *sourceData, size_t dataSize);
-    void BuildPacket();
-    [[nodiscard]] bool IsValid() const;
+    void BuildPacket(IntegrityMode mode = IntegrityMode::ONES_COMPLEMENT);
+    // size is how many bytes of the packet were received, the bytes past it
+    // are left over from whatever the packet held before
+    [[nodiscard]] bool IsValid(size_t size, IntegrityMode mode = IntegrityMode::ONES_COMPLEMENT) const;
     void PrintPacket() const;
 
     [[nodiscard]] const void* GetData() const { return data; }
     [[nodiscard]] uint8_t GetFlag() const { return flag; }
 
+    [[nodiscard]] uint16_t GetVersion() const {
+        if (state == PACKET_READY) {
+            return ntohs(version);
+        }
+        return version;
+    }
+
     [[nodiscard]] uint16_t GetSequence() const {
         if (state == PACKET_READY) {
             return ntohs(sequence);
@@ -52,10 +63,22 @@ public:
     static constexpr uint8_t END_ACK_FLAG = 0x06;
     static constexpr uint8_t RST_FLAG = 0x07;
     static constexpr uint8_t PING_FLAG = 0x08;
+    // Transport framing, see Transport.h
+    static constexpr uint8_t FRAGMENT_FLAG = 0x09;
+    static constexpr uint8_t BUNDLE_FLAG = 0x0A;
+
+    static constexpr uint32_t PACKET_SYNC_BYTES = 0x554E4554;
+    static constexpr uint16_t PACKET_SYNC2_BYTES = 0x554E;
+    // Layout of the Wire:: messages in the payload, bumped on any change to a
+    // Wire::Schema. Packets of another version fail validation.
+    static constexpr uint16_t WIRE_VERSION = 2;
+    static constexpr uint8_t PACKET_HOLD = 1;
+    static constexpr uint8_t PACKET_READY = 2;
 
 private:
     uint32_t sync1;
-    uint32_t sync2;
+    uint16_t sync2;
+    uint16_t version;
     uint8_t state;
     uint16_t sequence;
     uint8_t flag;
@@ -63,9 +86,5 @@ private:
     uint16_t length;
     uint16_t checksum;
     uint8_t data[MAX_PACKET_DATA_BYTES];
-
-    static constexpr uint32_t PACKET_SYNC_BYTES = 0x554E4554;
-    static constexpr uint8_t PACKET_HOLD = 1;
-    static constexpr uint8_t PACKET_READY = 2;
 };
 #pragma pack(0)
\ No newline at end of file
@@ -0,0 +1,35 @@
+#include "PacketBatch.h"
+
+PacketBatch::PacketBatch(const size_t capacity)
+:mBuffers(capacity)
+,mAddresses(capacity)
+,mBytes(capacity, 0)
+,mSize(0)
+#ifdef PLATFORM_LINUX
+,mHeaders(capacity)
+,mVectors(capacity)
+#endif
+{
+#ifdef PLATFORM_LINUX
+    for (size_t i = 0; i < capacity; i++) {
+        mVectors[i].iov_base = mBuffers[i].bytes;
+        mVectors[i].iov_len = SLOT_BYTES;
+
+        mHeaders[i] = {};
+        mHeaders[i].msg_hdr.msg_name = &mAddresses[i];
+        mHeaders[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        mHeaders[i].msg_hdr.msg_iov = &mVectors[i];
+        mHeaders[i].msg_hdr.msg_iovlen = 1;
+    }
+#endif
+}
+
+PacketWriter PacketBatch::Push(const sockaddr_in &addr) {
+    if (IsFull()) {
+        return {};
+    }
+
+    mAddresses[mSize] = addr;
+    mBytes[mSize] = 0;
+    return PacketWriter(mBuffers[mSize++].bytes);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "Platforms.h"
+#include "Packet.h"
+#include "PacketView.h"
+
+// Preallocated packet slots used by the batched socket calls (recvmmsg/sendmmsg).
+// The cache aligned buffers are allocated once and reused by every call, packets
+// are written and read in place through PacketWriter and PacketView.
+class PacketBatch {
+public:
+    explicit PacketBatch(size_t capacity);
+
+    void Clear() { mSize = 0; }
+
+    // Reserves the next slot for an outgoing packet, a null writer when the batch is full
+    PacketWriter Push(const sockaddr_in &addr);
+
+    // True when the slot holds a complete datagram with a valid header and checksum
+    [[nodiscard]] bool IsValid(const size_t index, const IntegrityMode mode = IntegrityMode::ONES_COMPLEMENT) const {
+        return index < mSize && GetView(index).IsValid(mode);
+    }
+
+    [[nodiscard]] PacketView GetView(const size_t index) const { return {mBuffers[index].bytes, mBytes[index]}; }
+    [[nodiscard]] uint8_t *GetBuffer(const size_t index) { return mBuffers[index].bytes; }
+    [[nodiscard]] sockaddr_in &GetAddress(const size_t index) { return mAddresses[index]; }
+    [[nodiscard]] const sockaddr_in &GetAddress(const size_t index) const { return mAddresses[index]; }
+    [[nodiscard]] size_t GetBytes(const size_t index) const { return mBytes[index]; }
+
+    void SetSize(const size_t size) { mSize = size; }
+    void SetBytes(const size_t index, const size_t bytes) { mBytes[index] = bytes; }
+
+#ifdef PLATFORM_LINUX
+    // Message headers already pointing at the packet slots and addresses
+    [[nodiscard]] mmsghdr *GetHeaders() { return mHeaders.data(); }
+#endif
+
+    [[nodiscard]] size_t GetSize() const { return mSize; }
+    [[nodiscard]] size_t GetCapacity() const { return mBuffers.size(); }
+    [[nodiscard]] bool IsFull() const { return mSize == mBuffers.size(); }
+
+    static constexpr size_t SLOT_BYTES = sizeof(PacketBuffer::bytes);
+
+private:
+    std::vector<PacketBuffer> mBuffers;
+    std::vector<sockaddr_in> mAddresses;
+    std::vector<size_t> mBytes;
+    size_t mSize;
+
+#ifdef PLATFORM_LINUX
+    std::vector<mmsghdr> mHeaders;
+    std::vector<iovec> mVectors;
+#endif
+};
@@ -0,0 +1,113 @@
+#include "PacketView.h"
+#include "NetUtils.h"
+#include <cstring>
+
+static_assert(sizeof(Packet) == Packet::PACKET_HEADER_BYTES + Packet::MAX_PACKET_DATA_BYTES,
+    "Packet header layout changed, update the PacketView offsets");
+
+namespace {
+    uint16_t readU16(const uint8_t *bytes) {
+        uint16_t value;
+        memcpy(&value, bytes, sizeof(value));
+        return ntohs(value);
+    }
+
+    uint32_t readU32(const uint8_t *bytes) {
+        uint32_t value;
+        memcpy(&value, bytes, sizeof(value));
+        return ntohl(value);
+    }
+
+    void writeU16(uint8_t *bytes, const uint16_t value) {
+        const uint16_t netValue = htons(value);
+        memcpy(bytes, &netValue, sizeof(netValue));
+    }
+
+    void writeU32(uint8_t *bytes, const uint32_t value) {
+        const uint32_t netValue = htonl(value);
+        memcpy(bytes, &netValue, sizeof(netValue));
+    }
+}
+
+bool PacketView::IsValid(const IntegrityMode mode) const {
+    return IsIntact(mode) && GetVersion() == Packet::WIRE_VERSION;
+}
+
+bool PacketView::IsOtherVersion(const IntegrityMode mode) const {
+    return IsIntact(mode) && GetVersion() != Packet::WIRE_VERSION;
+}
+
+// Framing, length and checksum, the same in every wire version
+bool PacketView::IsIntact(const IntegrityMode mode) const {
+    if (mBytes == nullptr || mSize < Packet::PACKET_HEADER_BYTES) {
+        return false;
+    }
+
+    if (readU32(mBytes + SYNC1_OFFSET) != Packet::PACKET_SYNC_BYTES ||
+        readU16(mBytes + SYNC2_OFFSET) != Packet::PACKET_SYNC2_BYTES ||
+        mBytes[STATE_OFFSET] != Packet::PACKET_READY) {
+        return false;
+    }
+
+    const uint16_t dataSize = GetLength();
+    if (dataSize > Packet::MAX_PACKET_DATA_BYTES || dataSize > mSize - Packet::PACKET_HEADER_BYTES) {
+        return false;
+    }
+
+    const uint16_t checksum = Integrity::computePacketChecksum(
+        mode,
+        mBytes,
+        Packet::PACKET_HEADER_BYTES + dataSize,
+        CHECKSUM_OFFSET
+    );
+
+    return checksum == readU16(mBytes + CHECKSUM_OFFSET);
+}
+
+uint16_t PacketView::GetVersion() const {
+    return readU16(mBytes + VERSION_OFFSET);
+}
+
+uint16_t PacketView::GetSequence() const {
+    return readU16(mBytes + SEQUENCE_OFFSET);
+}
+
+uint8_t PacketView::GetFlag() const {
+    return mBytes[FLAG_OFFSET];
+}
+
+uint32_t PacketView::GetNonce() const {
+    return readU32(mBytes + NONCE_OFFSET);
+}
+
+uint16_t PacketView::GetLength() const {
+    return readU16(mBytes + LENGTH_OFFSET);
+}
+
+void PacketWriter::Begin(const uint16_t sequence, const uint8_t flag, const uint32_t nonce,
+    const uint16_t version) const {
+    writeU32(mBytes + PacketView::SYNC1_OFFSET, Packet::PACKET_SYNC_BYTES);
+    writeU16(mBytes + PacketView::SYNC2_OFFSET, Packet::PACKET_SYNC2_BYTES);
+    writeU16(mBytes + PacketView::VERSION_OFFSET, version);
+    mBytes[PacketView::STATE_OFFSET] = Packet::PACKET_READY;
+    writeU16(mBytes + PacketView::SEQUENCE_OFFSET, sequence);
+    mBytes[PacketView::FLAG_OFFSET] = flag;
+    writeU32(mBytes + PacketView::NONCE_OFFSET, nonce);
+    writeU16(mBytes + PacketView::LENGTH_OFFSET, 0);
+    writeU16(mBytes + PacketView::CHECKSUM_OFFSET, 0);
+}
+
+size_t PacketWriter::Finish(size_t payloadSize, const IntegrityMode mode) const {
+    if (payloadSize > PAYLOAD_CAPACITY) {
+        payloadSize = PAYLOAD_CAPACITY;
+    }
+
+    const size_t packetSize = Packet::PACKET_HEADER_BYTES + payloadSize;
+    writeU16(mBytes + PacketView::LENGTH_OFFSET, static_cast<uint16_t>(payloadSize));
+    writeU16(
+        mBytes + PacketView::CHECKSUM_OFFSET,
+        Integrity::computePacketChecksum(mode, mBytes, packetSize, PacketView::CHECKSUM_OFFSET)
+    );
+
+    return packetSize;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "Packet.h"
+#include "Integrity.h"
+
+// Cache aligned storage for one datagram, reused by batches and senders
+struct alignas(64) PacketBuffer {
+    uint8_t bytes[Packet::PACKET_HEADER_BYTES + Packet::MAX_PACKET_DATA_BYTES];
+};
+
+// Read only view over a received datagram, fields are decoded from the wire
+// bytes on access and validation never writes to the buffer
+class PacketView {
+public:
+    PacketView() :mBytes(nullptr), mSize(0) {}
+    PacketView(const void *bytes, const size_t size) :mBytes(static_cast<const uint8_t *>(bytes)), mSize(size) {}
+
+    // Header and checksum are checked only against the bytes actually received,
+    // and the packet has to carry this build's Packet::WIRE_VERSION
+    [[nodiscard]] bool IsValid(IntegrityMode mode = IntegrityMode::ONES_COMPLEMENT) const;
+    // Intact packet of a peer speaking another wire version
+    [[nodiscard]] bool IsOtherVersion(IntegrityMode mode = IntegrityMode::ONES_COMPLEMENT) const;
+
+    [[nodiscard]] uint16_t GetVersion() const;
+    [[nodiscard]] uint16_t GetSequence() const;
+    [[nodiscard]] uint8_t GetFlag() const;
+    [[nodiscard]] uint32_t GetNonce() const;
+    [[nodiscard]] uint16_t GetLength() const;
+    [[nodiscard]] const void *GetData() const { return mBytes + Packet::PACKET_HEADER_BYTES; }
+    [[nodiscard]] size_t GetSize() const { return mSize; }
+
+    // Wire layout of the Packet header
+    static constexpr size_t SYNC1_OFFSET = 0;
+    static constexpr size_t SYNC2_OFFSET = 4;
+    static constexpr size_t VERSION_OFFSET = 6;
+    static constexpr size_t STATE_OFFSET = 8;
+    static constexpr size_t SEQUENCE_OFFSET = 9;
+    static constexpr size_t FLAG_OFFSET = 11;
+    static constexpr size_t NONCE_OFFSET = 12;
+    static constexpr size_t LENGTH_OFFSET = 16;
+    static constexpr size_t CHECKSUM_OFFSET = 18;
+
+private:
+    [[nodiscard]] bool IsIntact(IntegrityMode mode) const;
+
+    const uint8_t *mBytes;
+    size_t mSize;
+};
+
+// Serializes a datagram in place: the header is written up front, the caller
+// fills the payload directly and Finish seals length and checksum
+class PacketWriter {
+public:
+    PacketWriter() :mBytes(nullptr) {}
+    explicit PacketWriter(void *bytes) :mBytes(static_cast<uint8_t *>(bytes)) {}
+
+    // A version other than Packet::WIRE_VERSION answers a peer in its own
+    void Begin(uint16_t sequence, uint8_t flag, uint32_t nonce, uint16_t version = Packet::WIRE_VERSION) const;
+
+    // Returns the datagram size, payloads over MAX_PACKET_DATA_BYTES are cut
+    size_t Finish(size_t payloadSize, IntegrityMode mode = IntegrityMode::ONES_COMPLEMENT) const;
+
+    [[nodiscard]] uint8_t *GetPayload() const { return mBytes + Packet::PACKET_HEADER_BYTES; }
+    [[nodiscard]] const uint8_t *GetBytes() const { return mBytes; }
+    [[nodiscard]] bool IsNull() const { return mBytes == nullptr; }
+
+    static constexpr size_t PAYLOAD_CAPACITY = Packet::MAX_PACKET_DATA_BYTES;
+
+private:
+    uint8_t *mBytes;
+};
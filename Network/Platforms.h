@@ -56,6 +56,11 @@
     #define socket_bind(socket, addr, addrlen) \
         bind(static_cast<SOCKET>(socket), addr, static_cast<int>(addrlen))
 
+    inline int socket_set_nonblocking(const SocketType sock) {
+        u_long mode = 1;
+        return ioctlsocket(sock, FIONBIO, &mode);
+    }
+
     #define networkingInit() do { \
         WSADATA wsaData; \
         int result = WSAStartup(MAKEWORD(2, 2), &wsaData); \
@@ -78,6 +83,7 @@
     #include <arpa/inet.h>
     #include <unistd.h>
     #include <poll.h>
+    #include <fcntl.h>
 
     typedef int SocketType;
     #define INVALID_SOCKET (-1)
@@ -101,6 +107,8 @@
 
     #define socket_bind(socket, addr, addrlen) bind(socket, addr, addrlen)
 
+    #define socket_set_nonblocking(sock) fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK)
+
     #define networkingInit()
     #define networkingCleanup()
 #endif
\ No newline at end of file
@@ -0,0 +1,174 @@
+#include "ReliableChannel.h"
+#include "AckWindow.h"
+#include "WireFormat.h"
+#include <cstring>
+
+void ReliableSender::Clear() {
+    for (auto &pending : mPending) {
+        pending.acked = true;
+        pending.sent = false;
+    }
+    for (auto &packet : mSentPackets) {
+        packet.valid = false;
+        packet.size = 0;
+    }
+    mNextId = 0;
+    mOldestId = 0;
+}
+
+bool ReliableSender::Enqueue(const void *data, const size_t size) {
+    if (size > ReliableChannel::MAX_MESSAGE_BYTES || GetPendingSize() >= ReliableChannel::WINDOW_SIZE) {
+        return false;
+    }
+
+    Pending &pending = mPending[mNextId % ReliableChannel::WINDOW_SIZE];
+    pending.acked = false;
+    pending.sent = false;
+    pending.message.id = mNextId;
+    pending.message.size = static_cast<uint8_t>(size);
+    memcpy(pending.message.data, data, size);
+
+    mNextId++;
+    return true;
+}
+
+size_t ReliableSender::Write(
+    const uint16_t packetSequence,
+    void *buffer,
+    const size_t capacity,
+    const std::chrono::steady_clock::time_point now
+) {
+    if (capacity < sizeof(uint8_t)) {
+        return 0;
+    }
+
+    auto *bytes = static_cast<uint8_t*>(buffer);
+    size_t offset = sizeof(uint8_t);
+
+    SentPacket &record = mSentPackets[packetSequence % SENT_PACKET_HISTORY];
+    record.valid = true;
+    record.sequence = packetSequence;
+    record.size = 0;
+
+    for (uint16_t id = mOldestId; id != mNextId && record.size < ReliableChannel::MAX_MESSAGES_PER_PACKET; id++) {
+        Pending &pending = mPending[id % ReliableChannel::WINDOW_SIZE];
+        if (pending.acked || (pending.sent && now - pending.lastSentAt < ReliableChannel::RESEND_INTERVAL)) {
+            continue;
+        }
+
+        const ReliableChannel::Message &message = pending.message;
+        const size_t messageBytes = ReliableChannel::MESSAGE_HEADER_BYTES + message.size;
+        if (offset + messageBytes > capacity) {
+            break;
+        }
+
+        Wire::Codec<uint16_t>::write(message.id, bytes + offset);
+        bytes[offset + sizeof(uint16_t)] = message.size;
+        memcpy(bytes + offset + ReliableChannel::MESSAGE_HEADER_BYTES, message.data, message.size);
+        offset += messageBytes;
+
+        pending.sent = true;
+        pending.lastSentAt = now;
+        record.ids[record.size++] = id;
+    }
+
+    bytes[0] = record.size;
+    return offset;
+}
+
+void ReliableSender::OnAck(const uint16_t newest, const uint32_t bits) {
+    for (uint16_t age = 0; age <= AckWindow::WINDOW_SIZE; age++) {
+        const auto sequence = static_cast<uint16_t>(newest - age);
+        if (AckWindow::isAcked(sequence, newest, bits)) {
+            AckPacket(sequence);
+        }
+    }
+
+    // the queue only shrinks from the front, later acks wait for the oldest
+    while (mOldestId != mNextId && mPending[mOldestId % ReliableChannel::WINDOW_SIZE].acked) {
+        mOldestId++;
+    }
+}
+
+void ReliableSender::AckPacket(const uint16_t sequence) {
+    SentPacket &record = mSentPackets[sequence % SENT_PACKET_HISTORY];
+    if (!record.valid || record.sequence != sequence) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < record.size; i++) {
+        const uint16_t id = record.ids[i];
+        // ids the queue already moved past belong to an older lap of the slot
+        if (static_cast<uint16_t>(id - mOldestId) >= GetPendingSize()) {
+            continue;
+        }
+        mPending[id % ReliableChannel::WINDOW_SIZE].acked = true;
+    }
+
+    record.valid = false;
+}
+
+void ReliableReceiver::Clear() {
+    for (auto &slot : mSlots) {
+        slot.stored = false;
+    }
+    mNextId = 0;
+}
+
+size_t ReliableReceiver::Read(const void *data, const size_t size, bool *accepted) {
+    *accepted = true;
+    if (size < sizeof(uint8_t)) {
+        return 0;
+    }
+
+    const auto *bytes = static_cast<const uint8_t*>(data);
+    const uint8_t count = bytes[0];
+    size_t offset = sizeof(uint8_t);
+
+    for (uint8_t i = 0; i < count; i++) {
+        if (offset + ReliableChannel::MESSAGE_HEADER_BYTES > size) {
+            return 0;
+        }
+
+        const uint16_t id = Wire::Codec<uint16_t>::read(bytes + offset);
+        const uint8_t messageSize = bytes[offset + sizeof(uint16_t)];
+        offset += ReliableChannel::MESSAGE_HEADER_BYTES;
+
+        if (messageSize > ReliableChannel::MAX_MESSAGE_BYTES || offset + messageSize > size) {
+            return 0;
+        }
+
+        const auto ahead = static_cast<uint16_t>(id - mNextId);
+        if (ahead < ReliableChannel::WINDOW_SIZE) {
+            Slot &slot = mSlots[id % ReliableChannel::WINDOW_SIZE];
+            if (!slot.stored) {
+                slot.stored = true;
+                slot.message.id = id;
+                slot.message.size = messageSize;
+                memcpy(slot.message.data, bytes + offset, messageSize);
+            }
+        } else if (AckWindow::isNewer(id, mNextId)) {
+            // past the window, only possible while the reader is not popping
+            *accepted = false;
+        }
+
+        offset += messageSize;
+    }
+
+    return offset;
+}
+
+const ReliableChannel::Message *ReliableReceiver::Peek() const {
+    const Slot &slot = mSlots[mNextId % ReliableChannel::WINDOW_SIZE];
+    return slot.stored ? &slot.message : nullptr;
+}
+
+void ReliableReceiver::Pop() {
+    Slot &slot = mSlots[mNextId % ReliableChannel::WINDOW_SIZE];
+    if (!slot.stored) {
+        return;
+    }
+
+    slot.stored = false;
+    mNextId++;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Small messages that must arrive exactly once and in order, written into the
+// datagrams that are sent anyway. Each message is repeated in later packets
+// until one of the packets carrying it is acked (see AckWindow), the receiver
+// drops the copies it already has and hands them out in id order. Unreliable
+// data in the same datagram is never held back by a missing message.
+//
+// Block layout: message count (uint8), then per message its id (uint16),
+// payload size (uint8) and payload. The id is little endian.
+namespace ReliableChannel {
+    static constexpr size_t MAX_MESSAGE_BYTES = 32;
+    // ids in flight, the receiver window has the same size so it never has
+    // to refuse a message the sender is allowed to send
+    static constexpr uint16_t WINDOW_SIZE = 256;
+    static constexpr size_t MAX_MESSAGES_PER_PACKET = 16;
+    static constexpr size_t MESSAGE_HEADER_BYTES = sizeof(uint16_t) + sizeof(uint8_t);
+    static constexpr size_t MAX_BLOCK_BYTES =
+        sizeof(uint8_t) + MAX_MESSAGES_PER_PACKET * (MESSAGE_HEADER_BYTES + MAX_MESSAGE_BYTES);
+    static constexpr auto RESEND_INTERVAL = std::chrono::milliseconds(100);
+
+    struct Message {
+        uint16_t id;
+        uint8_t size;
+        uint8_t data[MAX_MESSAGE_BYTES];
+    };
+}
+
+class ReliableSender {
+public:
+    ReliableSender() { Clear(); }
+
+    void Clear();
+
+    // False when the message is too large or WINDOW_SIZE messages are still unacked
+    bool Enqueue(const void *data, size_t size);
+
+    // Writes the messages that were never sent or whose last copy is older than
+    // RESEND_INTERVAL, oldest first, and remembers them under the packet sequence.
+    // Returns the block size, at least the count byte when it fits.
+    size_t Write(uint16_t packetSequence, void *buffer, size_t capacity, std::chrono::steady_clock::time_point now);
+
+    // Ack of the packets that carried messages, newest sequence and AckWindow bits
+    void OnAck(uint16_t newest, uint32_t bits);
+
+    [[nodiscard]] size_t GetPendingSize() const { return static_cast<uint16_t>(mNextId - mOldestId); }
+
+    static constexpr size_t SENT_PACKET_HISTORY = 256;
+
+private:
+    struct Pending {
+        bool acked;
+        bool sent;
+        std::chrono::steady_clock::time_point lastSentAt;
+        ReliableChannel::Message message;
+    };
+
+    struct SentPacket {
+        bool valid;
+        uint16_t sequence;
+        uint8_t size;
+        uint16_t ids[ReliableChannel::MAX_MESSAGES_PER_PACKET];
+    };
+
+    void AckPacket(uint16_t sequence);
+
+    Pending mPending[ReliableChannel::WINDOW_SIZE];
+    SentPacket mSentPackets[SENT_PACKET_HISTORY];
+    uint16_t mNextId;
+    uint16_t mOldestId;
+};
+
+class ReliableReceiver {
+public:
+    ReliableReceiver() { Clear(); }
+
+    void Clear();
+
+    // Stores the new messages of a block and returns its size, 0 when it is
+    // malformed. accepted is false when a message did not fit the window, that
+    // packet must not be acked so the sender repeats it.
+    size_t Read(const void *data, size_t size, bool *accepted);
+
+    // Next message in order, nullptr until it arrives
+    [[nodiscard]] const ReliableChannel::Message *Peek() const;
+    void Pop();
+
+private:
+    struct Slot {
+        bool stored;
+        ReliableChannel::Message message;
+    };
+
+    Slot mSlots[ReliableChannel::WINDOW_SIZE];
+    uint16_t mNextId;
+};
@@ -6,7 +6,23 @@
 #include "Logger.h"
 #include "Addresses.h"
 #include "Defs.h"
-#include <cstring>
+#include "Capture.h"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+
+namespace {
+    CaptureWriter sCapture;
+    // checked before taking the writer lock, so sockets pay nothing without a capture
+    std::atomic<bool> sCapturing(false);
+
+    void captureDatagram(const Capture::Direction direction, const sockaddr_in &addr, const void *data,
+        const size_t size, const std::chrono::steady_clock::time_point at) {
+        if (sCapturing.load(std::memory_order_relaxed)) {
+            sCapture.Write(direction, addr, data, size, at);
+        }
+    }
+}
 
 SocketType SocketUtils::createSocketV4() {
     const SocketType sock = create_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
@@ -19,8 +35,12 @@ SocketType SocketUtils::createSocketV4() {
 }
 
 void SocketUtils::bindSocketToAnyV4(const SocketType sock) {
+    bindSocketToPortV4(sock, APP_PORT);
+}
+
+void SocketUtils::bindSocketToPortV4(const SocketType sock, const uint16_t port) {
     sockaddr_in addr{};
-    Addresses::initAddrAnyV4(&addr, APP_PORT);
+    Addresses::initAddrAnyV4(&addr, port);
 
     if (socket_bind(sock, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
         close_socket(sock);
@@ -28,6 +48,13 @@ void SocketUtils::bindSocketToAnyV4(const SocketType sock) {
     }
 }
 
+void SocketUtils::setSocketNonBlocking(const SocketType sock) {
+    if (socket_set_nonblocking(sock) < 0) {
+        close_socket(sock);
+        Logger::sysLogExit("set socket non-blocking");
+    }
+}
+
 bool SocketUtils::socketReadyToReceive(const SocketType sock, const int ms) {
     POLL_FD_TYPE fds[1];
     fds[0].fd = sock;
@@ -42,23 +69,153 @@ bool SocketUtils::socketReadyToReceive(const SocketType sock, const int ms) {
 }
 
 bool SocketUtils::sendPacketToV4(const SocketType sock, Packet *pk, const size_t pkSize, sockaddr_in * addr4) {
+    return sendBytesToV4(sock, pk, pkSize, addr4);
+}
+
+bool SocketUtils::sendBytesToV4(const SocketType sock, const void *bytes, const size_t size, sockaddr_in * addr4) {
     constexpr socklen_t addr_size = sizeof(sockaddr_in);
 
-    if (const ssize_t bytes_sent = socket_sendto(sock, pk, pkSize, 0, reinterpret_cast<sockaddr *>(addr4), addr_size);
-        bytes_sent < 0 || static_cast<size_t>(bytes_sent) != pkSize) {
+    if (const ssize_t bytes_sent = socket_sendto(sock, bytes, size, 0, reinterpret_cast<sockaddr *>(addr4), addr_size);
+        bytes_sent < 0 || static_cast<size_t>(bytes_sent) != size) {
         return false;
         }
+
+    captureDatagram(Capture::Direction::OUTGOING, *addr4, bytes, size, std::chrono::steady_clock::now());
     return true;
 }
 
-bool SocketUtils::receivePacketFromV4(const SocketType sock, Packet *pk, sockaddr_in * addr4) {
+size_t SocketUtils::receivePacketFromV4(const SocketType sock, Packet *pk, sockaddr_in * addr4) {
     constexpr size_t pkSize = Packet::PACKET_HEADER_BYTES + Packet::MAX_PACKET_DATA_BYTES;
-    std::memset(pk, 0, pkSize);
-
     socklen_t addrSize = sizeof(sockaddr_in);
 
-    if (const ssize_t bytes_received = socket_recvfrom(sock, pk, pkSize, 0, reinterpret_cast<sockaddr *>(addr4), &addrSize); bytes_received <= 0) {
+    const ssize_t bytes_received = socket_recvfrom(sock, pk, pkSize, 0, reinterpret_cast<sockaddr *>(addr4), &addrSize);
+    if (bytes_received <= 0) {
+        return 0;
+    }
+
+    captureDatagram(Capture::Direction::INCOMING, *addr4, pk, static_cast<size_t>(bytes_received), std::chrono::steady_clock::now());
+    return static_cast<size_t>(bytes_received);
+}
+
+// Fills the batch with every datagram already queued, up to its capacity, without blocking
+size_t SocketUtils::receivePacketBatchFromV4(const SocketType sock, PacketBatch *batch) {
+    batch->Clear();
+    const size_t capacity = batch->GetCapacity();
+
+#ifdef PLATFORM_LINUX
+    mmsghdr *headers = batch->GetHeaders();
+    for (size_t i = 0; i < capacity; i++) {
+        headers[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        headers[i].msg_hdr.msg_iov->iov_len = PacketBatch::SLOT_BYTES;
+    }
+
+    const int received = recvmmsg(sock, headers, static_cast<unsigned int>(capacity), MSG_DONTWAIT, nullptr);
+    if (received <= 0) {
+        return 0;
+    }
+
+    for (int i = 0; i < received; i++) {
+        batch->SetBytes(i, headers[i].msg_len);
+    }
+    batch->SetSize(received);
+#else
+    size_t received = 0;
+
+    while (received < capacity && socketReadyToReceive(sock, 0)) {
+        socklen_t addrSize = sizeof(sockaddr_in);
+        const ssize_t bytes = socket_recvfrom(sock, batch->GetBuffer(received), PacketBatch::SLOT_BYTES, 0,
+            reinterpret_cast<sockaddr *>(&batch->GetAddress(received)), &addrSize);
+        if (bytes <= 0) {
+            break;
+        }
+
+        batch->SetBytes(received, static_cast<size_t>(bytes));
+        received++;
+    }
+    batch->SetSize(received);
+#endif
+
+    if (sCapturing.load(std::memory_order_relaxed)) {
+        const auto now = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < batch->GetSize(); i++) {
+            captureDatagram(Capture::Direction::INCOMING, batch->GetAddress(i), batch->GetBuffer(i), batch->GetBytes(i), now);
+        }
+    }
+
+    return batch->GetSize();
+}
+
+// Outgoing slots are sized by the length their writer sealed in the header
+static size_t getOutgoingSize(PacketBatch *batch, const size_t index) {
+    const PacketView view(batch->GetBuffer(index), PacketBatch::SLOT_BYTES);
+    return Packet::PACKET_HEADER_BYTES + view.GetLength();
+}
+
+// Sends every packet pushed to the batch, returns how many left the socket
+size_t SocketUtils::sendPacketBatchToV4(const SocketType sock, PacketBatch *batch) {
+    const size_t size = batch->GetSize();
+    size_t sent = 0;
+
+#ifdef PLATFORM_LINUX
+    mmsghdr *headers = batch->GetHeaders();
+    for (size_t i = 0; i < size; i++) {
+        headers[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        headers[i].msg_hdr.msg_iov->iov_len = getOutgoingSize(batch, i);
+        headers[i].msg_len = 0;
+    }
+
+    // sendmmsg stops at the first message that fails, resume from there. A
+    // destination that refuses (ECONNREFUSED, EHOSTUNREACH...) only loses its
+    // own message, only a full socket buffer ends the batch.
+    size_t next = 0;
+    while (next < size) {
+        const int result = sendmmsg(sock, headers + next, static_cast<unsigned int>(size - next), 0);
+        if (result > 0) {
+            sent += static_cast<size_t>(result);
+            next += static_cast<size_t>(result);
+            continue;
+        }
+
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result == 0 || errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+        next++;
+    }
+
+    // the ones that failed keep a zero length
+    if (sCapturing.load(std::memory_order_relaxed)) {
+        const auto now = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < next; i++) {
+            if (headers[i].msg_len > 0) {
+                captureDatagram(Capture::Direction::OUTGOING, batch->GetAddress(i), batch->GetBuffer(i), headers[i].msg_hdr.msg_iov->iov_len, now);
+            }
+        }
+    }
+#else
+    for (size_t i = 0; i < size; i++) {
+        if (sendBytesToV4(sock, batch->GetBuffer(i), getOutgoingSize(batch, i), &batch->GetAddress(i))) {
+            sent++;
+        }
+    }
+#endif
+
+    batch->Clear();
+    return sent;
+}
+
+bool SocketUtils::startCapture(const char *path) {
+    if (!sCapture.Open(path)) {
         return false;
     }
+
+    sCapturing = true;
     return true;
+}
+
+void SocketUtils::stopCapture() {
+    sCapturing = false;
+    sCapture.Close();
 }
\ No newline at end of file
@@ -4,11 +4,23 @@
 #pragma once
 #include "Platforms.h"
 #include "Packet.h"
+#include "PacketBatch.h"
 
 namespace  SocketUtils {
     SocketType createSocketV4();
     void bindSocketToAnyV4(SocketType sock);
+    void bindSocketToPortV4(SocketType sock, uint16_t port);
+    void setSocketNonBlocking(SocketType sock);
     bool socketReadyToReceive(SocketType sock, int ms);
     bool sendPacketToV4(SocketType sock, Packet *pk, size_t pkSize, sockaddr_in* addr4);
-    bool receivePacketFromV4(SocketType sock, Packet *pk, sockaddr_in* addr4);
+    bool sendBytesToV4(SocketType sock, const void *bytes, size_t size, sockaddr_in* addr4);
+    // Returns the size of the datagram received, 0 when nothing was
+    size_t receivePacketFromV4(SocketType sock, Packet *pk, sockaddr_in* addr4);
+    size_t receivePacketBatchFromV4(SocketType sock, PacketBatch *batch);
+    size_t sendPacketBatchToV4(SocketType sock, PacketBatch *batch);
+
+    // Optional capture of every datagram sent or received by the calls above,
+    // see Capture.h. Starting one while another is running fails.
+    bool startCapture(const char *path);
+    void stopCapture();
 };
\ No newline at end of file
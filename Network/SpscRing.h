@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// Bounded lock free queue for exactly one producer thread and one consumer thread.
+// Each side caches the other's index and only reloads it when the ring looks full
+// or empty, so the shared cache lines are touched as little as possible.
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+public:
+    // Producer side, false when the ring is full
+    bool TryPush(const T &item) {
+        const size_t head = mHead.load(std::memory_order_relaxed);
+        if (head - mCachedTail == Capacity) {
+            mCachedTail = mTail.load(std::memory_order_acquire);
+            if (head - mCachedTail == Capacity) {
+                return false;
+            }
+        }
+
+        mItems[head & MASK] = item;
+        mHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side, false when the ring is empty
+    bool TryPop(T &item) {
+        const size_t tail = mTail.load(std::memory_order_relaxed);
+        if (tail == mCachedHead) {
+            mCachedHead = mHead.load(std::memory_order_acquire);
+            if (tail == mCachedHead) {
+                return false;
+            }
+        }
+
+        item = mItems[tail & MASK];
+        mTail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side, drops everything queued so far
+    void Clear() {
+        mCachedHead = mHead.load(std::memory_order_acquire);
+        mTail.store(mCachedHead, std::memory_order_release);
+    }
+
+    static constexpr size_t CAPACITY = Capacity;
+
+private:
+    static constexpr size_t MASK = Capacity - 1;
+
+    // producer
+    alignas(64) std::atomic<size_t> mHead{0};
+    size_t mCachedTail = 0;
+
+    // consumer
+    alignas(64) std::atomic<size_t> mTail{0};
+    size_t mCachedHead = 0;
+
+    alignas(64) T mItems[Capacity];
+};
@@ -0,0 +1,334 @@
+#include "Transport.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    bool isFraming(const uint8_t flag) {
+        return flag == Packet::FRAGMENT_FLAG || flag == Packet::BUNDLE_FLAG;
+    }
+
+    // Handshake and teardown, read as plain packets before and after the
+    // peer has a TransportReader
+    bool isControl(const uint8_t flag) {
+        return flag == Packet::SYN_FLAG || flag == Packet::SYN_ACK_FLAG || flag == Packet::ACK_FLAG ||
+               flag == Packet::END_FLAG || flag == Packet::END_ACK_FLAG || flag == Packet::RST_FLAG;
+    }
+}
+
+size_t TransportWriter::getSlotsNeeded(const size_t size) {
+    if (size <= PacketWriter::PAYLOAD_CAPACITY) {
+        return 1;
+    }
+    return (size + Transport::FRAGMENT_DATA_BYTES - 1) / Transport::FRAGMENT_DATA_BYTES;
+}
+
+size_t TransportWriter::Write(
+    const sockaddr_in &addr,
+    const uint32_t nonce,
+    const IntegrityMode mode,
+    const uint8_t flag,
+    const uint16_t sequence,
+    const void *data,
+    const size_t size
+) {
+    if (size > Transport::MAX_MESSAGE_BYTES || isFraming(flag)) {
+        return 0;
+    }
+
+    const auto *bytes = static_cast<const uint8_t*>(data);
+
+    if (size > PacketWriter::PAYLOAD_CAPACITY) {
+        Seal();
+        return WriteFragments(addr, nonce, mode, flag, sequence, bytes, size);
+    }
+
+    // append to the open datagram, its first message moves into an entry of its own
+    if (!isControl(flag) && IsOpenFor(addr, nonce, mode)) {
+        const size_t firstEntry = mEntries == 1 ? Transport::BUNDLE_ENTRY_BYTES : 0;
+        const size_t needed = firstEntry + Transport::BUNDLE_ENTRY_BYTES + size;
+
+        if (mPayloadSize + needed <= PacketWriter::PAYLOAD_CAPACITY) {
+            const PacketWriter writer(mBatch->GetBuffer(mSlot));
+            uint8_t *payload = writer.GetPayload();
+
+            if (mEntries == 1) {
+                memmove(payload + Transport::BUNDLE_ENTRY_BYTES, payload, mPayloadSize);
+                const Transport::BundleEntry entry{mSequence, static_cast<uint16_t>(mPayloadSize), mFlag};
+                Wire::encode(entry, payload, Transport::BUNDLE_ENTRY_BYTES);
+                mPayloadSize += Transport::BUNDLE_ENTRY_BYTES;
+                writer.Begin(mSequence, Packet::BUNDLE_FLAG, mNonce);
+            }
+
+            const Transport::BundleEntry entry{sequence, static_cast<uint16_t>(size), flag};
+            Wire::encode(entry, payload + mPayloadSize, Transport::BUNDLE_ENTRY_BYTES);
+            if (size > 0) {
+                memcpy(payload + mPayloadSize + Transport::BUNDLE_ENTRY_BYTES, bytes, size);
+            }
+            mPayloadSize += Transport::BUNDLE_ENTRY_BYTES + size;
+            mEntries++;
+            return needed;
+        }
+    }
+
+    Seal();
+
+    const PacketWriter writer = mBatch->Push(addr);
+    if (writer.IsNull()) {
+        return 0;
+    }
+
+    writer.Begin(sequence, flag, nonce);
+    if (size > 0) {
+        memcpy(writer.GetPayload(), bytes, size);
+    }
+
+    // a control message gets its datagram to itself, nothing joins it
+    if (isControl(flag)) {
+        return writer.Finish(size, mode);
+    }
+
+    mOpen = true;
+    mSlot = mBatch->GetSize() - 1;
+    mAddr = addr;
+    mNonce = nonce;
+    mMode = mode;
+    mFlag = flag;
+    mSequence = sequence;
+    mPayloadSize = size;
+    mEntries = 1;
+    return Packet::PACKET_HEADER_BYTES + size;
+}
+
+void TransportWriter::Seal() {
+    if (!mOpen) {
+        return;
+    }
+
+    // the batch was sent or cleared without sealing, the slot is gone
+    if (mSlot < mBatch->GetSize()) {
+        PacketWriter(mBatch->GetBuffer(mSlot)).Finish(mPayloadSize, mMode);
+    }
+    mOpen = false;
+}
+
+size_t TransportWriter::WriteFragments(
+    const sockaddr_in &addr,
+    const uint32_t nonce,
+    const IntegrityMode mode,
+    const uint8_t flag,
+    const uint16_t sequence,
+    const uint8_t *data,
+    const size_t size
+) const {
+    // all or nothing, a partial message would only take reassembly slots
+    const size_t count = getSlotsNeeded(size);
+    if (mBatch->GetCapacity() - mBatch->GetSize() < count) {
+        return 0;
+    }
+
+    size_t written = 0;
+    for (size_t index = 0; index < count; index++) {
+        const size_t offset = index * Transport::FRAGMENT_DATA_BYTES;
+        const size_t chunk = std::min(Transport::FRAGMENT_DATA_BYTES, size - offset);
+
+        const PacketWriter writer = mBatch->Push(addr);
+        writer.Begin(sequence, Packet::FRAGMENT_FLAG, nonce);
+
+        const Transport::FragmentHeader header{flag, static_cast<uint8_t>(index), static_cast<uint8_t>(count)};
+        Wire::encode(header, writer.GetPayload(), Transport::FRAGMENT_HEADER_BYTES);
+        memcpy(writer.GetPayload() + Transport::FRAGMENT_HEADER_BYTES, data + offset, chunk);
+
+        written += writer.Finish(Transport::FRAGMENT_HEADER_BYTES + chunk, mode);
+    }
+    return written;
+}
+
+bool TransportWriter::IsOpenFor(const sockaddr_in &addr, const uint32_t nonce, const IntegrityMode mode) const {
+    return mOpen &&
+           mSlot + 1 == mBatch->GetSize() &&
+           mAddr.sin_addr.s_addr == addr.sin_addr.s_addr &&
+           mAddr.sin_port == addr.sin_port &&
+           mNonce == nonce &&
+           mMode == mode;
+}
+
+void FragmentAssembler::Clear() {
+    for (auto &slot : mSlots) {
+        slot.used = false;
+    }
+}
+
+bool FragmentAssembler::Add(
+    const uint16_t sequence,
+    const void *data,
+    const size_t size,
+    const std::chrono::steady_clock::time_point now,
+    Transport::Message *message
+) {
+    if (size <= Transport::FRAGMENT_HEADER_BYTES) {
+        return false;
+    }
+
+    Transport::FragmentHeader header{};
+    Wire::decode(data, size, &header);
+    const auto *chunk = static_cast<const uint8_t*>(data) + Transport::FRAGMENT_HEADER_BYTES;
+    const size_t chunkSize = size - Transport::FRAGMENT_HEADER_BYTES;
+
+    if (header.count < 2 || header.count > Transport::MAX_FRAGMENTS || header.index >= header.count ||
+        isFraming(header.flag)) {
+        return false;
+    }
+
+    // only the last chunk may be short
+    const bool last = header.index == header.count - 1;
+    if (!last && chunkSize != Transport::FRAGMENT_DATA_BYTES) {
+        return false;
+    }
+
+    Slot *slot = FindSlot(header.flag, sequence, now);
+    if (slot->used && slot->complete) {
+        return false;
+    }
+
+    if (!slot->used) {
+        slot->used = true;
+        slot->complete = false;
+        slot->flag = header.flag;
+        slot->sequence = sequence;
+        slot->count = header.count;
+        slot->received = 0;
+        slot->receivedMask = 0;
+        slot->lastSize = 0;
+        slot->startedAt = now;
+    }
+
+    const auto bit = static_cast<uint8_t>(1u << header.index);
+    if (slot->count != header.count || (slot->receivedMask & bit) != 0) {
+        return false;
+    }
+
+    memcpy(slot->data + header.index * Transport::FRAGMENT_DATA_BYTES, chunk, chunkSize);
+    slot->receivedMask |= bit;
+    slot->received++;
+    if (last) {
+        slot->lastSize = chunkSize;
+    }
+
+    if (slot->received < slot->count) {
+        return false;
+    }
+
+    // kept as done so late duplicates are dropped, the bytes stay until the slot is reused
+    slot->complete = true;
+    message->flag = slot->flag;
+    message->sequence = slot->sequence;
+    message->data = slot->data;
+    message->size = (slot->count - 1) * Transport::FRAGMENT_DATA_BYTES + slot->lastSize;
+    return true;
+}
+
+FragmentAssembler::Slot *FragmentAssembler::FindSlot(
+    const uint8_t flag,
+    const uint16_t sequence,
+    const std::chrono::steady_clock::time_point now
+) {
+    Slot *free = nullptr;
+    Slot *oldestComplete = nullptr;
+    Slot *oldest = nullptr;
+
+    for (auto &slot : mSlots) {
+        if (slot.used && now - slot.startedAt > Transport::REASSEMBLY_TIMEOUT) {
+            slot.used = false;
+        }
+
+        if (!slot.used) {
+            if (free == nullptr) {
+                free = &slot;
+            }
+            continue;
+        }
+
+        if (slot.flag == flag && slot.sequence == sequence) {
+            return &slot;
+        }
+
+        Slot *&candidate = slot.complete ? oldestComplete : oldest;
+        if (candidate == nullptr || slot.startedAt < candidate->startedAt) {
+            candidate = &slot;
+        }
+    }
+
+    // finished messages give way first, then the oldest unfinished one
+    Slot *slot = free != nullptr ? free : oldestComplete != nullptr ? oldestComplete : oldest;
+    slot->used = false;
+    return slot;
+}
+
+void TransportReader::Clear() {
+    mAssembler.Clear();
+    mPacket = PacketView();
+    mDone = true;
+    mOffset = 0;
+    mHasFragmentMessage = false;
+}
+
+void TransportReader::Begin(const PacketView &packet, const std::chrono::steady_clock::time_point now) {
+    mPacket = packet;
+    mDone = false;
+    mOffset = 0;
+    mHasFragmentMessage = false;
+
+    if (packet.GetFlag() == Packet::FRAGMENT_FLAG) {
+        mHasFragmentMessage = mAssembler.Add(
+            packet.GetSequence(),
+            packet.GetData(),
+            packet.GetLength(),
+            now,
+            &mFragmentMessage
+        );
+    }
+}
+
+bool TransportReader::Next(Transport::Message *message) {
+    if (mDone) {
+        return false;
+    }
+
+    const uint8_t flag = mPacket.GetFlag();
+    const auto *payload = static_cast<const uint8_t*>(mPacket.GetData());
+    const size_t length = mPacket.GetLength();
+
+    if (flag == Packet::FRAGMENT_FLAG) {
+        mDone = true;
+        if (!mHasFragmentMessage) {
+            return false;
+        }
+        *message = mFragmentMessage;
+        return true;
+    }
+
+    if (flag != Packet::BUNDLE_FLAG) {
+        mDone = true;
+        *message = {flag, mPacket.GetSequence(), payload, length};
+        return true;
+    }
+
+    // a malformed entry ends the bundle, the ones before it were fine
+    Transport::BundleEntry entry{};
+    if (length - mOffset < Transport::BUNDLE_ENTRY_BYTES) {
+        mDone = true;
+        return false;
+    }
+    Wire::decode(payload + mOffset, length - mOffset, &entry);
+
+    const size_t start = mOffset + Transport::BUNDLE_ENTRY_BYTES;
+    if (entry.size > length - start || isFraming(entry.flag)) {
+        mDone = true;
+        return false;
+    }
+
+    *message = {entry.flag, entry.sequence, payload + start, entry.size};
+    mOffset = start + entry.size;
+    mDone = mOffset == length;
+    return true;
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include "Platforms.h"
+#include "Packet.h"
+#include "PacketBatch.h"
+#include "PacketView.h"
+#include "WireFormat.h"
+
+// Framing between the protocol messages (DATA, PING, ...) and the datagrams.
+// A message larger than one payload is split in FRAGMENT datagrams that carry
+// its sequence, small messages written back to back for the same peer share a
+// BUNDLE datagram. A datagram holding a single message is a plain packet of
+// that message, so nothing changes on the wire while messages stay small.
+// Handshake and teardown messages (SYN, SYN_ACK, ACK, END, END_ACK, RST) are
+// never bundled, the peer reads them as plain packets.
+//
+// FRAGMENT payload: FragmentHeader, then the chunk. Every chunk but the last
+// one is FRAGMENT_DATA_BYTES long.
+// BUNDLE payload: per message a BundleEntry, then its bytes.
+// Both go through Wire, little endian whatever the host.
+namespace Transport {
+    struct FragmentHeader {
+        uint8_t flag;
+        uint8_t index;
+        uint8_t count;
+    };
+
+    struct BundleEntry {
+        uint16_t sequence;
+        uint16_t size;
+        uint8_t flag;
+    };
+}
+
+template <>
+struct Wire::Schema<Transport::FragmentHeader> {
+    using Fields = std::tuple<
+        Wire::Field<&Transport::FragmentHeader::flag>,
+        Wire::Field<&Transport::FragmentHeader::index>,
+        Wire::Field<&Transport::FragmentHeader::count>
+    >;
+};
+
+template <>
+struct Wire::Schema<Transport::BundleEntry> {
+    using Fields = std::tuple<
+        Wire::Field<&Transport::BundleEntry::flag>,
+        Wire::Field<&Transport::BundleEntry::sequence>,
+        Wire::Field<&Transport::BundleEntry::size>
+    >;
+};
+
+namespace Transport {
+    static constexpr size_t FRAGMENT_HEADER_BYTES = Wire::size<FragmentHeader>();
+    static constexpr size_t BUNDLE_ENTRY_BYTES = Wire::size<BundleEntry>();
+    static constexpr size_t FRAGMENT_DATA_BYTES = Packet::MAX_PACKET_DATA_BYTES - FRAGMENT_HEADER_BYTES;
+    static constexpr size_t MAX_FRAGMENTS = 4;
+    static constexpr size_t MAX_MESSAGE_BYTES = MAX_FRAGMENTS * FRAGMENT_DATA_BYTES;
+    // messages being reassembled at once per peer, the oldest gives way to a new one
+    static constexpr size_t REASSEMBLY_SLOTS = 4;
+    // a few server ticks, a snapshot that old is useless anyway
+    static constexpr auto REASSEMBLY_TIMEOUT = std::chrono::milliseconds(200);
+
+    // Points into the datagram or the reassembly slot, valid until the next datagram is read
+    struct Message {
+        uint8_t flag;
+        uint16_t sequence;
+        const uint8_t *data;
+        size_t size;
+    };
+}
+
+// Writes messages into the slots of a PacketBatch. Everything pushed to the
+// batch must go through the same writer, and Seal must run before the batch
+// is sent since the last datagram stays open for more messages.
+class TransportWriter {
+public:
+    explicit TransportWriter(PacketBatch *batch) :mBatch(batch), mOpen(false), mSlot(0), mAddr{}, mNonce(0),
+    mMode(IntegrityMode::ONES_COMPLEMENT), mFlag(0), mSequence(0), mPayloadSize(0), mEntries(0) {}
+
+    // Returns the bytes added to the batch, 0 when the message is over
+    // MAX_MESSAGE_BYTES or the batch has no room for it
+    size_t Write(
+        const sockaddr_in &addr,
+        uint32_t nonce,
+        IntegrityMode mode,
+        uint8_t flag,
+        uint16_t sequence,
+        const void *data,
+        size_t size
+    );
+
+    void Seal();
+
+private:
+    // Slots a message of this size takes
+    static size_t getSlotsNeeded(size_t size);
+
+    size_t WriteFragments(const sockaddr_in &addr, uint32_t nonce, IntegrityMode mode, uint8_t flag,
+        uint16_t sequence, const uint8_t *data, size_t size) const;
+    [[nodiscard]] bool IsOpenFor(const sockaddr_in &addr, uint32_t nonce, IntegrityMode mode) const;
+
+    PacketBatch *mBatch;
+
+    // datagram still accepting messages
+    bool mOpen;
+    size_t mSlot;
+    sockaddr_in mAddr;
+    uint32_t mNonce;
+    IntegrityMode mMode;
+    uint8_t mFlag;
+    uint16_t mSequence;
+    size_t mPayloadSize;
+    size_t mEntries;
+};
+
+// Puts the fragments of a message back together. Memory is fixed, every slot
+// holds up to MAX_MESSAGE_BYTES, and slots not completed in REASSEMBLY_TIMEOUT
+// are given up.
+class FragmentAssembler {
+public:
+    FragmentAssembler() { Clear(); }
+
+    void Clear();
+
+    // True when the fragment completed its message, malformed fragments are dropped
+    bool Add(uint16_t sequence, const void *data, size_t size, std::chrono::steady_clock::time_point now,
+        Transport::Message *message);
+
+private:
+    struct Slot {
+        bool used;
+        bool complete;
+        uint8_t flag;
+        uint16_t sequence;
+        uint8_t count;
+        uint8_t received;
+        uint8_t receivedMask;
+        size_t lastSize;
+        std::chrono::steady_clock::time_point startedAt;
+        uint8_t data[Transport::MAX_MESSAGE_BYTES];
+    };
+
+    static_assert(Transport::MAX_FRAGMENTS <= 8, "receivedMask holds one bit per fragment");
+
+    Slot *FindSlot(uint8_t flag, uint16_t sequence, std::chrono::steady_clock::time_point now);
+
+    Slot mSlots[Transport::REASSEMBLY_SLOTS];
+};
+
+// Hands out the messages of the datagrams received from one peer
+class TransportReader {
+public:
+    TransportReader() :mDone(true), mOffset(0), mHasFragmentMessage(false), mFragmentMessage{} {}
+
+    void Clear();
+
+    // The datagram must have passed IsValid
+    void Begin(const PacketView &packet, std::chrono::steady_clock::time_point now);
+
+    // Next message of the datagram, a fragment only gives the message it completes
+    bool Next(Transport::Message *message);
+
+private:
+    FragmentAssembler mAssembler;
+    PacketView mPacket;
+    bool mDone;
+    size_t mOffset;
+    bool mHasFragmentMessage;
+    Transport::Message mFragmentMessage;
+};
@@ -0,0 +1,345 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Field by field serialization of the protocol structs. A message type lists
+// its fields once in a Wire::Schema specialization and encode/decode are
+// generated from that table at compile time: every field has a fixed offset
+// and a fixed little endian size, so the bytes on the wire no longer depend on
+// struct packing, the size of bool or int, or the host byte order. The only
+// branch is the one bounds check per message.
+//
+// A message whose fields are laid out in memory exactly as on the wire (see
+// isPlain) is copied whole instead. On little endian hosts that is every
+// message made of integers, floats and byte sized enums declared from the
+// widest field to the narrowest; messages of LittleEndian fields are plain on
+// every host, and have no tail padding, so their arrays are one memcpy.
+namespace Wire {
+    // Wire size, store and load of one value type. PLAIN when the wire bytes
+    // of a value are its bytes in memory on this host.
+    template <typename T, typename Enable = void>
+    struct Codec;
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    constexpr bool LITTLE_ENDIAN_HOST = false;
+#else
+    constexpr bool LITTLE_ENDIAN_HOST = true;
+#endif
+
+    namespace detail {
+        // Little endian words are loaded and stored whole, big endian hosts
+        // swap them and compilers turn that into one bswap or movbe
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        inline uint16_t toLittle(const uint16_t value) { return __builtin_bswap16(value); }
+        inline uint32_t toLittle(const uint32_t value) { return __builtin_bswap32(value); }
+#else
+        inline uint16_t toLittle(const uint16_t value) { return value; }
+        inline uint32_t toLittle(const uint32_t value) { return value; }
+#endif
+
+        template <typename Word>
+        void storeLittle(const Word value, uint8_t *out) {
+            const Word little = toLittle(value);
+            memcpy(out, &little, sizeof(little));
+        }
+
+        template <typename Word>
+        Word loadLittle(const uint8_t *in) {
+            Word little;
+            memcpy(&little, in, sizeof(little));
+            return toLittle(little);
+        }
+    }
+
+    template <>
+    struct Codec<uint8_t> {
+        static constexpr size_t BYTES = 1;
+        static constexpr bool PLAIN = true;
+        static void write(const uint8_t value, uint8_t *out) { out[0] = value; }
+        static uint8_t read(const uint8_t *in) { return in[0]; }
+    };
+
+    template <>
+    struct Codec<uint16_t> {
+        static constexpr size_t BYTES = 2;
+        static constexpr bool PLAIN = LITTLE_ENDIAN_HOST;
+        static void write(const uint16_t value, uint8_t *out) { detail::storeLittle(value, out); }
+        static uint16_t read(const uint8_t *in) { return detail::loadLittle<uint16_t>(in); }
+    };
+
+    template <>
+    struct Codec<uint32_t> {
+        static constexpr size_t BYTES = 4;
+        static constexpr bool PLAIN = LITTLE_ENDIAN_HOST;
+        static void write(const uint32_t value, uint8_t *out) { detail::storeLittle(value, out); }
+        static uint32_t read(const uint8_t *in) { return detail::loadLittle<uint32_t>(in); }
+    };
+
+    template <>
+    struct Codec<int32_t> {
+        static constexpr size_t BYTES = 4;
+        static constexpr bool PLAIN = LITTLE_ENDIAN_HOST;
+        static void write(const int32_t value, uint8_t *out) { Codec<uint32_t>::write(static_cast<uint32_t>(value), out); }
+        static int32_t read(const uint8_t *in) { return static_cast<int32_t>(Codec<uint32_t>::read(in)); }
+    };
+
+    // Any byte but 0 reads as true, so a bool is never copied as is
+    template <>
+    struct Codec<bool> {
+        static constexpr size_t BYTES = 1;
+        static constexpr bool PLAIN = false;
+        static void write(const bool value, uint8_t *out) { out[0] = value ? 1 : 0; }
+        static bool read(const uint8_t *in) { return in[0] != 0; }
+    };
+
+    // IEEE 754 bits, sent like any other 32 bit word
+    template <>
+    struct Codec<float> {
+        static_assert(std::numeric_limits<float>::is_iec559 && sizeof(float) == 4, "floats go out as IEEE 754 words");
+
+        static constexpr size_t BYTES = 4;
+        static constexpr bool PLAIN = LITTLE_ENDIAN_HOST;
+        static void write(const float value, uint8_t *out) {
+            uint32_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            Codec<uint32_t>::write(bits, out);
+        }
+        static float read(const uint8_t *in) {
+            const uint32_t bits = Codec<uint32_t>::read(in);
+            float value;
+            memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+    };
+
+    // Enums travel as their underlying type
+    template <typename T>
+    struct Codec<T, std::enable_if_t<std::is_enum_v<T>>> {
+        using Underlying = std::underlying_type_t<T>;
+
+        static constexpr size_t BYTES = Codec<Underlying>::BYTES;
+        static constexpr bool PLAIN = Codec<Underlying>::PLAIN;
+        static void write(const T value, uint8_t *out) { Codec<Underlying>::write(static_cast<Underlying>(value), out); }
+        static T read(const uint8_t *in) { return static_cast<T>(Codec<Underlying>::read(in)); }
+    };
+
+    // An integer or a float stored as its little endian bytes, with no
+    // alignment. A message made of these and of byte sized fields has no
+    // padding and holds its wire bytes on every host, so arrays of it are
+    // copied whole. Reads and writes convert to and from T.
+    template <typename T>
+    class LittleEndian {
+    public:
+        LittleEndian() = default;
+        LittleEndian(const T value) { Codec<T>::write(value, mBytes); }
+
+        LittleEndian &operator=(const T value) {
+            Codec<T>::write(value, mBytes);
+            return *this;
+        }
+
+        operator T() const { return Codec<T>::read(mBytes); }
+
+    private:
+        uint8_t mBytes[Codec<T>::BYTES];
+    };
+
+    template <typename T>
+    struct Codec<LittleEndian<T>> {
+        static constexpr size_t BYTES = Codec<T>::BYTES;
+        static constexpr bool PLAIN = true;
+        static void write(const LittleEndian<T> value, uint8_t *out) { memcpy(out, &value, BYTES); }
+        static LittleEndian<T> read(const uint8_t *in) {
+            LittleEndian<T> value;
+            memcpy(static_cast<void*>(&value), in, BYTES);
+            return value;
+        }
+    };
+
+    template <typename Member>
+    struct MemberTraits;
+
+    template <typename Owner, typename Value>
+    struct MemberTraits<Value Owner::*> {
+        using OwnerType = Owner;
+        using ValueType = Value;
+    };
+
+    // One data member of a message, the value type picks the codec
+    template <auto Member>
+    struct Field {
+        using Owner = typename MemberTraits<decltype(Member)>::OwnerType;
+        using Value = typename MemberTraits<decltype(Member)>::ValueType;
+
+        static constexpr size_t BYTES = Codec<Value>::BYTES;
+        static constexpr bool PLAIN = Codec<Value>::PLAIN && sizeof(Value) == BYTES;
+        static constexpr size_t ALIGNMENT = alignof(Value);
+        static void write(const Owner &owner, uint8_t *out) { Codec<Value>::write(owner.*Member, out); }
+        static void read(Owner &owner, const uint8_t *in) { owner.*Member = Codec<Value>::read(in); }
+    };
+
+    // Specialized next to each message type, with every data member in
+    // declaration order:
+    //   template <> struct Wire::Schema<T> { using Fields = std::tuple<Wire::Field<&T::a>, ...>; };
+    template <typename T>
+    struct Schema;
+
+    namespace detail {
+        template <typename Fields, size_t... I>
+        constexpr std::array<size_t, sizeof...(I) + 1> offsets(std::index_sequence<I...>) {
+            const size_t sizes[] = {std::tuple_element_t<I, Fields>::BYTES..., 0};
+            std::array<size_t, sizeof...(I) + 1> result{};
+            for (size_t i = 0; i < sizeof...(I); i++) {
+                result[i + 1] = result[i] + sizes[i];
+            }
+            return result;
+        }
+
+        template <typename T>
+        using Fields = typename Schema<T>::Fields;
+
+        template <typename T>
+        using FieldIndices = std::make_index_sequence<std::tuple_size_v<Fields<T>>>;
+
+        // Offset of every field, the last entry is the whole message
+        template <typename T>
+        inline constexpr auto OFFSETS = offsets<Fields<T>>(FieldIndices<T>{});
+
+        // Members follow each other in declaration order, each one at the
+        // next offset aligned for its type. When every wire offset already is
+        // aligned that way the compiler left no padding between the fields,
+        // and the size check catches members missing from the schema.
+        template <typename T, size_t... I>
+        constexpr bool isPlain(std::index_sequence<I...>) {
+            using Fields = typename Schema<T>::Fields;
+            constexpr size_t alignment = alignof(T);
+            constexpr size_t wireSize = OFFSETS<T>.back();
+
+            return std::is_standard_layout_v<T> &&
+                   std::is_trivially_copyable_v<T> &&
+                   ((std::tuple_element_t<I, Fields>::PLAIN &&
+                     OFFSETS<T>[I] % std::tuple_element_t<I, Fields>::ALIGNMENT == 0) && ...) &&
+                   sizeof(T) == (wireSize + alignment - 1) / alignment * alignment;
+        }
+
+        template <typename T, size_t... I>
+        void write(const T &value, uint8_t *out, std::index_sequence<I...>) {
+            (std::tuple_element_t<I, Fields<T>>::write(value, out + OFFSETS<T>[I]), ...);
+        }
+
+        template <typename T, size_t... I>
+        void read(T &value, const uint8_t *in, std::index_sequence<I...>) {
+            (std::tuple_element_t<I, Fields<T>>::read(value, in + OFFSETS<T>[I]), ...);
+        }
+    }
+
+    // Bytes of one message on the wire
+    template <typename T>
+    constexpr size_t size() {
+        return detail::OFFSETS<T>.back();
+    }
+
+    // True when the message is stored in memory as it goes on the wire, its
+    // first size() bytes are then copied as they are
+    template <typename T>
+    constexpr bool isPlain() {
+        return detail::isPlain<T>(detail::FieldIndices<T>{});
+    }
+
+    namespace detail {
+        template <typename T>
+        void writeMessage(const T &value, uint8_t *out) {
+            if constexpr (Wire::isPlain<T>()) {
+                memcpy(out, &value, size<T>());
+            } else {
+                write(value, out, FieldIndices<T>{});
+            }
+        }
+
+        template <typename T>
+        void readMessage(T &value, const uint8_t *in) {
+            if constexpr (Wire::isPlain<T>()) {
+                memcpy(static_cast<void*>(&value), in, size<T>());
+            } else {
+                read(value, in, FieldIndices<T>{});
+            }
+        }
+    }
+
+    // Returns the bytes written, 0 when the message does not fit the capacity
+    template <typename T>
+    size_t encode(const T &value, void *out, const size_t capacity) {
+        if (capacity < size<T>()) {
+            return 0;
+        }
+
+        detail::writeMessage(value, static_cast<uint8_t*>(out));
+        return size<T>();
+    }
+
+    // Returns the bytes read, 0 when the data is shorter than a message and
+    // the value is left untouched
+    template <typename T>
+    size_t decode(const void *in, const size_t available, T *value) {
+        if (available < size<T>()) {
+            return 0;
+        }
+
+        detail::readMessage(*value, static_cast<const uint8_t*>(in));
+        return size<T>();
+    }
+
+    // Back to back messages, as many whole ones as fit. Returns the bytes written.
+    template <typename T>
+    size_t encodeArray(const T *values, const size_t count, void *out, const size_t capacity) {
+        auto *bytes = static_cast<uint8_t*>(out);
+        if constexpr (isPlain<T>() && sizeof(T) == size<T>()) {
+            // the usual case first, the size stays known when count is
+            if (count * size<T>() <= capacity) {
+                memcpy(bytes, values, count * size<T>());
+                return count * size<T>();
+            }
+        }
+
+        const size_t fitting = std::min(count, capacity / size<T>());
+        if constexpr (isPlain<T>() && sizeof(T) == size<T>()) {
+            memcpy(bytes, values, fitting * size<T>());
+        } else {
+            // padded structs go one by one, at their exact size
+            for (size_t i = 0; i < fitting; i++) {
+                detail::writeMessage(values[i], bytes + i * size<T>());
+            }
+        }
+        return fitting * size<T>();
+    }
+
+    // Returns how many whole messages were read, trailing bytes are ignored
+    template <typename T>
+    size_t decodeArray(const void *in, const size_t available, T *values, const size_t capacity) {
+        const auto *bytes = static_cast<const uint8_t*>(in);
+        if constexpr (isPlain<T>() && sizeof(T) == size<T>()) {
+            if (available >= capacity * size<T>()) {
+                memcpy(static_cast<void*>(values), bytes, capacity * size<T>());
+                return capacity;
+            }
+        }
+
+        const size_t fitting = std::min(available / size<T>(), capacity);
+        if constexpr (isPlain<T>() && sizeof(T) == size<T>()) {
+            memcpy(static_cast<void*>(values), bytes, fitting * size<T>());
+        } else {
+            for (size_t i = 0; i < fitting; i++) {
+                detail::readMessage(values[i], bytes + i * size<T>());
+            }
+        }
+        return fitting;
+    }
+}
@@ -0,0 +1,45 @@
+#include "Server.h"
+#include "../Network/Socket.h"
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+
+static Server *sServer = nullptr;
+
+static void HandleSignal(int) {
+    if (sServer) {
+        sServer->Quit();
+    }
+}
+
+int main(const int argc, char **argv) {
+    // every datagram of the session is appended to the capture, see Network/Capture.h
+    const char *capturePath = nullptr;
+    if (argc == 3 && strcmp(argv[1], "--capture") == 0) {
+        capturePath = argv[2];
+    } else if (argc != 1) {
+        printf("Usage: %s [--capture FILE]\n", argv[0]);
+        return 1;
+    }
+
+    networkingInit();
+
+    if (capturePath && !SocketUtils::startCapture(capturePath)) {
+        printf("Could not create capture %s\n", capturePath);
+    }
+
+    Server server;
+    sServer = &server;
+
+    std::signal(SIGINT, HandleSignal);
+    std::signal(SIGTERM, HandleSignal);
+
+    if (server.Initialize()) {
+        server.RunLoop();
+    }
+    server.Shutdown();
+
+    SocketUtils::stopCapture();
+    networkingCleanup();
+    return 0;
+}
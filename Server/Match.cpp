@@ -0,0 +1,332 @@
+#include "Match.h"
+#include <algorithm>
+#include "Server.h"
+
+static_assert(Match::COMMANDS_PER_TICK * Server::SIM_DELTA_TIME == Server::TICK_DELTA_TIME,
+              "one tick must last COMMANDS_PER_TICK client frames");
+
+// The first spawn points mirror the local game layout, one per corner
+static const Vector2 CORNER_SPAWN_POINTS[] = {
+    Vector2(ShipSimulation::WORLD_WIDTH - 100.0f, 100.0f),
+    Vector2(100.0f, ShipSimulation::WORLD_HEIGHT - 100.0f),
+    Vector2(100.0f, 100.0f),
+    Vector2(ShipSimulation::WORLD_WIDTH - 100.0f, ShipSimulation::WORLD_HEIGHT - 100.0f),
+};
+
+// Larger rooms spread the remaining players on an ellipse around the center
+static Vector2 getSpawnPoint(const int slot) {
+    constexpr int cornersSize = sizeof(CORNER_SPAWN_POINTS) / sizeof(CORNER_SPAWN_POINTS[0]);
+    if (slot < cornersSize) {
+        return CORNER_SPAWN_POINTS[slot];
+    }
+
+    constexpr float margin = 200.0f;
+    const float angle = Math::TwoPi * static_cast<float>(slot - cornersSize) /
+        static_cast<float>(Match::MAX_PLAYERS - cornersSize);
+
+    return Vector2(
+        ShipSimulation::WORLD_WIDTH / 2.0f + (ShipSimulation::WORLD_WIDTH / 2.0f - margin) * Math::Cos(angle),
+        ShipSimulation::WORLD_HEIGHT / 2.0f + (ShipSimulation::WORLD_HEIGHT / 2.0f - margin) * Math::Sin(angle)
+    );
+}
+
+Match::Match()
+:mPlayersSize(0)
+,mPriorities{}
+{
+    mLasers.reserve(MAX_PLAYERS * 4);
+    mShots.reserve(MAX_PLAYERS * 4);
+}
+
+int Match::AddPlayer(const int playerId) {
+    for (int slot = 0; slot < MAX_PLAYERS; slot++) {
+        if (mPlayers[slot].used) {
+            continue;
+        }
+
+        MatchPlayer &player = mPlayers[slot];
+        player = MatchPlayer();
+        player.used = true;
+        player.id = playerId;
+        const Vector2 spawnPoint = getSpawnPoint(slot);
+        player.ship.posX = spawnPoint.x;
+        player.ship.posY = spawnPoint.y;
+        player.ship.rotation = slot % 2 == 0 ? Math::Pi : 0.0f;
+        player.ship.life = ShipSimulation::MAX_LIVES;
+        player.commandBudget = MAX_COMMAND_BUDGET;
+
+        for (int i = 0; i < MAX_PLAYERS; i++) {
+            mPriorities[slot][i] = 0.0f;
+            mPriorities[i][slot] = 0.0f;
+        }
+
+        mPlayersSize++;
+        return slot;
+    }
+
+    return -1;
+}
+
+void Match::RemovePlayer(const int slot) {
+    if (slot < 0 || slot >= MAX_PLAYERS || !mPlayers[slot].used) {
+        return;
+    }
+
+    mPlayers[slot] = MatchPlayer();
+    mPlayersSize--;
+
+    // ticks stop while the match is empty, the frames would no longer be one tick apart
+    if (mPlayersSize == 0) {
+        mHistory.Clear();
+    }
+
+    mLasers.erase(
+        std::remove_if(mLasers.begin(), mLasers.end(), [slot](const MatchLaser &laser) {
+            return laser.ownerSlot == slot;
+        }),
+        mLasers.end()
+    );
+}
+
+void Match::ApplyCommands(const int slot, const Command *commands, const size_t commandsSize, const float rewindTicks) {
+    MatchPlayer &player = mPlayers[slot];
+    if (!player.used || player.ship.life <= 0) {
+        return;
+    }
+
+    const size_t sizeToUse = std::min(commandsSize, MAX_COMMANDS_PER_BATCH);
+    for (size_t i = 0; i < sizeToUse; i++) {
+        const Command &cmd = commands[i];
+
+        // batches carry every unconfirmed command, skip the ones already applied
+        if (player.hasConfirmedInput && cmd.sequence <= player.lastConfirmedInputSequence) {
+            continue;
+        }
+
+        // the rest stays unconfirmed until a later tick
+        if (player.commandBudget == 0) {
+            break;
+        }
+        player.commandBudget--;
+
+        if (ShipSimulation::step(player.ship, cmd.inputData, Server::SIM_DELTA_TIME)) {
+            FireLaser(slot, rewindTicks);
+        }
+
+        player.hasConfirmedInput = true;
+        player.lastConfirmedInputSequence = cmd.sequence;
+        player.receivedInputThisTick = true;
+    }
+}
+
+void Match::Update(const float deltaTime) {
+    for (auto &player : mPlayers) {
+        if (!player.used) {
+            continue;
+        }
+
+        // the client keeps cooling down while idle, commands only cover active frames
+        if (!player.receivedInputThisTick) {
+            ShipSimulation::updateCooldown(player.ship, deltaTime);
+        }
+        player.receivedInputThisTick = false;
+        player.commandBudget = std::min(player.commandBudget + COMMANDS_PER_TICK, MAX_COMMAND_BUDGET);
+
+        ShipSimulation::updateInvulnerability(player.ship, deltaTime);
+        player.recentFireTimer = Math::Max(0.0f, player.recentFireTimer - deltaTime);
+    }
+
+    // lasers rewind from this tick on, like the ones fired before the next one
+    RecordHistory();
+    CheckLaserHits();
+
+    for (auto &laser : mLasers) {
+        laser.lifetime -= deltaTime;
+    }
+
+    mLasers.erase(
+        std::remove_if(mLasers.begin(), mLasers.end(), [](const MatchLaser &laser) {
+            return laser.lifetime <= 0.0f;
+        }),
+        mLasers.end()
+    );
+}
+
+FullState Match::BuildState(const int slot) {
+    const MatchPlayer &player = mPlayers[slot];
+
+    RawState raw;
+    raw.active = player.ship.life > 0;
+    raw.posX = player.ship.posX;
+    raw.posY = player.ship.posY;
+    raw.rotation = player.ship.rotation;
+    raw.life = player.ship.life;
+    raw.invulnerableTimer = player.ship.invulnerableTimer;
+
+    FullState state(raw, player.lastConfirmedInputSequence);
+
+    struct Candidate {
+        float priority;
+        int slot;
+    };
+    Candidate candidates[MAX_PLAYERS];
+    size_t candidatesSize = 0;
+
+    for (int i = 0; i < MAX_PLAYERS; i++) {
+        const MatchPlayer &other = mPlayers[i];
+        if (i == slot || !other.used) {
+            continue;
+        }
+
+        mPriorities[slot][i] += GetPriority(slot, i);
+        candidates[candidatesSize++] = {mPriorities[slot][i], i};
+    }
+
+    std::sort(candidates, candidates + candidatesSize, [](const Candidate &a, const Candidate &b) {
+        return a.priority > b.priority;
+    });
+
+    for (size_t i = 0; i < candidatesSize && state.otherStateSize < MAX_OTHER_STATES; i++) {
+        const MatchPlayer &other = mPlayers[candidates[i].slot];
+
+        state.otherStates[state.otherStateSize++] = OtherState(
+            other.id,
+            other.ship.posX,
+            other.ship.posY,
+            other.ship.rotation,
+            other.ship.life,
+            other.ship.invulnerableTimer
+        );
+    }
+
+    return state;
+}
+
+void Match::MarkStateSent(const int slot, const FullState &state) {
+    for (size_t i = 0; i < state.otherStateSize; i++) {
+        if (const int otherSlot = FindSlot(state.otherStates[i].id); otherSlot >= 0) {
+            mPriorities[slot][otherSlot] = 0.0f;
+        }
+    }
+}
+
+void Match::ClearEvents() {
+    mShots.clear();
+}
+
+void Match::FireLaser(const int slot, const float rewindTicks) {
+    MatchPlayer &player = mPlayers[slot];
+    player.recentFireTimer = RECENT_FIRE_WINDOW;
+    mShots.push_back({player.id, player.ship.posX, player.ship.posY, player.ship.rotation});
+
+    const Vector2 start = ShipSimulation::getLaserStart(player.ship);
+    Vector2 end = ShipSimulation::getLaserEdgeEnd(start, player.ship.rotation);
+    float minDist = (end - start).Length();
+
+    // the beam stops at the first ship in its way, like LaserBeamComponent::CalculateEndPoint
+    // against the ships where the shooter saw them
+    for (int i = 0; i < MAX_PLAYERS; i++) {
+        Vector2 otherPosition;
+        if (i == slot || !GetRewoundPosition(i, rewindTicks, &otherPosition)) {
+            continue;
+        }
+
+        const float hitDist = ShipSimulation::rayCastToCircle(
+            start,
+            player.ship.rotation,
+            otherPosition,
+            ShipSimulation::SHIP_COLLIDER_RADIUS
+        );
+
+        if (hitDist > 0.0f && hitDist < minDist) {
+            minDist = hitDist;
+        }
+    }
+
+    end = start + Vector2(Math::Cos(player.ship.rotation), Math::Sin(player.ship.rotation)) * minDist;
+    mLasers.push_back({slot, start, end, ShipSimulation::LASER_LIFETIME, 0, rewindTicks});
+}
+
+void Match::CheckLaserHits() {
+    for (auto &laser : mLasers) {
+        for (int i = 0; i < MAX_PLAYERS; i++) {
+            MatchPlayer &target = mPlayers[i];
+            if (i == laser.ownerSlot || !target.used || (laser.hitSlots & (static_cast<uint64_t>(1) << i)) != 0) {
+                continue;
+            }
+
+            // damage follows the present, the position the shooter's past
+            Vector2 targetPosition;
+            if (target.ship.invulnerableTimer > 0.0f || !GetRewoundPosition(i, laser.rewindTicks, &targetPosition)) {
+                continue;
+            }
+
+            if (ShipSimulation::segmentIntersectsCircle(
+                laser.start,
+                laser.end,
+                targetPosition,
+                ShipSimulation::SHIP_COLLIDER_RADIUS)) {
+                ShipSimulation::takeDamage(target.ship);
+                laser.hitSlots |= static_cast<uint64_t>(1) << i;
+            }
+        }
+    }
+}
+
+void Match::RecordHistory() {
+    mHistory.Push();
+    for (int i = 0; i < MAX_PLAYERS; i++) {
+        const MatchPlayer &player = mPlayers[i];
+        if (player.used && player.ship.life > 0) {
+            mHistory.Set(i, player.id, player.ship.posX, player.ship.posY);
+        }
+    }
+}
+
+bool Match::GetRewoundPosition(const int slot, const float rewindTicks, Vector2 *position) const {
+    const MatchPlayer &player = mPlayers[slot];
+    if (!player.used || player.ship.life <= 0) {
+        return false;
+    }
+
+    // no rewind, or a match too young to have a past, tests the present
+    if (rewindTicks <= 0.0f || mHistory.GetSize() == 0) {
+        *position = Vector2(player.ship.posX, player.ship.posY);
+        return true;
+    }
+
+    return mHistory.Sample(slot, player.id, rewindTicks, position);
+}
+
+int Match::FindSlot(const int playerId) const {
+    for (int i = 0; i < MAX_PLAYERS; i++) {
+        if (mPlayers[i].used && mPlayers[i].id == playerId) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+float Match::GetPriority(const int viewerSlot, const int slot) const {
+    const ShipSimState &viewer = mPlayers[viewerSlot].ship;
+    const MatchPlayer &other = mPlayers[slot];
+
+    // the world wraps around, so distance is measured on the torus
+    float dx = Math::Abs(other.ship.posX - viewer.posX);
+    float dy = Math::Abs(other.ship.posY - viewer.posY);
+    dx = Math::Min(dx, ShipSimulation::WORLD_WIDTH - dx);
+    dy = Math::Min(dy, ShipSimulation::WORLD_HEIGHT - dy);
+
+    constexpr float halfWidth = ShipSimulation::WORLD_WIDTH / 2.0f;
+    constexpr float halfHeight = ShipSimulation::WORLD_HEIGHT / 2.0f;
+    const float maxDistance = Math::Sqrt(halfWidth * halfWidth + halfHeight * halfHeight);
+    const float closeness = 1.0f - Math::Min(1.0f, Math::Sqrt(dx * dx + dy * dy) / maxDistance);
+
+    float priority = MIN_PRIORITY + DISTANCE_PRIORITY * closeness;
+    if (other.recentFireTimer > 0.0f) {
+        priority += RECENT_FIRE_PRIORITY;
+    }
+
+    return priority;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../Client/DataObjects.h"
+#include "../Client/ShipSimulation.h"
+#include "RewindHistory.h"
+
+struct MatchPlayer {
+    bool used;
+    int id;
+    ShipSimState ship;
+    bool hasConfirmedInput;
+    uint32_t lastConfirmedInputSequence;
+    float recentFireTimer;
+    bool receivedInputThisTick;
+    // commands the player may still apply, refilled every tick
+    int commandBudget;
+
+    MatchPlayer()
+    :used(false), id(-1), hasConfirmedInput(false), lastConfirmedInputSequence(0),
+    recentFireTimer(0.0f), receivedInputThisTick(false), commandBudget(0) {}
+};
+
+// Shots fired since the last snapshot, sent to the other players as events
+struct MatchShot {
+    int playerId;
+    float posX, posY, rotation;
+};
+
+struct MatchLaser {
+    int ownerSlot;
+    Vector2 start;
+    Vector2 end;
+    float lifetime;
+    uint64_t hitSlots;
+    // how far behind the server the owner saw the other ships, kept for the
+    // whole beam so it sweeps the owner's timeline
+    float rewindTicks;
+};
+
+class Match {
+public:
+    Match();
+
+    // Returns the slot the player was placed in, or -1 if the match is full
+    int AddPlayer(int playerId);
+    void RemovePlayer(int slot);
+
+    // rewindTicks is how many ticks behind the last one the player saw the
+    // others, its shots are judged against that past
+    void ApplyCommands(int slot, const Command *commands, size_t commandsSize, float rewindTicks);
+    // One server tick, closes with a frame of the rewind history
+    void Update(float deltaTime);
+
+    // Other players come sorted by relevance to the viewer, the ones left out
+    // keep accumulating priority until they make it into a snapshot
+    FullState BuildState(int slot);
+    void MarkStateSent(int slot, const FullState &state);
+    [[nodiscard]] const std::vector<MatchShot> &GetShots() const { return mShots; }
+    void ClearEvents();
+
+    [[nodiscard]] bool IsFull() const { return mPlayersSize == MAX_PLAYERS; }
+    [[nodiscard]] bool IsEmpty() const { return mPlayersSize == 0; }
+    [[nodiscard]] size_t GetPlayersSize() const { return mPlayersSize; }
+
+    static constexpr int MAX_PLAYERS = MAX_OTHER_STATES + 1;
+    static constexpr size_t MAX_COMMANDS_PER_BATCH = 256;
+
+    // Every command is one client frame and a tick lasts COMMANDS_PER_TICK of
+    // them. The budget keeps a player from simulating faster than real time,
+    // the allowance absorbs commands that arrive in bursts after jitter or a
+    // lost packet. Commands over the budget are left unconfirmed, the client
+    // sends them again and they are applied on a later tick.
+    static constexpr int COMMANDS_PER_TICK = 2;
+    static constexpr int COMMAND_BURST_ALLOWANCE = 4;
+    static constexpr int MAX_COMMAND_BUDGET = COMMANDS_PER_TICK + COMMAND_BURST_ALLOWANCE;
+
+    // Interest management weights, accumulated every snapshot
+    static constexpr float MIN_PRIORITY = 0.1f;
+    static constexpr float DISTANCE_PRIORITY = 1.0f;
+    static constexpr float RECENT_FIRE_PRIORITY = 1.0f;
+    static constexpr float RECENT_FIRE_WINDOW = 1.0f;
+
+    // Lag compensation never looks further back than this, 300 ms at 30 ticks
+    // per second. Slower clients hit a little behind what they saw.
+    static constexpr float MAX_REWIND_TICKS = 9.0f;
+
+    static_assert(MAX_PLAYERS <= 64, "hit slots are a 64 bit mask");
+    static_assert(MAX_PLAYERS == RewindHistory::SLOTS, "one history pose per player slot");
+    static_assert(MAX_REWIND_TICKS < RewindHistory::FRAMES, "the history must cover the longest rewind");
+
+private:
+    void FireLaser(int slot, float rewindTicks);
+    void CheckLaserHits();
+    void RecordHistory();
+    // Where the ship in the slot was rewindTicks ago, false when it was not alive
+    [[nodiscard]] bool GetRewoundPosition(int slot, float rewindTicks, Vector2 *position) const;
+    [[nodiscard]] int FindSlot(int playerId) const;
+    [[nodiscard]] float GetPriority(int viewerSlot, int slot) const;
+
+    MatchPlayer mPlayers[MAX_PLAYERS];
+    size_t mPlayersSize;
+    // accumulated priority of each player in the snapshots of each viewer
+    float mPriorities[MAX_PLAYERS][MAX_PLAYERS];
+    std::vector<MatchLaser> mLasers;
+    std::vector<MatchShot> mShots;
+    RewindHistory mHistory;
+};
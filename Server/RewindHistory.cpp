@@ -0,0 +1,78 @@
+#include "RewindHistory.h"
+#include "../Client/ShipSimulation.h"
+
+namespace {
+    float wrapPosition(float value, const float size) {
+        if (value < 0.0f) {
+            value += size;
+        } else if (value > size) {
+            value -= size;
+        }
+        return value;
+    }
+}
+
+void RewindHistory::Clear() {
+    mNewest = 0;
+    mSize = 0;
+}
+
+void RewindHistory::Push() {
+    mNewest = (mNewest + 1) & (FRAMES - 1);
+    if (mSize < FRAMES) {
+        mSize++;
+    }
+
+    for (auto &pose : mFrames[mNewest].poses) {
+        pose.playerId = -1;
+    }
+}
+
+void RewindHistory::Set(const int slot, const int playerId, const float posX, const float posY) {
+    mFrames[mNewest].poses[slot] = {playerId, posX, posY};
+}
+
+bool RewindHistory::Sample(const int slot, const int playerId, const float ticksAgo, Vector2 *position) const {
+    if (mSize == 0) {
+        return false;
+    }
+
+    const auto oldest = static_cast<float>(mSize - 1);
+    const float clamped = Math::Clamp(ticksAgo, 0.0f, oldest);
+    const auto newer = static_cast<size_t>(clamped);
+
+    const Pose &to = GetPose(newer, slot);
+    if (to.playerId != playerId) {
+        return false;
+    }
+
+    const float alpha = clamped - static_cast<float>(newer);
+    if (alpha <= 0.0f || newer + 1 >= mSize) {
+        *position = Vector2(to.posX, to.posY);
+        return true;
+    }
+
+    // the older frame is where the ship came from, a ship that just spawned or
+    // respawned is taken where it appeared
+    const Pose &from = GetPose(newer + 1, slot);
+    if (from.playerId != playerId) {
+        *position = Vector2(to.posX, to.posY);
+        return true;
+    }
+
+    // the world wraps around, a ship crossing an edge moved the short way
+    const float t = 1.0f - alpha;
+    position->x = wrapPosition(
+        from.posX + ShipSimulation::wrapDelta(from.posX, to.posX, ShipSimulation::WORLD_WIDTH) * t,
+        ShipSimulation::WORLD_WIDTH
+    );
+    position->y = wrapPosition(
+        from.posY + ShipSimulation::wrapDelta(from.posY, to.posY, ShipSimulation::WORLD_HEIGHT) * t,
+        ShipSimulation::WORLD_HEIGHT
+    );
+    return true;
+}
+
+const RewindHistory::Pose &RewindHistory::GetPose(const size_t framesAgo, const int slot) const {
+    return mFrames[(mNewest - framesAgo) & (FRAMES - 1)].poses[slot];
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "../Client/DataObjects.h"
+#include "../Source/Math.h"
+
+// Ship positions of a match over its last ticks, one frame per tick in a fixed
+// ring. Shots are tested against the world a client was looking at, which is
+// a few ticks behind the server. Lookups index the ring directly and nothing
+// is allocated after construction.
+class RewindHistory {
+public:
+    RewindHistory() { Clear(); }
+
+    void Clear();
+
+    // Starts the frame of a new tick, overwriting the oldest one. Slots not
+    // set afterwards hold no ship in that frame.
+    void Push();
+    void Set(int slot, int playerId, float posX, float posY);
+
+    // Position of the slot ticksAgo ticks before the newest frame, between two
+    // frames for fractions. Clamped to the oldest frame kept. False when the
+    // slot held no ship or another player back then.
+    bool Sample(int slot, int playerId, float ticksAgo, Vector2 *position) const;
+
+    [[nodiscard]] size_t GetSize() const { return mSize; }
+
+    static constexpr int SLOTS = MAX_OTHER_STATES + 1;
+    // power of two, a tick maps to its frame with a mask
+    static constexpr size_t FRAMES = 16;
+
+    static_assert((FRAMES & (FRAMES - 1)) == 0, "frames index the ring with a mask");
+
+private:
+    struct Pose {
+        // -1 when the slot was empty or the ship dead
+        int playerId;
+        float posX, posY;
+    };
+
+    struct Frame {
+        Pose poses[SLOTS];
+    };
+
+    [[nodiscard]] const Pose &GetPose(size_t framesAgo, int slot) const;
+
+    Frame mFrames[FRAMES];
+    size_t mNewest;
+    size_t mSize;
+};
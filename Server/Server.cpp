@@ -0,0 +1,504 @@
+#include "Server.h"
+#include "ServerOperations.h"
+#include "../Client/CommandRuns.h"
+#include "../Network/Socket.h"
+#include "../Network/Logger.h"
+#include "../Network/NetUtils.h"
+#include "../Network/Defs.h"
+#include "../Source/Random.h"
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+
+Server::Server()
+:mSocket(INVALID_SOCKET)
+,mEpollFd(-1)
+,mTimerFd(-1)
+,mIsRunning(false)
+,mReceiveBatch(RECEIVE_BATCH_CAPACITY)
+,mSendBatch(SEND_BATCH_CAPACITY)
+,mTransportWriter(&mSendBatch)
+,mNextPlayerId(0)
+,mServerTick(0)
+{
+}
+
+bool Server::Initialize() {
+    Random::Init();
+
+    mSocket = SocketUtils::createSocketV4();
+    SocketUtils::bindSocketToAnyV4(mSocket);
+    SocketUtils::setSocketNonBlocking(mSocket);
+
+    mTimerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+    if (mTimerFd < 0) {
+        Logger::sysLogExit("create tick timer");
+    }
+
+    constexpr long tickIntervalNs = 1000000000L / TICK_RATE;
+    itimerspec interval{};
+    interval.it_interval.tv_nsec = tickIntervalNs;
+    interval.it_value.tv_nsec = tickIntervalNs;
+    if (timerfd_settime(mTimerFd, 0, &interval, nullptr) < 0) {
+        Logger::sysLogExit("start tick timer");
+    }
+
+    mEpollFd = epoll_create1(0);
+    if (mEpollFd < 0) {
+        Logger::sysLogExit("create epoll");
+    }
+
+    epoll_event socketEvent{};
+    socketEvent.events = EPOLLIN;
+    socketEvent.data.fd = mSocket;
+
+    epoll_event timerEvent{};
+    timerEvent.events = EPOLLIN;
+    timerEvent.data.fd = mTimerFd;
+
+    if (epoll_ctl(mEpollFd, EPOLL_CTL_ADD, mSocket, &socketEvent) < 0 ||
+        epoll_ctl(mEpollFd, EPOLL_CTL_ADD, mTimerFd, &timerEvent) < 0) {
+        Logger::sysLogExit("register epoll events");
+    }
+
+    mIsRunning = true;
+    printf("Server listening on port %d at %d ticks per second\n", APP_PORT, TICK_RATE);
+    return true;
+}
+
+void Server::RunLoop() {
+    epoll_event events[MAX_EPOLL_EVENTS];
+
+    while (mIsRunning) {
+        const int eventsSize = epoll_wait(mEpollFd, events, MAX_EPOLL_EVENTS, -1);
+        if (eventsSize < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            Logger::sysLogExit("epoll wait");
+        }
+
+        for (int i = 0; i < eventsSize; i++) {
+            if (events[i].data.fd == mSocket) {
+                ReceivePackets();
+                continue;
+            }
+
+            uint64_t expirations = 0;
+            if (read(mTimerFd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+                continue;
+            }
+
+            // after a stall catch up a few ticks, but never spiral
+            const uint64_t ticks = std::min<uint64_t>(expirations, MAX_TICKS_PER_WAKEUP);
+            for (uint64_t t = 0; t < ticks; t++) {
+                Tick();
+            }
+            SendSnapshots();
+            RemoveTimedOutClients();
+        }
+    }
+}
+
+void Server::Shutdown() {
+    for (auto &[key, connection] : mConnections) {
+        if (connection.state == ConnectionState::CONNECTION_ESTABLISHED) {
+            ServerOperations::sendSinglePacketToClient(this, connection, Packet::RST_FLAG);
+        }
+    }
+    FlushSendBatch();
+    mConnections.clear();
+    mMatches.clear();
+
+    if (mEpollFd >= 0) {
+        close(mEpollFd);
+        mEpollFd = -1;
+    }
+
+    if (mTimerFd >= 0) {
+        close(mTimerFd);
+        mTimerFd = -1;
+    }
+
+    if (mSocket != INVALID_SOCKET) {
+        close_socket(mSocket);
+        mSocket = INVALID_SOCKET;
+    }
+
+    printf("Server shutdown\n");
+}
+
+void Server::ReceivePackets() {
+    // drain the socket, epoll is level triggered but one wakeup may hold many datagrams
+    size_t batchSize;
+    do {
+        batchSize = SocketUtils::receivePacketBatchFromV4(mSocket, &mReceiveBatch);
+
+        for (size_t i = 0; i < batchSize; i++) {
+            HandlePacket(mReceiveBatch.GetView(i), mReceiveBatch.GetAddress(i));
+        }
+    } while (batchSize == mReceiveBatch.GetCapacity());
+
+    // handshake answers queued while handling the batch
+    FlushSendBatch();
+}
+
+void Server::HandlePacket(const PacketView &packet, const sockaddr_in &addr) {
+    const uint64_t key = GetAddressKey(addr);
+    const auto it = mConnections.find(key);
+
+    // the checksum mode depends on the connection, so validate after the lookup
+    if (packet.GetSize() > PacketView::FLAG_OFFSET && packet.GetFlag() == Packet::SYN_FLAG) {
+        if (packet.IsValid(IntegrityMode::ONES_COMPLEMENT)) {
+            HandleSyn(packet, addr, key);
+        } else if (packet.IsOtherVersion(IntegrityMode::ONES_COMPLEMENT)) {
+            RefuseSyn(packet, addr);
+        }
+        return;
+    }
+
+    if (it == mConnections.end()) {
+        return;
+    }
+
+    ClientConnection &connection = it->second;
+    if (!packet.IsValid(connection.integrityMode) || packet.GetNonce() != connection.nonce) {
+        return;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    connection.lastPacketTime = now;
+
+    // a handler may drop the connection, the rest of the datagram goes with it
+    Transport::Message message{};
+    connection.incoming.Begin(packet, now);
+    while (connection.incoming.Next(&message)) {
+        HandleMessage(connection, key, message);
+        if (mConnections.find(key) == mConnections.end()) {
+            return;
+        }
+    }
+}
+
+void Server::HandleMessage(ClientConnection &connection, const uint64_t key, const Transport::Message &message) {
+    // the client only sends DATA and PING after its ACK, they stand in for a lost one
+    if (connection.state == ConnectionState::CONNECTION_SYN_RECEIVED &&
+        (message.flag == Packet::DATA_FLAG || message.flag == Packet::PING_FLAG)) {
+        HandleAck(connection, key);
+        if (mConnections.find(key) == mConnections.end()) {
+            return;
+        }
+    }
+
+    switch (message.flag) {
+        case Packet::ACK_FLAG:
+            HandleAck(connection, key);
+            break;
+        case Packet::DATA_FLAG:
+            HandleData(connection, message);
+            break;
+        case Packet::PING_FLAG:
+            HandlePing(connection, message);
+            break;
+        case Packet::END_FLAG:
+            HandleEnd(connection, message);
+            break;
+        default:
+            break;
+    }
+}
+
+void Server::HandleSyn(const PacketView &packet, const sockaddr_in &addr, const uint64_t key) {
+    if (const auto it = mConnections.find(key); it != mConnections.end()) {
+        if (packet.GetNonce() == it->second.synNonce) {
+            // lost SYN_ACK, answer the retry with the same nonce and its own
+            // sequence so the client can time the attempt that got through
+            if (it->second.state == ConnectionState::CONNECTION_SYN_RECEIVED) {
+                it->second.sequence = static_cast<uint16_t>(packet.GetSequence() + 1);
+                it->second.lastPacketTime = std::chrono::steady_clock::now();
+                ServerOperations::sendSinglePacketToClient(this, it->second, Packet::SYN_ACK_FLAG);
+            }
+
+            // a late or duplicated retry must not reset the session it opened
+            return;
+        }
+
+        // another SYN nonce is a new session from the same address, the client restarted
+        LeaveMatch(it->second);
+        mConnections.erase(it);
+    }
+
+    ClientConnection connection{};
+    connection.addr = addr;
+    connection.state = ConnectionState::CONNECTION_SYN_RECEIVED;
+    connection.sequence = static_cast<uint16_t>(packet.GetSequence() + 1);
+    connection.nonce = NetUtils::getRandomNonce(NetUtils::getNonce());
+    connection.synNonce = packet.GetNonce();
+    connection.playerId = -1;
+    connection.matchIndex = -1;
+    connection.matchSlot = -1;
+    connection.lastPacketTime = std::chrono::steady_clock::now();
+    connection.nextSnapshotId = 0;
+    connection.nextDataSequence = 0;
+
+    SynPayload syn;
+    if (Wire::decode(packet.GetData(), packet.GetLength(), &syn) == 0) {
+        return;
+    }
+    connection.integrityMode = Integrity::chooseMode(syn.integrityModes);
+    connection.hasAckedSnapshot = false;
+    connection.ackedSnapshotId = 0;
+
+    const auto [it, inserted] = mConnections.emplace(key, connection);
+    ServerOperations::sendSinglePacketToClient(this, it->second, Packet::SYN_ACK_FLAG);
+}
+
+// Other wire versions would misread every message. The RST goes out in the
+// client's own version, the only one it can validate.
+void Server::RefuseSyn(const PacketView &packet, const sockaddr_in &addr) const {
+    PacketBuffer buffer;
+    const PacketWriter writer(buffer.bytes);
+    writer.Begin(static_cast<uint16_t>(packet.GetSequence() + 1), Packet::RST_FLAG, packet.GetNonce(),
+        packet.GetVersion());
+    const size_t size = writer.Finish(0);
+
+    sockaddr_in target = addr;
+    SocketUtils::sendBytesToV4(mSocket, buffer.bytes, size, &target);
+}
+
+void Server::HandleAck(ClientConnection &connection, const uint64_t key) {
+    if (connection.state == ConnectionState::CONNECTION_CLOSING) {
+        printf("Player %d disconnected\n", connection.playerId);
+        mConnections.erase(key);
+        return;
+    }
+
+    if (connection.state != ConnectionState::CONNECTION_SYN_RECEIVED) {
+        return;
+    }
+
+    connection.playerId = mNextPlayerId++;
+    if (!JoinMatch(connection)) {
+        ServerOperations::sendSinglePacketToClient(this, connection, Packet::RST_FLAG);
+        mConnections.erase(key);
+        return;
+    }
+
+    connection.state = ConnectionState::CONNECTION_ESTABLISHED;
+    printf("Player %d connected to match %d\n", connection.playerId, connection.matchIndex);
+}
+
+void Server::HandleData(ClientConnection &connection, const Transport::Message &message) {
+    if (connection.state != ConnectionState::CONNECTION_ESTABLISHED) {
+        return;
+    }
+
+    ClientDataHeader header(false, 0);
+    const size_t headerSize = Wire::decode(message.data, message.size, &header);
+    if (headerSize == 0) {
+        return;
+    }
+
+    RecordUplinkPacket(connection, message.sequence);
+    HandleSnapshotAck(connection, header);
+    HandleDownlinkAck(connection, header);
+
+    const uint8_t *body = message.data + headerSize;
+    const size_t bodySize = message.size - headerSize;
+    const float rewindTicks = GetRewindTicks(header);
+
+    if (header.commandFormat == CommandFormat::RUNS) {
+        Command commands[CommandRuns::REDUNDANCY_WINDOW];
+        const size_t commandsSize = CommandRuns::decode(body, bodySize, commands, CommandRuns::REDUNDANCY_WINDOW);
+        if (commandsSize > 0) {
+            mMatches[connection.matchIndex].ApplyCommands(connection.matchSlot, commands, commandsSize, rewindTicks);
+        }
+        return;
+    }
+
+    // the match applies MAX_COMMANDS_PER_BATCH at most, the rest is not read
+    Command commands[Match::MAX_COMMANDS_PER_BATCH];
+    const size_t commandsSize = Wire::decodeArray(body, bodySize, commands, Match::MAX_COMMANDS_PER_BATCH);
+    if (commandsSize == 0) {
+        return;
+    }
+
+    mMatches[connection.matchIndex].ApplyCommands(connection.matchSlot, commands, commandsSize, rewindTicks);
+}
+
+void Server::HandlePing(ClientConnection &connection, const Transport::Message &message) {
+    ClientDataHeader header(false, 0);
+    if (connection.state != ConnectionState::CONNECTION_ESTABLISHED ||
+        Wire::decode(message.data, message.size, &header) == 0) {
+        return;
+    }
+
+    RecordUplinkPacket(connection, message.sequence);
+    HandleSnapshotAck(connection, header);
+    HandleDownlinkAck(connection, header);
+}
+
+void Server::RecordUplinkPacket(ClientConnection &connection, const uint16_t sequence) {
+    const bool newest = !connection.uplinkAcks.HasReceived() ||
+                        AckWindow::isNewer(sequence, connection.uplinkAcks.GetNewest());
+
+    // the client subtracts how long the newest packet waited here from its RTT
+    if (connection.uplinkAcks.Receive(sequence) && newest) {
+        connection.uplinkNewestAt = std::chrono::steady_clock::now();
+    }
+}
+
+void Server::HandleSnapshotAck(ClientConnection &connection, const ClientDataHeader &header) {
+    if (!header.hasAckedSnapshot) {
+        return;
+    }
+
+    // acks may arrive out of order, keep the newest one
+    if (connection.hasAckedSnapshot &&
+        !SnapshotCodec::isNewer(header.ackedSnapshotId, connection.ackedSnapshotId)) {
+        return;
+    }
+
+    connection.hasAckedSnapshot = true;
+    connection.ackedSnapshotId = header.ackedSnapshotId;
+}
+
+void Server::HandleDownlinkAck(ClientConnection &connection, const ClientDataHeader &header) {
+    if (!header.hasDownlinkAck) {
+        return;
+    }
+
+    connection.events.OnAck(header.downlinkAckedSequence, header.downlinkAckBits);
+}
+
+float Server::GetRewindTicks(const ClientDataHeader &header) const {
+    if (!header.hasViewTick) {
+        return 0.0f;
+    }
+
+    // a view ahead of the server is a clock estimate running early, no rewind
+    const auto behind = static_cast<float>(static_cast<int32_t>(mServerTick - header.viewTick)) -
+                        static_cast<float>(header.viewTickFraction) / 256.0f;
+    return Math::Clamp(behind, 0.0f, Match::MAX_REWIND_TICKS);
+}
+
+void Server::HandleEnd(ClientConnection &connection, const Transport::Message &message) {
+    if (connection.state != ConnectionState::CONNECTION_CLOSING) {
+        LeaveMatch(connection);
+        connection.state = ConnectionState::CONNECTION_CLOSING;
+        connection.sequence = static_cast<uint16_t>(message.sequence + 1);
+    }
+
+    ServerOperations::sendSinglePacketToClient(this, connection, Packet::END_ACK_FLAG);
+}
+
+void Server::Tick() {
+    mServerTick++;
+    for (auto &match : mMatches) {
+        if (!match.IsEmpty()) {
+            match.Update(TICK_DELTA_TIME);
+        }
+    }
+}
+
+void Server::SendSnapshots() {
+    for (auto &[key, connection] : mConnections) {
+        if (connection.state != ConnectionState::CONNECTION_ESTABLISHED) {
+            continue;
+        }
+
+        if (mSendBatch.IsFull()) {
+            FlushSendBatch();
+        }
+
+        Match &match = mMatches[connection.matchIndex];
+        QueueShotEvents(connection, match);
+
+        FullState state = match.BuildState(connection.matchSlot);
+        state.serverTick = mServerTick;
+        ServerOperations::sendStateToClient(this, connection, state);
+        match.MarkStateSent(connection.matchSlot, state);
+    }
+    FlushSendBatch();
+
+    for (auto &match : mMatches) {
+        match.ClearEvents();
+    }
+}
+
+void Server::QueueShotEvents(ClientConnection &connection, const Match &match) const {
+    for (const auto &shot : match.GetShots()) {
+        if (shot.playerId == connection.playerId) {
+            continue;
+        }
+
+        // a full queue means the client stopped acking, it times out soon after
+        uint8_t event[Wire::size<ShotEvent>()];
+        Wire::encode(ShotEvent(shot.playerId, mServerTick, shot.posX, shot.posY, shot.rotation), event, sizeof(event));
+        connection.events.Enqueue(event, sizeof(event));
+    }
+}
+
+void Server::RemoveTimedOutClients() {
+    const auto now = std::chrono::steady_clock::now();
+    const auto timeout = std::chrono::milliseconds(CLIENT_TIMEOUT_MS);
+
+    for (auto it = mConnections.begin(); it != mConnections.end();) {
+        if (now - it->second.lastPacketTime > timeout) {
+            printf("Player %d timed out\n", it->second.playerId);
+            LeaveMatch(it->second);
+            it = mConnections.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool Server::JoinMatch(ClientConnection &connection) {
+    int matchIndex = -1;
+    for (size_t i = 0; i < mMatches.size(); i++) {
+        if (!mMatches[i].IsFull()) {
+            matchIndex = static_cast<int>(i);
+            break;
+        }
+    }
+
+    if (matchIndex < 0) {
+        mMatches.emplace_back();
+        matchIndex = static_cast<int>(mMatches.size() - 1);
+    }
+
+    const int slot = mMatches[matchIndex].AddPlayer(connection.playerId);
+    if (slot < 0) {
+        return false;
+    }
+
+    connection.matchIndex = matchIndex;
+    connection.matchSlot = slot;
+    return true;
+}
+
+void Server::LeaveMatch(ClientConnection &connection) {
+    if (connection.matchIndex < 0) {
+        return;
+    }
+
+    mMatches[connection.matchIndex].RemovePlayer(connection.matchSlot);
+    connection.matchIndex = -1;
+    connection.matchSlot = -1;
+}
+
+void Server::FlushSendBatch() {
+    if (mSendBatch.GetSize() == 0) {
+        return;
+    }
+
+    mTransportWriter.Seal();
+    SocketUtils::sendPacketBatchToV4(mSocket, &mSendBatch);
+}
+
+uint64_t Server::GetAddressKey(const sockaddr_in &addr) {
+    return (static_cast<uint64_t>(addr.sin_addr.s_addr) << 16) | addr.sin_port;
+}
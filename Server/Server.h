@@ -0,0 +1,122 @@
+#pragma once
+
+#include "../Network/Platforms.h"
+#include "../Network/Packet.h"
+#include "../Network/PacketBatch.h"
+#include "../Network/AckWindow.h"
+#include "../Network/ReliableChannel.h"
+#include "../Network/Transport.h"
+#include "Match.h"
+#include "../Client/SnapshotCodec.h"
+#include <atomic>
+#include <chrono>
+#include <unordered_map>
+#include <vector>
+
+enum class ConnectionState {
+    CONNECTION_SYN_RECEIVED,
+    CONNECTION_ESTABLISHED,
+    CONNECTION_CLOSING,
+};
+
+struct ClientConnection {
+    sockaddr_in addr;
+    ConnectionState state;
+    uint16_t sequence;
+    uint32_t nonce;
+    // Nonce of the SYN that opened the connection, its retries carry it too
+    uint32_t synNonce;
+    IntegrityMode integrityMode;
+    int playerId;
+    int matchIndex;
+    int matchSlot;
+    std::chrono::steady_clock::time_point lastPacketTime;
+    // Splits bundles and reassembles fragments of the datagrams from this client
+    TransportReader incoming;
+
+    // Snapshots sent to this client, deltas are encoded against the last acked one
+    uint16_t nextSnapshotId;
+    bool hasAckedSnapshot;
+    uint16_t ackedSnapshotId;
+    SnapshotHistory sentSnapshots;
+
+    // Client packets received, acked back in every snapshot for the client stats
+    AckWindow uplinkAcks;
+    std::chrono::steady_clock::time_point uplinkNewestAt;
+
+    // DATA packets carry their own sequence, the client acks them so the
+    // events riding on them can be repeated until one copy gets through
+    uint16_t nextDataSequence;
+    ReliableSender events;
+};
+
+class Server {
+public:
+    Server();
+    ~Server() = default;
+
+    bool Initialize();
+    void RunLoop();
+    void Shutdown();
+    void Quit() { mIsRunning = false; }
+
+    [[nodiscard]] SocketType GetSocket() const { return mSocket; }
+    [[nodiscard]] PacketBatch *GetSendBatch() { return &mSendBatch; }
+    [[nodiscard]] TransportWriter *GetTransportWriter() { return &mTransportWriter; }
+
+    // Must match Game::SIM_DELTA_TIME, each command is one client frame
+    static constexpr float SIM_DELTA_TIME = 1.0f / 60.0f;
+    static constexpr int TICK_RATE = 30;
+    static constexpr float TICK_DELTA_TIME = 1.0f / static_cast<float>(TICK_RATE);
+    static constexpr int CLIENT_TIMEOUT_MS = 5000;
+    static constexpr int MAX_EPOLL_EVENTS = 8;
+    static constexpr int MAX_TICKS_PER_WAKEUP = 5;
+    static constexpr size_t RECEIVE_BATCH_CAPACITY = 64;
+    // sendmmsg accepts up to UIO_MAXIOV (1024) messages per call
+    static constexpr size_t SEND_BATCH_CAPACITY = 1024;
+    // Snapshots stop adding other players past this size. One datagram, a
+    // fragmented snapshot is lost with any of its fragments and the next one
+    // replaces it anyway, fragments are for reliable or bulk messages.
+    static constexpr size_t SNAPSHOT_BYTE_BUDGET = PacketWriter::PAYLOAD_CAPACITY;
+
+private:
+    void ReceivePackets();
+    void HandlePacket(const PacketView &packet, const sockaddr_in &addr);
+    void HandleMessage(ClientConnection &connection, uint64_t key, const Transport::Message &message);
+    void HandleSyn(const PacketView &packet, const sockaddr_in &addr, uint64_t key);
+    void RefuseSyn(const PacketView &packet, const sockaddr_in &addr) const;
+    void HandleAck(ClientConnection &connection, uint64_t key);
+    void HandleData(ClientConnection &connection, const Transport::Message &message);
+    void HandlePing(ClientConnection &connection, const Transport::Message &message);
+    static void HandleSnapshotAck(ClientConnection &connection, const ClientDataHeader &header);
+    static void HandleDownlinkAck(ClientConnection &connection, const ClientDataHeader &header);
+    static void RecordUplinkPacket(ClientConnection &connection, uint16_t sequence);
+    // Ticks between the newest one and the one the client was looking at
+    [[nodiscard]] float GetRewindTicks(const ClientDataHeader &header) const;
+    void HandleEnd(ClientConnection &connection, const Transport::Message &message);
+
+    void Tick();
+    void SendSnapshots();
+    void QueueShotEvents(ClientConnection &connection, const Match &match) const;
+    void RemoveTimedOutClients();
+    void FlushSendBatch();
+
+    bool JoinMatch(ClientConnection &connection);
+    void LeaveMatch(ClientConnection &connection);
+
+    static uint64_t GetAddressKey(const sockaddr_in &addr);
+
+    SocketType mSocket;
+    int mEpollFd;
+    int mTimerFd;
+    std::atomic<bool> mIsRunning;
+    PacketBatch mReceiveBatch;
+    PacketBatch mSendBatch;
+    TransportWriter mTransportWriter;
+
+    std::unordered_map<uint64_t, ClientConnection> mConnections;
+    std::vector<Match> mMatches;
+    int mNextPlayerId;
+    // Simulation ticks since startup, stamped on every snapshot
+    uint32_t mServerTick;
+};
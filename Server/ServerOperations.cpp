@@ -0,0 +1,88 @@
+#include "ServerOperations.h"
+#include "../Network/Packet.h"
+#include "../Client/SnapshotCodec.h"
+#include <algorithm>
+
+void ServerOperations::sendSinglePacketToClient(Server *server, const ClientConnection &connection, const uint8_t flag) {
+    if (flag != Packet::SYN_ACK_FLAG && flag != Packet::END_ACK_FLAG && flag != Packet::RST_FLAG) {
+        return;
+    }
+
+    TransportWriter *writer = server->GetTransportWriter();
+
+    // SYN_ACK tells the client which checksum mode the rest of the connection uses
+    if (flag == Packet::SYN_ACK_FLAG) {
+        const auto mode = static_cast<uint8_t>(connection.integrityMode);
+        writer->Write(connection.addr, connection.nonce, IntegrityMode::ONES_COMPLEMENT, flag, connection.sequence,
+            &mode, sizeof(uint8_t));
+        return;
+    }
+
+    writer->Write(connection.addr, connection.nonce, connection.integrityMode, flag, connection.sequence, nullptr, 0);
+}
+
+void ServerOperations::sendStateToClient(Server *server, ClientConnection &connection, FullState &state) {
+    const uint16_t snapshotId = connection.nextSnapshotId++;
+
+    // an ack older than the history window no longer has a matching baseline
+    const FullState *baseline = nullptr;
+    if (connection.hasAckedSnapshot) {
+        baseline = connection.sentSnapshots.FindBaseline(snapshotId, connection.ackedSnapshotId);
+    }
+
+    // ack of the client packets, pending events, then the snapshot in whatever
+    // room is left, all in a single datagram
+    uint8_t message[Server::SNAPSHOT_BYTE_BUDGET];
+    const uint16_t dataSequence = connection.nextDataSequence++;
+
+    ServerDataHeader header;
+    if (connection.uplinkAcks.HasReceived()) {
+        const auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - connection.uplinkNewestAt).count();
+
+        header.hasAck = 1;
+        header.ackedSequence = connection.uplinkAcks.GetNewest();
+        header.ackBits = connection.uplinkAcks.GetBits();
+        header.ackDelayMs = static_cast<uint8_t>(std::clamp<long long>(waited, 0, UINT8_MAX));
+    }
+    constexpr size_t budget = Server::SNAPSHOT_BYTE_BUDGET;
+    const size_t headerSize = Wire::encode(header, message, budget);
+
+    const size_t eventsSize = connection.events.Write(
+        dataSequence,
+        message + headerSize,
+        std::min(ReliableChannel::MAX_BLOCK_BYTES, budget - headerSize),
+        std::chrono::steady_clock::now()
+    );
+    const size_t prefixSize = headerSize + eventsSize;
+
+    size_t otherStatesWritten = 0;
+    const size_t size = SnapshotCodec::encode(
+        state,
+        snapshotId,
+        baseline,
+        connection.ackedSnapshotId,
+        message + prefixSize,
+        budget - prefixSize,
+        &otherStatesWritten
+    );
+
+    // a full batch is flushed before every snapshot, so this only fails on a
+    // broken budget and the client then sees a skipped snapshot id
+    if (server->GetTransportWriter()->Write(
+        connection.addr,
+        connection.nonce,
+        connection.integrityMode,
+        Packet::DATA_FLAG,
+        dataSequence,
+        message,
+        prefixSize + size
+    ) == 0) {
+        state.otherStateSize = 0;
+        return;
+    }
+
+    // the client only knows about what was actually written
+    state.otherStateSize = otherStatesWritten;
+    connection.sentSnapshots.Store(snapshotId, state);
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "Server.h"
+
+namespace ServerOperations {
+    // Packets are queued in the server send batch and leave on the next flush
+    void sendSinglePacketToClient(Server *server, const ClientConnection &connection, uint8_t flag);
+    // Delta encoded against the last snapshot the client acked, full when none is usable.
+    // The state is trimmed to the other players that fit the snapshot byte budget.
+    void sendStateToClient(Server *server, ClientConnection &connection, FullState &state);
+};
@@ -1,16 +1,18 @@
 #include "Actor.h"
 #include "../Game.h"
 #include "../Components/Component.h"
+#include "../Entities/EntitySystems.h"
 #include <algorithm>
 
 // Constrói um ator e o adiciona ao jogo
 Actor::Actor(Game* game)
-        : mState(ActorState::Active)
-        , mPosition(Vector2::Zero)
-        , mScale(Vector2(1.0f, 1.0f))
-        , mRotation(0.0f)
-        , mGame(game)
+        : mGame(game)
+        , mState(ActorState::Active)
+        , mEntities(&game->GetEntities())
+        , mComponentSlots{}
+        , mComponentMask(0)
 {
+    mEntity = mEntities->Create(this);
     mGame->AddActor(this);
 }
 
@@ -23,6 +25,7 @@ Actor::~Actor()
         delete mComponents[i];
     }
     mComponents.clear();
+    mEntities->Destroy(mEntity);
 }
 
 // Atualiza o ator e seus componentes se estiver ativo
@@ -38,6 +41,13 @@ void Actor::Update(float deltaTime)
     }
 }
 
+// Só entidades ativas são simuladas e desenhadas pelos sistemas
+void Actor::SetState(ActorState state)
+{
+    mState = state;
+    mEntities->SetActive(mEntity, state == ActorState::Active);
+}
+
 // Método virtual para atualização específica do ator (pode ser sobrescrito)
 void Actor::OnUpdate(float deltaTime){}
 
@@ -57,9 +67,15 @@ void Actor::ProcessInput(const Uint8* keyState)
 // Método virtual para processamento de entrada específico do ator (pode ser sobrescrito)
 void Actor::OnProcessInput(const Uint8* keyState){}
 
-// Adiciona um componente ao ator e ordena por ordem de atualização
+// Adiciona um componente ao ator, registra seu tipo e ordena por ordem de atualização
 void Actor::AddComponent(Component* c)
 {
+    const auto type = static_cast<size_t>(c->GetType());
+    if (mComponentSlots[type] == nullptr) {
+        mComponentSlots[type] = c;
+    }
+    mComponentMask |= ComponentMask{1} << type;
+
     mComponents.emplace_back(c);
     std::sort(
         mComponents.begin(),
@@ -69,11 +85,17 @@ void Actor::AddComponent(Component* c)
         });
 }
 
-// Calcula e retorna a matriz de transformação do modelo (escala * rotação * translação)
+// Matriz de modelo interpolada: a dos desenháveis já vem calculada para o frame,
+// a dos demais é calculada na hora
 Matrix4 Actor::GetModelMatrix() const
 {
-    Matrix4 scaleMat = Matrix4::CreateScale(mScale.x, mScale.y, 1.0f);
-    Matrix4 rotMat   = Matrix4::CreateRotationZ(mRotation);
-    Matrix4 transMat = Matrix4::CreateTranslation(Vector3(mPosition.x, mPosition.y, 0.0f));
-    return scaleMat * rotMat * transMat;
+    if (mEntities->HasParts(mEntity, EntityPart::Drawable)) {
+        return mEntities->World(mEntity);
+    }
+
+    return EntitySystems::BlendWorldTransform(mEntities->PreviousPosition(mEntity),
+                                              mEntities->PreviousRotation(mEntity),
+                                              mEntities->HasRenderState(mEntity) != 0,
+                                              GetPosition(), GetRotation(), GetScale(),
+                                              mGame->GetRenderAlpha());
 }
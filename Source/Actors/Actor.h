@@ -3,6 +3,8 @@
 #include <SDL_stdinc.h>
 #include "../Math.h"
 #include "../Renderer/Renderer.h"
+#include "../Entities/EntityStore.h"
+#include "../Components/Component.h"
 
 enum class ActorState
 {
@@ -25,43 +27,56 @@ public:
     void Update(float deltaTime);
     void ProcessInput(const Uint8* keyState);
 
-    const Vector2& GetPosition() const { return mPosition; }
-    void SetPosition(const Vector2& pos) { mPosition = pos; }
+    // The transform lives in the game's entity table, the actor only names its row
+    Vector2 GetPosition() const { return mEntities->Position(mEntity); }
+    void SetPosition(const Vector2& pos) { mEntities->Position(mEntity) = pos; }
 
-    const Vector2& GetScale() const { return mScale; }
-    void SetScale(const Vector2& scale) { mScale = scale; }
+    Vector2 GetScale() const { return mEntities->Scale(mEntity); }
+    void SetScale(const Vector2& scale) { mEntities->Scale(mEntity) = scale; }
 
-    float GetRotation() const { return mRotation; }
-    void SetRotation(float rotation) { mRotation = rotation; }
+    float GetRotation() const { return mEntities->Rotation(mEntity); }
+    void SetRotation(float rotation) { mEntities->Rotation(mEntity) = rotation; }
 
     ActorState GetState() const { return mState; }
-    void SetState(ActorState state) { mState = state; }
+    void SetState(ActorState state);
 
     ActorType GetType() const { return mType;}
     void SetType(const ActorType type) { mType = type; }
 
-    Vector2 GetForward() const { return Vector2(Math::Cos(mRotation), Math::Sin(mRotation)); }
+    Vector2 GetForward() const { return Vector2(Math::Cos(GetRotation()), Math::Sin(GetRotation())); }
 
+    // Transform drawn this frame, blended from the previous simulation step
+    // by the game's render alpha
     Matrix4 GetModelMatrix() const;
 
+    // Drawn where it is from now on, without blending, for jumps like spawns
+    void ResetRenderState() { mEntities->HasRenderState(mEntity) = 0; }
+
+    EntityId GetEntity() const { return mEntity; }
+    class EntityStore* GetEntities() const { return mEntities; }
+
     class Game* GetGame() { return mGame; }
 
     const std::vector<class Component*>& GetComponents() const { return mComponents; }
 
-    // Returns component of type T, or null if doesn't exist
+    // Bit of a component type in the actor's mask
+    using ComponentMask = uint32_t;
+    template <typename T>
+    static constexpr ComponentMask MaskOf() { return ComponentMask{1} << static_cast<uint8_t>(T::TYPE); }
+
+    // Returns the first component added of exactly type T, or null if doesn't exist
     template <typename T>
     T* GetComponent() const
     {
-        for (auto c : mComponents)
-        {
-            T* t = dynamic_cast<T*>(c);
-            if (t != nullptr)
-            {
-                return t;
-            }
-        }
-
-        return nullptr;
+        return static_cast<T*>(mComponentSlots[static_cast<size_t>(T::TYPE)]);
+    }
+
+    // Whether the actor has a component of each of the types, in one mask test
+    template <typename... Ts>
+    bool HasComponents() const
+    {
+        constexpr ComponentMask mask = (MaskOf<Ts>() | ...);
+        return (mComponentMask & mask) == mask;
     }
 
 protected:
@@ -74,13 +89,19 @@ protected:
 
     ActorType mType;
 
-    Vector2 mPosition;
-    Vector2 mScale;
-    float mRotation;
+    class EntityStore* mEntities;
+    EntityId mEntity;
 
     std::vector<class Component*> mComponents;
 
 private:
+    static constexpr size_t COMPONENT_TYPES = static_cast<size_t>(ComponentType::Count);
+    static_assert(COMPONENT_TYPES <= sizeof(ComponentMask) * 8, "ComponentMask has a bit per component type");
+
+    // First component of each type, and a bit for each type the actor has
+    class Component* mComponentSlots[COMPONENT_TYPES];
+    ComponentMask mComponentMask;
+
     friend class Component;
 
     void AddComponent(class Component* c);
@@ -0,0 +1,36 @@
+#pragma once
+#include <vector>
+#include "Actor.h"
+
+// Actors of one type kept paused between uses instead of deleted, the way
+// ParticleSystemComponent keeps its particles: their components, vertex
+// buffers and sounds come back with them, so reusing one allocates nothing.
+// The pooled actors still belong to the scene, which deletes them on unload.
+template <typename T>
+class ActorPool
+{
+public:
+    // An idle actor, or null when every one is in use and a new one is needed
+    T* Acquire()
+    {
+        if (mIdle.empty()) {
+            return nullptr;
+        }
+
+        T* actor = mIdle.back();
+        mIdle.pop_back();
+        return actor;
+    }
+
+    void Release(T* actor)
+    {
+        actor->SetState(ActorState::Paused);
+        mIdle.emplace_back(actor);
+    }
+
+    // The scene is going away with every actor in it
+    void Clear() { mIdle.clear(); }
+
+private:
+    std::vector<T*> mIdle;
+};
@@ -12,27 +12,43 @@ LaserBeam::LaserBeam(class Game* game, const Vector2& startPos, float rotation,
     , mOwnerShip(ownerShip)
     , mShootSound(nullptr)
 {
-    SetPosition(startPos);
-    SetRotation(rotation);
-    
-    float screenWidth = static_cast<float>(GetGame()->GetWindowWidth());
-    float screenHeight = static_cast<float>(GetGame()->GetWindowHeight());
-    
     mLaserComponent = new LaserBeamComponent(this, color, 0.5f);
-    mLaserComponent->Activate(startPos, rotation, screenWidth, screenHeight, ownerShip);
     
-    // Criar e tocar som de tiro
+    // Criar o som de tiro, carregado uma vez e tocado a cada disparo
     mShootSound = new AudioPlayer();
     if (mShootSound->Load(PathResolver::ResolvePath("Assets/Sounds/Shoot.wav")))
     {
         mShootSound->SetVolume(64); // Volume reduzido (50% do máximo)
-        mShootSound->Play(false);
     }
     else
     {
         delete mShootSound;
         mShootSound = nullptr;
     }
+
+    Fire(startPos, rotation, color, ownerShip);
+}
+
+// Dispara o laser da posição inicial, também quando ele volta do pool do jogo
+void LaserBeam::Fire(const Vector2& startPos, float rotation, Vector3 color, class Ship* ownerShip)
+{
+    mOwnerShip = ownerShip;
+    SetState(ActorState::Active);
+    SetPosition(startPos);
+    SetRotation(rotation);
+    ResetRenderState();
+    
+    float screenWidth = static_cast<float>(GetGame()->GetWindowWidth());
+    float screenHeight = static_cast<float>(GetGame()->GetWindowHeight());
+    
+    mLaserComponent->SetColor(color);
+    mLaserComponent->Activate(startPos, rotation, screenWidth, screenHeight, ownerShip);
+    
+    if (mShootSound)
+    {
+        mShootSound->Stop();
+        mShootSound->Play(false);
+    }
 }
 
 LaserBeam::~LaserBeam()
@@ -45,11 +61,11 @@ LaserBeam::~LaserBeam()
     }
 }
 
-// Destrói o laser quando seu componente não estiver mais ativo
+// Devolve o laser ao pool do jogo quando seu componente não estiver mais ativo
 void LaserBeam::OnUpdate(float deltaTime)
 {
     if (mLaserComponent && !mLaserComponent->IsActive()) {
-        SetState(ActorState::Destroy);
+        GetGame()->ReleaseLaser(this);
     }
 }
 
@@ -8,6 +8,9 @@ public:
     ~LaserBeam();
     
     void OnUpdate(float deltaTime) override;
+
+    // Shoots again a laser that went back to the game's pool
+    void Fire(const Vector2& startPos, float rotation, Vector3 color, class Ship* ownerShip);
     
     class LaserBeamComponent* GetLaserComponent() const { return mLaserComponent; }
     class Ship* GetOwnerShip() const { return mOwnerShip; }
@@ -32,8 +32,12 @@ Ship::Ship(Game* game,
         , mTrailComponent(nullptr)
         , mHitSound(nullptr)
 {
-    for (int i = 0; i < 4; i++) {
-        mLivesActors[i] = nullptr;
+    // os quatro indicadores de vida existem enquanto a nave existir, perder ou
+    // ganhar uma vida só mostra ou esconde um deles
+    std::vector<Vector2> lifeSquare = CreateLifeSquareVertices();
+    for (auto& life : mLivesActors) {
+        life = new Actor(GetGame());
+        new DrawComponent(life, lifeSquare, 101, Vector3(1.0f, 1.0f, 1.0f), true);
     }
     
     std::vector<Vector2> vertices = CreateShipVertices();
@@ -100,50 +104,6 @@ void Ship::TakeDamage()
 // Processa entrada do teclado para movimento e disparo da nave
 void Ship::OnProcessInput(const uint8_t* state)
 {
-    if (mGame->IsMultiplayer()) {
-        const bool up = state[SDL_SCANCODE_W];
-        const bool down = state[SDL_SCANCODE_S];
-        const bool left = state[SDL_SCANCODE_A];
-        const bool right = state[SDL_SCANCODE_D];
-        const bool space = state[SDL_SCANCODE_SPACE];
-
-        Vector2 velocity = Vector2::Zero;
-
-        if (up && !down) {
-            velocity.y = -mForwardSpeed;
-        } else if (down && !up) {
-            velocity.y = mForwardSpeed;
-        }
-
-        if (left && !right) {
-            velocity.x = -mForwardSpeed;
-        } else if (right && !left) {
-            velocity.x = mForwardSpeed;
-        }
-
-        if (velocity.x != 0.0f || velocity.y != 0.0f) {
-            SetRotation(Math::Atan2(velocity.y, velocity.x));
-            if (velocity.x != 0.0f && velocity.y != 0.0f) {
-                const float length = Math::Sqrt(velocity.x * velocity.x + velocity.y * velocity.y);
-
-                velocity.x = (velocity.x / length) * mForwardSpeed;
-                velocity.y = (velocity.y / length) * mForwardSpeed;
-            }
-        }
-        mRigidBodyComponent->SetVelocity(velocity);
-
-        if (space) {
-            if (mLaserCooldown <= 0.f) {
-                constexpr auto laserColor =  Vector3(0.0f, 1.0f, 0.0f);
-                const Vector2 laserStart = GetPosition() + GetForward() * (mHeight / 2.0f);
-                const auto lb = new LaserBeam(GetGame(), laserStart, GetRotation(), laserColor, this);
-                lb->SetType(ActorType::Local);
-                mLaserCooldown = 0.2f;
-            }
-        }
-        return;
-    }
-
     bool up, down, left, right;
     
     if (mIsRedShip) {
@@ -194,12 +154,21 @@ void Ship::OnProcessInput(const uint8_t* state)
         if (mLaserCooldown <= 0.f) {
             Vector3 laserColor = mIsRedShip ? Vector3(1.0f, 0.0f, 0.0f) : Vector3(0.0f, 1.0f, 0.0f);
             Vector2 laserStart = GetPosition() + GetForward() * (mHeight / 2.0f);
-            new LaserBeam(GetGame(), laserStart, GetRotation(), laserColor, this);
+            GetGame()->FireLaser(laserStart, GetRotation(), laserColor, this);
             mLaserCooldown = 0.2f;
         }
     }
 }
 
+// Dispara o laser visual da nave do jogador no multiplayer
+void Ship::FireLocalLaser()
+{
+    constexpr auto laserColor = Vector3(0.0f, 1.0f, 0.0f);
+    const Vector2 laserStart = GetPosition() + GetForward() * (mHeight / 2.0f);
+    const auto lb = GetGame()->FireLaser(laserStart, GetRotation(), laserColor, this);
+    lb->SetType(ActorType::Local);
+}
+
 // Atualiza timers, invencibilidade e posição dos indicadores de vida
 void Ship::OnUpdate(float deltaTime)
 {
@@ -383,28 +352,27 @@ std::vector<Vector2> Ship::CreateColliderCircleVertices(float radius) {
     return vertices;
 }
 
-// Atualiza a exibição visual das vidas da nave
+// Atualiza a exibição visual das vidas da nave: um quadrado ativo por vida restante
 void Ship::UpdateLivesDisplay() {
-    for (int i = 0; i < 4; i++) {
-        if (mLivesActors[i] != nullptr) {
-            mLivesActors[i]->SetState(ActorState::Destroy);
-            mLivesActors[i] = nullptr;
-        }
-    }
-    
-    std::vector<Vector2> lifeSquare = CreateLifeSquareVertices();
     float spacing = 20.0f;
     float startX = -(spacing * (mLives - 1)) / 2.0f;
+    float offsetY = mHeight / 2 + 20.0f;
     
-    for (int i = 0; i < mLives; i++) {
-        Actor* lifeActor = new Actor(GetGame());
-        lifeActor->SetState(ActorState::Active);
+    for (int i = 0; i < 4; i++) {
+        Actor* lifeActor = mLivesActors[i];
+        // a cena já está sendo descarregada
+        if (lifeActor->GetState() == ActorState::Destroy) {
+            continue;
+        }
+        
+        if (i >= mLives) {
+            lifeActor->SetState(ActorState::Paused);
+            continue;
+        }
         
+        lifeActor->SetState(ActorState::Active);
         float offsetX = startX + i * spacing;
-        float offsetY = mHeight / 2 + 20.0f;
         lifeActor->SetPosition(GetPosition() + Vector2(offsetX, -offsetY));
-        
-        new DrawComponent(lifeActor, lifeSquare, 101, Vector3(1.0f, 1.0f, 1.0f), true);
-        mLivesActors[i] = lifeActor;
+        lifeActor->ResetRenderState();
     }
 }
@@ -22,6 +22,7 @@ public:
         }
     }
     void TakeDamage();
+    void FireLocalLaser();
 
     void SetInvincibilityTimer(const float timer) { mInvincibilityTimer = timer; }
     bool IsInvincible() const { return mInvincibilityTimer > 0.0f; }
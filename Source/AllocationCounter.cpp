@@ -0,0 +1,103 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic<uint64_t> sAllocations{0};
+}
+
+uint64_t AllocationCounter::GetCount()
+{
+    return sAllocations.load(std::memory_order_relaxed);
+}
+
+namespace
+{
+    // o aligned_alloc pede um tamanho múltiplo do alinhamento
+    void* AlignedAlloc(std::size_t size, const std::size_t alignment)
+    {
+        size = (size + alignment - 1) / alignment * alignment;
+#ifdef _WIN32
+        return _aligned_malloc(size, alignment);
+#else
+        return std::aligned_alloc(alignment, size);
+#endif
+    }
+
+    void AlignedFree(void* memory)
+    {
+#ifdef _WIN32
+        _aligned_free(memory);
+#else
+        std::free(memory);
+#endif
+    }
+}
+
+// Substitui o operator new global, com e sem alinhamento; as versões de array,
+// nothrow e o delete com tamanho da biblioteca padrão chamam estas duas, então
+// todas passam pela contagem
+void* operator new(std::size_t size)
+{
+    sAllocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (size == 0) {
+        size = 1;
+    }
+
+    while (true) {
+        if (void* memory = std::malloc(size)) {
+            return memory;
+        }
+
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+// Tipos com alignas acima do alinhamento do malloc, como PacketBuffer e SpscRing
+void* operator new(std::size_t size, const std::align_val_t alignment)
+{
+    sAllocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (size == 0) {
+        size = 1;
+    }
+
+    while (true) {
+        if (void* memory = AlignedAlloc(size, static_cast<std::size_t>(alignment))) {
+            return memory;
+        }
+
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+    AlignedFree(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept
+{
+    AlignedFree(memory);
+}
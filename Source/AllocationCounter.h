@@ -0,0 +1,9 @@
+#pragma once
+#include <cstdint>
+
+// Counts every call to the global operator new of the process, on any thread,
+// so a frame can tell whether it touched the heap
+namespace AllocationCounter
+{
+    uint64_t GetCount();
+}
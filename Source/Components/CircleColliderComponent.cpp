@@ -4,12 +4,14 @@
 
 #include "CircleColliderComponent.h"
 #include "../Actors/Actor.h"
+#include "../Game.h"
 
 
 CircleColliderComponent::CircleColliderComponent(class Actor* owner, const float radius, const int updateOrder)
-        :Component(owner, updateOrder)
-        ,mRadius(radius)
+        :Component(owner, TYPE, updateOrder)
 {
+    mOwner->GetEntities()->AddCollider(mOwner->GetEntity(), radius);
+
     std::vector<float> vertices = CreateCircleVertices(radius);
     std::vector<unsigned int> indices;
 
@@ -24,13 +26,24 @@ CircleColliderComponent::CircleColliderComponent(class Actor* owner, const float
 
 CircleColliderComponent::~CircleColliderComponent()
 {
-    delete mDrawArray;
+    mOwner->GetGame()->GetRenderer()->ReleaseVertexArray(mDrawArray);
     mDrawArray = nullptr;
+    mOwner->GetEntities()->RemoveParts(mOwner->GetEntity(), EntityPart::Collider);
+}
+
+void CircleColliderComponent::SetRadius(const float radius)
+{
+    mOwner->GetEntities()->Radius(mOwner->GetEntity()) = radius;
+}
+
+float CircleColliderComponent::GetRadius() const
+{
+    return mOwner->GetEntities()->Radius(mOwner->GetEntity());
 }
 
 bool CircleColliderComponent::Intersect(const CircleColliderComponent& c) const
 {
-    float radiusSum = mRadius + c.mRadius;
+    float radiusSum = GetRadius() + c.GetRadius();
     float distanceX = Math::Abs(mOwner->GetPosition().x - c.mOwner->GetPosition().x);
     float distanceY = Math::Abs(mOwner->GetPosition().y - c.mOwner->GetPosition().y);
 
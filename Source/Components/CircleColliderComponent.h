@@ -10,22 +10,23 @@
 class CircleColliderComponent : public Component
 {
 public:
+    static constexpr ComponentType TYPE = ComponentType::CircleCollider;
+
     CircleColliderComponent(class Actor* owner, float radius, int updateOrder = 10);
     ~CircleColliderComponent();
 
     // Drawing for debug purposes
     void DebugDraw(class Renderer* renderer) override;
 
-    // Setters and getters
-    void SetRadius(float radius) { mRadius = radius; }
-    float GetRadius() const { return mRadius; }
+    // Setters and getters, the radius is kept in the game's entity table
+    void SetRadius(float radius);
+    float GetRadius() const;
 
     // Check intersection between this circle and another
     bool Intersect(const CircleColliderComponent& b) const;
 
 private:
     std::vector<float> CreateCircleVertices(float radius);
-    float mRadius;
     class VertexArray *mDrawArray;
 };
 
@@ -2,8 +2,9 @@
 #include "../Actors/Actor.h"
 
 // Constrói um componente e o adiciona ao ator proprietário
-Component::Component(Actor* owner, int updateOrder)
+Component::Component(Actor* owner, ComponentType type, int updateOrder)
           :mOwner(owner)
+          ,mType(type)
           ,mUpdateOrder(updateOrder)
 {
     mOwner->AddComponent(this);
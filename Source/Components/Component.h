@@ -1,20 +1,40 @@
 #pragma once
+#include <cstdint>
 #include <SDL_stdinc.h>
 
+// Id of every concrete component type, fixed at compile time. Each component
+// class names its own in TYPE and the actor keeps its components in a table
+// indexed by it, so finding one is an array access and never a cast.
+enum class ComponentType : uint8_t
+{
+    RigidBody,
+    CircleCollider,
+    Draw,
+    GridDraw,
+    LaserDraw,
+    ColliderDraw,
+    Trail,
+    LaserBeam,
+    ParticleSystem,
+    Count
+};
+
 class Component
 {
 public:
-    Component(class Actor* owner, int updateOrder = 100);
+    Component(class Actor* owner, ComponentType type, int updateOrder = 100);
     virtual ~Component();
     virtual void Update(float deltaTime);
     virtual void ProcessInput(const Uint8* keyState);
     virtual void DebugDraw(class Renderer* renderer);
 
+    ComponentType GetType() const { return mType; }
     int GetUpdateOrder() const { return mUpdateOrder; }
     class Actor* GetOwner() const { return mOwner; }
     class Game* GetGame() const;
 
 protected:
     class Actor* mOwner;
+    ComponentType mType;
     int mUpdateOrder;
 };
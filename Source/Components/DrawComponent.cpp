@@ -4,13 +4,20 @@
 
 // Constrói um componente de desenho com os vértices especificados
 DrawComponent::DrawComponent(class Actor* owner, std::vector<Vector2> &vertices, int drawOrder, Vector3 color, bool filled)
-    :Component(owner)
+    :DrawComponent(owner, TYPE, vertices, drawOrder, color, filled)
+{
+}
+
+DrawComponent::DrawComponent(class Actor* owner, ComponentType type, std::vector<Vector2> &vertices, int drawOrder, Vector3 color, bool filled)
+    :Component(owner, type)
     ,mDrawOrder(drawOrder)
     ,mIsVisible(true)
     ,mIsFilled(filled)
     ,mColor(color)
 {
     mOwner->GetGame()->AddDrawable(this);
+    // a matriz de modelo passa a ser calculada pelo sistema junto com as demais
+    mOwner->GetEntities()->AddDrawable(mOwner->GetEntity());
 
     std::vector<float> floatVertices;
     std::vector<unsigned int> indices;
@@ -27,7 +34,7 @@ DrawComponent::DrawComponent(class Actor* owner, std::vector<Vector2> &vertices,
 DrawComponent::~DrawComponent()
 {
     mOwner->GetGame()->RemoveDrawable(this);
-    delete mDrawArray;
+    mOwner->GetGame()->GetRenderer()->ReleaseVertexArray(mDrawArray);
     mDrawArray = nullptr;
 }
 
@@ -9,6 +9,8 @@
 class DrawComponent : public Component
 {
 public:
+    static constexpr ComponentType TYPE = ComponentType::Draw;
+
     DrawComponent(class Actor* owner, std::vector<Vector2> &vertices, int drawOrder = 100, Vector3 color = Vector3(1, 1, 1), bool filled = false);
     ~DrawComponent();
 
@@ -16,9 +18,13 @@ public:
     int GetDrawOrder() const { return mDrawOrder; }
 
     void SetVisible(bool visible) { mIsVisible = visible; }
+    void SetColor(Vector3 color) { mColor = color; }
     class VertexArray* GetVertexArray() const { return mDrawArray; }
 
 protected:
+    // For the derived draw components, each registered under its own type
+    DrawComponent(class Actor* owner, ComponentType type, std::vector<Vector2> &vertices, int drawOrder, Vector3 color, bool filled);
+
     int mDrawOrder;
     bool mIsVisible;
     bool mIsFilled;
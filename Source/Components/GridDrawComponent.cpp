@@ -4,8 +4,6 @@
 
 #include "GridDrawComponent.h"
 #include "../Game.h"
-#include "../Renderer/Shader.h"
-#include <GL/glew.h>
 #include <cmath>
 
 namespace {
@@ -13,7 +11,7 @@ namespace {
 }
 
 GridDrawComponent::GridDrawComponent(class Actor* owner, float width, float height, float cellSize, int drawOrder, Vector3 color)
-    : DrawComponent(owner, emptyVertices, drawOrder, color)
+    : DrawComponent(owner, TYPE, emptyVertices, drawOrder, color, false)
     , mWidth(width)
     , mHeight(height)
     , mCellSize(cellSize)
@@ -84,43 +82,24 @@ GridDrawComponent::GridDrawComponent(class Actor* owner, float width, float heig
 
 GridDrawComponent::~GridDrawComponent()
 {
-    delete mGridArray;
+    mOwner->GetGame()->GetRenderer()->ReleaseVertexArray(mGridArray);
     mGridArray = nullptr;
 }
 
 void GridDrawComponent::Draw(Renderer* renderer)
 {
     if (mOwner->GetState() == ActorState::Active) {
-        renderer->GetBaseShader()->SetActive();
-        renderer->GetBaseShader()->SetMatrixUniform("uWorldTransform", mOwner->GetModelMatrix());
-        
-        // Enable blending for neon glow effect
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        
+        const Matrix4 world = mOwner->GetModelMatrix();
+
         // First pass: Draw the glow (wider lines with cyan color and reduced alpha)
-        Vector3 glowColor(0.0f, 0.7f, 1.0f); // Cyan-blue glow color
-        renderer->GetBaseShader()->SetVectorUniform("uColor", glowColor);
-        renderer->GetBaseShader()->SetFloatUniform("uAlpha", 0.3f); // Reduced alpha for subtle glow
-        
-        // Set wider line width for glow (note: glLineWidth may be limited by implementation)
+        // Wider line width for glow (note: glLineWidth may be limited by implementation)
         // If glLineWidth doesn't work, the glow effect will still be visible due to blending
-        glLineWidth(4.0f);
-        
-        mGridArray->SetActive();
-        glDrawElements(GL_LINES, mGridArray->GetNumIndices(), GL_UNSIGNED_INT, nullptr);
+        Vector3 glowColor(0.0f, 0.7f, 1.0f); // Cyan-blue glow color
+        renderer->DrawLines(world, mGridArray, glowColor, 0.3f, 4.0f);
         
         // Second pass: Draw the black line on top (thinner, opaque)
         Vector3 lineColor(0.0f, 0.0f, 0.0f); // Black line
-        renderer->GetBaseShader()->SetVectorUniform("uColor", lineColor);
-        renderer->GetBaseShader()->SetFloatUniform("uAlpha", 1.0f); // Full opacity
-        
-        // Set thinner line width for the actual line
-        glLineWidth(1.0f);
-        
-        glDrawElements(GL_LINES, mGridArray->GetNumIndices(), GL_UNSIGNED_INT, nullptr);
-        
-        glDisable(GL_BLEND);
+        renderer->DrawLines(world, mGridArray, lineColor, 1.0f, 1.0f);
     }
 }
 
@@ -12,6 +12,8 @@
 class GridDrawComponent : public DrawComponent
 {
 public:
+    static constexpr ComponentType TYPE = ComponentType::GridDraw;
+
     GridDrawComponent(class Actor* owner, float width, float height, float cellSize, int drawOrder = 0, Vector3 color = Vector3(1, 1, 1));
     ~GridDrawComponent();
 
@@ -8,7 +8,7 @@
 
 // Constrói o componente de desenho do laser
 LaserDrawComponent::LaserDrawComponent(class Actor* owner, std::vector<Vector2> &vertices, int drawOrder, Vector3 color, class LaserBeamComponent* laserComp)
-    : DrawComponent(owner, vertices, drawOrder, color, true)
+    : DrawComponent(owner, TYPE, vertices, drawOrder, color, true)
     , mAlpha(1.0f)
     ,     mLaserComponent(laserComp)
 {
@@ -73,48 +73,34 @@ void LaserDrawComponent::Draw(Renderer* renderer)
 void LaserDrawComponent::DrawLaserFlare(Renderer* renderer, const Vector2& position, Vector3 color, float alpha, float size)
 {
     const int numSegments = 16;
-    std::vector<Vector2> flareVertices;
+    Vector2 flareVertices[numSegments];
     
     for (int i = 0; i < numSegments; i++) {
         float angle = (Math::TwoPi * i) / numSegments;
-        flareVertices.emplace_back(Vector2(
+        flareVertices[i] = Vector2(
             position.x + Math::Cos(angle) * size,
             position.y + Math::Sin(angle) * size
-        ));
+        );
     }
     
-    // Converter para formato de float array
-    std::vector<float> floatVertices;
-    std::vector<unsigned int> indices;
-    for (size_t i = 0; i < flareVertices.size(); ++i) {
-        floatVertices.push_back(flareVertices[i].x);
-        floatVertices.push_back(flareVertices[i].y);
-        indices.push_back(static_cast<unsigned int>(i));
-    }
-    
-    // Criar VertexArray temporário
-    class VertexArray* flareArray = new VertexArray(floatVertices.data(), 
-                                                    static_cast<unsigned int>(floatVertices.size()), 
-                                                    indices.data(), 
-                                                    static_cast<unsigned int>(indices.size()));
+    // Os vértices vão no próprio quadro e servem às quatro camadas
+    RenderGeometry flare = renderer->AddGeometry(flareVertices, numSegments);
     
     Matrix4 outerFlareTransform = Matrix4::CreateScale(2.5f, 2.5f, 1.0f) * 
                                    Matrix4::CreateTranslation(Vector3(position.x, position.y, 0.0f));
-    renderer->DrawFilledWithAlpha(outerFlareTransform, flareArray, color, alpha * 0.2f);
+    renderer->DrawFilledWithAlpha(outerFlareTransform, flare, color, alpha * 0.2f);
     
     Matrix4 midFlareTransform = Matrix4::CreateScale(1.8f, 1.8f, 1.0f) * 
                                  Matrix4::CreateTranslation(Vector3(position.x, position.y, 0.0f));
-    renderer->DrawFilledWithAlpha(midFlareTransform, flareArray, color, alpha * 0.4f);
+    renderer->DrawFilledWithAlpha(midFlareTransform, flare, color, alpha * 0.4f);
     
     Matrix4 innerFlareTransform = Matrix4::CreateScale(1.2f, 1.2f, 1.0f) * 
                                   Matrix4::CreateTranslation(Vector3(position.x, position.y, 0.0f));
-    renderer->DrawFilledWithAlpha(innerFlareTransform, flareArray, color, alpha * 0.7f);
+    renderer->DrawFilledWithAlpha(innerFlareTransform, flare, color, alpha * 0.7f);
     
     Vector3 whiteCore(1.0f, 1.0f, 1.0f);
     Matrix4 coreFlareTransform = Matrix4::CreateTranslation(Vector3(position.x, position.y, 0.0f));
-    renderer->DrawFilledWithAlpha(coreFlareTransform, flareArray, whiteCore, alpha * 0.9f);
-    
-    delete flareArray;
+    renderer->DrawFilledWithAlpha(coreFlareTransform, flare, whiteCore, alpha * 0.9f);
 }
 
 // Desenha um efeito de impacto quando o laser atinge um objeto
@@ -122,56 +108,43 @@ void LaserDrawComponent::DrawLaserImpact(Renderer* renderer, const Vector2& posi
 {
     const float impactSize = 10.0f;
     const int numSegments = 16;
-    std::vector<Vector2> impactVertices;
+    Vector2 impactVertices[numSegments];
     
     for (int i = 0; i < numSegments; i++) {
         float angle = (Math::TwoPi * i) / numSegments;
-        impactVertices.emplace_back(Vector2(
+        impactVertices[i] = Vector2(
             position.x + Math::Cos(angle) * impactSize,
             position.y + Math::Sin(angle) * impactSize
-        ));
-    }
-    
-    // Converter para formato de float array
-    std::vector<float> floatVertices;
-    std::vector<unsigned int> indices;
-    for (size_t i = 0; i < impactVertices.size(); ++i) {
-        floatVertices.push_back(impactVertices[i].x);
-        floatVertices.push_back(impactVertices[i].y);
-        indices.push_back(static_cast<unsigned int>(i));
+        );
     }
     
-    class VertexArray* impactArray = new VertexArray(floatVertices.data(), 
-                                                      static_cast<unsigned int>(floatVertices.size()), 
-                                                      indices.data(), 
-                                                      static_cast<unsigned int>(indices.size()));
+    // Os vértices vão no próprio quadro e servem às cinco camadas
+    RenderGeometry impact = renderer->AddGeometry(impactVertices, numSegments);
     
     Matrix4 outerImpactTransform = Matrix4::CreateScale(3.0f, 3.0f, 1.0f) * 
                                     Matrix4::CreateTranslation(Vector3(position.x, position.y, 0.0f));
-    renderer->DrawFilledWithAlpha(outerImpactTransform, impactArray, color, alpha * 0.25f);
+    renderer->DrawFilledWithAlpha(outerImpactTransform, impact, color, alpha * 0.25f);
     
     Matrix4 largeImpactTransform = Matrix4::CreateScale(2.2f, 2.2f, 1.0f) * 
                                    Matrix4::CreateTranslation(Vector3(position.x, position.y, 0.0f));
-    renderer->DrawFilledWithAlpha(largeImpactTransform, impactArray, color, alpha * 0.45f);
+    renderer->DrawFilledWithAlpha(largeImpactTransform, impact, color, alpha * 0.45f);
     
     Matrix4 midImpactTransform = Matrix4::CreateScale(1.5f, 1.5f, 1.0f) * 
                                   Matrix4::CreateTranslation(Vector3(position.x, position.y, 0.0f));
-    renderer->DrawFilledWithAlpha(midImpactTransform, impactArray, color, alpha * 0.7f);
+    renderer->DrawFilledWithAlpha(midImpactTransform, impact, color, alpha * 0.7f);
     
     Matrix4 innerImpactTransform = Matrix4::CreateScale(1.1f, 1.1f, 1.0f) * 
                                    Matrix4::CreateTranslation(Vector3(position.x, position.y, 0.0f));
-    renderer->DrawFilledWithAlpha(innerImpactTransform, impactArray, color, alpha * 0.9f);
+    renderer->DrawFilledWithAlpha(innerImpactTransform, impact, color, alpha * 0.9f);
     
     Vector3 whiteCore(1.0f, 1.0f, 1.0f);
     Matrix4 coreImpactTransform = Matrix4::CreateTranslation(Vector3(position.x, position.y, 0.0f));
-    renderer->DrawFilledWithAlpha(coreImpactTransform, impactArray, whiteCore, alpha);
-    
-    delete impactArray;
+    renderer->DrawFilledWithAlpha(coreImpactTransform, impact, whiteCore, alpha);
 }
 
 // Constrói o componente de desenho do colisor
 ColliderDrawComponent::ColliderDrawComponent(class Actor* owner, std::vector<Vector2> &vertices, int drawOrder, Vector3 color)
-    : DrawComponent(owner, vertices, drawOrder, color, false)
+    : DrawComponent(owner, TYPE, vertices, drawOrder, color, false)
 {
 }
 
@@ -221,7 +194,7 @@ void ColliderDrawComponent::Draw(Renderer* renderer)
 
 // Constrói o componente de raio laser
 LaserBeamComponent::LaserBeamComponent(class Actor* owner, Vector3 color, float lifetime)
-    : Component(owner, 10)
+    : Component(owner, TYPE, 10)
     , mColor(color)
     , mLifetime(0.0f)
     , mMaxLifetime(lifetime)
@@ -230,6 +203,7 @@ LaserBeamComponent::LaserBeamComponent(class Actor* owner, Vector3 color, float
     , mEndPos(Vector2::Zero)
     , mRotation(0.0f)
     , mHitObject(false)
+    , mOwnerShip(nullptr)
     , mDrawComponent(nullptr)
     , mHitShips()
 {
@@ -260,6 +234,13 @@ void LaserBeamComponent::Update(float deltaTime)
     }
 }
 
+// Muda a cor do raio, um laser reaproveitado pode ser de outra nave
+void LaserBeamComponent::SetColor(Vector3 color)
+{
+    mColor = color;
+    mDrawComponent->SetColor(color);
+}
+
 // Ativa o laser na posição inicial com rotação especificada
 void LaserBeamComponent::Activate(const Vector2& startPos, float rotation, float screenWidth, float screenHeight, class Ship* ownerShip)
 {
@@ -267,6 +248,9 @@ void LaserBeamComponent::Activate(const Vector2& startPos, float rotation, float
     mRotation = rotation;
     mLifetime = mMaxLifetime;
     mIsActive = true;
+    mOwnerShip = ownerShip;
+    // as naves atingidas no disparo anterior não contam mais, a capacidade fica
+    mHitShips.clear();
     
     CalculateEndPoint(screenWidth, screenHeight, ownerShip);
     
@@ -9,6 +9,8 @@ class LaserBeamComponent;
 class LaserDrawComponent : public DrawComponent
 {
 public:
+    static constexpr ComponentType TYPE = ComponentType::LaserDraw;
+
     LaserDrawComponent(class Actor* owner, std::vector<Vector2> &vertices, int drawOrder, Vector3 color, class LaserBeamComponent* laserComp = nullptr);
     void Draw(Renderer* renderer) override;
     
@@ -26,6 +28,8 @@ private:
 class ColliderDrawComponent : public DrawComponent
 {
 public:
+    static constexpr ComponentType TYPE = ComponentType::ColliderDraw;
+
     ColliderDrawComponent(class Actor* owner, std::vector<Vector2> &vertices, int drawOrder, Vector3 color);
     void Draw(Renderer* renderer) override;
 };
@@ -33,6 +37,8 @@ public:
 class LaserBeamComponent : public Component
 {
 public:
+    static constexpr ComponentType TYPE = ComponentType::LaserBeam;
+
     LaserBeamComponent(class Actor* owner, Vector3 color, float lifetime = 0.5f);
     ~LaserBeamComponent();
 
@@ -40,12 +46,14 @@ public:
     
     bool IsActive() const { return mIsActive && mLifetime > 0.0f; }
     float GetAlpha() const { return mLifetime / mMaxLifetime; }
+    void SetColor(Vector3 color);
     void Activate(const Vector2& startPos, float rotation, float screenWidth, float screenHeight, class Ship* ownerShip = nullptr);
     bool IntersectCircle(const Vector2& circleCenter, float radius) const;
     
     Vector2 GetStartPos() const { return mStartPos; }
     Vector2 GetEndPos() const { return mEndPos; }
     bool HitObject() const { return mHitObject; }
+    class Ship* GetOwnerShip() const { return mOwnerShip; }
     
     bool HasHitShip(class Ship* ship) const;
     void MarkShipHit(class Ship* ship);
@@ -59,6 +67,7 @@ private:
     Vector2 mEndPos;
     float mRotation;
     bool mHitObject; // Indica se o raio atingiu um objeto (não apenas a borda)
+    class Ship* mOwnerShip;
     
     class LaserDrawComponent* mDrawComponent;
     std::vector<Vector2> CreateLineVertices(float width);
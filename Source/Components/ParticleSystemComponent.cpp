@@ -22,14 +22,14 @@ Particle::Particle(class Game* game, std::vector<Vector2> &vertices, SystemType
     mRigidBodyComponent = new RigidBodyComponent(this);
     mCircleColliderComponent = new CircleColliderComponent(this, 2);
 
-    mState = ActorState::Paused;
+    SetState(ActorState::Paused);
     mDrawComponent->SetVisible(false);
 }
 
 void Particle::Kill()
 {
     mIsDead = true;
-    mState = ActorState::Paused;
+    SetState(ActorState::Paused);
     mDrawComponent->SetVisible(false);
     mRigidBodyComponent->SetVelocity(Vector2(0.0f, 0.0f));
 }
@@ -38,10 +38,11 @@ void Particle::Awake(const Vector2 &position, float rotation, float lifetime)
 {
     mLifeTime = lifetime;
     mIsDead = false;
-    mState = ActorState::Active;
+    SetState(ActorState::Active);
     mDrawComponent->SetVisible(true);
-    mPosition = position;
-    mRotation = rotation;
+    SetPosition(position);
+    SetRotation(rotation);
+    ResetRenderState();
 }
 
 void Particle::OnUpdate(float deltaTime)
@@ -56,7 +57,7 @@ void Particle::OnUpdate(float deltaTime)
 
 ParticleSystemComponent::ParticleSystemComponent(class Actor* owner, std::vector<Vector2> &vertices, int poolSize, int updateOrder,
     SystemType type, Vector3 color, bool filled)
-    : Component(owner, updateOrder)
+    : Component(owner, TYPE, updateOrder)
     ,mSystemType(type)
     ,mParticleColor(color)
     ,mParticleFilled(filled)
@@ -39,6 +39,8 @@ private:
 class ParticleSystemComponent : public Component {
 
 public:
+    static constexpr ComponentType TYPE = ComponentType::ParticleSystem;
+
     ParticleSystemComponent(class Actor* owner, std::vector<Vector2> &vertices,  int poolSize = 100, int updateOrder = 10,
         SystemType type = SystemType::Shoot, Vector3 color = Vector3(1.0f, 1.0f, 1.0f), bool filled = false);
     void EmitParticle(float lifetime, float speed, const Vector2& offsetPosition = Vector2::Zero);
@@ -2,86 +2,57 @@
 // Created by Lucas N. Ferreira on 08/09/23.
 //
 
-#include <SDL.h>
 #include "RigidBodyComponent.h"
-
-
-
 #include "../Actors/Actor.h"
-#include "../Game.h"
 
 RigidBodyComponent::RigidBodyComponent(class Actor* owner, float mass, int updateOrder)
-        :Component(owner, updateOrder)
-        ,mMass(mass)
-        ,mAngularSpeed(0.0f)
-        ,mVelocity(Vector2::Zero)
-        ,mAcceleration(Vector2::Zero)
+        :Component(owner, TYPE, updateOrder)
 {
-
+        mOwner->GetEntities()->AddBody(mOwner->GetEntity(), mass);
 }
 
-void RigidBodyComponent::ApplyForce(const Vector2 &force)
+RigidBodyComponent::~RigidBodyComponent()
 {
-        mAcceleration.x += force.x / mMass;
-        mAcceleration.y += force.y / mMass;
+        mOwner->GetEntities()->RemoveParts(mOwner->GetEntity(), EntityPart::Body);
 }
 
-void RigidBodyComponent::Update(float deltaTime)
+Vector2 RigidBodyComponent::GetVelocity() const
 {
-        Vector2 position = mOwner->GetPosition();
-
-        mVelocity.x += mAcceleration.x * deltaTime;
-        if (mVelocity.x > MAX_VELOCITY) {
-                mVelocity.x = MAX_VELOCITY;
-        }else if (mVelocity.x < -MAX_VELOCITY) {
-                mVelocity.x = -MAX_VELOCITY;
-        }else {
-                if (Math::Abs(mVelocity.x) < 0.1f) {
-                        mVelocity.x = 0.0f;
-                }
-        }
-        position.x += mVelocity.x * deltaTime;
+        return mOwner->GetEntities()->Velocity(mOwner->GetEntity());
+}
 
+void RigidBodyComponent::SetVelocity(const Vector2& velocity)
+{
+        mOwner->GetEntities()->Velocity(mOwner->GetEntity()) = velocity;
+}
 
-        mVelocity.y += mAcceleration.y * deltaTime;
-        if (mVelocity.y > MAX_VELOCITY) {
-                mVelocity.y = MAX_VELOCITY;
-        }else if (mVelocity.y < -MAX_VELOCITY) {
-                mVelocity.y = -MAX_VELOCITY;
-        }else {
-                if (Math::Abs(mVelocity.y) < 0.1f) {
-                        mVelocity.y = 0.0f;
-                }
-        }
-        position.y += mVelocity.y * deltaTime;
+Vector2 RigidBodyComponent::GetAcceleration() const
+{
+        return mOwner->GetEntities()->Acceleration(mOwner->GetEntity());
+}
 
+void RigidBodyComponent::SetAcceleration(const Vector2& acceleration)
+{
+        mOwner->GetEntities()->Acceleration(mOwner->GetEntity()) = acceleration;
+}
 
-        ScreenWrap(position);
-        mOwner->SetPosition(position);
-        mAcceleration.x = 0.0f;
-        mAcceleration.y = 0.0f;
+void RigidBodyComponent::SetAngularSpeed(const float speed)
+{
+        mOwner->GetEntities()->AngularSpeed(mOwner->GetEntity()) = speed;
+}
 
-        float rotation = mOwner->GetRotation();
-        rotation += mAngularSpeed * deltaTime;
-        mOwner->SetRotation(rotation);
+float RigidBodyComponent::GetAngularSpeed() const
+{
+        return mOwner->GetEntities()->AngularSpeed(mOwner->GetEntity());
 }
 
-void RigidBodyComponent::ScreenWrap(Vector2 &position)
+void RigidBodyComponent::ApplyForce(const Vector2 &force)
 {
-        // Obter o tamanho atual da janela
-        Game* game = mOwner->GetGame();
-        int windowWidth = game->GetWindowWidth();
-        int windowHeight = game->GetWindowHeight();
-        
-        if (position.x > static_cast<float>(windowWidth)) {
-                position.x = 0;
-        }else if (position.x < 0) {
-                position.x = static_cast<float>(windowWidth);
-        }
+        EntityStore *entities = mOwner->GetEntities();
+        const EntityId entity = mOwner->GetEntity();
+        const float inverseMass = entities->InverseMass(entity);
 
-        if (position.y > static_cast<float>(windowHeight)) {
-                position.y = 0;
-        }else if (position.y < 0) {
-                position.y = static_cast<float>(windowHeight);
-        }
+        Vector2 &acceleration = entities->Acceleration(entity);
+        acceleration.x += force.x * inverseMass;
+        acceleration.y += force.y * inverseMass;
 }
@@ -6,35 +6,26 @@
 #include "Component.h"
 #include "../Math.h"
 
+// The body itself is a row of the game's entity table, integrated with all the
+// others by EntitySystems::IntegrateBodies; the component only reaches it
 class RigidBodyComponent : public Component
 {
 public:
-    static const int MAX_VELOCITY = 700;
+    static constexpr ComponentType TYPE = ComponentType::RigidBody;
 
     // Lower update order to update first
     RigidBodyComponent(class Actor* owner, float mass = 1.0f, int updateOrder = 10);
-
-    void Update(float deltaTime) override;
+    ~RigidBodyComponent();
 
     // Getters/setters
-    const Vector2& GetVelocity() const { return mVelocity; }
-    void SetVelocity(const Vector2& velocity) { mVelocity = velocity; }
+    Vector2 GetVelocity() const;
+    void SetVelocity(const Vector2& velocity);
 
-    const Vector2& GetAcceleration() const { return mAcceleration; }
-    void SetAcceleration(const Vector2& acceleration) { mAcceleration = acceleration; }
+    Vector2 GetAcceleration() const;
+    void SetAcceleration(const Vector2& acceleration);
 
-    void SetAngularSpeed(const float speed) { mAngularSpeed = speed; }
-    float GetAngularSpeed() const { return mAngularSpeed; }
+    void SetAngularSpeed(float speed);
+    float GetAngularSpeed() const;
 
     void ApplyForce(const Vector2 &force);
-
-private:
-    void ScreenWrap(Vector2 &position);
-
-    // Physical properties
-    float mMass;
-    float mAngularSpeed;
-
-    Vector2 mVelocity;
-    Vector2 mAcceleration;
 };
@@ -8,7 +8,7 @@
 static std::vector<Vector2> emptyTrailVertices;
 
 TrailComponent::TrailComponent(class Actor* owner, Vector3 color, float trailLength, float updateInterval)
-    : DrawComponent(owner, emptyTrailVertices, 96, color, false) // Draw order 96 (atrás da nave mas na frente do grid)
+    : DrawComponent(owner, TYPE, emptyTrailVertices, 96, color, false) // Draw order 96 (atrás da nave mas na frente do grid)
     , mTrailLength(trailLength)
     , mUpdateInterval(updateInterval)
     , mTimeSinceLastUpdate(0.0f)
@@ -116,47 +116,20 @@ void TrailComponent::Draw(Renderer* renderer)
         Vector2 perpendicular(-direction.y, direction.x);
         float halfWidth = trailWidth * 0.5f;
         
-        // Criar vértices do quad (retângulo)
-        Vector2 p1 = point1.position + perpendicular * halfWidth;
-        Vector2 p2 = point1.position - perpendicular * halfWidth;
-        Vector2 p3 = point2.position - perpendicular * halfWidth;
-        Vector2 p4 = point2.position + perpendicular * halfWidth;
+        // Criar vértices do quad (retângulo), desenhado como TRIANGLE_FAN
+        // a partir do primeiro vértice
+        const Vector2 quadVertices[4] = {
+            point1.position + perpendicular * halfWidth,
+            point1.position - perpendicular * halfWidth,
+            point2.position - perpendicular * halfWidth,
+            point2.position + perpendicular * halfWidth
+        };
         
-        std::vector<Vector2> quadVertices;
-        quadVertices.push_back(p1);
-        quadVertices.push_back(p2);
-        quadVertices.push_back(p3);
-        quadVertices.push_back(p4);
+        // Os vértices vão no próprio quadro, sem criar um VertexArray por segmento
+        RenderGeometry quad = renderer->AddGeometry(quadVertices, 4);
         
-        // Converter para formato de float array
-        std::vector<float> floatVertices;
-        std::vector<unsigned int> indices;
-        for (size_t j = 0; j < quadVertices.size(); ++j) {
-            floatVertices.push_back(quadVertices[j].x);
-            floatVertices.push_back(quadVertices[j].y);
-        }
-        
-        // Índices para TRIANGLE_FAN (quad como fan de triângulos)
-        // TRIANGLE_FAN desenha triângulos conectados a partir do primeiro vértice
-        indices.push_back(0);
-        indices.push_back(1);
-        indices.push_back(2);
-        indices.push_back(3);
-        
-        // Criar VertexArray temporário
-        class VertexArray* quadArray = new VertexArray(floatVertices.data(), 
-                                                       static_cast<unsigned int>(floatVertices.size()), 
-                                                       indices.data(), 
-                                                       static_cast<unsigned int>(indices.size()));
-        
-        // Criar transformação de identidade (as posições já estão em coordenadas do mundo)
-        Matrix4 identity = Matrix4::Identity;
-        
-        // Desenhar o quad preenchido com alpha
-        renderer->DrawFilledWithAlpha(identity, quadArray, mColor, segmentAlpha);
-        
-        // Limpar o VertexArray
-        delete quadArray;
+        // Desenhar o quad preenchido com alpha (as posições já estão em coordenadas do mundo)
+        renderer->DrawFilledWithAlpha(Matrix4::Identity, quad, mColor, segmentAlpha);
     }
 }
 
@@ -13,13 +13,14 @@ struct TrailPoint
 class TrailComponent : public DrawComponent
 {
 public:
+    static constexpr ComponentType TYPE = ComponentType::Trail;
+
     TrailComponent(class Actor* owner, Vector3 color, float trailLength = 0.8f, float updateInterval = 0.02f);
     ~TrailComponent();
     
     void Update(float deltaTime) override;
     void Draw(class Renderer* renderer) override;
     
-    void SetColor(Vector3 color) { mColor = color; }
     void SetTrailLength(float length) { mTrailLength = length; }
     
 private:
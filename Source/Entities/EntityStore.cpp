@@ -0,0 +1,122 @@
+#include "EntityStore.h"
+
+namespace
+{
+    // Leva a última linha de uma coluna para o lugar da linha removida
+    template <typename T>
+    void MoveLastInto(std::vector<T> &column, const uint32_t row)
+    {
+        column[row] = column.back();
+        column.pop_back();
+    }
+}
+
+// Cria a entidade na última linha, reaproveitando um slot livre se houver
+EntityId EntityStore::Create(Actor* owner)
+{
+    uint32_t index;
+    if (!mFreeSlots.empty()) {
+        index = mFreeSlots.back();
+        mFreeSlots.pop_back();
+    } else {
+        index = static_cast<uint32_t>(mSlots.size());
+        mSlots.push_back(Slot{0, 0});
+    }
+
+    const auto row = static_cast<uint32_t>(mOwners.size());
+    mSlots[index].row = row;
+
+    mRowSlots.push_back(index);
+    mOwners.push_back(owner);
+    mSignatures.push_back(0);
+    mActive.push_back(1);
+
+    mPositions.push_back(Vector2::Zero);
+    mRotations.push_back(0.0f);
+    mScales.push_back(Vector2(1.0f, 1.0f));
+    mPreviousPositions.push_back(Vector2::Zero);
+    mPreviousRotations.push_back(0.0f);
+    mHasRenderState.push_back(0);
+
+    mVelocities.push_back(Vector2::Zero);
+    mAccelerations.push_back(Vector2::Zero);
+    mAngularSpeeds.push_back(0.0f);
+    mInverseMasses.push_back(0.0f);
+
+    mRadii.push_back(0.0f);
+
+    mWorlds.push_back(Matrix4::Identity);
+
+    return EntityId{index, mSlots[index].generation};
+}
+
+// Remove a linha da entidade mantendo a tabela compacta: a última linha ocupa o seu lugar
+void EntityStore::Destroy(const EntityId id)
+{
+    if (!IsAlive(id)) {
+        return;
+    }
+
+    const uint32_t row = RowOf(id);
+    const uint32_t last = GetCount() - 1;
+    if (row != last) {
+        mSlots[mRowSlots[last]].row = row;
+    }
+
+    MoveLastInto(mRowSlots, row);
+    MoveLastInto(mOwners, row);
+    MoveLastInto(mSignatures, row);
+    MoveLastInto(mActive, row);
+
+    MoveLastInto(mPositions, row);
+    MoveLastInto(mRotations, row);
+    MoveLastInto(mScales, row);
+    MoveLastInto(mPreviousPositions, row);
+    MoveLastInto(mPreviousRotations, row);
+    MoveLastInto(mHasRenderState, row);
+
+    MoveLastInto(mVelocities, row);
+    MoveLastInto(mAccelerations, row);
+    MoveLastInto(mAngularSpeeds, row);
+    MoveLastInto(mInverseMasses, row);
+
+    MoveLastInto(mRadii, row);
+
+    MoveLastInto(mWorlds, row);
+
+    // handles antigos deixam de valer
+    mSlots[id.index].generation++;
+    mFreeSlots.push_back(id.index);
+}
+
+bool EntityStore::IsAlive(const EntityId id) const
+{
+    return id.index < mSlots.size() && mSlots[id.index].generation == id.generation;
+}
+
+void EntityStore::AddBody(const EntityId id, const float mass)
+{
+    const uint32_t row = RowOf(id);
+    mSignatures[row] |= EntityPart::Body;
+    mVelocities[row] = Vector2::Zero;
+    mAccelerations[row] = Vector2::Zero;
+    mAngularSpeeds[row] = 0.0f;
+    mInverseMasses[row] = 1.0f / mass;
+}
+
+void EntityStore::AddCollider(const EntityId id, const float radius)
+{
+    const uint32_t row = RowOf(id);
+    mSignatures[row] |= EntityPart::Collider;
+    mRadii[row] = radius;
+}
+
+void EntityStore::AddDrawable(const EntityId id)
+{
+    mSignatures[RowOf(id)] |= EntityPart::Drawable;
+}
+
+void EntityStore::RemoveParts(const EntityId id, const EntitySignature parts)
+{
+    mSignatures[RowOf(id)] &= static_cast<EntitySignature>(~parts);
+}
@@ -0,0 +1,133 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "../Math.h"
+
+// Handle to an entity: the slot it was given and the generation of that slot,
+// so a handle kept past the entity's destruction is never taken for the next
+// entity in the same slot
+struct EntityId {
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+    uint32_t index = INVALID_INDEX;
+    uint32_t generation = 0;
+
+    [[nodiscard]] bool IsValid() const { return index != INVALID_INDEX; }
+};
+
+// What an entity has besides its transform, one bit each in its signature
+using EntitySignature = uint8_t;
+
+namespace EntityPart
+{
+    constexpr EntitySignature Body = 1 << 0;
+    constexpr EntitySignature Collider = 1 << 1;
+    constexpr EntitySignature Drawable = 1 << 2;
+}
+
+// Every entity of the game in one table, each piece of data in a column of its
+// own laid out contiguously, so a system walks the few columns it needs from
+// the first row to the last instead of chasing actors and components around
+// the heap. Rows stay packed: destroying an entity moves the last row into its
+// place, which is why entities are named by EntityId and not by row.
+class EntityStore
+{
+public:
+    EntityStore() = default;
+
+    EntityStore(const EntityStore&) = delete;
+    EntityStore &operator=(const EntityStore&) = delete;
+
+    // The owner is kept for systems that report back to the actor, it may be null
+    EntityId Create(class Actor* owner);
+    void Destroy(EntityId id);
+    [[nodiscard]] bool IsAlive(EntityId id) const;
+
+    // A body starts at rest, its mass only scales the forces applied to it
+    void AddBody(EntityId id, float mass);
+    void AddCollider(EntityId id, float radius);
+    void AddDrawable(EntityId id);
+    void RemoveParts(EntityId id, EntitySignature parts);
+
+    [[nodiscard]] bool HasParts(const EntityId id, const EntitySignature parts) const {
+        return (mSignatures[RowOf(id)] & parts) == parts;
+    }
+
+    // Only active entities are simulated and drawn
+    void SetActive(const EntityId id, const bool active) { mActive[RowOf(id)] = active ? 1 : 0; }
+
+    // Data of one live entity
+    Vector2 &Position(const EntityId id) { return mPositions[RowOf(id)]; }
+    [[nodiscard]] const Vector2 &Position(const EntityId id) const { return mPositions[RowOf(id)]; }
+    float &Rotation(const EntityId id) { return mRotations[RowOf(id)]; }
+    [[nodiscard]] float Rotation(const EntityId id) const { return mRotations[RowOf(id)]; }
+    Vector2 &Scale(const EntityId id) { return mScales[RowOf(id)]; }
+    [[nodiscard]] const Vector2 &Scale(const EntityId id) const { return mScales[RowOf(id)]; }
+    [[nodiscard]] const Vector2 &PreviousPosition(const EntityId id) const { return mPreviousPositions[RowOf(id)]; }
+    [[nodiscard]] float PreviousRotation(const EntityId id) const { return mPreviousRotations[RowOf(id)]; }
+    uint8_t &HasRenderState(const EntityId id) { return mHasRenderState[RowOf(id)]; }
+    Vector2 &Velocity(const EntityId id) { return mVelocities[RowOf(id)]; }
+    [[nodiscard]] const Vector2 &Velocity(const EntityId id) const { return mVelocities[RowOf(id)]; }
+    Vector2 &Acceleration(const EntityId id) { return mAccelerations[RowOf(id)]; }
+    [[nodiscard]] const Vector2 &Acceleration(const EntityId id) const { return mAccelerations[RowOf(id)]; }
+    float &AngularSpeed(const EntityId id) { return mAngularSpeeds[RowOf(id)]; }
+    [[nodiscard]] float InverseMass(const EntityId id) const { return mInverseMasses[RowOf(id)]; }
+    float &Radius(const EntityId id) { return mRadii[RowOf(id)]; }
+    [[nodiscard]] float Radius(const EntityId id) const { return mRadii[RowOf(id)]; }
+    [[nodiscard]] const Matrix4 &World(const EntityId id) const { return mWorlds[RowOf(id)]; }
+
+    // Columns, one element per row up to GetCount, for the systems
+    [[nodiscard]] uint32_t GetCount() const { return static_cast<uint32_t>(mOwners.size()); }
+    [[nodiscard]] const EntitySignature *GetSignatures() const { return mSignatures.data(); }
+    [[nodiscard]] const uint8_t *GetActive() const { return mActive.data(); }
+    Vector2 *GetPositions() { return mPositions.data(); }
+    float *GetRotations() { return mRotations.data(); }
+    [[nodiscard]] const Vector2 *GetScales() const { return mScales.data(); }
+    Vector2 *GetPreviousPositions() { return mPreviousPositions.data(); }
+    float *GetPreviousRotations() { return mPreviousRotations.data(); }
+    uint8_t *GetHasRenderState() { return mHasRenderState.data(); }
+    Vector2 *GetVelocities() { return mVelocities.data(); }
+    Vector2 *GetAccelerations() { return mAccelerations.data(); }
+    [[nodiscard]] const float *GetAngularSpeeds() const { return mAngularSpeeds.data(); }
+    [[nodiscard]] const float *GetRadii() const { return mRadii.data(); }
+    Matrix4 *GetWorlds() { return mWorlds.data(); }
+    [[nodiscard]] class Actor *const *GetOwners() const { return mOwners.data(); }
+
+private:
+    struct Slot {
+        uint32_t row;
+        uint32_t generation;
+    };
+
+    [[nodiscard]] uint32_t RowOf(const EntityId id) const { return mSlots[id.index].row; }
+
+    std::vector<Slot> mSlots;
+    std::vector<uint32_t> mFreeSlots;
+
+    // Rows
+    std::vector<uint32_t> mRowSlots;
+    std::vector<class Actor*> mOwners;
+    std::vector<EntitySignature> mSignatures;
+    std::vector<uint8_t> mActive;
+
+    // Transform
+    std::vector<Vector2> mPositions;
+    std::vector<float> mRotations;
+    std::vector<Vector2> mScales;
+    // where the current simulation step started, for the drawn blend
+    std::vector<Vector2> mPreviousPositions;
+    std::vector<float> mPreviousRotations;
+    std::vector<uint8_t> mHasRenderState;
+
+    // Body
+    std::vector<Vector2> mVelocities;
+    std::vector<Vector2> mAccelerations;
+    std::vector<float> mAngularSpeeds;
+    std::vector<float> mInverseMasses;
+
+    // Collider
+    std::vector<float> mRadii;
+
+    // Drawable, the blended transform of the frame being drawn
+    std::vector<Matrix4> mWorlds;
+};
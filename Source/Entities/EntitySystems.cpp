@@ -0,0 +1,130 @@
+#include "EntitySystems.h"
+
+namespace
+{
+    // Limita a velocidade de um eixo e zera o resto de movimento que sobra quando o corpo para
+    float ClampAxis(float velocity)
+    {
+        if (velocity > EntitySystems::MAX_VELOCITY) {
+            return EntitySystems::MAX_VELOCITY;
+        }
+        if (velocity < -EntitySystems::MAX_VELOCITY) {
+            return -EntitySystems::MAX_VELOCITY;
+        }
+        if (Math::Abs(velocity) < 0.1f) {
+            return 0.0f;
+        }
+        return velocity;
+    }
+
+    // Quem sai por um lado da tela volta pelo outro
+    float WrapAxis(const float position, const float size)
+    {
+        if (position > size) {
+            return 0.0f;
+        }
+        if (position < 0.0f) {
+            return size;
+        }
+        return position;
+    }
+}
+
+// Guarda a transformação do início do passo de simulação, usada na interpolação do desenho
+void EntitySystems::SaveRenderStates(EntityStore &store)
+{
+    const uint32_t count = store.GetCount();
+    const Vector2 *positions = store.GetPositions();
+    const float *rotations = store.GetRotations();
+    Vector2 *previousPositions = store.GetPreviousPositions();
+    float *previousRotations = store.GetPreviousRotations();
+    uint8_t *hasRenderState = store.GetHasRenderState();
+
+    for (uint32_t row = 0; row < count; row++) {
+        previousPositions[row] = positions[row];
+        previousRotations[row] = rotations[row];
+        hasRenderState[row] = 1;
+    }
+}
+
+// Integra as forças do passo, move os corpos ativos e dá a volta na tela
+void EntitySystems::IntegrateBodies(EntityStore &store, const float deltaTime, const float screenWidth, const float screenHeight)
+{
+    const uint32_t count = store.GetCount();
+    const EntitySignature *signatures = store.GetSignatures();
+    const uint8_t *active = store.GetActive();
+    Vector2 *positions = store.GetPositions();
+    float *rotations = store.GetRotations();
+    Vector2 *velocities = store.GetVelocities();
+    Vector2 *accelerations = store.GetAccelerations();
+    const float *angularSpeeds = store.GetAngularSpeeds();
+
+    for (uint32_t row = 0; row < count; row++) {
+        if (!active[row] || (signatures[row] & EntityPart::Body) == 0) {
+            continue;
+        }
+
+        Vector2 &velocity = velocities[row];
+        Vector2 &position = positions[row];
+
+        velocity.x = ClampAxis(velocity.x + accelerations[row].x * deltaTime);
+        velocity.y = ClampAxis(velocity.y + accelerations[row].y * deltaTime);
+        position.x = WrapAxis(position.x + velocity.x * deltaTime, screenWidth);
+        position.y = WrapAxis(position.y + velocity.y * deltaTime, screenHeight);
+
+        accelerations[row] = Vector2::Zero;
+        rotations[row] += angularSpeeds[row] * deltaTime;
+    }
+}
+
+// Calcula de uma vez a matriz de modelo de todos os desenháveis ativos do frame
+void EntitySystems::BlendWorldTransforms(EntityStore &store, const float alpha)
+{
+    const uint32_t count = store.GetCount();
+    const EntitySignature *signatures = store.GetSignatures();
+    const uint8_t *active = store.GetActive();
+    const Vector2 *positions = store.GetPositions();
+    const float *rotations = store.GetRotations();
+    const Vector2 *scales = store.GetScales();
+    const Vector2 *previousPositions = store.GetPreviousPositions();
+    const float *previousRotations = store.GetPreviousRotations();
+    const uint8_t *hasRenderState = store.GetHasRenderState();
+    Matrix4 *worlds = store.GetWorlds();
+
+    for (uint32_t row = 0; row < count; row++) {
+        if (!active[row] || (signatures[row] & EntityPart::Drawable) == 0) {
+            continue;
+        }
+
+        worlds[row] = BlendWorldTransform(previousPositions[row], previousRotations[row], hasRenderState[row] != 0,
+                                          positions[row], rotations[row], scales[row], alpha);
+    }
+}
+
+// Matriz de transformação do modelo (escala * rotação * translação), interpolada
+// entre o passo anterior e o atual
+Matrix4 EntitySystems::BlendWorldTransform(const Vector2 &previousPosition, const float previousRotation,
+                                           const bool hasRenderState, const Vector2 &position,
+                                           const float rotation, const Vector2 &scale, const float alpha)
+{
+    Vector2 drawnPosition = position;
+    float drawnRotation = rotation;
+
+    // saltos maiores que um passo plausível (volta da tela, respawn) não são interpolados
+    const Vector2 moved = position - previousPosition;
+    if (hasRenderState && moved.LengthSq() < MAX_BLENDED_DISTANCE * MAX_BLENDED_DISTANCE) {
+        drawnPosition = Vector2::Lerp(previousPosition, position, alpha);
+
+        // pelo menor arco, a rotação não é normalizada
+        float turned = Math::Fmod(rotation - previousRotation + Math::Pi, Math::TwoPi);
+        if (turned < 0.0f) {
+            turned += Math::TwoPi;
+        }
+        drawnRotation = previousRotation + (turned - Math::Pi) * alpha;
+    }
+
+    Matrix4 scaleMat = Matrix4::CreateScale(scale.x, scale.y, 1.0f);
+    Matrix4 rotMat   = Matrix4::CreateRotationZ(drawnRotation);
+    Matrix4 transMat = Matrix4::CreateTranslation(Vector3(drawnPosition.x, drawnPosition.y, 0.0f));
+    return scaleMat * rotMat * transMat;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include "EntityStore.h"
+
+// Systems over the entity table: each one walks its columns from the first
+// row to the last and skips the rows whose signature lacks what it needs
+namespace EntitySystems
+{
+    // Fastest a body moves along each axis
+    constexpr float MAX_VELOCITY = 700.0f;
+    // Farther than this in one step is a jump, not movement, and is not blended
+    constexpr float MAX_BLENDED_DISTANCE = 100.0f;
+
+    // Keeps the transform the coming simulation step starts from
+    void SaveRenderStates(EntityStore &store);
+
+    // Applies the forces of the step to every active body, moves it and wraps
+    // it around the screen
+    void IntegrateBodies(EntityStore &store, float deltaTime, float screenWidth, float screenHeight);
+
+    // Transform of every active drawable for the frame about to be drawn,
+    // blended from the previous simulation step by the render alpha
+    void BlendWorldTransforms(EntityStore &store, float alpha);
+
+    // The same blend for a single entity
+    Matrix4 BlendWorldTransform(const Vector2 &previousPosition, float previousRotation, bool hasRenderState,
+                                const Vector2 &position, float rotation, const Vector2 &scale, float alpha);
+}
@@ -0,0 +1,48 @@
+#include "FrameArena.h"
+#include <cstdint>
+#include <new>
+
+FrameArena::FrameArena(const size_t blockSize)
+:mCurrent(0)
+,mOffset(0)
+{
+    mBlocks.push_back(Block{static_cast<unsigned char*>(::operator new(blockSize)), blockSize});
+}
+
+FrameArena::~FrameArena()
+{
+    for (const Block &block : mBlocks) {
+        ::operator delete(block.memory);
+    }
+}
+
+void *FrameArena::Allocate(const size_t size, const size_t alignment)
+{
+    while (true) {
+        const Block &block = mBlocks[mCurrent];
+        const auto address = reinterpret_cast<uintptr_t>(block.memory) + mOffset;
+        const size_t padding = (alignment - address % alignment) % alignment;
+
+        if (mOffset + padding + size <= block.size) {
+            mOffset += padding + size;
+            return block.memory + mOffset - size;
+        }
+
+        // o bloco seguinte, já alocado num quadro anterior ou novo e maior que o pedido
+        mOffset = 0;
+        mCurrent++;
+        if (mCurrent == mBlocks.size()) {
+            size_t blockSize = block.size * 2;
+            while (blockSize < size + alignment) {
+                blockSize *= 2;
+            }
+            mBlocks.push_back(Block{static_cast<unsigned char*>(::operator new(blockSize)), blockSize});
+        }
+    }
+}
+
+void FrameArena::Reset()
+{
+    mCurrent = 0;
+    mOffset = 0;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Scratch memory that lives for one frame. Allocating bumps an offset into a
+// block, freeing does nothing, and Reset at the end of the frame hands all of
+// it back at once. A frame that outgrows the blocks chains a larger one, which
+// is kept, so after the first busy frames the arena stops asking the heap.
+// Only the thread that owns the frame uses it.
+class FrameArena
+{
+public:
+    explicit FrameArena(size_t blockSize);
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena &operator=(const FrameArena&) = delete;
+
+    void *Allocate(size_t size, size_t alignment);
+    // Everything allocated since the last reset is gone
+    void Reset();
+
+private:
+    struct Block {
+        unsigned char *memory;
+        size_t size;
+    };
+
+    std::vector<Block> mBlocks;
+    size_t mCurrent;
+    size_t mOffset;
+};
+
+// STL allocator over a FrameArena, for containers that die before the frame ends
+template <typename T>
+class FrameAllocator
+{
+public:
+    using value_type = T;
+
+    explicit FrameAllocator(FrameArena &arena) : mArena(&arena) {}
+    template <typename U>
+    FrameAllocator(const FrameAllocator<U> &other) : mArena(other.GetArena()) {}
+
+    T *allocate(const size_t count) { return static_cast<T*>(mArena->Allocate(count * sizeof(T), alignof(T))); }
+    void deallocate(T*, size_t) {}
+
+    [[nodiscard]] FrameArena *GetArena() const { return mArena; }
+
+    template <typename U>
+    bool operator==(const FrameAllocator<U> &other) const { return mArena == other.GetArena(); }
+    template <typename U>
+    bool operator!=(const FrameAllocator<U> &other) const { return mArena != other.GetArena(); }
+
+private:
+    FrameArena *mArena;
+};
+
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
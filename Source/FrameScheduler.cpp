@@ -0,0 +1,85 @@
+#include "FrameScheduler.h"
+#include <thread>
+
+FrameScheduler::FrameScheduler(const float simRate, const float renderRate)
+:mRenderRate(0.0f)
+,mStep(PeriodOf(simRate))
+,mFrame(Clock::duration::zero())
+,mAccumulator(Clock::duration::zero())
+{
+    SetRenderRate(renderRate);
+    Reset();
+}
+
+void FrameScheduler::Reset() {
+    mAccumulator = Clock::duration::zero();
+    mLastFrame = Clock::now();
+    mNextFrame = mLastFrame + mFrame;
+}
+
+void FrameScheduler::SetSimRate(const float rate) {
+    mStep = PeriodOf(rate);
+    if (mAccumulator >= mStep) {
+        mAccumulator = mStep - Clock::duration(1);
+    }
+}
+
+void FrameScheduler::SetRenderRate(const float rate) {
+    mRenderRate = rate > 0.0f ? rate : 0.0f;
+    mFrame = mRenderRate > 0.0f ? PeriodOf(mRenderRate) : Clock::duration::zero();
+    mNextFrame = Clock::now() + mFrame;
+}
+
+int FrameScheduler::BeginFrame() {
+    const auto now = Clock::now();
+    mAccumulator += now - mLastFrame;
+    mLastFrame = now;
+
+    int steps = 0;
+    while (mAccumulator >= mStep && steps < MAX_STEPS_PER_FRAME) {
+        mAccumulator -= mStep;
+        steps++;
+    }
+
+    if (mAccumulator >= mStep) {
+        mAccumulator = mAccumulator % mStep;
+    }
+
+    return steps;
+}
+
+float FrameScheduler::GetAlpha() const {
+    return std::chrono::duration<float>(mAccumulator) / std::chrono::duration<float>(mStep);
+}
+
+float FrameScheduler::GetStepSeconds() const {
+    return std::chrono::duration<float>(mStep).count();
+}
+
+void FrameScheduler::WaitForNextFrame() {
+    if (mFrame == Clock::duration::zero()) {
+        return;
+    }
+
+    // a frame that ran a whole period late restarts the pace from now, the
+    // following ones are not rushed to make up for it
+    auto now = Clock::now();
+    if (now >= mNextFrame + mFrame) {
+        mNextFrame = now + mFrame;
+        return;
+    }
+
+    if (mNextFrame - now > SPIN_MARGIN) {
+        std::this_thread::sleep_until(mNextFrame - SPIN_MARGIN);
+    }
+
+    while (Clock::now() < mNextFrame) {
+        std::this_thread::yield();
+    }
+
+    mNextFrame += mFrame;
+}
+
+FrameScheduler::Clock::duration FrameScheduler::PeriodOf(const float rate) {
+    return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rate));
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <chrono>
+
+// Paces the main loop on the steady clock. Real time piles up in an
+// accumulator that the simulation drains in fixed steps, however often frames
+// are drawn, and what is left is how far the frame is into the next step, used
+// to blend the drawn transforms. Frames are capped to the render rate by
+// sleeping most of the gap and spinning only the last bit, since OS sleeps
+// wake up late by up to a millisecond or more.
+class FrameScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Rates in Hz, a render rate of 0 draws as fast as the swap allows
+    FrameScheduler(float simRate, float renderRate);
+
+    // Empties the accumulator, the next frame starts counting from now
+    void Reset();
+
+    void SetSimRate(float rate);
+    void SetRenderRate(float rate);
+
+    // Adds the real time since the previous frame and returns how many steps
+    // are due. A frame further behind than MAX_STEPS_PER_FRAME drops the rest
+    // instead of spending the next frame catching up.
+    int BeginFrame();
+
+    // Fraction of the next step already elapsed, in [0, 1)
+    [[nodiscard]] float GetAlpha() const;
+    [[nodiscard]] float GetStepSeconds() const;
+    [[nodiscard]] float GetRenderRate() const { return mRenderRate; }
+
+    // Blocks until the next frame is due at the render rate
+    void WaitForNextFrame();
+
+    static constexpr int MAX_STEPS_PER_FRAME = 5;
+    // the scheduler wakes up this early and spins the remaining time
+    static constexpr std::chrono::microseconds SPIN_MARGIN{1500};
+
+private:
+    static Clock::duration PeriodOf(float rate);
+
+    float mRenderRate;
+    Clock::duration mStep;
+    // zero when frames are not capped
+    Clock::duration mFrame;
+    Clock::duration mAccumulator;
+    Clock::time_point mLastFrame;
+    Clock::time_point mNextFrame;
+};
@@ -8,6 +8,8 @@
 #include "Components/RigidBodyComponent.h"
 #include "Components/LaserBeamComponent.h"
 #include "Components/CircleColliderComponent.h"
+#include "Entities/EntitySystems.h"
+#include "AllocationCounter.h"
 #include "Random.h"
 #include "UI/Screens/MainMenu.h"
 #include "UI/Screens/GameOver.h"
@@ -18,12 +20,23 @@
 #include <SDL_mixer.h>
 #include "UI/Screens/Connect.h"
 #include "UI/Screens/Endgame.h"
+#include "UI/Screens/NetStatsOverlay.h"
 
 
 Game::Game()
         :mWindow(nullptr)
         ,mRenderer(nullptr)
-        ,mTicksCount(0)
+        ,mScheduler(1.0f / SIM_DELTA_TIME, 0.0f)
+        ,mSimRate(1.0f / SIM_DELTA_TIME)
+        ,mRenderRate(AUTO_RENDER_RATE)
+        ,mRenderAlpha(0.0f)
+        ,mFrameArena(FRAME_ARENA_SIZE)
+        ,mIsPipelined(false)
+        ,mIsReportingAllocations(false)
+        ,mReportAllocations(0)
+        ,mReportPeakAllocations(0)
+        ,mReportFrames(0)
+        ,mLastAllocationReport(0)
         ,mIsRunning(true)
         ,mIsDebugging(false)
         ,mUpdatingActors(false)
@@ -33,11 +46,20 @@ Game::Game()
         ,mBackgroundAudio(nullptr)
         ,mClient(nullptr)
         ,inMultiplayer(false)
-        ,mNetTicksCount(0)
+        ,mNetStatsOverlay(nullptr)
         ,mPlayer(nullptr)
         ,mIsPlayerSet(false)
+        ,mEnemies{}
 {}
 
+// Define as taxas de simulação e de desenho (quadros por segundo)
+void Game::SetFrameRates(const float simRate, const float renderRate)
+{
+    mSimRate = simRate;
+    mRenderRate = renderRate;
+    mScheduler.SetSimRate(simRate);
+}
+
 // Inicializa o jogo, criando a janela SDL, o renderer e a tela de abertura
 bool Game::Initialize()
 {
@@ -81,9 +103,51 @@ bool Game::Initialize()
 
     new OpeningScreen(this);
 
-    mTicksCount = SDL_GetTicks();
-    mNetTicksCount = mTicksCount;
+    mScheduler.SetRenderRate(ChooseRenderRate());
+    if (mScheduler.GetRenderRate() > 0.0f) {
+        SDL_Log("Frame pacing: simulation %.0f Hz, render capped at %.0f Hz", mSimRate, mScheduler.GetRenderRate());
+    } else {
+        SDL_Log("Frame pacing: simulation %.0f Hz, render paced by the swap", mSimRate);
+    }
+    mScheduler.Reset();
+
+    // a thread de desenho fica com o contexto OpenGL, esta segue com a janela,
+    // os eventos e a simulação
+    if (mIsPipelined) {
+        mRenderer->StartRenderThread();
+        SDL_Log("Rendering on its own thread");
+    }
+
+    return true;
+}
+
+// Com vsync a troca de buffers já dita o ritmo dos quadros, sem ele os quadros
+// são limitados à taxa de atualização da tela
+float Game::ChooseRenderRate() const
+{
+    if (mRenderRate >= 0.0f) {
+        return mRenderRate;
+    }
+
+    if (SDL_GL_GetSwapInterval() != 0) {
+        return 0.0f;
+    }
 
+    SDL_DisplayMode mode;
+    if (SDL_GetWindowDisplayMode(mWindow, &mode) == 0 && mode.refresh_rate > 0) {
+        return static_cast<float>(mode.refresh_rate);
+    }
+    return 60.0f;
+}
+
+// Reproduz uma captura de rede da partida, sem conectar ao servidor
+bool Game::StartReplay(const char *path, const double speed)
+{
+    if (!mClient->StartReplay(path, speed)) {
+        return false;
+    }
+
+    SetScene(GameScene::Multiplayer);
     return true;
 }
 
@@ -120,16 +184,57 @@ int Game::GetWindowHeight() const
     return height;
 }
 
-// Executa o loop principal do jogo até que mIsRunning seja false
+// Executa o loop principal do jogo até que mIsRunning seja false. A simulação
+// avança em passos fixos, quantos couberem no tempo real decorrido, e cada quadro
+// desenha os atores interpolados entre os dois últimos passos
 void Game::RunLoop()
 {
+    mScheduler.Reset();
+    mLastAllocationReport = SDL_GetTicks();
     while (mIsRunning){
+        const uint64_t allocationsBefore = AllocationCounter::GetCount();
         ProcessInput();
-        UpdateGame();
+
+        const int steps = mScheduler.BeginFrame();
+        for (int i = 0; i < steps; i++) {
+            UpdateGame();
+        }
+        mRenderAlpha = mScheduler.GetAlpha();
+
+        // os inimigos são amostrados no instante do quadro, não do passo
+        if (inMultiplayer) {
+            InterpolateEnemies();
+        }
+
         GenerateOutput();
+        if (mIsReportingAllocations) {
+            ReportAllocations(AllocationCounter::GetCount() - allocationsBefore);
+        }
+        mScheduler.WaitForNextFrame();
     }
 }
 
+// Acumula as alocações dos quadros e as registra a cada poucos segundos
+void Game::ReportAllocations(const uint64_t frameAllocations)
+{
+    mReportAllocations += frameAllocations;
+    mReportPeakAllocations = std::max(mReportPeakAllocations, frameAllocations);
+    mReportFrames++;
+
+    const Uint32 now = SDL_GetTicks();
+    if (now - mLastAllocationReport < ALLOCATION_REPORT_MS) {
+        return;
+    }
+
+    SDL_Log("Heap allocations: %llu in %d frames, at most %llu in one frame",
+            static_cast<unsigned long long>(mReportAllocations), mReportFrames,
+            static_cast<unsigned long long>(mReportPeakAllocations));
+    mReportAllocations = 0;
+    mReportPeakAllocations = 0;
+    mReportFrames = 0;
+    mLastAllocationReport = now;
+}
+
 // Processa eventos de entrada do usuário (teclado, mouse, janela)
 void Game::ProcessInput()
 {
@@ -155,6 +260,10 @@ void Game::ProcessInput()
                         new GameOver(this, PathResolver::ResolvePath("Assets/Fonts/Arial.ttf"), true);
                     }
                 }
+                if (event.key.keysym.sym == SDLK_F3 && inMultiplayer) {
+                    ToggleNetStatsOverlay();
+                    break;
+                }
                 if (!mUIStack.empty()) {
                     mUIStack.back()->HandleKeyPress(event.key.keysym.sym);
                 }
@@ -168,13 +277,16 @@ void Game::ProcessInput()
     {
         Quit();
     }
+}
+
+// Aplica o teclado a um passo de simulação: cada passo gera um comando
+void Game::ProcessKeyState()
+{
+    const Uint8* state = SDL_GetKeyboardState(nullptr);
 
     if (inMultiplayer) {
+        // a nave do jogador é movida pela predição do cliente
         mClient->AddInput(state);
-
-        if (mIsPlayerSet) {
-            mPlayer->ProcessInput(state);
-        }
     }else {
         unsigned int size = mActors.size();
         for (unsigned int i = 0; i < size; ++i) {
@@ -186,31 +298,33 @@ void Game::ProcessInput()
 // Atualiza a lógica do jogo: atores, UI e remove elementos fechados
 void Game::UpdateGame()
 {
+    const float deltaTime = mScheduler.GetStepSeconds();
+
+    EntitySystems::SaveRenderStates(mEntities);
+
+    ProcessKeyState();
+
+    // os corpos rígidos avançam todos juntos, antes da lógica dos atores
+    EntitySystems::IntegrateBodies(mEntities, deltaTime,
+                                   static_cast<float>(GetWindowWidth()),
+                                   static_cast<float>(GetWindowHeight()));
+
     if (inMultiplayer) {
         if (mIsPlayerSet) {
-            mPlayer->Update(SIM_DELTA_TIME);
+            mPlayer->Update(deltaTime);
         }
-        UpdateLocalActors(SIM_DELTA_TIME);
+        UpdateLocalActors(deltaTime);
 
         mClient->ReceiveStateFromServer();
 
-        // execute enemies state interpolation
-        InterpolateEnemies();
-
         // control enemies list
         RemoveInactiveEnemies();
-
-        // Wait 100ms to send the next inputs batch
-        if (SDL_TICKS_PASSED(SDL_GetTicks(), mNetTicksCount + 100)) {
-            mClient->SendCommandsToServer();
-            mNetTicksCount = SDL_GetTicks();
-        }
     }else {
-        UpdateActors(SIM_DELTA_TIME);
+        UpdateActors(deltaTime);
     }
     for (auto ui : mUIStack) {
         if (ui->GetState() == UIScreen::UIState::Active) {
-            ui->Update(SIM_DELTA_TIME);
+            ui->Update(deltaTime);
         }
     }
 
@@ -223,9 +337,6 @@ void Game::UpdateGame()
             ++iter;
         }
     }
-
-    while (!SDL_TICKS_PASSED(SDL_GetTicks(), mTicksCount + 16)) {}
-    mTicksCount = SDL_GetTicks();
 }
 
 // Atualiza todos os atores, verifica colisões de laser e condições de vitória
@@ -255,17 +366,25 @@ void Game::UpdateActors(float deltaTime)
         }
     }
 
-    std::vector<Actor*> deadActors;
+    // a lista só vive até o fim do passo, vem da memória do quadro. Um ator pode
+    // apagar outros junto com ele (a nave apaga os indicadores de vida), por isso
+    // cada um é conferido pela sua entidade antes de ser apagado
+    struct DeadActor {
+        Actor* actor;
+        EntityId entity;
+    };
+    FrameVector<DeadActor> deadActors{FrameAllocator<DeadActor>(mFrameArena)};
     for (auto &actor : mActors) {
         if (actor->GetState() == ActorState::Destroy) {
-            deadActors.emplace_back(actor);
+            deadActors.emplace_back(DeadActor{actor, actor->GetEntity()});
         }
     }
 
-    for (auto actor : deadActors) {
-        delete actor;
+    for (const auto &dead : deadActors) {
+        if (mEntities.IsAlive(dead.entity)) {
+            delete dead.actor;
+        }
     }
-
 }
 
 // Adiciona um ator à lista de atores (ou à lista pendente se estiver atualizando)
@@ -307,15 +426,16 @@ void Game::RemoveDrawable(class DrawComponent *drawable)
     }
 }
 
-// Renderiza o frame atual: UI ou cena do jogo com grid e atores
+// Grava o frame atual, UI ou cena do jogo com grid e atores, e o entrega ao
+// renderer, que o desenha aqui mesmo ou na thread de desenho
 void Game::GenerateOutput()
 {
-    mRenderer->BeginRenderToTexture();
-    mRenderer->Clear();
+    mRenderer->BeginFrame();
     
+    // o overlay de rede não esconde a cena
     bool hasActiveUI = false;
     for (auto ui : mUIStack) {
-        if (ui->GetState() == UIScreen::UIState::Active) {
+        if (ui->GetState() == UIScreen::UIState::Active && ui != mNetStatsOverlay) {
             hasActiveUI = true;
             break;
         }
@@ -324,7 +444,7 @@ void Game::GenerateOutput()
     if (hasActiveUI) {
         for (auto it = mUIStack.rbegin(); it != mUIStack.rend(); ++it) {
             auto ui = *it;
-            if (ui->GetState() == UIScreen::UIState::Active) {
+            if (ui->GetState() == UIScreen::UIState::Active && ui != mNetStatsOverlay) {
                 OpeningScreen* openingScreen = dynamic_cast<OpeningScreen*>(ui);
                 if (openingScreen) {
                     openingScreen->Draw(mRenderer);
@@ -336,9 +456,9 @@ void Game::GenerateOutput()
         }
     } else {
         float currentTime = SDL_GetTicks() / 1000.0f;
-        mRenderer->DrawAdvancedGrid(mRenderer->GetScreenWidth(), 
-                                    mRenderer->GetScreenHeight(), 
-                                    currentTime);
+        mRenderer->DrawAdvancedGrid(currentTime);
+
+        EntitySystems::BlendWorldTransforms(mEntities, mRenderAlpha);
 
         unsigned int size = mDrawables.size();
         unsigned int size2;
@@ -351,10 +471,28 @@ void Game::GenerateOutput()
                 }
             }
         }
+
+        if (mNetStatsOverlay) {
+            mRenderer->Draw();
+        }
     }
     
-    mRenderer->EndRenderToTexture();
-    mRenderer->Present();
+    mRenderer->EndFrame();
+
+    // nada do que foi alocado na memória do quadro passa deste ponto
+    mFrameArena.Reset();
+}
+
+// Reaproveita um laser ocioso do pool, ou cria um se todos estiverem em uso
+LaserBeam* Game::FireLaser(const Vector2& startPos, const float rotation, const Vector3 color, Ship* ownerShip)
+{
+    LaserBeam* laser = mLaserPool.Acquire();
+    if (laser) {
+        laser->Fire(startPos, rotation, color, ownerShip);
+        return laser;
+    }
+
+    return new LaserBeam(this, startPos, rotation, color, ownerShip);
 }
 
 // Remove todos os atores e telas UI da cena atual
@@ -363,11 +501,27 @@ void Game::UnloadScene()
     for(auto *actor : mActors) {
         actor->SetState(ActorState::Destroy);
     }
+    // os lasers ociosos vão junto com a cena
+    mLaserPool.Clear();
 
     for (auto ui : mUIStack) {
         delete ui;
     }
     mUIStack.clear();
+    mNetStatsOverlay = nullptr;
+    mPendingShots.clear();
+}
+
+// Mostra ou esconde as estatísticas da conexão sobre a partida
+void Game::ToggleNetStatsOverlay()
+{
+    if (mNetStatsOverlay) {
+        mNetStatsOverlay->Close();
+        mNetStatsOverlay = nullptr;
+        return;
+    }
+
+    mNetStatsOverlay = new NetStatsOverlay(this, PathResolver::ResolvePath("Assets/Fonts/Arial.ttf"));
 }
 
 // Carrega uma nova cena do jogo, descarregando a anterior
@@ -398,6 +552,8 @@ void Game::SetScene(GameScene nextScene)
             break;
         }
         case GameScene::Multiplayer: {
+            // a predição do cliente precisa do mesmo passo do servidor
+            mScheduler.SetSimRate(1.0f / SIM_DELTA_TIME);
             ResetBackgroundAudio();
             new Floor(this);
             inMultiplayer = true;
@@ -405,6 +561,7 @@ void Game::SetScene(GameScene nextScene)
         }
         case GameScene::Level1:
         {
+            mScheduler.SetSimRate(mSimRate);
             ResetBackgroundAudio();
             InitializeActors();
             inMultiplayer = false;
@@ -416,6 +573,7 @@ void Game::SetScene(GameScene nextScene)
 // Limpa todos os recursos do jogo antes de encerrar
 void Game::Shutdown()
 {
+    mLaserPool.Clear();
     while (!mActors.empty()) {
         delete mActors.back();
     }
@@ -462,11 +620,11 @@ void Game::RemoveActorFromVector(std::vector<class Actor*> &actors, class Actor
 void Game::CheckLaserCollisions()
 {
     for (auto actor : mActors) {
-        LaserBeam* laser = dynamic_cast<LaserBeam*>(actor);
-        if (laser && laser->GetState() == ActorState::Active) {
-            LaserBeamComponent* laserComp = laser->GetLaserComponent();
-            Ship* ownerShip = laser->GetOwnerShip();
-            if (laserComp && laserComp->IsActive()) {
+        // o tipo do ator vem da máscara de componentes, sem dynamic_cast
+        if (actor->HasComponents<LaserBeamComponent>() && actor->GetState() == ActorState::Active) {
+            LaserBeamComponent* laserComp = actor->GetComponent<LaserBeamComponent>();
+            Ship* ownerShip = laserComp->GetOwnerShip();
+            if (laserComp->IsActive()) {
                 if (mShip1 && mShip1->GetState() == ActorState::Active && mShip1 != ownerShip && !mShip1->IsInvincible()) {
                     // Verificar se este laser já atingiu esta nave
                     if (!laserComp->HasHitShip(mShip1)) {
@@ -538,23 +696,32 @@ void Game::SetPlayer(const Vector2 &position, const float rotation) {
     mIsPlayerSet = true;
 }
 
+// Vidas e invencibilidade vêm sempre do servidor
 void Game::SetPlayerState(const RawState& raw) const {
-    const auto newPlayerPos = Vector2(raw.posX, raw.posY);
-
-    mPlayer->SetPosition(newPlayerPos);
-    mPlayer->SetRotation(raw.rotation);
     mPlayer->SetLives(raw.life);
     mPlayer->SetInvincibilityTimer(raw.invulnerableTimer);
 }
 
-bool Game::IsEnemySet(const int id) {
-    if (mEnemies.find(id) == mEnemies.end()) {
-        return false;
+// Aplica a pose prevista pelo cliente à nave do jogador
+void Game::SetPlayerPose(const ShipSimState &state, const bool fired) const {
+    mPlayer->SetPosition(Vector2(state.posX, state.posY));
+    mPlayer->SetRotation(state.rotation);
+
+    if (fired) {
+        mPlayer->FireLocalLaser();
     }
-    return true;
+}
+
+bool Game::IsEnemySet(const int id) {
+    return mEnemyBuffer.FindSlot(id) >= 0;
 }
 
 void Game::SetEnemy(const int id,const Vector2 &position, const float rotation) {
+        const int slot = mEnemyBuffer.AddEntity(id);
+        if (slot < 0) {
+            return;
+        }
+
         auto enemy = new Ship(
             this,
             40,
@@ -565,69 +732,79 @@ void Game::SetEnemy(const int id,const Vector2 &position, const float rotation)
         enemy->SetPosition(position);
         enemy->SetRotation(rotation);
         enemy->SetType(ActorType::Local);
-        mEnemies.emplace(id, enemy);
-        mEnemiesLastUpdate.emplace(id, std::chrono::steady_clock::now());
-
-        mEnemiesTargets[id] = {position.x, position.y, rotation};
+        mEnemies[slot] = {enemy, std::chrono::steady_clock::now()};
 }
 
 
-void Game::SetEnemiesState(const std::vector<OtherState> &others)  {
-    for (const auto& other : others) {
-        if (mEnemiesTargets.find(other.id) == mEnemiesTargets.end()) {
-            mEnemiesTargets[other.id] = {other.posX, other.posY, other.rotation};
-        } else {
-            mEnemiesTargets[other.id].targetPosX = other.posX;
-            mEnemiesTargets[other.id].targetPosY = other.posY;
-            mEnemiesTargets[other.id].targetRotation = other.rotation;
-
-            if (other.hasShot) {
-                const auto &enemy = mEnemies[other.id];
-                const auto lb = new LaserBeam(
-                    this,
-                    enemy->GetPosition(),
-                    enemy->GetRotation(),
-                    Vector3(1, 0, 1),
-                    enemy);
-
-                lb->SetType(ActorType::Local);
-            }
+void Game::SetEnemiesState(
+    const std::vector<OtherState> &others,
+    const uint32_t serverTick,
+    const std::chrono::steady_clock::time_point receivedAt
+) {
+    mEnemyBuffer.OnSnapshot(serverTick, receivedAt);
 
-            mEnemies[other.id]->SetLives(other.life);
-            mEnemies[other.id]->SetInvincibilityTimer(other.invulnerableTimer);
+    for (const auto& other : others) {
+        const int slot = mEnemyBuffer.FindSlot(other.id);
+        if (slot < 0) {
+            continue;
         }
 
-        if (auto it1 = mEnemiesLastUpdate.find(other.id); it1 != mEnemiesLastUpdate.end()) {
-            it1->second = std::chrono::steady_clock::now();
-        }
+        mEnemyBuffer.Push(slot, serverTick, other.posX, other.posY, other.rotation);
+
+        auto &[enemy, lastUpdate] = mEnemies[slot];
+        enemy->SetLives(other.life);
+        enemy->SetInvincibilityTimer(other.invulnerableTimer);
+        lastUpdate = std::chrono::steady_clock::now();
     }
 }
 
+// Posiciona os inimigos no instante atual do buffer de jitter
 void Game::InterpolateEnemies() {
-    for (auto& [id, enemy] : mEnemies) {
-        if (mEnemiesTargets.find(id) == mEnemiesTargets.end()) {
+    const double renderTick = mEnemyBuffer.AdvanceRenderTick(std::chrono::steady_clock::now());
+    FirePendingShots(renderTick);
+
+    // o servidor julga os nossos tiros contra os inimigos neste mesmo instante
+    mClient->SetViewTick(renderTick);
+
+    for (size_t slot = 0; slot < JitterBuffer::CAPACITY; slot++) {
+        Ship *enemy = mEnemies[slot].ship;
+        if (enemy == nullptr) {
+            continue;
+        }
+
+        EntityPose pose{};
+        if (mEnemyBuffer.Sample(static_cast<int>(slot), renderTick, &pose) == SampleResult::EMPTY) {
             continue;
         }
 
-        const auto&[targetPosX, targetPosY, targetRotation] = mEnemiesTargets[id];
-        const Vector2 currentPos = enemy->GetPosition();
-        const float currentRot = enemy->GetRotation();
+        enemy->SetPosition(Vector2(pose.posX, pose.posY));
+        enemy->SetRotation(pose.rotation);
+        enemy->ResetRenderState();
+    }
+}
 
-        // Position interpolation (Lerp)
-        // curent + (target - current) * fator
-        const float diffX = targetPosX - currentPos.x;
-        const float diffY = targetPosY - currentPos.y;
+// Dispara os tiros recebidos quando o inimigo interpolado chega ao tick do tiro
+void Game::FirePendingShots(const double renderTick) {
+    auto it = mPendingShots.begin();
+    while (it != mPendingShots.end()) {
+        if (static_cast<double>(it->serverTick) > renderTick) {
+            ++it;
+            continue;
+        }
 
-        const float newPosX = currentPos.x + (diffX * INTERPOLATION_FACTOR);
-        const float newPosY = currentPos.y + (diffY * INTERPOLATION_FACTOR);
+        // inimigos ainda desconhecidos não têm nave para disparar
+        const int slot = mEnemyBuffer.FindSlot(it->playerId);
+        if (slot >= 0 && mEnemies[slot].ship != nullptr) {
+            const auto lb = FireLaser(
+                Vector2(it->posX, it->posY),
+                it->rotation,
+                Vector3(1, 0, 1),
+                mEnemies[slot].ship);
 
-        const auto newPos = Vector2(newPosX, newPosY);
-        enemy->SetPosition(newPos);
+            lb->SetType(ActorType::Local);
+        }
 
-        // Rotation interpolation
-        const float rotDiff = targetRotation - currentRot;
-        const float newRot = currentRot + (rotDiff * INTERPOLATION_FACTOR);
-        enemy->SetRotation(newRot);
+        it = mPendingShots.erase(it);
     }
 }
 
@@ -635,15 +812,16 @@ void Game::RemoveInactiveEnemies() {
     const auto now = std::chrono::steady_clock::now();
     const auto timeout = std::chrono::milliseconds(ENEMY_RESPONSE_TIMEOUT_MS);
 
-    for (auto it = mEnemiesLastUpdate.begin(); it != mEnemiesLastUpdate.end();) {
-        if (const auto secondsPassed= std::chrono::duration_cast<std::chrono::milliseconds>(now - it->second); secondsPassed > timeout) {
-            if (const auto enemyIt = mEnemies.find(it->first); enemyIt!= mEnemies.end()) {
-                delete enemyIt->second;
-                mEnemies.erase(enemyIt);
-            }
-            it = mEnemiesLastUpdate.erase(it);
-        } else {
-            ++it;
+    for (size_t slot = 0; slot < JitterBuffer::CAPACITY; slot++) {
+        auto &[enemy, lastUpdate] = mEnemies[slot];
+        if (enemy == nullptr) {
+            continue;
+        }
+
+        if (const auto timePassed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastUpdate); timePassed > timeout) {
+            delete enemy;
+            enemy = nullptr;
+            mEnemyBuffer.RemoveEntity(static_cast<int>(slot));
         }
     }
 }
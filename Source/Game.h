@@ -4,9 +4,14 @@
 
 #include "Actors/Ship.h"
 #include "Actors/Actor.h"
+#include "Actors/ActorPool.h"
+#include "Actors/LaserBeam.h"
 #include "Renderer/Renderer.h"
+#include "Entities/EntityStore.h"
 #include  "../Client/Client.h"
-#include <map>
+#include "../Client/JitterBuffer.h"
+#include "FrameScheduler.h"
+#include "FrameArena.h"
 #include <chrono>
 
 enum class GameScene
@@ -22,15 +27,30 @@ class Game{
 public:
     Game();
 
+    // Simulation steps and drawn frames per second, set before Initialize.
+    // AUTO_RENDER_RATE follows vsync, or the display refresh rate without it.
+    void SetFrameRates(float simRate, float renderRate);
+    // Draws on a thread of its own while the next frame is simulated, set before Initialize
+    void SetPipelined(bool pipelined) { mIsPipelined = pipelined; }
+    // Logs how many heap allocations the frames made, steady gameplay should make none
+    void SetAllocationReport(bool report) { mIsReportingAllocations = report; }
     bool Initialize();
     void RunLoop();
     void Shutdown();
     void Quit() { mIsRunning = false; }
+    // Goes straight to the match and plays a capture instead of connecting
+    bool StartReplay(const char *path, double speed);
 
     void InitializeActors();
     void UpdateActors(float deltaTime);
     void AddActor(class Actor* actor);
     void RemoveActor(class Actor* actor);
+    // Transforms, bodies and colliders of every actor, updated by the entity systems
+    EntityStore& GetEntities() { return mEntities; }
+
+    // Shots reuse the lasers that already faded out, a new one is made only when none is idle
+    class LaserBeam* FireLaser(const Vector2& startPos, float rotation, Vector3 color, class Ship* ownerShip);
+    void ReleaseLaser(class LaserBeam* laser) { mLaserPool.Release(laser); }
 
     void PushUI(class UIScreen* screen) { mUIStack.emplace_back(screen); }
     const std::vector<class UIScreen*>& GetUIStack() { return mUIStack; }
@@ -49,6 +69,8 @@ public:
     void RemoveDrawable(class DrawComponent* drawable);
 
     std::vector<class DrawComponent*>& GetDrawables() { return mDrawables; }
+    // How far the drawn frame is between the last two simulation steps
+    [[nodiscard]] float GetRenderAlpha() const { return mRenderAlpha; }
 
     Ship *GetShip() const {return mShip; }
     Ship *GetShip1() const {return mShip1; }
@@ -61,30 +83,57 @@ public:
     [[nodiscard]] bool IsMultiplayer() const { return inMultiplayer; }
     [[nodiscard]] class Client* GetClient() const { return mClient; }
     static constexpr float SIM_DELTA_TIME = 1.0f / 60.0f;
+    static constexpr float AUTO_RENDER_RATE = -1.0f;
     [[nodiscard]] bool IsPlayerSet() const { return mIsPlayerSet; }
     void SetPlayer(const Vector2 &position, float rotation);
     [[nodiscard]] Ship* GetPlayer() const { return mPlayer; }
     void SetPlayerState(const RawState& raw) const;
+    void SetPlayerPose(const ShipSimState &state, bool fired) const;
     bool IsEnemySet(int id);
     void SetEnemy(int id, const Vector2 &position, float rotation);
-    void SetEnemiesState(const std::vector<OtherState> &others);
+    void SetEnemiesState(
+        const std::vector<OtherState> &others,
+        uint32_t serverTick,
+        std::chrono::steady_clock::time_point receivedAt
+    );
+    [[nodiscard]] JitterBufferStats GetEnemyBufferStats() const { return mEnemyBuffer.GetStats(); }
+    void QueueEnemyShot(const ShotEvent &shot) { mPendingShots.push_back(shot); }
 
 private:
     void ProcessInput();
+    void ProcessKeyState();
     void UpdateGame();
     void GenerateOutput();
     void RemoveActorFromVector(std::vector< Actor*> &actors,  Actor *actor);
     void CheckLaserCollisions();
 
+    EntityStore mEntities;
     std::vector<class Actor*> mActors;
     std::vector<class Actor*> mPendingActors;
     std::vector<class DrawComponent*> mDrawables;
+    ActorPool<LaserBeam> mLaserPool;
 
     std::vector<class UIScreen*> mUIStack;
 
     SDL_Window* mWindow;
     class Renderer* mRenderer;
-    Uint32 mTicksCount;
+    FrameScheduler mScheduler;
+    float mSimRate;
+    float mRenderRate;
+    float mRenderAlpha;
+    // Scratch memory of the frame being simulated and recorded, reset once it
+    // is handed to the renderer
+    FrameArena mFrameArena;
+    static constexpr size_t FRAME_ARENA_SIZE = 64 * 1024;
+    bool mIsPipelined;
+    bool mIsReportingAllocations;
+    // Allocations since the last report
+    uint64_t mReportAllocations;
+    uint64_t mReportPeakAllocations;
+    int mReportFrames;
+    Uint32 mLastAllocationReport;
+    void ReportAllocations(uint64_t frameAllocations);
+    [[nodiscard]] float ChooseRenderRate() const;
     bool mIsRunning;
     bool mIsDebugging;
     bool mUpdatingActors;
@@ -99,14 +148,23 @@ private:
     // Networking stuff
     class Client* mClient;
     bool inMultiplayer;
-    Uint32 mNetTicksCount;
+    // F3 toggles it, drawn over the scene while the game keeps running
+    class NetStatsOverlay* mNetStatsOverlay;
+    void ToggleNetStatsOverlay();
     Ship* mPlayer;
     bool mIsPlayerSet;
-    std::map<int, Ship*> mEnemies;
-    std::map<int, std::chrono::steady_clock::time_point> mEnemiesLastUpdate;
-    std::map<int, InterpolationState> mEnemiesTargets;
+    // Remote players, indexed by their slot in the jitter buffer
+    struct RemoteEnemy {
+        Ship *ship;
+        std::chrono::steady_clock::time_point lastUpdate;
+    };
+    RemoteEnemy mEnemies[JitterBuffer::CAPACITY];
+    JitterBuffer mEnemyBuffer;
+    // Shots arrive ahead of the interpolated enemies, they fire once the render tick gets there
+    std::vector<ShotEvent> mPendingShots;
+    void FirePendingShots(double renderTick);
     static constexpr int ENEMY_RESPONSE_TIMEOUT_MS = 500;
-    static constexpr float INTERPOLATION_FACTOR = 0.2f;
+    static constexpr Uint32 ALLOCATION_REPORT_MS = 5000;
     void UpdateLocalActors(float deltaTime) const;
     void InterpolateEnemies();
     void RemoveInactiveEnemies();
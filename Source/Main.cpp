@@ -1,16 +1,81 @@
 #define SDL_MAIN_HANDLED
 #include "Game.h"
 #include "../Network/Platforms.h"
+#include "../Network/Socket.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// --capture grava os datagramas da sessão, --replay reproduz uma captura
+// sem rede, na velocidade original ou multiplicada por --speed (0 = sem pausa).
+// --sim-hz muda o passo da simulação local (a partida em rede usa sempre o do
+// servidor) e --fps limita os quadros desenhados (0 = sem limite). --pipelined
+// desenha numa thread própria enquanto o quadro seguinte é simulado e
+// --count-allocations registra as alocações de memória feitas pelos quadros
+int main(const int argc, char **argv) {
+    const char *capturePath = nullptr;
+    const char *replayPath = nullptr;
+    double replaySpeed = 1.0;
+    float simRate = 1.0f / Game::SIM_DELTA_TIME;
+    float renderRate = Game::AUTO_RENDER_RATE;
+    bool pipelined = false;
+    bool countAllocations = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--pipelined") == 0) {
+            pipelined = true;
+            continue;
+        }
+        if (strcmp(argv[i], "--count-allocations") == 0) {
+            countAllocations = true;
+            continue;
+        }
+
+        if (i + 1 >= argc) {
+            printf("Missing value for %s\n", argv[i]);
+            return 1;
+        }
+
+        const char *option = argv[i];
+        const char *value = argv[++i];
+        if (strcmp(option, "--capture") == 0) {
+            capturePath = value;
+        } else if (strcmp(option, "--replay") == 0) {
+            replayPath = value;
+        } else if (strcmp(option, "--speed") == 0) {
+            replaySpeed = atof(value);
+        } else if (strcmp(option, "--sim-hz") == 0) {
+            simRate = static_cast<float>(atof(value));
+            if (simRate <= 0.0f) {
+                printf("Invalid simulation rate %s\n", value);
+                return 1;
+            }
+        } else if (strcmp(option, "--fps") == 0) {
+            renderRate = static_cast<float>(atof(value));
+        } else {
+            printf("Unknown option %s\n", option);
+            return 1;
+        }
+    }
 
-int main() {
     networkingInit();
 
+    if (capturePath && !SocketUtils::startCapture(capturePath)) {
+        printf("Could not create capture %s\n", capturePath);
+    }
+
     Game game;
+    game.SetFrameRates(simRate, renderRate);
+    game.SetPipelined(pipelined);
+    game.SetAllocationReport(countAllocations);
     if (bool success = game.Initialize()) {
-        game.RunLoop();
+        if (!replayPath || game.StartReplay(replayPath, replaySpeed)) {
+            game.RunLoop();
+        }
     }
     game.Shutdown();
 
+    SocketUtils::stopCapture();
     networkingCleanup();
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,46 @@
+#include "RenderSnapshot.h"
+#include "VertexArray.h"
+#include "Texture.h"
+
+RenderSnapshot::RenderSnapshot()
+: mScreenWidth(0.0f)
+, mScreenHeight(0.0f)
+{
+}
+
+RenderSnapshot::~RenderSnapshot()
+{
+    FreeReleased();
+}
+
+void RenderSnapshot::Begin(const float screenWidth, const float screenHeight)
+{
+    mCommands.clear();
+    mVertices.clear();
+    mScreenWidth = screenWidth;
+    mScreenHeight = screenHeight;
+}
+
+RenderGeometry RenderSnapshot::AddGeometry(const Vector2 *points, const unsigned int count)
+{
+    const RenderGeometry geometry{static_cast<unsigned int>(mVertices.size() / 2), count};
+    for (unsigned int i = 0; i < count; i++) {
+        mVertices.push_back(points[i].x);
+        mVertices.push_back(points[i].y);
+    }
+    return geometry;
+}
+
+void RenderSnapshot::FreeReleased()
+{
+    for (auto *mesh : mReleasedMeshes) {
+        delete mesh;
+    }
+    mReleasedMeshes.clear();
+
+    for (auto *texture : mReleasedTextures) {
+        texture->Unload();
+        delete texture;
+    }
+    mReleasedTextures.clear();
+}
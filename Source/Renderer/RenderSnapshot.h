@@ -0,0 +1,78 @@
+#pragma once
+#include <GL/glew.h>
+#include <vector>
+#include "../Math.h"
+
+// One draw of a frame, with everything it needs copied in
+struct RenderCommand {
+    enum class Kind : uint8_t {
+        // a VertexArray with the base shader
+        Mesh,
+        // vertices stored in the snapshot, with the base shader
+        Geometry,
+        // a textured or flat quad with the sprite shader
+        Sprite,
+        // the full screen neon grid
+        Background
+    };
+
+    Kind kind;
+    bool blend;
+    GLenum primitive;
+    float lineWidth;
+    Matrix4 transform;
+    Vector4 color;
+    float textureFactor;
+    float time;
+    class VertexArray *mesh;
+    class Texture *texture;
+    // Geometry: range of vertices in the snapshot, Mesh and Sprite: indices drawn
+    unsigned int first;
+    unsigned int count;
+};
+
+// Vertices of a shape built for this frame only, see RenderSnapshot::AddGeometry
+struct RenderGeometry {
+    unsigned int first;
+    unsigned int count;
+};
+
+// Everything the render thread needs to draw one frame, recorded by the
+// simulation after its steps and never changed once published. Meshes and
+// textures are referenced, not copied: the ones released while the snapshot
+// was recorded travel with it and are freed once it has been drawn, when no
+// later snapshot can name them any more.
+class RenderSnapshot {
+public:
+    RenderSnapshot();
+    ~RenderSnapshot();
+
+    RenderSnapshot(const RenderSnapshot&) = delete;
+    RenderSnapshot &operator=(const RenderSnapshot&) = delete;
+
+    // Drops the commands of the previous frame and keeps the buffers. The
+    // releases stay, a snapshot that was never drawn still has to free them.
+    void Begin(float screenWidth, float screenHeight);
+
+    void Add(const RenderCommand &command) { mCommands.push_back(command); }
+    RenderGeometry AddGeometry(const Vector2 *points, unsigned int count);
+
+    void Release(class VertexArray *mesh) { mReleasedMeshes.push_back(mesh); }
+    void Release(class Texture *texture) { mReleasedTextures.push_back(texture); }
+    // Render thread, after drawing
+    void FreeReleased();
+
+    [[nodiscard]] const std::vector<RenderCommand> &GetCommands() const { return mCommands; }
+    [[nodiscard]] const std::vector<float> &GetVertices() const { return mVertices; }
+    [[nodiscard]] float GetScreenWidth() const { return mScreenWidth; }
+    [[nodiscard]] float GetScreenHeight() const { return mScreenHeight; }
+
+private:
+    std::vector<RenderCommand> mCommands;
+    // x, y pairs of every RenderGeometry
+    std::vector<float> mVertices;
+    std::vector<class VertexArray*> mReleasedMeshes;
+    std::vector<class Texture*> mReleasedTextures;
+    float mScreenWidth;
+    float mScreenHeight;
+};
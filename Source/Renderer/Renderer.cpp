@@ -24,9 +24,15 @@ Renderer::Renderer(SDL_Window *window)
 , mRBO(0)
 , mScreenWidth(1024.0f)
 , mScreenHeight(768.0f)
+, mAppliedWidth(1024.0f)
+, mAppliedHeight(768.0f)
 , mSpriteVerts(nullptr)
 , mWindow(window)
 ,     mContext(nullptr)
+, mGeometryArray(0)
+, mGeometryBuffer(0)
+, mBlendState(-1)
+, mStopRendering(false)
 {
 }
 
@@ -39,6 +45,8 @@ bool Renderer::Initialize(float width, float height)
 {
     mScreenWidth = width;
     mScreenHeight = height;
+    mAppliedWidth = width;
+    mAppliedHeight = height;
 
     // Configurar atributos OpenGL com fallback para compatibilidade cross-platform
     // Tentar OpenGL 3.3 primeiro, depois 3.2 se falhar (necessário para macOS)
@@ -52,7 +60,6 @@ bool Renderer::Initialize(float width, float height)
     SDL_GL_SetAttribute(SDL_GL_ACCELERATED_VISUAL, 1);
     SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
     SDL_GL_SetAttribute(SDL_GL_STENCIL_SIZE, 8);
-    SDL_GL_SetSwapInterval(1);
 
     mContext = SDL_GL_CreateContext(mWindow);
     if (!mContext) {
@@ -73,6 +80,11 @@ bool Renderer::Initialize(float width, float height)
         return false;
     }
 
+    // O vsync só vale com um contexto atual; sem ele o jogo limita os quadros sozinho
+    if (SDL_GL_SetSwapInterval(1) != 0) {
+        SDL_Log("VSync unavailable: %s", SDL_GetError());
+    }
+
     glewExperimental = GL_TRUE;
     GLenum glewError = glewInit();
     if (glewError != GLEW_OK) {
@@ -126,6 +138,14 @@ bool Renderer::Initialize(float width, float height)
 	};
 	
 	mFullScreenQuad = new VertexArray(vertices, 8, indices, 6);
+
+	// Formas que só existem num quadro são reenviadas inteiras a cada quadro
+	glGenVertexArrays(1, &mGeometryArray);
+	glBindVertexArray(mGeometryArray);
+	glGenBuffers(1, &mGeometryBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, mGeometryBuffer);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
 	
 	mAdvancedGridShader = new Shader();
 	std::string advancedGridPath = FindShaderPath("AdvancedGrid");
@@ -175,11 +195,18 @@ bool Renderer::Initialize(float width, float height)
     return true;
 }
 
-// Atualiza o tamanho da tela e recalcula a projeção ortográfica
+// Atualiza o tamanho da tela dos próximos quadros gravados
 void Renderer::UpdateScreenSize(float width, float height)
 {
     mScreenWidth = width;
     mScreenHeight = height;
+}
+
+// Aplica o tamanho de tela de um quadro e recalcula a projeção ortográfica
+void Renderer::ApplyScreenSize(float width, float height)
+{
+    mAppliedWidth = width;
+    mAppliedHeight = height;
     
     glViewport(0, 0, static_cast<int>(width), static_cast<int>(height));
     
@@ -211,6 +238,23 @@ void Renderer::UnloadData()
 // Limpa todos os recursos do renderer
 void Renderer::Shutdown()
 {
+    if (mRenderThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mHandoffMutex);
+            mStopRendering = true;
+        }
+        mHandoff.notify_all();
+        mRenderThread.join();
+
+        // o contexto volta para esta thread para liberar os recursos
+        EnsureOpenGLContextCurrent(mWindow, mContext);
+    }
+
+    // o que foi liberado depois do último quadro desenhado
+    for (int i = 0; i < TripleBuffer<RenderSnapshot>::SLOTS; i++) {
+        mSnapshots.GetSlots()[i].FreeReleased();
+    }
+
     UnloadData();
 
     delete mSpriteVerts;
@@ -261,143 +305,367 @@ void Renderer::Shutdown()
         mFBO = 0;
     }
 
+    if (mGeometryBuffer != 0) {
+        glDeleteBuffers(1, &mGeometryBuffer);
+        glDeleteVertexArrays(1, &mGeometryArray);
+        mGeometryBuffer = 0;
+        mGeometryArray = 0;
+    }
+
     SDL_GL_DeleteContext(mContext);
 	SDL_DestroyWindow(mWindow);
 }
 
-// Limpa os buffers de cor e profundidade
-void Renderer::Clear()
+// Passa o contexto OpenGL para uma thread de desenho própria
+void Renderer::StartRenderThread()
 {
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    SDL_GL_MakeCurrent(mWindow, nullptr);
+    mStopRendering = false;
+    mRenderThread = std::thread(&Renderer::RenderLoop, this);
 }
 
-// Desenha uma forma usando linhas (wireframe)
-void Renderer::Draw(const Matrix4 &modelMatrix, VertexArray* vertices, Vector3 color)
+// Desenha cada quadro publicado, sempre o mais recente
+void Renderer::RenderLoop()
 {
-	mBaseShader->SetActive();
-	mBaseShader->SetMatrixUniform("uWorldTransform", modelMatrix);
-	mBaseShader->SetVectorUniform("uColor", color);
-	mBaseShader->SetFloatUniform("uAlpha", 1.0f);
+    if (!EnsureOpenGLContextCurrent(mWindow, mContext)) {
+        SDL_Log("Render thread could not take the OpenGL context");
+        {
+            std::lock_guard<std::mutex> lock(mHandoffMutex);
+            mStopRendering = true;
+        }
+        mHandoff.notify_all();
+        return;
+    }
 
-    vertices->SetActive();
-    glDrawElements(GL_LINE_LOOP, vertices->GetNumIndices(), GL_UNSIGNED_INT, nullptr);
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mHandoffMutex);
+            mHandoff.wait(lock, [this] { return mSnapshots.HasPublished() || mStopRendering; });
+            if (mStopRendering) {
+                break;
+            }
+            mSnapshots.Take();
+        }
+        mHandoff.notify_all();
+
+        Execute(mSnapshots.GetFront());
+    }
+
+    SDL_GL_MakeCurrent(mWindow, nullptr);
 }
 
-// Desenha todos os elementos UI usando o sprite shader
-void Renderer::Draw()
+// Começa a gravar um novo quadro
+void Renderer::BeginFrame()
 {
-    glEnable(GL_DEPTH_TEST);
-    glDisable(GL_BLEND);
+    mSnapshots.GetBack().Begin(mScreenWidth, mScreenHeight);
+}
 
-    glDisable(GL_DEPTH_TEST);
+// Sem thread de desenho o quadro é desenhado aqui mesmo; com ela, a simulação
+// espera só até o quadro anterior ser pego, não até ser desenhado
+void Renderer::EndFrame()
+{
+    if (!mRenderThread.joinable()) {
+        mSnapshots.Publish();
+        mSnapshots.Take();
+        Execute(mSnapshots.GetFront());
+        return;
+    }
 
-    glEnable(GL_BLEND);
-    glBlendEquationSeparate(GL_FUNC_ADD, GL_FUNC_ADD);
-    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ZERO, GL_ONE);
+    {
+        std::lock_guard<std::mutex> lock(mHandoffMutex);
+        mSnapshots.Publish();
+    }
+    mHandoff.notify_all();
 
-    if (mSpriteShader && mSpriteVerts) {
-        mSpriteShader->SetActive();
-        
-        Matrix4 viewProj = Matrix4::CreateSimpleViewProj(mScreenWidth, mScreenHeight);
-        mSpriteShader->SetMatrixUniform("uViewProj", viewProj);
-        
-        mSpriteVerts->SetActive();
+    std::unique_lock<std::mutex> lock(mHandoffMutex);
+    mHandoff.wait(lock, [this] { return !mSnapshots.HasPublished() || mStopRendering; });
+}
 
-        for (auto ui : mUIComps)
-        {
-            ui->Draw(mSpriteShader);
+// Desenha um quadro gravado: cena no FBO, efeito CRT e troca de buffers
+void Renderer::Execute(RenderSnapshot& snapshot)
+{
+    if (snapshot.GetScreenWidth() != mAppliedWidth || snapshot.GetScreenHeight() != mAppliedHeight) {
+        ApplyScreenSize(snapshot.GetScreenWidth(), snapshot.GetScreenHeight());
+    }
+
+    BeginRenderToTexture();
+    Clear();
+
+    const std::vector<float>& vertices = snapshot.GetVertices();
+    if (!vertices.empty()) {
+        glBindBuffer(GL_ARRAY_BUFFER, mGeometryBuffer);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertices.size() * sizeof(float)), vertices.data(), GL_STREAM_DRAW);
+    }
+
+    const Matrix4 viewProj = Matrix4::CreateSimpleViewProj(mAppliedWidth, mAppliedHeight);
+    mBlendState = -1;
+    for (const RenderCommand& command : snapshot.GetCommands()) {
+        SetBlend(command.kind, command.blend);
+        switch (command.kind) {
+            case RenderCommand::Kind::Mesh:
+                DrawMesh(command);
+                break;
+            case RenderCommand::Kind::Geometry:
+                DrawGeometry(command);
+                break;
+            case RenderCommand::Kind::Sprite:
+                DrawSpriteCommand(command, viewProj);
+                break;
+            case RenderCommand::Kind::Background:
+                DrawBackground(command);
+                break;
         }
     }
+
+    EndRenderToTexture();
+    Present();
+
+    snapshot.FreeReleased();
 }
 
-// Desenha uma forma preenchida (sólida)
-void Renderer::DrawFilled(const Matrix4 &modelMatrix, VertexArray* vertices, Vector3 color)
+// Troca o blend só quando o comando pede um estado diferente do atual
+void Renderer::SetBlend(RenderCommand::Kind kind, bool blend)
 {
-	mBaseShader->SetActive();
-	mBaseShader->SetMatrixUniform("uWorldTransform", modelMatrix);
-	mBaseShader->SetVectorUniform("uColor", color);
-	mBaseShader->SetFloatUniform("uAlpha", 1.0f);
-
-    vertices->SetActive();
-    glDrawElements(GL_TRIANGLE_FAN, vertices->GetNumIndices(), GL_UNSIGNED_INT, nullptr);
+    const int state = !blend ? 0 : kind == RenderCommand::Kind::Sprite ? 2 : 1;
+    if (state == mBlendState) {
+        return;
+    }
+    mBlendState = state;
+
+    if (state == 0) {
+        glDisable(GL_BLEND);
+    } else if (state == 1) {
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    } else {
+        glDisable(GL_DEPTH_TEST);
+        glEnable(GL_BLEND);
+        glBlendEquationSeparate(GL_FUNC_ADD, GL_FUNC_ADD);
+        glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ZERO, GL_ONE);
+    }
 }
 
-// Desenha uma forma preenchida com transparência
-void Renderer::DrawFilledWithAlpha(const Matrix4 &modelMatrix, VertexArray* vertices, Vector3 color, float alpha)
+// Desenha um VertexArray com o shader base
+void Renderer::DrawMesh(const RenderCommand& command)
 {
 	mBaseShader->SetActive();
-	mBaseShader->SetMatrixUniform("uWorldTransform", modelMatrix);
-	mBaseShader->SetVectorUniform("uColor", color);
-	mBaseShader->SetFloatUniform("uAlpha", alpha);
+	mBaseShader->SetMatrixUniform("uWorldTransform", command.transform);
+	mBaseShader->SetVectorUniform("uColor", Vector3(command.color.x, command.color.y, command.color.z));
+	mBaseShader->SetFloatUniform("uAlpha", command.color.w);
 
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    if (command.lineWidth != 1.0f) {
+        glLineWidth(command.lineWidth);
+    }
 
-    vertices->SetActive();
-    glDrawElements(GL_TRIANGLE_FAN, vertices->GetNumIndices(), GL_UNSIGNED_INT, nullptr);
-    
-    glDisable(GL_BLEND);
+    command.mesh->SetActive();
+    glDrawElements(command.primitive, static_cast<GLsizei>(command.count), GL_UNSIGNED_INT, nullptr);
+
+    if (command.lineWidth != 1.0f) {
+        glLineWidth(1.0f);
+    }
 }
 
-// Desenha uma forma em wireframe com transparência
-void Renderer::DrawWithAlpha(const Matrix4 &modelMatrix, VertexArray* vertices, Vector3 color, float alpha)
+// Desenha uma forma cujos vértices vieram no próprio quadro
+void Renderer::DrawGeometry(const RenderCommand& command)
 {
 	mBaseShader->SetActive();
-	mBaseShader->SetMatrixUniform("uWorldTransform", modelMatrix);
-	mBaseShader->SetVectorUniform("uColor", color);
-	mBaseShader->SetFloatUniform("uAlpha", alpha);
+	mBaseShader->SetMatrixUniform("uWorldTransform", command.transform);
+	mBaseShader->SetVectorUniform("uColor", Vector3(command.color.x, command.color.y, command.color.z));
+	mBaseShader->SetFloatUniform("uAlpha", command.color.w);
+
+    glBindVertexArray(mGeometryArray);
+    glDrawArrays(command.primitive, static_cast<GLint>(command.first), static_cast<GLsizei>(command.count));
+}
+
+// Desenha um quad de UI com o sprite shader
+void Renderer::DrawSpriteCommand(const RenderCommand& command, const Matrix4& viewProj)
+{
+    if (!mSpriteShader || !mSpriteVerts) {
+        return;
+    }
 
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    mSpriteShader->SetActive();
+    mSpriteShader->SetMatrixUniform("uViewProj", viewProj);
+    mSpriteShader->SetMatrixUniform("uWorldTransform", command.transform);
+    mSpriteShader->SetFloatUniform("uTextureFactor", command.textureFactor);
+    mSpriteShader->SetVectorUniform("uBaseColor", command.color);
+
+    if (command.texture) {
+        command.texture->SetActive(0);
+        mSpriteShader->SetTextureUniform("uTexture", command.texture->GetTextureID(), 0);
+    } else {
+        mSpriteShader->SetTextureUniform("uTexture", 0, 0);
+    }
 
+    VertexArray* vertices = command.mesh ? command.mesh : mSpriteVerts;
     vertices->SetActive();
-    glDrawElements(GL_LINES, vertices->GetNumIndices(), GL_UNSIGNED_INT, nullptr);
-    
-    glDisable(GL_BLEND);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(command.count), GL_UNSIGNED_INT, nullptr);
 }
 
 // Desenha o grid avançado isométrico neon como fundo
-void Renderer::DrawAdvancedGrid(float screenWidth, float screenHeight, float time)
+void Renderer::DrawBackground(const RenderCommand& command)
 {
 	if (!mAdvancedGridShader || !mFullScreenQuad) {
 		return;
 	}
 	
 	mAdvancedGridShader->SetActive();
-	mAdvancedGridShader->SetVector2Uniform("uResolution", Vector2(screenWidth, screenHeight));
-	mAdvancedGridShader->SetFloatUniform("uTime", time);
-	
-	Vector3 neonColor(0.0f, 0.7f, 1.0f);
-	mAdvancedGridShader->SetVectorUniform("uColor", neonColor);
-	
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	mAdvancedGridShader->SetVector2Uniform("uResolution", Vector2(mAppliedWidth, mAppliedHeight));
+	mAdvancedGridShader->SetFloatUniform("uTime", command.time);
+	mAdvancedGridShader->SetVectorUniform("uColor", Vector3(command.color.x, command.color.y, command.color.z));
 	
 	mFullScreenQuad->SetActive();
 	glDrawElements(GL_TRIANGLES, mFullScreenQuad->GetNumIndices(), GL_UNSIGNED_INT, nullptr);
-	
-	glDisable(GL_BLEND);
+}
+
+// Limpa os buffers de cor e profundidade
+void Renderer::Clear()
+{
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+// Grava um desenho de VertexArray com o shader base
+void Renderer::AddMeshCommand(const Matrix4 &modelMatrix, VertexArray* vertices, Vector3 color, float alpha,
+                              GLenum primitive, bool blend, float lineWidth)
+{
+    RenderCommand command{};
+    command.kind = RenderCommand::Kind::Mesh;
+    command.blend = blend;
+    command.primitive = primitive;
+    command.lineWidth = lineWidth;
+    command.transform = modelMatrix;
+    command.color = Vector4(color.x, color.y, color.z, alpha);
+    command.mesh = vertices;
+    command.count = vertices->GetNumIndices();
+    mSnapshots.GetBack().Add(command);
+}
+
+// Desenha uma forma usando linhas (wireframe)
+void Renderer::Draw(const Matrix4 &modelMatrix, VertexArray* vertices, Vector3 color)
+{
+    AddMeshCommand(modelMatrix, vertices, color, 1.0f, GL_LINE_LOOP, false);
+}
+
+// Desenha todos os elementos UI usando o sprite shader
+void Renderer::Draw()
+{
+    for (auto ui : mUIComps)
+    {
+        ui->Draw(this);
+    }
+}
+
+// Desenha uma forma preenchida (sólida)
+void Renderer::DrawFilled(const Matrix4 &modelMatrix, VertexArray* vertices, Vector3 color)
+{
+    AddMeshCommand(modelMatrix, vertices, color, 1.0f, GL_TRIANGLE_FAN, false);
+}
+
+// Desenha uma forma preenchida com transparência
+void Renderer::DrawFilledWithAlpha(const Matrix4 &modelMatrix, VertexArray* vertices, Vector3 color, float alpha)
+{
+    AddMeshCommand(modelMatrix, vertices, color, alpha, GL_TRIANGLE_FAN, true);
+}
+
+// Desenha uma forma em wireframe com transparência
+void Renderer::DrawWithAlpha(const Matrix4 &modelMatrix, VertexArray* vertices, Vector3 color, float alpha)
+{
+    AddMeshCommand(modelMatrix, vertices, color, alpha, GL_LINES, true);
+}
+
+// Desenha segmentos de reta com transparência e espessura própria
+void Renderer::DrawLines(const Matrix4 &modelMatrix, VertexArray* vertices, Vector3 color, float alpha, float lineWidth)
+{
+    AddMeshCommand(modelMatrix, vertices, color, alpha, GL_LINES, true, lineWidth);
+}
+
+// Copia os vértices de uma forma que só existe neste quadro
+RenderGeometry Renderer::AddGeometry(const Vector2* points, unsigned int count)
+{
+    return mSnapshots.GetBack().AddGeometry(points, count);
+}
+
+// Desenha uma forma do quadro preenchida com transparência
+void Renderer::DrawFilledWithAlpha(const Matrix4 &modelMatrix, const RenderGeometry &geometry, Vector3 color, float alpha)
+{
+    RenderCommand command{};
+    command.kind = RenderCommand::Kind::Geometry;
+    command.blend = true;
+    command.primitive = GL_TRIANGLE_FAN;
+    command.lineWidth = 1.0f;
+    command.transform = modelMatrix;
+    command.color = Vector4(color.x, color.y, color.z, alpha);
+    command.first = geometry.first;
+    command.count = geometry.count;
+    mSnapshots.GetBack().Add(command);
+}
+
+// Desenha um quad com o sprite shader, com ou sem textura
+void Renderer::DrawSprite(const Matrix4 &world, Texture* texture, const Vector4 &color, float textureFactor,
+                          VertexArray* vertices, unsigned int numIndices)
+{
+    RenderCommand command{};
+    command.kind = RenderCommand::Kind::Sprite;
+    command.blend = true;
+    command.primitive = GL_TRIANGLES;
+    command.lineWidth = 1.0f;
+    command.transform = world;
+    command.color = color;
+    command.textureFactor = textureFactor;
+    command.texture = texture;
+    command.mesh = vertices;
+    command.count = numIndices;
+    mSnapshots.GetBack().Add(command);
+}
+
+// Desenha o grid avançado isométrico neon como fundo
+void Renderer::DrawAdvancedGrid(float time)
+{
+    RenderCommand command{};
+    command.kind = RenderCommand::Kind::Background;
+    command.blend = true;
+    command.primitive = GL_TRIANGLES;
+    command.lineWidth = 1.0f;
+    command.color = Vector4(0.0f, 0.7f, 1.0f, 1.0f);
+    command.time = time;
+    mSnapshots.GetBack().Add(command);
+}
+
+// O array só é apagado depois que o quadro que o liberou for desenhado
+void Renderer::ReleaseVertexArray(VertexArray* vertices)
+{
+    if (vertices) {
+        mSnapshots.GetBack().Release(vertices);
+    }
+}
+
+// A textura só é apagada depois que o quadro que a liberou for desenhado
+void Renderer::ReleaseTexture(Texture* texture)
+{
+    if (texture) {
+        mSnapshots.GetBack().Release(texture);
+    }
 }
 
 // Inicia renderização para textura (FBO)
 void Renderer::BeginRenderToTexture()
 {
 	glBindFramebuffer(GL_FRAMEBUFFER, mFBO);
-	glViewport(0, 0, static_cast<GLsizei>(mScreenWidth), static_cast<GLsizei>(mScreenHeight));
+	glViewport(0, 0, static_cast<GLsizei>(mAppliedWidth), static_cast<GLsizei>(mAppliedHeight));
 }
 
 // Finaliza renderização para textura e aplica efeito CRT
 void Renderer::EndRenderToTexture()
 {
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
-	glViewport(0, 0, static_cast<GLsizei>(mScreenWidth), static_cast<GLsizei>(mScreenHeight));
+	glViewport(0, 0, static_cast<GLsizei>(mAppliedWidth), static_cast<GLsizei>(mAppliedHeight));
 	
 	glClear(GL_COLOR_BUFFER_BIT);
 	
 	if (mCRTShader && mFullScreenQuad) {
 		mCRTShader->SetActive();
 		
-		mCRTShader->SetVector2Uniform("uResolution", Vector2(mScreenWidth, mScreenHeight));
+		mCRTShader->SetVector2Uniform("uResolution", Vector2(mAppliedWidth, mAppliedHeight));
 		mCRTShader->SetFloatUniform("uTime", SDL_GetTicks() / 1000.0f);
 		mCRTShader->SetTextureUniform("uSceneTexture", mSceneTexture, 0);
 		
@@ -436,16 +704,10 @@ void Renderer::RemoveUIElement(UIElement *comp)
     }
 }
 
-// Carrega e retorna uma textura (usa cache se já foi carregada)
+// Carrega e retorna uma textura (usa cache se já foi carregada). Só a imagem
+// é lida aqui, a textura OpenGL é criada quando for desenhada pela primeira vez
 Texture* Renderer::GetTexture(const std::string& fileName)
 {
-    // Garantir que o contexto OpenGL está atual antes de carregar texturas
-    // Importante para macOS e Linux onde o contexto pode ser perdido
-    if (!EnsureOpenGLContextCurrent(mWindow, mContext)) {
-        SDL_Log("Failed to make OpenGL context current when loading texture");
-        return nullptr;
-    }
-    
     Texture* tex = nullptr;
     auto iter = mTextures.find(fileName);
     if (iter != mTextures.end())
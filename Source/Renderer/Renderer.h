@@ -3,12 +3,23 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <SDL.h>
 #include "../Math.h"
 #include "VertexArray.h"
 #include "Texture.h"
 #include "Font.h"
+#include "RenderSnapshot.h"
+#include "TripleBuffer.h"
 
+// Draw calls do not reach GL directly: between BeginFrame and EndFrame they
+// are recorded into a RenderSnapshot, which is then drawn by the thread that
+// owns the GL context. Without a render thread that is the caller itself, at
+// EndFrame. With one, the snapshots are handed over through a triple buffer,
+// the simulation records the next frame while the previous one is drawn, and
+// the render thread always draws the newest one.
 class Renderer
 {
 public:
@@ -20,27 +31,43 @@ public:
     void Shutdown();
     void UnloadData();
 
-    void Clear();
+    // Moves the GL context to a thread of its own, after Initialize. Shutdown
+    // stops it and brings the context back.
+    void StartRenderThread();
+
+    void BeginFrame();
+    // Draws the recorded frame, or hands it to the render thread and returns
+    // once that thread picked it up, the next frame is simulated while this
+    // one is drawn
+    void EndFrame();
+
     void Draw();
     void Draw(const Matrix4 &modelMatrix, VertexArray* vertices, Vector3 color);
     void DrawFilled(const Matrix4 &modelMatrix, VertexArray* vertices, Vector3 color);
     void DrawFilledWithAlpha(const Matrix4 &modelMatrix, VertexArray* vertices, Vector3 color, float alpha);
     void DrawWithAlpha(const Matrix4 &modelMatrix, VertexArray* vertices, Vector3 color, float alpha);
-    
-    void DrawAdvancedGrid(float screenWidth, float screenHeight, float time);
+    void DrawLines(const Matrix4 &modelMatrix, VertexArray* vertices, Vector3 color, float alpha, float lineWidth);
 
-    void BeginRenderToTexture();
-    void EndRenderToTexture();
-    
-    void Present();
+    // Shapes that only live for this frame, their vertices are copied into it
+    RenderGeometry AddGeometry(const Vector2* points, unsigned int count);
+    void DrawFilledWithAlpha(const Matrix4 &modelMatrix, const RenderGeometry &geometry, Vector3 color, float alpha);
+
+    // Quad with the sprite shader, in screen coordinates centred on the screen
+    void DrawSprite(const Matrix4 &world, class Texture* texture, const Vector4 &color, float textureFactor,
+                    VertexArray* vertices = nullptr, unsigned int numIndices = 6);
+
+    // Full screen, at the size the frame is drawn
+    void DrawAdvancedGrid(float time);
+
+    // Frees the array or texture once no frame in flight can draw it
+    void ReleaseVertexArray(VertexArray* vertices);
+    void ReleaseTexture(class Texture* texture);
 
     void AddUIElement(class UIElement *comp);
     void RemoveUIElement(class UIElement *comp);
 
-    class Shader* GetBaseShader() const { return mBaseShader; }
     float GetScreenWidth() const { return mScreenWidth; }
     float GetScreenHeight() const { return mScreenHeight; }
-    class Shader* GetSpriteShader() const { return mSpriteShader; }
     class Texture* GetTexture(const std::string& fileName);
     class Font* GetFont(const std::string& fileName);
 
@@ -49,6 +76,23 @@ private:
     void CreateSpriteVerts();
     std::string FindShaderPath(const std::string& shaderName);
 
+    // Everything below runs on the thread that owns the GL context
+    void RenderLoop();
+    void Execute(RenderSnapshot& snapshot);
+    void ApplyScreenSize(float width, float height);
+    void SetBlend(RenderCommand::Kind kind, bool blend);
+    void DrawMesh(const RenderCommand& command);
+    void DrawGeometry(const RenderCommand& command);
+    void DrawSpriteCommand(const RenderCommand& command, const Matrix4& viewProj);
+    void DrawBackground(const RenderCommand& command);
+    void Clear();
+    void BeginRenderToTexture();
+    void EndRenderToTexture();
+    void Present();
+
+    void AddMeshCommand(const Matrix4 &modelMatrix, VertexArray* vertices, Vector3 color, float alpha,
+                        GLenum primitive, bool blend, float lineWidth = 1.0f);
+
     class Game* mGame;
 
     class Shader* mSpriteShader;
@@ -63,8 +107,12 @@ private:
     GLuint mSceneTexture;
     GLuint mRBO;
     
+    // Size recorded into the next frames
     float mScreenWidth;
     float mScreenHeight;
+    // Size the viewport and projections were last set to
+    float mAppliedWidth;
+    float mAppliedHeight;
 
     class VertexArray *mSpriteVerts;
 
@@ -78,4 +126,17 @@ private:
     std::unordered_map<std::string, class Font*> mFonts;
 
     std::vector<class UIElement*> mUIComps;
+
+    // Vertices of the per frame shapes, refilled from each snapshot
+    GLuint mGeometryArray;
+    GLuint mGeometryBuffer;
+    // Blend state left by the last command, -1 before the first one
+    int mBlendState;
+
+    TripleBuffer<RenderSnapshot> mSnapshots;
+    std::thread mRenderThread;
+    std::mutex mHandoffMutex;
+    // Signalled when a snapshot is published and when one is taken
+    std::condition_variable mHandoff;
+    bool mStopRendering;
 };
\ No newline at end of file
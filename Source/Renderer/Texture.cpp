@@ -1,11 +1,16 @@
+
 #include "Texture.h"
-#include "PlatformCompatibility.h"
 #include <SDL_image.h>
+#include <cstring>
 
 Texture::Texture()
 : mTextureID(0)
 , mWidth(0)
 , mHeight(0)
+, mFormat(GL_RGBA)
+, mIsStreaming(false)
+, mHasMipmaps(false)
+, mHasPixels(false)
 {
 }
 
@@ -15,13 +20,6 @@ Texture::~Texture()
 
 bool Texture::Load(const std::string &filePath)
 {
-    // Verificar se o contexto OpenGL está válido e atual
-    // Importante para macOS e Linux onde o contexto pode ser perdido
-    if (!IsOpenGLContextValid()) {
-        SDL_Log("Failed to load texture %s: No valid OpenGL context", filePath.c_str());
-        return false;
-    }
-
     SDL_Surface* surface = IMG_Load(filePath.c_str());
 
     if (!surface) {
@@ -32,17 +30,15 @@ bool Texture::Load(const std::string &filePath)
     // Verify surface has valid pixels
     if (!surface->pixels) {
         SDL_Log("Failed to load texture %s: Surface has no pixel data", filePath.c_str());
+        SDL_FreeSurface(surface);
         return false;
     }
 
-    mWidth = surface->w;
-    mHeight = surface->h;
-
     // Convert surface to RGBA format if necessary (for consistent format)
-    SDL_Surface* convertedSurface = nullptr;
-    if (surface->format->format != SDL_PIXELFORMAT_RGBA32 && 
+    if (surface->format->format != SDL_PIXELFORMAT_RGBA32 &&
         surface->format->format != SDL_PIXELFORMAT_BGRA32) {
-        convertedSurface = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+        SDL_Surface* convertedSurface = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+        SDL_FreeSurface(surface);
         if (!convertedSurface || !convertedSurface->pixels) {
             SDL_Log("Failed to convert surface format for texture %s", filePath.c_str());
             if (convertedSurface) SDL_FreeSurface(convertedSurface);
@@ -51,46 +47,15 @@ bool Texture::Load(const std::string &filePath)
         surface = convertedSurface;
     }
 
-    // Generate a GL texture
-    glGenTextures(1, &mTextureID);
-    if (mTextureID == 0) {
-        SDL_Log("Failed to generate texture ID for %s", filePath.c_str());
-        return false;
-    }
+    mWidth = surface->w;
+    mHeight = surface->h;
 
-    glBindTexture(GL_TEXTURE_2D, mTextureID);
-    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
-    
-    // Check for OpenGL errors before glTexImage2D
-    GLenum error = glGetError();
-    if (error != GL_NO_ERROR) {
-        SDL_Log("OpenGL error before glTexImage2D for %s: %d", filePath.c_str(), error);
-    }
-    
     // Determine format based on pixel format
-    GLenum glFormat = GL_RGBA;
-    if (surface->format->format == SDL_PIXELFORMAT_BGRA32) {
-        glFormat = GL_BGRA;
-    }
-    
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, mWidth, mHeight, 0, glFormat, GL_UNSIGNED_BYTE, surface->pixels);
-    
-    // Check for OpenGL errors after glTexImage2D
-    error = glGetError();
-    if (error != GL_NO_ERROR) {
-        SDL_Log("OpenGL error after glTexImage2D for %s: %d", filePath.c_str(), error);
-        glDeleteTextures(1, &mTextureID);
-        mTextureID = 0;
-        return false;
-    }
-
-    // Generate mipmaps for texture
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    // Enable linear filtering
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    mFormat = surface->format->format == SDL_PIXELFORMAT_BGRA32 ? GL_BGRA : GL_RGBA;
+    mHasMipmaps = true;
 
+    StagePixels(static_cast<const unsigned char*>(surface->pixels), surface->pitch);
+    SDL_FreeSurface(surface);
     return true;
 }
 
@@ -98,27 +63,95 @@ void Texture::CreateFromSurface(SDL_Surface* surface)
 {
     mWidth = surface->w;
     mHeight = surface->h;
+    mFormat = GL_RGBA;
+
+    StagePixels(static_cast<const unsigned char*>(surface->pixels), surface->pitch);
+}
+
+void Texture::CreateStreaming(int width, int height)
+{
+    mWidth = width;
+    mHeight = height;
+    mFormat = GL_RGBA;
+    mIsStreaming = true;
+}
+
+void Texture::SetPixels(const unsigned char* pixels, int pitch)
+{
+    StagePixels(pixels, pitch);
+}
+
+void Texture::StagePixels(const unsigned char* pixels, int pitch)
+{
+    const size_t rowBytes = static_cast<size_t>(mWidth) * 4;
+
+    std::lock_guard<std::mutex> lock(mPixelsMutex);
+    mPixels.resize(rowBytes * mHeight);
+    for (int row = 0; row < mHeight; row++) {
+        memcpy(mPixels.data() + row * rowBytes, pixels + static_cast<size_t>(row) * pitch, rowBytes);
+    }
+    mHasPixels = true;
+}
+
+void Texture::Upload()
+{
+    std::lock_guard<std::mutex> lock(mPixelsMutex);
+    if (!mHasPixels) {
+        return;
+    }
+
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    if (mTextureID != 0) {
+        glBindTexture(GL_TEXTURE_2D, mTextureID);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, mWidth, mHeight, mFormat, GL_UNSIGNED_BYTE, mPixels.data());
+        mHasPixels = false;
+        return;
+    }
 
     // Generate a GL texture
     glGenTextures(1, &mTextureID);
-    glBindTexture(GL_TEXTURE_2D, mTextureID);
-    glPixelStorei(GL_UNPACK_ROW_LENGTH, surface->pitch / 4);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, mWidth, mHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE,
-                 surface->pixels);
+    if (mTextureID == 0) {
+        SDL_Log("Failed to generate texture ID");
+        return;
+    }
 
-    // Use linear filtering
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, mTextureID);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, mWidth, mHeight, 0, mFormat, GL_UNSIGNED_BYTE, mPixels.data());
+
+    if (mHasMipmaps) {
+        // Generate mipmaps for texture
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    } else {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    }
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    if (mIsStreaming) {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+
+    mHasPixels = false;
+
+    // Static images never change again, the copy is not needed any more
+    if (!mIsStreaming) {
+        mPixels.clear();
+        mPixels.shrink_to_fit();
+    }
 }
 
 void Texture::Unload()
 {
 	glDeleteTextures(1, &mTextureID);
+	mTextureID = 0;
 }
 
-void Texture::SetActive(int index) const
+void Texture::SetActive(int index)
 {
 	glActiveTexture(GL_TEXTURE0 + index);
+	Upload();
 	glBindTexture(GL_TEXTURE_2D, mTextureID);
 }
-
@@ -1,10 +1,16 @@
 #pragma once
 #include <string>
+#include <vector>
+#include <mutex>
 #include <GL/glew.h>
 #include <SDL.h>
 
 struct SDL_Surface;
 
+// Images are decoded on the calling thread and their pixels staged until the
+// render thread first binds the texture, which is when the GL texture is
+// created. Delete them through Renderer::ReleaseTexture, a frame still in
+// flight may draw them.
 class Texture
 {
 public:
@@ -12,20 +18,39 @@ public:
 	~Texture();
 
 	bool Load(const std::string& fileName);
+	// Render thread
 	void Unload();
 
     void CreateFromSurface(struct SDL_Surface* surface);
 
-    void SetActive(int index = 0) const;
+    // A texture whose pixels are replaced while it is drawn, like video frames.
+    // The render thread uploads the latest image before it next binds it.
+    void CreateStreaming(int width, int height);
+    void SetPixels(const unsigned char* pixels, int pitch);
+
+    // Render thread, uploads the staged pixels first
+    void SetActive(int index = 0);
 
 	int GetWidth() const { return mWidth; }
 	int GetHeight() const { return mHeight; }
 
+	// 0 until the render thread first binds it
 	unsigned int GetTextureID() const { return mTextureID; }
 
 private:
+    // Copies RGBA rows, pitch apart, into the staged image
+    void StagePixels(const unsigned char* pixels, int pitch);
+    void Upload();
+
 	unsigned int mTextureID;
 	int mWidth;
 	int mHeight;
+    GLenum mFormat;
+    bool mIsStreaming;
+    bool mHasMipmaps;
+
+    // written by the decoding thread, read by the render thread
+    std::mutex mPixelsMutex;
+    std::vector<unsigned char> mPixels;
+    bool mHasPixels;
 };
-
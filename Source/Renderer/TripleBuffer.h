@@ -0,0 +1,51 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Hands values from one producer thread to one consumer thread without either
+// waiting on the other. The producer fills the back slot and publishes it, the
+// consumer takes the newest published slot; a slot published again before the
+// consumer got to it is overwritten, so the consumer always sees the latest
+// one and the producer never blocks. Slots are reused, never reconstructed.
+template <typename T>
+class TripleBuffer {
+public:
+    // Producer side
+    T &GetBack() { return mSlots[mBack]; }
+
+    // Returns false when the previous published slot was never taken, its
+    // slot comes back as the new back one with whatever it still holds
+    bool Publish() {
+        const uint8_t previous = mMiddle.exchange(static_cast<uint8_t>(mBack | FRESH), std::memory_order_acq_rel);
+        mBack = previous & INDEX_MASK;
+        return (previous & FRESH) == 0;
+    }
+
+    // Consumer side, false when nothing was published since the last take
+    bool Take() {
+        if (!HasPublished()) {
+            return false;
+        }
+
+        const uint8_t previous = mMiddle.exchange(mFront, std::memory_order_acq_rel);
+        mFront = previous & INDEX_MASK;
+        return true;
+    }
+
+    T &GetFront() { return mSlots[mFront]; }
+
+    [[nodiscard]] bool HasPublished() const { return (mMiddle.load(std::memory_order_acquire) & FRESH) != 0; }
+
+    // Every slot, only while neither side is running
+    T *GetSlots() { return mSlots; }
+    static constexpr int SLOTS = 3;
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0x3;
+    static constexpr uint8_t FRESH = 0x4;
+
+    T mSlots[SLOTS];
+    uint8_t mBack = 0;
+    std::atomic<uint8_t> mMiddle{1};
+    uint8_t mFront = 2;
+};
@@ -5,6 +5,15 @@
 #include "VertexArray.h"
 #include <GL/glew.h>
 
+namespace {
+    // Sprite format: 4 vertices (numVerts=4) with 6 indices, and 8 floats per vertex = 32 floats total
+    // 2D line format: numVerts is actually number of floats (vertices * 2), with 2 floats per vertex
+    bool IsSpriteFormat(unsigned int numVerts, unsigned int numIndices)
+    {
+        return numVerts == 4 && numIndices == 6;
+    }
+}
+
 VertexArray::VertexArray(const float* verts, unsigned int numVerts, const unsigned int* indices,
                          unsigned int numIndices)
 : mNumVerts(numVerts)
@@ -13,6 +22,30 @@ VertexArray::VertexArray(const float* verts, unsigned int numVerts, const unsign
 , mIndexBuffer(0)
 , mVertexArray(0)
 {
+    const unsigned int numFloats = IsSpriteFormat(numVerts, numIndices) ? numVerts * 8 : numVerts;
+    mVerts.assign(verts, verts + numFloats);
+    mIndices.assign(indices, indices + numIndices);
+}
+
+VertexArray::~VertexArray()
+{
+    if (mVertexArray == 0) {
+        return;
+    }
+
+    glDeleteBuffers(1, &mVertexBuffer);
+    glDeleteBuffers(1, &mIndexBuffer);
+    glDeleteVertexArrays(1, &mVertexArray);
+}
+
+// Creates the GL buffers from the copy kept by the constructor
+void VertexArray::Upload()
+{
+    const float* verts = mVerts.data();
+    const unsigned int* indices = mIndices.data();
+    const unsigned int numVerts = mNumVerts;
+    const unsigned int numIndices = mNumIndices;
+
     // Create vertex array
     glGenVertexArrays(1, &mVertexArray);
     glBindVertexArray(mVertexArray);
@@ -21,12 +54,8 @@ VertexArray::VertexArray(const float* verts, unsigned int numVerts, const unsign
     glGenBuffers(1, &mVertexBuffer);
     glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
     
-    // Determine format based on numVerts and numIndices
-    // Sprite format: 4 vertices (numVerts=4) with 6 indices, and 8 floats per vertex = 32 floats total
-    // 2D line format: numVerts is actually number of floats (vertices * 2), with 2 floats per vertex
-    
     // Check if this is sprite format (4 vertices, 6 indices = quad)
-    if (numVerts == 4 && numIndices == 6) {
+    if (IsSpriteFormat(numVerts, numIndices)) {
         // Sprite format: 8 floats per vertex (3 pos + 3 normal + 2 texCoord)
         unsigned int numFloats = numVerts * 8; // 4 vertices * 8 floats = 32 floats
         unsigned int stride = 8 * sizeof(float);
@@ -60,17 +89,19 @@ VertexArray::VertexArray(const float* verts, unsigned int numVerts, const unsign
     glGenBuffers(1, &mIndexBuffer);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, numIndices * sizeof(GLuint), indices, GL_STATIC_DRAW);
-}
 
-VertexArray::~VertexArray()
-{
-    glDeleteBuffers(1, &mVertexBuffer);
-    glDeleteBuffers(1, &mIndexBuffer);
-    glDeleteVertexArrays(1, &mVertexArray);
+    mVerts.clear();
+    mVerts.shrink_to_fit();
+    mIndices.clear();
+    mIndices.shrink_to_fit();
 }
 
-void VertexArray::SetActive() const
+void VertexArray::SetActive()
 {
+    if (mVertexArray == 0) {
+        Upload();
+    }
+
     glBindVertexArray(mVertexArray);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
 }
@@ -1,4 +1,10 @@
 #pragma once
+#include <vector>
+
+// The vertices are kept on the CPU until the array is first made active, so
+// arrays can be built on the simulation thread and the GL buffers are created
+// on the thread that owns the context. Delete them through
+// Renderer::ReleaseVertexArray, a frame still in flight may draw them.
 class VertexArray
 {
 public:
@@ -6,14 +12,20 @@ public:
                 unsigned int numIndices);
     ~VertexArray();
 
-    void SetActive() const;
+    void SetActive();
     unsigned int GetNumIndices() const { return mNumIndices; }
     unsigned int GetNumVerts() const { return mNumVerts; }
 
 private:
+    void Upload();
+
     unsigned int mNumVerts;
     unsigned int mNumIndices;
     unsigned int mVertexBuffer;
     unsigned int mIndexBuffer;
     unsigned int mVertexArray;
-};
\ No newline at end of file
+
+    // dropped once uploaded
+    std::vector<float> mVerts;
+    std::vector<unsigned int> mIndices;
+};
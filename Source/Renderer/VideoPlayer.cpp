@@ -1,19 +1,21 @@
 #include "VideoPlayer.h"
 #include "Renderer.h"
+#include "Texture.h"
 #include <SDL.h>
 #include <iostream>
 
 // FFmpeg 4.0+ não precisa mais de av_register_all(), mas vamos garantir compatibilidade
 
-VideoPlayer::VideoPlayer()
-    : mFormatContext(nullptr)
+VideoPlayer::VideoPlayer(class Renderer* renderer)
+    : mRenderer(renderer)
+    , mFormatContext(nullptr)
     , mCodecContext(nullptr)
     , mFrame(nullptr)
     , mFrameRGB(nullptr)
     , mPacket(nullptr)
     , mSwsContext(nullptr)
     , mVideoStreamIndex(-1)
-    , mTextureID(0)
+    , mTexture(nullptr)
     , mWidth(0)
     , mHeight(0)
     , mCurrentTime(0.0)
@@ -136,14 +138,9 @@ bool VideoPlayer::Load(const std::string& fileName)
         return false;
     }
     
-    // Criar textura OpenGL com formato RGBA
-    glGenTextures(1, &mTextureID);
-    glBindTexture(GL_TEXTURE_2D, mTextureID);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, mWidth, mHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    // Criar textura com formato RGBA, enviada à GPU pela thread de desenho
+    mTexture = new Texture();
+    mTexture->CreateStreaming(mWidth, mHeight);
     
     mPacket = av_packet_alloc();
     mCurrentTime = 0.0;
@@ -159,10 +156,10 @@ bool VideoPlayer::Load(const std::string& fileName)
 
 void VideoPlayer::Unload()
 {
-    if (mTextureID != 0)
+    if (mTexture)
     {
-        glDeleteTextures(1, &mTextureID);
-        mTextureID = 0;
+        mRenderer->ReleaseTexture(mTexture);
+        mTexture = nullptr;
     }
     
     if (mFrameBuffer)
@@ -287,31 +284,8 @@ bool VideoPlayer::DecodeFrame()
 
 void VideoPlayer::UpdateTexture()
 {
-    glBindTexture(GL_TEXTURE_2D, mTextureID);
-    
-    // Configurar alinhamento de pixels correto para RGBA
-    // RGBA = 4 bytes por pixel, então o pitch deve ser divisível por 4
-    int pitch = mFrameRGB->linesize[0];
-    int expectedPitch = mWidth * 4; // 4 bytes por pixel (RGBA)
-    
-    // Se o pitch for diferente do esperado, precisamos usar GL_UNPACK_ROW_LENGTH
-    if (pitch != expectedPitch)
-    {
-        glPixelStorei(GL_UNPACK_ROW_LENGTH, pitch / 4);
-    }
-    else
-    {
-        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0); // Usar width padrão
-    }
-    
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 4); // RGBA precisa de alinhamento de 4 bytes
-    
-    // Atualizar textura com dados RGBA
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, mWidth, mHeight, GL_RGBA, GL_UNSIGNED_BYTE, mFrameRGB->data[0]);
-    
-    // Restaurar alinhamento padrão
-    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    // O pitch pode ser maior que a largura, a textura copia linha a linha
+    mTexture->SetPixels(mFrameRGB->data[0], mFrameRGB->linesize[0]);
 }
 
 void VideoPlayer::SeekToTime(double timeInSeconds)
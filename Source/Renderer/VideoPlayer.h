@@ -10,10 +10,12 @@ extern "C" {
 #include <libavutil/imgutils.h>
 }
 
+// Decodes on the thread that calls Update into a streaming texture, the
+// render thread uploads the newest frame when it draws it
 class VideoPlayer
 {
 public:
-    VideoPlayer();
+    VideoPlayer(class Renderer* renderer);
     ~VideoPlayer();
 
     bool Load(const std::string& fileName);
@@ -28,7 +30,7 @@ public:
     double GetCurrentTime() const { return mCurrentTime; }
     double GetDuration() const { return mDuration; }
     
-    unsigned int GetTextureID() const { return mTextureID; }
+    class Texture* GetTexture() const { return mTexture; }
     int GetWidth() const { return mWidth; }
     int GetHeight() const { return mHeight; }
 
@@ -36,6 +38,7 @@ private:
     bool DecodeFrame();
     void UpdateTexture();
     
+    class Renderer* mRenderer;
     AVFormatContext* mFormatContext;
     AVCodecContext* mCodecContext;
     AVFrame* mFrame;
@@ -44,7 +47,7 @@ private:
     struct SwsContext* mSwsContext;
     
     int mVideoStreamIndex;
-    unsigned int mTextureID;
+    class Texture* mTexture;
     int mWidth;
     int mHeight;
     
@@ -26,12 +26,23 @@ Connect::Connect(class Game* game, const std::string& fontName)
 void Connect::HandleKeyPress(const int key)
 {
         if ((key ==  SDLK_RETURN || key == SDLK_RETURN2) && !mConnecting) {
-                const std::string ip = mInputField->GetTextValue();
-                if (!IsValidIPv4(ip)) {
-                        return;
+                // Vários servidores podem ser testados de uma vez: "ip[:porta],ip[:porta]"
+                Client* client = mGame->GetClient();
+                std::stringstream ss(mInputField->GetTextValue());
+                std::string endpoint;
+                bool hasServer = false;
+
+                while (std::getline(ss, endpoint, ',')) {
+                        if (!IsValidIPv4(endpoint.substr(0, endpoint.find(':'))) ||
+                            !client->AddServerAddr(endpoint.c_str())) {
+                                client->ClearServerAddrs();
+                                return;
+                        }
+                        hasServer = true;
                 }
 
-                if (!mGame->GetClient()->AddServerAddr(ip.c_str())) {
+                if (!hasServer || !client->StartConnection()) {
+                        client->ClearServerAddrs();
                         return;
                 }
 
@@ -39,7 +50,6 @@ void Connect::HandleKeyPress(const int key)
                 mInputField->SetFocused(false);
                 mInputField->SetIsVisible(false);
                 mConnectionText->SetIsVisible(true);
-                mGame->GetClient()->StartConnection();
         }else {
                 mInputField->HandleKey(key);
         }
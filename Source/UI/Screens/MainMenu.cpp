@@ -22,7 +22,7 @@ MainMenu::MainMenu(class Game* game, const std::string& fontName)
         , mRightArrow(nullptr)
 {
     // Criar VideoPlayer para o background
-    mVideoPlayer = new VideoPlayer();
+    mVideoPlayer = new VideoPlayer(GetGame()->GetRenderer());
     
     // Carregar vídeo abertura.mp4
     std::string videoPath = PathResolver::ResolvePath("Opening/abertura.mp4");
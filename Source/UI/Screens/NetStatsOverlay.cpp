@@ -0,0 +1,74 @@
+//
+// Created by pedro-souza on 17/10/2026.
+//
+
+#include "NetStatsOverlay.h"
+#include "../../Game.h"
+#include <chrono>
+#include <cstdio>
+
+NetStatsOverlay::NetStatsOverlay(class Game* game, const std::string& fontName)
+    :UIScreen(game, fontName)
+    ,mRttText(nullptr)
+    ,mLossText(nullptr)
+    ,mRateText(nullptr)
+    ,mSnapshotText(nullptr)
+    ,mRefreshTimer(0.0f)
+{
+    // Screen coordinates: center is (0, 0), top-right is positive X and Y
+    const float x = mGame->GetRenderer()->GetScreenWidth() / 2.0f - 200.0f;
+    const float y = mGame->GetRenderer()->GetScreenHeight() / 2.0f - 30.0f;
+    constexpr float lineHeight = 30.0f;
+
+    UIText** lines[] = {&mRttText, &mLossText, &mRateText, &mSnapshotText};
+    for (int i = 0; i < 4; i++) {
+        UIText* text = AddText("-", Vector2(x, y - lineHeight * i), 1.0f, 0.0f, POINT_SIZE, 1024, 1000);
+        text->SetBackgroundColor(Vector4(0.0f, 0.0f, 0.0f, 0.5f));
+        text->SetMargin(Vector2(10.0f, 4.0f));
+        *lines[i] = text;
+    }
+
+    Refresh();
+}
+
+void NetStatsOverlay::Update(float deltaTime)
+{
+    // re-rendering the text textures every frame is not worth it
+    mRefreshTimer -= deltaTime;
+    if (mRefreshTimer <= 0.0f) {
+        mRefreshTimer = REFRESH_INTERVAL;
+        Refresh();
+    }
+}
+
+void NetStatsOverlay::Refresh()
+{
+    const Client* client = mGame->GetClient();
+    if (!client) {
+        return;
+    }
+
+    const ConnectionReport& report = client->GetConnectionReport();
+    const JitterBufferStats buffer = mGame->GetEnemyBufferStats();
+    char line[96];
+
+    if (report.hasRtt) {
+        snprintf(line, sizeof(line), "rtt %.0f ms  p95 %.0f  jitter %.1f ms",
+            report.rttMs, report.GetRttPercentileMs(0.95f), report.jitterMs);
+    } else {
+        snprintf(line, sizeof(line), "rtt -");
+    }
+    mRttText->SetText(line);
+
+    snprintf(line, sizeof(line), "loss up %.1f%%  down %.1f%%",
+        report.uplinkLossPercent, report.downlinkLossPercent);
+    mLossText->SetText(line);
+
+    snprintf(line, sizeof(line), "in %.1f KB/s  out %.1f KB/s",
+        report.bytesInPerSecond / 1024.0f, report.bytesOutPerSecond / 1024.0f);
+    mRateText->SetText(line);
+
+    snprintf(line, sizeof(line), "snapshot age %.0f ms  delay %.0f ms",
+        report.GetSnapshotAgeMs(std::chrono::steady_clock::now()), buffer.delayMs);
+    mSnapshotText->SetText(line);
+}
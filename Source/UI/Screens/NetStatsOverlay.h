@@ -0,0 +1,28 @@
+//
+// Created by pedro-souza on 17/10/2026.
+//
+#pragma once
+
+#include "UIScreen.h"
+
+// Link quality of the multiplayer connection in the top-right corner, drawn
+// over the game instead of replacing it
+class NetStatsOverlay : public UIScreen
+{
+public:
+    NetStatsOverlay(class Game* game, const std::string& fontName);
+
+    void Update(float deltaTime) override;
+
+    static constexpr float REFRESH_INTERVAL = 0.25f;
+    static constexpr int POINT_SIZE = 20;
+
+private:
+    void Refresh();
+
+    UIText* mRttText;
+    UIText* mLossText;
+    UIText* mRateText;
+    UIText* mSnapshotText;
+    float mRefreshTimer;
+};
@@ -3,13 +3,11 @@
 #include "../../Renderer/VideoPlayer.h"
 #include "../../Renderer/AudioPlayer.h"
 #include "../../Renderer/Renderer.h"
-#include "../../Renderer/Shader.h"
 #include "../../Renderer/VertexArray.h"
 #include "../../Math.h"
 #include "../../PathResolver.h"
 #include "../UIImage.h"
 #include <SDL.h>
-#include <GL/glew.h>
 #include <iostream>
 
 OpeningScreen::OpeningScreen(class Game* game)
@@ -21,7 +19,7 @@ OpeningScreen::OpeningScreen(class Game* game)
     , mVideoVerts(nullptr)
 {
     // Criar VideoPlayer
-    mVideoPlayer = new VideoPlayer();
+    mVideoPlayer = new VideoPlayer(GetGame()->GetRenderer());
     
     // Carregar vídeo begin.mp4
     std::string videoPath = PathResolver::ResolvePath("Opening/begin.mp4");
@@ -78,11 +76,8 @@ OpeningScreen::~OpeningScreen()
         mVideoPlayer = nullptr;
     }
     
-    if (mVideoVerts)
-    {
-        delete mVideoVerts;
-        mVideoVerts = nullptr;
-    }
+    GetGame()->GetRenderer()->ReleaseVertexArray(mVideoVerts);
+    mVideoVerts = nullptr;
 }
 
 void OpeningScreen::Update(float deltaTime)
@@ -154,23 +149,9 @@ void OpeningScreen::Draw(class Renderer* renderer)
     if (!mVideoPlayer || !mVideoVerts)
         return;
     
-    class Shader* spriteShader = renderer->GetSpriteShader();
-    if (!spriteShader)
-        return;
-    
-    spriteShader->SetActive();
-    
-    // Obter o tamanho real da janela
-    SDL_Window* window = GetGame()->GetWindow();
-    int windowWidth, windowHeight;
-    SDL_GetWindowSize(window, &windowWidth, &windowHeight);
-    
-    float width = static_cast<float>(windowWidth);
-    float height = static_cast<float>(windowHeight);
-    
-    // Configurar view projection (mesma usada para sprites)
-    Matrix4 viewProj = Matrix4::CreateSimpleViewProj(width, height);
-    spriteShader->SetMatrixUniform("uViewProj", viewProj);
+    // Tamanho da tela do quadro, o mesmo da view projection dos sprites
+    float width = renderer->GetScreenWidth();
+    float height = renderer->GetScreenHeight();
     
     // Criar matriz de transformação para ajustar o vídeo à tela
     // Usar "fit" ao invés de "fill" - o vídeo deve caber inteiro na tela
@@ -192,15 +173,7 @@ void OpeningScreen::Draw(class Renderer* renderer)
     Matrix4 transMat = Matrix4::CreateTranslation(Vector3(0.0f, 0.0f, 0.0f)); // Centro já está em (0,0)
     Matrix4 world = scaleMat * transMat; // Mesma ordem do UIImage
     
-    spriteShader->SetMatrixUniform("uWorldTransform", world);
-    
-    // Configurar textura
-    spriteShader->SetTextureUniform("uTexture", mVideoPlayer->GetTextureID(), 0);
-    spriteShader->SetFloatUniform("uTextureFactor", 1.0f);
-    spriteShader->SetVectorUniform("uBaseColor", Vector4(1.0f, 1.0f, 1.0f, 1.0f));
-    
-    // Desenhar usando nossos vertices
-    mVideoVerts->SetActive();
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+    // Desenhar usando nossos vertices e a textura do vídeo
+    renderer->DrawSprite(world, mVideoPlayer->GetTexture(), Vector4(1.0f, 1.0f, 1.0f, 1.0f), 1.0f, mVideoVerts);
 }
 
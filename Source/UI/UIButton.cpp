@@ -28,10 +28,10 @@ void UIButton::OnClick()
     }
 }
 
-void UIButton::Draw(class Shader* shader)
+void UIButton::Draw(class Renderer* renderer)
 {
     // Tornar background sempre transparente
     mBackgroundColor.w = 0.0f;
 
-    UIText::Draw(shader);
+    UIText::Draw(renderer);
 }
\ No newline at end of file
@@ -17,7 +17,7 @@ public:
 
     ~UIButton();
 
-    void Draw(class Shader* shader) override;
+    void Draw(class Renderer* renderer) override;
 
     void SetHighlighted(bool sel) { mHighlighted = sel; }
     bool GetHighlighted() const { return mHighlighted; }
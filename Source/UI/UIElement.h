@@ -30,7 +30,7 @@ public:
 
     int GetDrawOrder() const { return mDrawOrder; }
 
-    virtual void Draw(class Shader* shader) {};
+    virtual void Draw(class Renderer* renderer) {};
 
 protected:
     class Game* mGame;
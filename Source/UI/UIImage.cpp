@@ -4,11 +4,9 @@
 
 #include "UIImage.h"
 #include "../Renderer/Texture.h"
-#include "../Renderer/Shader.h"
 #include "../Renderer/Renderer.h"
 #include "../Actors/Actor.h"
 #include "../Game.h"
-#include <GL/glew.h>
 
 
 UIImage::UIImage(class Game* game, const Vector2 &offset, const float scale, const float angle, int drawOrder)
@@ -33,7 +31,7 @@ UIImage::~UIImage()
 
 }
 
-void UIImage::Draw(class Shader* shader)
+void UIImage::Draw(class Renderer* renderer)
 {
     if(!mTexture || !GetIsVisible())
         return;
@@ -49,24 +47,10 @@ void UIImage::Draw(class Shader* shader)
 
     // Set world transform
     Matrix4 world = scaleMat * rotMat * transMat;
-    shader->SetMatrixUniform("uWorldTransform", world);
-
-    // Set uTextureFactor
-    shader->SetFloatUniform("uTextureFactor", 1.0f);
 
     // Set color for transparency if using color
-    if (mUseColor)
-    {
-        shader->SetVectorUniform("uBaseColor", mColor);
-    }
-    else
-    {
-        shader->SetVectorUniform("uBaseColor", Vector4(1.0f, 1.0f, 1.0f, 1.0f));
-    }
-
-    // Set current texture and texture uniform
-    shader->SetTextureUniform("uTexture", mTexture->GetTextureID(), 0);
+    Vector4 color = mUseColor ? mColor : Vector4(1.0f, 1.0f, 1.0f, 1.0f);
 
-    // Draw quad
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+    // Draw quad with the texture
+    renderer->DrawSprite(world, mTexture, color, 1.0f);
 }
\ No newline at end of file
@@ -15,7 +15,7 @@ public:
 
     ~UIImage();
 
-    void Draw(class Shader* shader) override;
+    void Draw(class Renderer* renderer) override;
     void SetColor(const Vector4 &color) { mColor = color; mUseColor = true; }
 
 protected:
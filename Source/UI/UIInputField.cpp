@@ -44,16 +44,19 @@ void UIInputField::HandleKey(int key)
     }
     // Lógica para entrada de dígitos (0-9)
     else if (key >= SDLK_0 && key <= SDLK_9) {
-        if (mTextValue.length() < MAX_IPV4_LENGTH) {
+        if (mTextValue.length() < MAX_INPUT_LENGTH) {
             char digit = (char)(key - SDLK_0 + '0');
             mTextValue += digit;
         }
     }
-    // Lógica para Ponto ('.')
-    else if (key == SDLK_PERIOD) {
-        // Permitir o ponto, desde que não seja o primeiro caractere e haja espaço
-        if (!mTextValue.empty() && mTextValue.length() < MAX_IPV4_LENGTH && mTextValue.back() != '.') {
-             mTextValue += '.';
+    // Lógica para Ponto ('.'), vírgula entre servidores e dois-pontos (SHIFT + ;) antes da porta
+    else if (key == SDLK_PERIOD || key == SDLK_COMMA || key == SDLK_COLON ||
+             (key == SDLK_SEMICOLON && (SDL_GetModState() & KMOD_SHIFT))) {
+        const char separator = key == SDLK_PERIOD ? '.' : key == SDLK_COMMA ? ',' : ':';
+        // Permitir o separador, desde que não seja o primeiro caractere, não repita outro e haja espaço
+        if (!mTextValue.empty() && mTextValue.length() < MAX_INPUT_LENGTH &&
+            mTextValue.back() != '.' && mTextValue.back() != ',' && mTextValue.back() != ':') {
+             mTextValue += separator;
         }
     }
 
@@ -64,10 +67,10 @@ void UIInputField::HandleKey(int key)
     mCursorTimer = 0.0f;
 }
 
-void UIInputField::Draw(class Shader* shader)
+void UIInputField::Draw(class Renderer* renderer)
 {
     // 1. Desenha o fundo e o texto (chamando a Draw da classe base)
-    UIText::Draw(shader);
+    UIText::Draw(renderer);
 
     // Se o elemento estiver focado, desenha o cursor piscando
     if (mIsFocused) {
@@ -92,6 +95,6 @@ void UIInputField::Draw(class Shader* shader)
 
         mCursor->SetOffset(cursorOffset);
 
-        mCursor->Draw(shader);
+        mCursor->Draw(renderer);
     }
 }
\ No newline at end of file
@@ -17,7 +17,7 @@ public:
     void SetCursorColor(const Vector3& color) const { if (mCursor) {mCursor->SetTextColor(color);}}
 
     // Método para desenhar o fundo (se necessário) e o cursor
-    void Draw(class Shader* shader) override;
+    void Draw(class Renderer* renderer) override;
 
     // Getters e Setters
     const std::string& GetTextValue() const { return mTextValue; }
@@ -26,6 +26,8 @@ public:
 
     // Constante para o tamanho máximo (Ex: "255.255.255.255" = 15 caracteres)
     static constexpr size_t MAX_IPV4_LENGTH = 15;
+    // Vários servidores separados por vírgula, cada um com porta opcional ("ip:porta")
+    static constexpr size_t MAX_INPUT_LENGTH = 4 * (MAX_IPV4_LENGTH + 6) + 3;
 
 private:
     std::string mTextValue;
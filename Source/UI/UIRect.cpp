@@ -3,6 +3,7 @@
 //
 
 #include "UIRect.h"
+#include "../Renderer/Renderer.h"
 
 UIRect::UIRect(class Game* game, const Vector2 &offset, const Vector2 &size, const float scale, float angle, int drawOrder)
         : UIElement(game, offset, scale, angle, drawOrder)
@@ -17,7 +18,7 @@ UIRect::~UIRect()
 
 }
 
-void UIRect::Draw(class Shader* shader)
+void UIRect::Draw(class Renderer* renderer)
 {
     if (!GetIsVisible())
         return;
@@ -32,15 +33,7 @@ void UIRect::Draw(class Shader* shader)
 
     // Set world transform
     Matrix4 world = scaleMat * rotMat * transMat;
-    shader->SetMatrixUniform("uWorldTransform", world);
 
-    // Set uTextureFactor and color
-    shader->SetFloatUniform("uTextureFactor", 0.0f);
-    shader->SetVectorUniform("uBaseColor", mColor);
-    
-    // Set texture uniform (even though we're not using a texture, the shader expects it)
-    shader->SetTextureUniform("uTexture", 0, 0);
-
-    // Draw quad
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+    // Draw quad with the color only
+    renderer->DrawSprite(world, nullptr, mColor, 0.0f);
 }
\ No newline at end of file
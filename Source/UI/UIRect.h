@@ -14,7 +14,7 @@ public:
     UIRect(class Game* game, const Vector2 &offset, const Vector2 &size, float scale = 1.0f, float angle = 0.0f, int drawOrder = 100);
     ~UIRect();
 
-    void Draw(class Shader* shader) override;
+    void Draw(class Renderer* renderer) override;
     void SetColor(const Vector4 &color) { mColor = color; }
 
 protected:
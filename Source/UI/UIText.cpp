@@ -5,8 +5,8 @@
 #include "UIText.h"
 #include "../Renderer/Font.h"
 #include "../Renderer/Texture.h"
-#include "../Renderer/Shader.h"
-#include <GL/glew.h>
+#include "../Renderer/Renderer.h"
+#include "../Game.h"
 
 UIText::UIText(class Game* game, const std::string& text, class Font* font, const Vector2 &offset, float scale, float angle,
                int pointSize, const unsigned wrapLength, int drawOrder)
@@ -23,18 +23,15 @@ UIText::UIText(class Game* game, const std::string& text, class Font* font, cons
 
 UIText::~UIText()
 {
-
+    GetGame()->GetRenderer()->ReleaseTexture(mTexture);
+    mTexture = nullptr;
 }
 
 void UIText::SetText(const std::string &text)
 {
     // Clear out previous title texture if it exists
-    if (mTexture)
-    {
-        mTexture->Unload();
-        delete mTexture;
-        mTexture = nullptr;
-    }
+    GetGame()->GetRenderer()->ReleaseTexture(mTexture);
+    mTexture = nullptr;
 
     // Create texture for title
     mText = text;
@@ -44,18 +41,14 @@ void UIText::SetText(const std::string &text)
 void UIText::SetTextColor(const Vector3 &color)
 {
     // Clear out previous title texture if it exists
-    if (mTexture)
-    {
-        mTexture->Unload();
-        delete mTexture;
-        mTexture = nullptr;
-    }
+    GetGame()->GetRenderer()->ReleaseTexture(mTexture);
+    mTexture = nullptr;
 
     mTextColor = color;
     mTexture = mFont->RenderText(mText, mTextColor, mPointSize, mWrapLength);
 }
 
-void UIText::Draw(class Shader* shader)
+void UIText::Draw(class Renderer* renderer)
 {
     if(!mTexture || !GetIsVisible())
         return;
@@ -69,15 +62,10 @@ void UIText::Draw(class Shader* shader)
 
     // Set world transform
     Matrix4 world = scaleMat * transMat;
-    shader->SetMatrixUniform("uWorldTransform", world);
-
-    // Set uTextureFactor and color
-    shader->SetFloatUniform("uTextureFactor", 0.0f);
-    shader->SetVectorUniform("uBaseColor", mBackgroundColor);
 
-    // Draw quad
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+    // Draw quad with the background color only
+    renderer->DrawSprite(world, nullptr, mBackgroundColor, 0.0f);
 
     // Draw text
-    UIImage::Draw(shader);
+    UIImage::Draw(renderer);
 }
\ No newline at end of file
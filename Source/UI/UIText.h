@@ -16,7 +16,7 @@ public:
 
     ~UIText();
 
-    void Draw(class Shader* shader) override;
+    void Draw(class Renderer* renderer) override;
 
     void SetText(const std::string& name);
     void SetTextColor(const Vector3 &color);
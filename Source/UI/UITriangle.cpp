@@ -1,9 +1,8 @@
 #include "UITriangle.h"
-#include "../Renderer/Shader.h"
+#include "../Renderer/Renderer.h"
 #include "../Renderer/VertexArray.h"
 #include "../Game.h"
 #include "../Math.h"
-#include <GL/glew.h>
 
 UITriangle::UITriangle(class Game* game, const Vector2& offset, float size, float angle, int drawOrder)
     : UIElement(game, offset, 1.0f, angle, drawOrder)
@@ -41,14 +40,11 @@ UITriangle::UITriangle(class Game* game, const Vector2& offset, float size, floa
 
 UITriangle::~UITriangle()
 {
-    if (mTriangleVerts)
-    {
-        delete mTriangleVerts;
-        mTriangleVerts = nullptr;
-    }
+    GetGame()->GetRenderer()->ReleaseVertexArray(mTriangleVerts);
+    mTriangleVerts = nullptr;
 }
 
-void UITriangle::Draw(class Shader* shader)
+void UITriangle::Draw(class Renderer* renderer)
 {
     if (!GetIsVisible() || !mTriangleVerts)
         return;
@@ -63,17 +59,8 @@ void UITriangle::Draw(class Shader* shader)
     
     // Set world transform
     Matrix4 world = scaleMat * rotMat * transMat;
-    shader->SetMatrixUniform("uWorldTransform", world);
-    
-    // Set uTextureFactor and color
-    shader->SetFloatUniform("uTextureFactor", 0.0f);
-    shader->SetVectorUniform("uBaseColor", mColor);
-    
-    // Set texture uniform (even though we're not using a texture, the shader expects it)
-    shader->SetTextureUniform("uTexture", 0, 0);
     
     // Draw triangle (usar apenas os primeiros 3 índices para formar um triângulo)
-    mTriangleVerts->SetActive();
-    glDrawElements(GL_TRIANGLES, 3, GL_UNSIGNED_INT, nullptr);
+    renderer->DrawSprite(world, nullptr, mColor, 0.0f, mTriangleVerts, 3);
 }
 
@@ -9,7 +9,7 @@ public:
     UITriangle(class Game* game, const Vector2& offset, float size, float angle, int drawOrder = 100);
     ~UITriangle();
 
-    void Draw(class Shader* shader) override;
+    void Draw(class Renderer* renderer) override;
     void SetColor(const Vector4& color) { mColor = color; }
 
 private:
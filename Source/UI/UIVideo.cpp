@@ -1,29 +1,23 @@
 #include "UIVideo.h"
 #include "../Renderer/VideoPlayer.h"
-#include "../Renderer/Shader.h"
+#include "../Renderer/Renderer.h"
 #include "../Game.h"
 #include "../Math.h"
-#include <GL/glew.h>
 
 UIVideo::UIVideo(class Game* game, class VideoPlayer* videoPlayer, const Vector2& offset, float scale, float angle, int drawOrder)
     : UIImage(game, offset, scale, angle, drawOrder)
     , mVideoPlayer(videoPlayer)
-    , mVideoTextureID(0)
 {
-    if (mVideoPlayer)
-    {
-        mVideoTextureID = mVideoPlayer->GetTextureID();
-    }
 }
 
-void UIVideo::Draw(class Shader* shader)
+void UIVideo::Draw(class Renderer* renderer)
 {
     if (!mVideoPlayer || !GetIsVisible())
         return;
     
     // Usar a textura do vídeo ao invés da textura normal
-    unsigned int textureID = mVideoPlayer->GetTextureID();
-    if (textureID == 0)
+    class Texture* texture = mVideoPlayer->GetTexture();
+    if (!texture)
         return;
     
     // Scale the quad by the width/height of video
@@ -40,18 +34,8 @@ void UIVideo::Draw(class Shader* shader)
     
     // Set world transform
     Matrix4 world = scaleMat * rotMat * transMat;
-    shader->SetMatrixUniform("uWorldTransform", world);
     
-    // Set uTextureFactor
-    shader->SetFloatUniform("uTextureFactor", 1.0f);
-    
-    // Set color (sempre branco para vídeo)
-    shader->SetVectorUniform("uBaseColor", Vector4(1.0f, 1.0f, 1.0f, 1.0f));
-    
-    // Set current texture and texture uniform (usando a textura do vídeo)
-    shader->SetTextureUniform("uTexture", textureID, 0);
-    
-    // Draw quad (usar os mesmos vertices do sprite que já estão ativos)
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+    // Draw quad com a textura do vídeo (sempre branco para vídeo)
+    renderer->DrawSprite(world, texture, Vector4(1.0f, 1.0f, 1.0f, 1.0f), 1.0f);
 }
 
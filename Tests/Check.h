@@ -0,0 +1,23 @@
+#pragma once
+#include <cstdio>
+
+// Assertions of line-casters-tests: a failed CHECK prints its line and the
+// suite goes on, run reports one line per test
+namespace Check {
+    inline int failures = 0;
+
+    inline void check(const bool condition, const char *expression, const char *file, const int line) {
+        if (!condition) {
+            printf("  %s:%d: %s\n", file, line, expression);
+            failures++;
+        }
+    }
+
+    inline void run(const char *name, void (*test)()) {
+        const int failuresBefore = failures;
+        test();
+        printf("%s %s\n", failures == failuresBefore ? "ok  " : "FAIL", name);
+    }
+}
+
+#define CHECK(condition) Check::check((condition), #condition, __FILE__, __LINE__)
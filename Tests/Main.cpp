@@ -0,0 +1,29 @@
+#include "Check.h"
+#include "Tests.h"
+#include <cstring>
+
+int main(const int argc, char **argv) {
+    const char *name = argc > 1 ? argv[1] : "all";
+    const bool all = strcmp(name, "all") == 0;
+
+    bool ran = false;
+    if (all || strcmp(name, "snapshot") == 0) {
+        Tests::runSnapshotCodec();
+        ran = true;
+    }
+    if (all || strcmp(name, "transport") == 0) {
+        Tests::runTransport();
+        ran = true;
+    }
+    if (all || strcmp(name, "match") == 0) {
+        Tests::runMatch();
+        ran = true;
+    }
+
+    if (!ran) {
+        printf("Usage: %s [all|snapshot|transport|match]\n", argv[0]);
+        return 1;
+    }
+
+    return Check::failures == 0 ? 0 : 1;
+}
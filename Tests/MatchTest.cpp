@@ -0,0 +1,68 @@
+#include "Check.h"
+#include "Tests.h"
+#include "../Server/Match.h"
+#include "../Server/Server.h"
+#include <vector>
+
+// Commands as Server::HandleData hands them to the match, with the
+// ticks of Server::Tick in between
+namespace {
+    std::vector<Command> makeCommands(const uint32_t first, const size_t size) {
+        std::vector<Command> commands;
+        for (size_t i = 0; i < size; i++) {
+            commands.emplace_back(first + static_cast<uint32_t>(i), InputData(0));
+        }
+        return commands;
+    }
+
+    uint32_t confirmedSequence(Match &match, const int slot) {
+        return match.BuildState(slot).lastConfirmedInputSequence;
+    }
+
+    // A client sending a second of commands at once only gets the budget
+    void testFloodIsCappedPerTick() {
+        Match match;
+        const int slot = match.AddPlayer(1);
+        const std::vector<Command> commands = makeCommands(1, 60);
+
+        match.ApplyCommands(slot, commands.data(), commands.size(), 0.0f);
+        CHECK(confirmedSequence(match, slot) == Match::MAX_COMMAND_BUDGET);
+
+        // the same batch again within the tick adds nothing
+        match.ApplyCommands(slot, commands.data(), commands.size(), 0.0f);
+        CHECK(confirmedSequence(match, slot) == Match::MAX_COMMAND_BUDGET);
+
+        // every tick lets COMMANDS_PER_TICK of the unconfirmed ones through
+        for (int tick = 1; tick <= 5; tick++) {
+            match.Update(Server::TICK_DELTA_TIME);
+            match.ApplyCommands(slot, commands.data(), commands.size(), 0.0f);
+            CHECK(confirmedSequence(match, slot) == static_cast<uint32_t>(Match::MAX_COMMAND_BUDGET + tick * Match::COMMANDS_PER_TICK));
+        }
+    }
+
+    // Real time input is never held back, bursts within the allowance neither
+    void testRealTimeInputKeepsUp() {
+        Match match;
+        const int slot = match.AddPlayer(1);
+        uint32_t next = 1;
+
+        for (int tick = 0; tick < 30; tick++) {
+            const std::vector<Command> commands = makeCommands(next, Match::COMMANDS_PER_TICK);
+            match.ApplyCommands(slot, commands.data(), commands.size(), 0.0f);
+            next += Match::COMMANDS_PER_TICK;
+            CHECK(confirmedSequence(match, slot) == next - 1);
+            match.Update(Server::TICK_DELTA_TIME);
+        }
+
+        // two ticks of commands arriving together after a lost packet
+        match.Update(Server::TICK_DELTA_TIME);
+        const std::vector<Command> late = makeCommands(next, 2 * Match::COMMANDS_PER_TICK);
+        match.ApplyCommands(slot, late.data(), late.size(), 0.0f);
+        CHECK(confirmedSequence(match, slot) == next + late.size() - 1);
+    }
+}
+
+void Tests::runMatch() {
+    Check::run("command flood is capped per tick", testFloodIsCappedPerTick);
+    Check::run("real time input keeps up", testRealTimeInputKeepsUp);
+}
@@ -0,0 +1,288 @@
+#include "Check.h"
+#include "Tests.h"
+#include "../Client/SnapshotCodec.h"
+#include "../Network/Packet.h"
+#include "../Source/Math.h"
+#include <utility>
+
+// Round trips of SnapshotCodec the way the server and the client use it: the
+// server keeps the states it sent, the client the states it decoded, and the
+// deltas are resolved against those two histories.
+namespace {
+    // Half a quantization step of each field
+    constexpr float POSITION_TOLERANCE = 0.5f / SnapshotCodec::POSITION_SCALE;
+    constexpr float ROTATION_TOLERANCE = Math::Pi / (1 << SnapshotCodec::ROTATION_BITS);
+    constexpr float TIMER_TOLERANCE = 0.5f / SnapshotCodec::TIMER_SCALE;
+
+    bool near(const float a, const float b, const float tolerance) {
+        return Math::Abs(a - b) <= tolerance + 1e-4f;
+    }
+
+    bool nearRotation(const float a, const float b) {
+        float difference = Math::Fmod(Math::Abs(a - b), Math::TwoPi);
+        difference = Math::Min(difference, Math::TwoPi - difference);
+        return difference <= ROTATION_TOLERANCE + 1e-4f;
+    }
+
+    void checkShip(const float x, const float y, const float rotation, const int life, const float timer,
+                   const float decodedX, const float decodedY, const float decodedRotation, const int decodedLife,
+                   const float decodedTimer) {
+        CHECK(near(x, decodedX, POSITION_TOLERANCE));
+        CHECK(near(y, decodedY, POSITION_TOLERANCE));
+        CHECK(nearRotation(rotation, decodedRotation));
+        CHECK(life == decodedLife);
+        CHECK(near(timer, decodedTimer, TIMER_TOLERANCE));
+    }
+
+    void checkState(const FullState &sent, const FullState &decoded) {
+        CHECK(decoded.serverTick == sent.serverTick);
+        CHECK(decoded.lastConfirmedInputSequence == sent.lastConfirmedInputSequence);
+        CHECK(decoded.rawState.active == sent.rawState.active);
+        checkShip(sent.rawState.posX, sent.rawState.posY, sent.rawState.rotation, sent.rawState.life,
+                  sent.rawState.invulnerableTimer, decoded.rawState.posX, decoded.rawState.posY,
+                  decoded.rawState.rotation, decoded.rawState.life, decoded.rawState.invulnerableTimer);
+
+        CHECK(decoded.otherStateSize == sent.otherStateSize);
+        for (size_t i = 0; i < sent.otherStateSize && i < decoded.otherStateSize; i++) {
+            const OtherState &a = sent.otherStates[i];
+            const OtherState &b = decoded.otherStates[i];
+            CHECK(a.id == b.id);
+            checkShip(a.posX, a.posY, a.rotation, a.life, a.invulnerableTimer,
+                      b.posX, b.posY, b.rotation, b.life, b.invulnerableTimer);
+        }
+    }
+
+    FullState makeState(const uint32_t tick, const size_t others) {
+        RawState raw;
+        raw.active = true;
+        raw.posX = 960.3f;
+        raw.posY = 540.7f;
+        raw.rotation = 1.234f;
+        raw.life = 3;
+        raw.invulnerableTimer = 1.5f;
+
+        FullState state(raw, tick * 2);
+        state.serverTick = tick;
+        for (size_t i = 0; i < others; i++) {
+            const auto offset = static_cast<float>(i);
+            state.otherStates[state.otherStateSize++] = OtherState(
+                static_cast<int>(100 + i), Math::Fmod(50.0f + offset * 137.1f, 1900.0f),
+                Math::Fmod(20.0f + offset * 83.9f, 1060.0f), offset * 0.4f,
+                static_cast<int>(i % 4), i % 3 == 0 ? 0.75f : 0.0f);
+        }
+        return state;
+    }
+
+    // Encodes like ServerOperations::sendStateToClient and stores what was sent
+    size_t send(const FullState &state, const uint16_t snapshotId, const bool hasAck, const uint16_t ackedId,
+                SnapshotHistory &sent, uint8_t *buffer, const size_t capacity, bool *isDelta) {
+        const FullState *baseline = hasAck ? sent.FindBaseline(snapshotId, ackedId) : nullptr;
+        *isDelta = baseline != nullptr;
+
+        size_t written = 0;
+        const size_t size = SnapshotCodec::encode(state, snapshotId, baseline, ackedId, buffer, capacity, &written);
+
+        FullState stored = state;
+        stored.otherStateSize = written;
+        sent.Store(snapshotId, stored);
+        return size;
+    }
+
+    void testFullSnapshot() {
+        SnapshotHistory sent;
+        const SnapshotHistory received;
+        uint8_t buffer[Packet::MAX_PACKET_DATA_BYTES];
+        const FullState state = makeState(1000, 12);
+
+        bool isDelta = true;
+        const size_t size = send(state, 7, false, 0, sent, buffer, sizeof(buffer), &isDelta);
+        CHECK(size > 0);
+        CHECK(!isDelta);
+
+        // no history at all on the receiving side
+        FullState decoded;
+        uint16_t id = 0;
+        CHECK(SnapshotCodec::decode(buffer, size, received, &decoded, &id));
+        CHECK(id == 7);
+        checkState(state, decoded);
+
+        uint16_t peeked = 0;
+        CHECK(SnapshotCodec::peekId(buffer, size, &peeked));
+        CHECK(peeked == 7);
+    }
+
+    void testDeltaAgainstAckedBaseline() {
+        SnapshotHistory sent;
+        SnapshotHistory received;
+        uint8_t buffer[Packet::MAX_PACKET_DATA_BYTES];
+
+        // snapshot 40 reaches the client, which acks it
+        const FullState first = makeState(2000, 10);
+        bool isDelta = true;
+        size_t size = send(first, 40, false, 0, sent, buffer, sizeof(buffer), &isDelta);
+        FullState decoded;
+        uint16_t id = 0;
+        CHECK(SnapshotCodec::decode(buffer, size, received, &decoded, &id));
+        received.Store(id, decoded);
+        const size_t fullSize = size;
+
+        // a few ticks later: some moved a little, one jumped across the
+        // world, one got hit, one left and one joined, the order changed
+        FullState next = first;
+        next.serverTick += 3;
+        next.lastConfirmedInputSequence += 6;
+        next.rawState.posX += 4.5f;
+        next.rawState.rotation += 0.3f;
+        next.otherStates[0].posX += 2.0f;
+        next.otherStates[1].posY = 1000.0f;
+        next.otherStates[2].life -= 1;
+        next.otherStates[2].invulnerableTimer = 2.0f;
+        next.otherStates[3] = OtherState(555, 300.0f, 400.0f, 3.0f, 3, 0.0f);
+        std::swap(next.otherStates[4], next.otherStates[5]);
+
+        size = send(next, 43, true, 40, sent, buffer, sizeof(buffer), &isDelta);
+        CHECK(isDelta);
+        CHECK(size > 0 && size < fullSize);
+
+        CHECK(SnapshotCodec::decode(buffer, size, received, &decoded, &id));
+        CHECK(id == 43);
+        checkState(next, decoded);
+
+        // nothing changed since the baseline, only the flags go
+        size = send(first, 44, true, 40, sent, buffer, sizeof(buffer), &isDelta);
+        CHECK(isDelta);
+        CHECK(size * 4 < fullSize);
+        CHECK(SnapshotCodec::decode(buffer, size, received, &decoded, &id));
+        checkState(first, decoded);
+
+        // the client dropped the baseline, the delta cannot be resolved
+        SnapshotHistory empty;
+        CHECK(!SnapshotCodec::decode(buffer, size, empty, &decoded, &id));
+    }
+
+    void testIdsWrapAround() {
+        SnapshotHistory sent;
+        SnapshotHistory received;
+        uint8_t buffer[Packet::MAX_PACKET_DATA_BYTES];
+
+        bool isDelta = true;
+        const FullState first = makeState(10, 4);
+        size_t size = send(first, 65534, false, 0, sent, buffer, sizeof(buffer), &isDelta);
+        FullState decoded;
+        uint16_t id = 0;
+        CHECK(SnapshotCodec::decode(buffer, size, received, &decoded, &id));
+        received.Store(id, decoded);
+
+        const FullState next = makeState(12, 4);
+        size = send(next, 1, true, 65534, sent, buffer, sizeof(buffer), &isDelta);
+        CHECK(isDelta);
+        CHECK(SnapshotCodec::decode(buffer, size, received, &decoded, &id));
+        CHECK(id == 1);
+        checkState(next, decoded);
+        CHECK(SnapshotCodec::isNewer(1, 65534));
+    }
+
+    void testFallbackWhenBaselineWrapped() {
+        SnapshotHistory sent;
+        SnapshotHistory received;
+        uint8_t buffer[Packet::MAX_PACKET_DATA_BYTES];
+
+        const FullState acked = makeState(3000, 6);
+        bool isDelta = true;
+        size_t size = send(acked, 100, false, 0, sent, buffer, sizeof(buffer), &isDelta);
+        FullState decoded;
+        uint16_t id = 0;
+        CHECK(SnapshotCodec::decode(buffer, size, received, &decoded, &id));
+        received.Store(id, decoded);
+
+        // the last ack is still 100 but a whole history of snapshots went out
+        // since, slot 100 % HISTORY_SIZE now holds a newer one on both sides
+        const auto wrapped = static_cast<uint16_t>(100 + SnapshotHistory::HISTORY_SIZE);
+        const FullState newer = makeState(3100, 6);
+        size = send(newer, wrapped, false, 0, sent, buffer, sizeof(buffer), &isDelta);
+        CHECK(SnapshotCodec::decode(buffer, size, received, &decoded, &id));
+        received.Store(id, decoded);
+        CHECK(sent.Find(100) == nullptr);
+        CHECK(received.Find(100) == nullptr);
+
+        // one more and the ack is out of range, the server falls back to a full snapshot
+        const FullState latest = makeState(3105, 6);
+        const auto latestId = static_cast<uint16_t>(wrapped + 1);
+        CHECK(sent.FindBaseline(latestId, 100) == nullptr);
+        size = send(latest, latestId, true, 100, sent, buffer, sizeof(buffer), &isDelta);
+        CHECK(!isDelta);
+        CHECK(SnapshotCodec::decode(buffer, size, received, &decoded, &id));
+        CHECK(id == latestId);
+        checkState(latest, decoded);
+
+        // a delta against the overwritten entry is refused, never misapplied
+        size_t written = 0;
+        size = SnapshotCodec::encode(latest, latestId, &acked, 100, buffer, sizeof(buffer), &written);
+        CHECK(size > 0);
+        CHECK(!SnapshotCodec::decode(buffer, size, received, &decoded, &id));
+    }
+
+    void testTruncatedInput() {
+        SnapshotHistory sent;
+        SnapshotHistory received;
+        uint8_t buffer[Packet::MAX_PACKET_DATA_BYTES];
+
+        const FullState first = makeState(500, 20);
+        bool isDelta = true;
+        const size_t fullSize = send(first, 9, false, 0, sent, buffer, sizeof(buffer), &isDelta);
+        FullState decoded;
+        uint16_t id = 0;
+        CHECK(SnapshotCodec::decode(buffer, fullSize, received, &decoded, &id));
+        received.Store(id, decoded);
+
+        // the last byte may only hold padding, every shorter cut has to fail
+        for (size_t size = 0; size + 1 < fullSize; size++) {
+            CHECK(!SnapshotCodec::decode(buffer, size, received, &decoded, &id));
+        }
+
+        FullState next = first;
+        next.serverTick++;
+        next.otherStates[3].posX += 1.0f;
+        const size_t deltaSize = send(next, 10, true, 9, sent, buffer, sizeof(buffer), &isDelta);
+        CHECK(isDelta);
+        for (size_t size = 0; size + 1 < deltaSize; size++) {
+            CHECK(!SnapshotCodec::decode(buffer, size, received, &decoded, &id));
+        }
+
+        uint16_t peeked = 0;
+        CHECK(!SnapshotCodec::peekId(buffer, 1, &peeked));
+    }
+
+    void testCapacityLimitsOtherStates() {
+        SnapshotHistory sent;
+        const SnapshotHistory received;
+        uint8_t buffer[Packet::MAX_PACKET_DATA_BYTES];
+
+        const FullState state = makeState(700, MAX_OTHER_STATES);
+        constexpr size_t capacity = 64;
+        size_t written = 0;
+        const size_t size = SnapshotCodec::encode(state, 3, nullptr, 0, buffer, capacity, &written);
+        CHECK(size > 0 && size <= capacity);
+        CHECK(written > 0 && written < MAX_OTHER_STATES);
+
+        // the ones written are the first ones, in order
+        FullState expected = state;
+        expected.otherStateSize = written;
+        FullState decoded;
+        uint16_t id = 0;
+        CHECK(SnapshotCodec::decode(buffer, size, received, &decoded, &id));
+        checkState(expected, decoded);
+
+        // not even the player fits
+        CHECK(SnapshotCodec::encode(state, 3, nullptr, 0, buffer, 4, &written) == 0);
+    }
+}
+
+void Tests::runSnapshotCodec() {
+    Check::run("full snapshot", testFullSnapshot);
+    Check::run("delta against the acked baseline", testDeltaAgainstAckedBaseline);
+    Check::run("snapshot ids wrap around", testIdsWrapAround);
+    Check::run("full fallback when the baseline wrapped", testFallbackWhenBaselineWrapped);
+    Check::run("truncated input", testTruncatedInput);
+    Check::run("capacity limits the other states", testCapacityLimitsOtherStates);
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+// Suites of line-casters-tests, each runs its tests through Check::run
+namespace Tests {
+    // Snapshot encode/decode round trips, full and delta
+    void runSnapshotCodec();
+    // Datagram framing of TransportWriter and TransportReader
+    void runTransport();
+    // Per tick command budget of the server match
+    void runMatch();
+}
@@ -0,0 +1,146 @@
+#include "Check.h"
+#include "Tests.h"
+#include "../Network/PacketBatch.h"
+#include "../Network/Transport.h"
+#include <cstring>
+
+// Datagrams as TransportWriter lays them out in a send batch, read back the
+// way each side reads them: handshake and teardown replies as plain packets
+// (Client::ReceiveSynAck, Bot::HandleDatagram), the rest through a
+// TransportReader.
+namespace {
+    constexpr uint32_t NONCE = 0x1234ABCD;
+    constexpr uint16_t SEQUENCE = 41;
+
+    sockaddr_in makeAddress(const uint16_t port) {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(port);
+        return addr;
+    }
+
+    // An outgoing slot as the peer receives it, the batch only sizes its
+    // datagrams when it is sent
+    PacketView datagram(PacketBatch &batch, const size_t index) {
+        const PacketView slot(batch.GetBuffer(index), PacketBatch::SLOT_BYTES);
+        return {batch.GetBuffer(index), Packet::PACKET_HEADER_BYTES + slot.GetLength()};
+    }
+
+    // What a client accepts while connecting or closing: a whole valid packet
+    // carrying the flag itself
+    bool isPlainReply(PacketBatch &batch, const size_t index, const uint8_t flag) {
+        const PacketView view = datagram(batch, index);
+        return view.IsValid() && view.GetFlag() == flag;
+    }
+
+    // The server answers every copy of a SYN it gets in one receive batch
+    void testDuplicatedSynGetsPlainSynAcks() {
+        PacketBatch batch(8);
+        TransportWriter writer(&batch);
+        const sockaddr_in client = makeAddress(50000);
+
+        // as ServerOperations::sendSinglePacketToClient writes a SYN_ACK
+        const auto mode = static_cast<uint8_t>(IntegrityMode::CRC32C);
+        for (int copy = 0; copy < 2; copy++) {
+            CHECK(writer.Write(client, NONCE, IntegrityMode::ONES_COMPLEMENT, Packet::SYN_ACK_FLAG, SEQUENCE,
+                &mode, sizeof(mode)) == Packet::PACKET_HEADER_BYTES + sizeof(mode));
+        }
+        writer.Seal();
+
+        CHECK(batch.GetSize() == 2);
+        for (size_t i = 0; i < batch.GetSize(); i++) {
+            CHECK(isPlainReply(batch, i, Packet::SYN_ACK_FLAG));
+            CHECK(datagram(batch, i).GetSequence() == SEQUENCE);
+            CHECK(datagram(batch, i).GetLength() == sizeof(mode));
+            CHECK(static_cast<const uint8_t*>(datagram(batch, i).GetData())[0] == mode);
+        }
+    }
+
+    void testTeardownNotBundledWithData() {
+        PacketBatch batch(8);
+        TransportWriter writer(&batch);
+        const sockaddr_in client = makeAddress(50001);
+        const uint8_t data[16] = {};
+
+        writer.Write(client, NONCE, IntegrityMode::ONES_COMPLEMENT, Packet::DATA_FLAG, SEQUENCE, data, sizeof(data));
+        writer.Write(client, NONCE, IntegrityMode::ONES_COMPLEMENT, Packet::END_ACK_FLAG, SEQUENCE + 1, nullptr, 0);
+        writer.Write(client, NONCE, IntegrityMode::ONES_COMPLEMENT, Packet::RST_FLAG, SEQUENCE + 2, nullptr, 0);
+        // nothing joins a control packet either
+        writer.Write(client, NONCE, IntegrityMode::ONES_COMPLEMENT, Packet::DATA_FLAG, SEQUENCE + 3, data, sizeof(data));
+        writer.Seal();
+
+        CHECK(batch.GetSize() == 4);
+        CHECK(isPlainReply(batch, 0, Packet::DATA_FLAG));
+        CHECK(isPlainReply(batch, 1, Packet::END_ACK_FLAG));
+        CHECK(isPlainReply(batch, 2, Packet::RST_FLAG));
+        CHECK(isPlainReply(batch, 3, Packet::DATA_FLAG));
+    }
+
+    void testSmallMessagesShareABundle() {
+        PacketBatch batch(8);
+        TransportWriter writer(&batch);
+        const sockaddr_in client = makeAddress(50002);
+        uint8_t first[40];
+        uint8_t second[7];
+        memset(first, 0xA5, sizeof(first));
+        memset(second, 0x3C, sizeof(second));
+
+        writer.Write(client, NONCE, IntegrityMode::ONES_COMPLEMENT, Packet::DATA_FLAG, SEQUENCE, first, sizeof(first));
+        writer.Write(client, NONCE, IntegrityMode::ONES_COMPLEMENT, Packet::PING_FLAG, 0xBEEF, second, sizeof(second));
+        writer.Seal();
+
+        CHECK(batch.GetSize() == 1);
+        CHECK(isPlainReply(batch, 0, Packet::BUNDLE_FLAG));
+
+        // entries are flag, sequence and size, little endian on every host
+        const auto *payload = static_cast<const uint8_t*>(datagram(batch, 0).GetData());
+        const uint8_t entry[] = {Packet::DATA_FLAG, SEQUENCE & 0xFF, SEQUENCE >> 8, sizeof(first), 0};
+        CHECK(memcmp(payload, entry, sizeof(entry)) == 0);
+
+        TransportReader reader;
+        reader.Begin(datagram(batch, 0), std::chrono::steady_clock::now());
+        Transport::Message message{};
+        CHECK(reader.Next(&message));
+        CHECK(message.flag == Packet::DATA_FLAG && message.sequence == SEQUENCE && message.size == sizeof(first));
+        CHECK(memcmp(message.data, first, sizeof(first)) == 0);
+        CHECK(reader.Next(&message));
+        CHECK(message.flag == Packet::PING_FLAG && message.sequence == 0xBEEF && message.size == sizeof(second));
+        CHECK(memcmp(message.data, second, sizeof(second)) == 0);
+        CHECK(!reader.Next(&message));
+    }
+
+    void testLargeMessageIsReassembled() {
+        PacketBatch batch(8);
+        TransportWriter writer(&batch);
+        const sockaddr_in client = makeAddress(50003);
+        uint8_t data[Transport::FRAGMENT_DATA_BYTES * 2 + 100];
+        for (size_t i = 0; i < sizeof(data); i++) {
+            data[i] = static_cast<uint8_t>(i * 7);
+        }
+
+        writer.Write(client, NONCE, IntegrityMode::ONES_COMPLEMENT, Packet::DATA_FLAG, SEQUENCE, data, sizeof(data));
+        writer.Seal();
+        CHECK(batch.GetSize() == 3);
+
+        // out of order, the last fragment first
+        TransportReader reader;
+        Transport::Message message{};
+        const auto now = std::chrono::steady_clock::now();
+        const size_t order[] = {2, 0, 1};
+        for (size_t n = 0; n < 3; n++) {
+            CHECK(isPlainReply(batch, order[n], Packet::FRAGMENT_FLAG));
+            reader.Begin(datagram(batch, order[n]), now);
+            CHECK(reader.Next(&message) == (n == 2));
+        }
+        CHECK(message.flag == Packet::DATA_FLAG && message.sequence == SEQUENCE && message.size == sizeof(data));
+        CHECK(memcmp(message.data, data, sizeof(data)) == 0);
+    }
+}
+
+void Tests::runTransport() {
+    Check::run("duplicated SYN gets plain SYN_ACKs", testDuplicatedSynGetsPlainSynAcks);
+    Check::run("teardown is never bundled with data", testTeardownNotBundledWithData);
+    Check::run("small messages share a bundle", testSmallMessagesShareABundle);
+    Check::run("large message is reassembled", testLargeMessageIsReassembled);
+}